@@ -0,0 +1,655 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+/**
+ * @file
+ * @brief   Measures hook call overhead, barrier cost, transaction commit latency and trampoline
+ *          creation throughput.
+ *
+ * All results are written to `stdout` in CSV format using the following columns:
+ * `benchmark,parameter,iterations,total_ns,ns_per_op`
+ *
+ * Usage: `ZyrexBenchmarks [scale]`. The optional `scale` argument multiplies the default
+ * iteration counts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <Zycore/Defines.h>
+#include <Zycore/LibC.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Zyrex.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/Transaction.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <pthread.h>
+#   include <sys/mman.h>
+#   include <time.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+#if defined(ZYAN_MSVC)
+#   define BENCH_NOINLINE __declspec(noinline)
+#else
+#   define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+/**
+ * @brief   The size of a single generated target function (in bytes).
+ */
+#define BENCH_GENERATED_FUNCTION_SIZE   16
+
+/**
+ * @brief   The maximum number of generated target functions.
+ */
+#define BENCH_MAX_HOOKS                 1024
+
+/**
+ * @brief   The maximum number of idle worker threads.
+ */
+#define BENCH_MAX_THREADS               64
+
+/**
+ * @brief   The maximum barrier recursion depth and the maximum number of distinct barrier
+ *          handles.
+ */
+#define BENCH_MAX_BARRIER_DEPTH         16
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+typedef int (BenchFunction)(int value);
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+#if defined(ZYAN_WINDOWS)
+static LARGE_INTEGER g_frequency;
+#endif
+
+static ZyanU32 g_scale = 1;
+
+static BenchFunction* volatile g_target_original = ZYAN_NULL;
+
+static volatile int g_sink = 0;
+
+static ZyanU8* g_generated_functions = ZYAN_NULL;
+
+#if defined(ZYAN_WINDOWS)
+typedef HANDLE BenchThread;
+
+static HANDLE g_worker_stop_event = ZYAN_NULL;
+#elif defined(ZYAN_POSIX)
+typedef pthread_t BenchThread;
+
+static pthread_mutex_t g_worker_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t g_worker_condition = PTHREAD_COND_INITIALIZER;
+
+static ZyanBool g_worker_stop = ZYAN_FALSE;
+#endif
+
+/* ============================================================================================== */
+/* Helper functions                                                                               */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Timing                                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+static void BenchInitializeTimer(void)
+{
+#if defined(ZYAN_WINDOWS)
+    QueryPerformanceFrequency(&g_frequency);
+#endif
+}
+
+static ZyanU64 BenchNow(void)
+{
+#if defined(ZYAN_WINDOWS)
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (ZyanU64)counter.QuadPart;
+#elif defined(ZYAN_POSIX)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (ZyanU64)now.tv_sec * 1000000000ULL + (ZyanU64)now.tv_nsec;
+#endif
+}
+
+static ZyanU64 BenchElapsedNs(ZyanU64 start, ZyanU64 end)
+{
+    const ZyanU64 ticks = end - start;
+
+#if defined(ZYAN_WINDOWS)
+    const ZyanU64 frequency = (ZyanU64)g_frequency.QuadPart;
+
+    return (ticks / frequency) * 1000000000ULL + ((ticks % frequency) * 1000000000ULL) / frequency;
+#elif defined(ZYAN_POSIX)
+    // The monotonic clock already counts in nanoseconds
+    return ticks;
+#endif
+}
+
+static void BenchReport(const char* benchmark, ZyanU64 parameter, ZyanU64 iterations,
+    ZyanU64 total_ns)
+{
+    printf("%s,%llu,%llu,%llu,%.3f\n", benchmark, (unsigned long long)parameter,
+        (unsigned long long)iterations, (unsigned long long)total_ns,
+        iterations ? (double)total_ns / (double)iterations : 0.0);
+    fflush(stdout);
+}
+
+static int BenchFailed(const char* benchmark, ZyanStatus status)
+{
+    fprintf(stderr, "%s failed with status 0x%08X\n", benchmark, (unsigned int)status);
+    return EXIT_FAILURE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Target functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+static BENCH_NOINLINE int BenchTarget(int value)
+{
+    g_sink = value;
+    return value + 1;
+}
+
+static BENCH_NOINLINE int BenchTargetCallback(int value)
+{
+    return g_target_original(value);
+}
+
+static BENCH_NOINLINE int BenchGeneratedCallback(int value)
+{
+    return value;
+}
+
+/**
+ * @brief   Generates `BENCH_MAX_HOOKS` distinct `mov eax, imm32; ret` functions in a single
+ *          executable buffer.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus BenchGenerateFunctions(void)
+{
+    const ZyanUSize size = BENCH_MAX_HOOKS * BENCH_GENERATED_FUNCTION_SIZE;
+
+#if defined(ZYAN_WINDOWS)
+    g_generated_functions = (ZyanU8*)VirtualAlloc(ZYAN_NULL, size, MEM_RESERVE | MEM_COMMIT,
+        PAGE_EXECUTE_READWRITE);
+    if (!g_generated_functions)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    void* const buffer = mmap(ZYAN_NULL, size, PROT_READ | PROT_WRITE | PROT_EXEC, 
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer == MAP_FAILED)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    g_generated_functions = (ZyanU8*)buffer;
+#endif
+
+    for (ZyanU32 i = 0; i < BENCH_MAX_HOOKS; ++i)
+    {
+        ZyanU8* const code = g_generated_functions + i * BENCH_GENERATED_FUNCTION_SIZE;
+        ZYAN_MEMSET(code, 0xCC, BENCH_GENERATED_FUNCTION_SIZE);
+        code[0] = 0xB8;
+        *(ZyanU32*)(code + 1) = i;
+        code[5] = 0xC3;
+    }
+
+#if defined(ZYAN_WINDOWS)
+    FlushInstructionCache(GetCurrentProcess(), g_generated_functions, size);
+#elif defined(ZYAN_POSIX)
+    __builtin___clear_cache((char*)g_generated_functions, (char*)g_generated_functions + size);
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static void BenchReleaseFunctions(void)
+{
+#if defined(ZYAN_WINDOWS)
+    VirtualFree(g_generated_functions, 0, MEM_RELEASE);
+#elif defined(ZYAN_POSIX)
+    munmap(g_generated_functions, BENCH_MAX_HOOKS * BENCH_GENERATED_FUNCTION_SIZE);
+#endif
+    g_generated_functions = ZYAN_NULL;
+}
+
+static void* BenchGetGeneratedFunction(ZyanU32 index)
+{
+    return g_generated_functions + index * BENCH_GENERATED_FUNCTION_SIZE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Worker threads                                                                                 */
+/* ---------------------------------------------------------------------------------------------- */
+
+#if defined(ZYAN_WINDOWS)
+
+static DWORD WINAPI BenchWorkerThread(LPVOID parameter)
+{
+    ZYAN_UNUSED(parameter);
+
+    WaitForSingleObject(g_worker_stop_event, INFINITE);
+    return 0;
+}
+
+#elif defined(ZYAN_POSIX)
+
+static void* BenchWorkerThread(void* parameter)
+{
+    ZYAN_UNUSED(parameter);
+
+    pthread_mutex_lock(&g_worker_mutex);
+    while (!g_worker_stop)
+    {
+        pthread_cond_wait(&g_worker_condition, &g_worker_mutex);
+    }
+    pthread_mutex_unlock(&g_worker_mutex);
+    return ZYAN_NULL;
+}
+
+#endif
+
+static ZyanStatus BenchInitializeWorkers(void)
+{
+#if defined(ZYAN_WINDOWS)
+    g_worker_stop_event = CreateEventW(ZYAN_NULL, TRUE, FALSE, ZYAN_NULL);
+    if (!g_worker_stop_event)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static void BenchShutdownWorkers(void)
+{
+#if defined(ZYAN_WINDOWS)
+    CloseHandle(g_worker_stop_event);
+    g_worker_stop_event = ZYAN_NULL;
+#endif
+}
+
+static ZyanStatus BenchStartWorkers(BenchThread* threads, ZyanBool* started, ZyanU32 count)
+{
+    for (ZyanU32 i = 0; i < count; ++i)
+    {
+#if defined(ZYAN_WINDOWS)
+        threads[i] = CreateThread(ZYAN_NULL, 0, &BenchWorkerThread, ZYAN_NULL, 0, ZYAN_NULL);
+        started[i] = (threads[i] != ZYAN_NULL);
+#elif defined(ZYAN_POSIX)
+        started[i] = !pthread_create(&threads[i], ZYAN_NULL, &BenchWorkerThread, ZYAN_NULL);
+#endif
+        if (!started[i])
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static void BenchStopWorkers(BenchThread* threads, ZyanBool* started, ZyanU32 count)
+{
+#if defined(ZYAN_WINDOWS)
+    SetEvent(g_worker_stop_event);
+#elif defined(ZYAN_POSIX)
+    pthread_mutex_lock(&g_worker_mutex);
+    g_worker_stop = ZYAN_TRUE;
+    pthread_cond_broadcast(&g_worker_condition);
+    pthread_mutex_unlock(&g_worker_mutex);
+#endif
+
+    for (ZyanU32 i = 0; i < count; ++i)
+    {
+        if (!started[i])
+        {
+            continue;
+        }
+#if defined(ZYAN_WINDOWS)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#elif defined(ZYAN_POSIX)
+        pthread_join(threads[i], ZYAN_NULL);
+#endif
+        started[i] = ZYAN_FALSE;
+    }
+
+#if defined(ZYAN_WINDOWS)
+    ResetEvent(g_worker_stop_event);
+#elif defined(ZYAN_POSIX)
+    g_worker_stop = ZYAN_FALSE;
+#endif
+}
+
+/* ============================================================================================== */
+/* Benchmarks                                                                                     */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Call overhead                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+static ZyanStatus BenchCallOverhead(void)
+{
+    BenchFunction* volatile target = &BenchTarget;
+    const ZyanU64 iterations = 10000000ULL * g_scale;
+
+    ZyanU64 start = BenchNow();
+    for (ZyanU64 i = 0; i < iterations; ++i)
+    {
+        target((int)i);
+    }
+    BenchReport("call_unhooked", 0, iterations, BenchElapsedNs(start, BenchNow()));
+
+    ZYAN_CHECK(ZyrexTransactionBegin());
+    ZYAN_CHECK(ZyrexInstallInlineHook((void*)&BenchTarget, (const void*)&BenchTargetCallback,
+        (ZyanConstVoidPointer*)&g_target_original));
+    ZYAN_CHECK(ZyrexTransactionCommit());
+
+    start = BenchNow();
+    for (ZyanU64 i = 0; i < iterations; ++i)
+    {
+        target((int)i);
+    }
+    BenchReport("call_hooked", 0, iterations, BenchElapsedNs(start, BenchNow()));
+
+    start = BenchNow();
+    for (ZyanU64 i = 0; i < iterations; ++i)
+    {
+        g_target_original((int)i);
+    }
+    BenchReport("call_trampoline", 0, iterations, BenchElapsedNs(start, BenchNow()));
+
+    ZYAN_CHECK(ZyrexTransactionBegin());
+    ZYAN_CHECK(ZyrexRemoveInlineHook((ZyanConstVoidPointer*)&g_target_original));
+    ZYAN_CHECK(ZyrexTransactionCommit());
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Barrier                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+static ZyanStatus BenchBarrierDepth(void)
+{
+    static const ZyanU8 dummy = 0;
+    const ZyrexBarrierHandle handle = ZyrexBarrierGetHandle(&dummy);
+    const ZyanU64 iterations = 1000000ULL * g_scale;
+
+    for (ZyanU32 depth = 1; depth <= BENCH_MAX_BARRIER_DEPTH; ++depth)
+    {
+        const ZyanU64 start = BenchNow();
+        for (ZyanU64 i = 0; i < iterations; ++i)
+        {
+            for (ZyanU32 j = 0; j < depth; ++j)
+            {
+                ZyrexBarrierTryEnterEx(handle, BENCH_MAX_BARRIER_DEPTH);
+            }
+            for (ZyanU32 j = 0; j < depth; ++j)
+            {
+                ZyrexBarrierLeave(handle);
+            }
+        }
+        BenchReport("barrier_depth", depth, iterations * depth, 
+            BenchElapsedNs(start, BenchNow()));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static ZyanStatus BenchBarrierHandles(void)
+{
+    static const ZyanU8 dummies[BENCH_MAX_BARRIER_DEPTH] = { 0 };
+    ZyrexBarrierHandle handles[BENCH_MAX_BARRIER_DEPTH];
+    const ZyanU64 iterations = 1000000ULL * g_scale;
+
+    for (ZyanU32 i = 0; i < BENCH_MAX_BARRIER_DEPTH; ++i)
+    {
+        handles[i] = ZyrexBarrierGetHandle(&dummies[i]);
+    }
+
+    for (ZyanU32 count = 1; count <= BENCH_MAX_BARRIER_DEPTH; ++count)
+    {
+        const ZyanU64 start = BenchNow();
+        for (ZyanU64 i = 0; i < iterations; ++i)
+        {
+            for (ZyanU32 j = 0; j < count; ++j)
+            {
+                ZyrexBarrierTryEnter(handles[j]);
+            }
+            for (ZyanU32 j = count; j > 0; --j)
+            {
+                ZyrexBarrierLeave(handles[j - 1]);
+            }
+        }
+        BenchReport("barrier_handles", count, iterations * count, 
+            BenchElapsedNs(start, BenchNow()));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction commit                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+static ZyanStatus BenchCommitOnce(const char* benchmark_install, const char* benchmark_remove,
+    ZyanU32 parameter, ZyanU32 hook_count)
+{
+    static ZyanConstVoidPointer trampolines[BENCH_MAX_HOOKS];
+
+    ZYAN_CHECK(ZyrexTransactionBegin());
+    ZYAN_CHECK(ZyrexUpdateAllThreads());
+    for (ZyanU32 i = 0; i < hook_count; ++i)
+    {
+        ZYAN_CHECK(ZyrexInstallInlineHook(BenchGetGeneratedFunction(i),
+            (const void*)&BenchGeneratedCallback, &trampolines[i]));
+    }
+    ZyanU64 start = BenchNow();
+    ZYAN_CHECK(ZyrexTransactionCommit());
+    BenchReport(benchmark_install, parameter, 1, BenchElapsedNs(start, BenchNow()));
+
+    ZYAN_CHECK(ZyrexTransactionBegin());
+    ZYAN_CHECK(ZyrexUpdateAllThreads());
+    for (ZyanU32 i = 0; i < hook_count; ++i)
+    {
+        ZYAN_CHECK(ZyrexRemoveInlineHook(&trampolines[i]));
+    }
+    start = BenchNow();
+    ZYAN_CHECK(ZyrexTransactionCommit());
+    BenchReport(benchmark_remove, parameter, 1, BenchElapsedNs(start, BenchNow()));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static ZyanStatus BenchCommitHooks(void)
+{
+    for (ZyanU32 hook_count = 1; hook_count <= BENCH_MAX_HOOKS; hook_count *= 4)
+    {
+        ZYAN_CHECK(BenchCommitOnce("commit_install_hooks", "commit_remove_hooks", hook_count,
+            hook_count));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+static ZyanStatus BenchCommitThreads(void)
+{
+    BenchThread threads[BENCH_MAX_THREADS];
+    ZyanBool started[BENCH_MAX_THREADS] = { 0 };
+
+    for (ZyanU32 thread_count = 0; thread_count <= BENCH_MAX_THREADS; 
+        thread_count = thread_count ? thread_count * 2 : 1)
+    {
+        ZyanStatus status = BenchStartWorkers(threads, started, thread_count);
+        if (ZYAN_SUCCESS(status))
+        {
+            status = BenchCommitOnce("commit_install_threads", "commit_remove_threads", 
+                thread_count, 16);
+        }
+        BenchStopWorkers(threads, started, thread_count);
+        ZYAN_CHECK(status);
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline creation                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Measures the trampoline creation throughput.
+ *
+ * @return  A zyan status code.
+ *
+ * The trampoline of an inline hook is created by `ZyrexInstallInlineHook` and released again,
+ * when the transaction is aborted. Both numbers include the bookkeeping of the pending operation.
+ */
+static ZyanStatus BenchTrampolineCreate(void)
+{
+    static ZyanConstVoidPointer trampolines[BENCH_MAX_HOOKS];
+
+    for (ZyanU32 round = 0; round < g_scale; ++round)
+    {
+        ZYAN_CHECK(ZyrexTransactionBegin());
+
+        ZyanU64 start = BenchNow();
+        for (ZyanU32 i = 0; i < BENCH_MAX_HOOKS; ++i)
+        {
+            const ZyanStatus status = ZyrexInstallInlineHook(BenchGetGeneratedFunction(i),
+                (const void*)&BenchGeneratedCallback, &trampolines[i]);
+            if (!ZYAN_SUCCESS(status))
+            {
+                ZYAN_UNUSED(ZyrexTransactionAbort());
+                return status;
+            }
+        }
+        BenchReport("trampoline_create", BENCH_MAX_HOOKS, BENCH_MAX_HOOKS, 
+            BenchElapsedNs(start, BenchNow()));
+
+        start = BenchNow();
+        ZYAN_CHECK(ZyrexTransactionAbort());
+        BenchReport("trampoline_free", BENCH_MAX_HOOKS, BENCH_MAX_HOOKS, 
+            BenchElapsedNs(start, BenchNow()));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ============================================================================================== */
+/* Entry point                                                                                    */
+/* ============================================================================================== */
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        const long scale = strtol(argv[1], ZYAN_NULL, 10);
+        if (scale <= 0)
+        {
+            fprintf(stderr, "Usage: %s [scale]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        g_scale = (ZyanU32)scale;
+    }
+
+    BenchInitializeTimer();
+
+    ZyanStatus status;
+    if (!ZYAN_SUCCESS((status = ZyrexInitialize())))
+    {
+        return BenchFailed("ZyrexInitialize", status);
+    }
+    if (!ZYAN_SUCCESS((status = ZyrexBarrierSystemInitialize())))
+    {
+        return BenchFailed("ZyrexBarrierSystemInitialize", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchGenerateFunctions())))
+    {
+        return BenchFailed("BenchGenerateFunctions", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchInitializeWorkers())))
+    {
+        return BenchFailed("BenchInitializeWorkers", status);
+    }
+
+    puts("benchmark,parameter,iterations,total_ns,ns_per_op");
+
+    if (!ZYAN_SUCCESS((status = BenchCallOverhead())))
+    {
+        return BenchFailed("call", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchBarrierDepth())))
+    {
+        return BenchFailed("barrier_depth", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchBarrierHandles())))
+    {
+        return BenchFailed("barrier_handles", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchCommitHooks())))
+    {
+        return BenchFailed("commit_hooks", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchCommitThreads())))
+    {
+        return BenchFailed("commit_threads", status);
+    }
+    if (!ZYAN_SUCCESS((status = BenchTrampolineCreate())))
+    {
+        return BenchFailed("trampoline_create", status);
+    }
+
+    BenchShutdownWorkers();
+    BenchReleaseFunctions();
+    ZyrexBarrierSystemShutdown();
+    ZyrexShutdown();
+
+    return EXIT_SUCCESS;
+}
+
+/* ============================================================================================== */
\ No newline at end of file
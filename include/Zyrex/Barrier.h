@@ -134,6 +134,32 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierSystemShutdown();
  */
 ZYREX_EXPORT ZyrexBarrierHandle ZyrexBarrierGetHandle(const void* trampoline);
 
+/**
+ * @brief   Returns the indexed barrier handle for the hook that is identified by the given
+ *          `trampoline`.
+ *
+ * @param   trampoline  The `trampoline` that identifies the hook for which the barrier handle
+ *                      should be obtained.
+ * @param   handle      Receives the indexed barrier handle.
+ *
+ * @return  A zyan status code.
+ *
+ * This function only succeeds for inline hooks that were installed using the
+ * `ZYREX_INLINE_HOOK_FLAG_RESERVE_BARRIER_SLOT` flag. The `trampoline` has to be the exact value
+ * received from the hook installation function.
+ *
+ * Indexed handles refer to a dense barrier slot that was reserved during hook installation. The
+ * barrier API functions directly access the recursion counter of that slot, instead of searching
+ * the per-thread barrier context table.
+ *
+ * The handle stays constant for the lifetime of the hook and can be obtained once (e.g. after
+ * committing the transaction) to be used inside the hook callback. After the hook was removed,
+ * the barrier functions reject the handle with `ZYAN_STATUS_INVALID_ARGUMENT`, as soon as its
+ * barrier slot is reserved by another hook.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexBarrierGetIndexedHandle(const void* trampoline,
+    ZyrexBarrierHandle* handle);
+
 /**
  * @brief   Tries to enter the barrier for the given hook.
  *
@@ -157,6 +183,11 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle);
  *
  * This function passes the barrier, if the `current_recursion_depth` is less than or equal to
  * the given `max_recursion_depth`.
+ *
+ * `ZYAN_STATUS_OUT_OF_RESOURCES` is returned, if the calling thread has already entered too many
+ * distinct barriers at the same time.
+ *
+ * Barriers never pass while the calling thread is draining trace events (see `ZyrexTraceDrain`).
  */
 ZYREX_EXPORT ZyanStatus ZyrexBarrierTryEnterEx(ZyrexBarrierHandle handle,
     ZyanU32 max_recursion_depth);
@@ -187,6 +218,20 @@ ZYREX_EXPORT ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle);
 ZYREX_EXPORT ZyanStatus ZyrexBarrierGetRecursionDepth(ZyrexBarrierHandle handle,
     ZyanU32* current_depth);
 
+/**
+ * @brief   Returns the instrumentation buffer of the current thread.
+ *
+ * @param   buffer  Receives a pointer to the instrumentation buffer of the current thread.
+ * @param   size    Receives the size of the instrumentation buffer (in bytes).
+ *
+ * @return  A zyan status code.
+ *
+ * The buffer is part of the per-thread state block that is shared with the barrier system. It is
+ * zero-initialized the first time a thread accesses its state and never allocated from the heap,
+ * which makes it safe to use inside of hooked memory allocation functions.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexBarrierGetThreadBuffer(void** buffer, ZyanUSize* size);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
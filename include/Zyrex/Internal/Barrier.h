@@ -0,0 +1,262 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_BARRIER_H
+#define ZYREX_INTERNAL_BARRIER_H
+
+#include <Zycore/Types.h>
+#include <Zyrex/Barrier.h>
+#include <Zyrex/Internal/Trampoline.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The number of bits used to encode the barrier slot in an indexed barrier handle.
+ */
+#define ZYREX_BARRIER_SLOT_BITS     9
+
+/**
+ * @brief   Defines the maximum number of barrier slots that can be reserved at the same time.
+ */
+#define ZYREX_BARRIER_MAX_SLOTS     (1 << ZYREX_BARRIER_SLOT_BITS)
+
+/**
+ * @brief   The number of bits used to encode the slot generation in an indexed barrier handle.
+ *
+ * The generation takes all remaining bits of a 32-bit handle, so that indexed handles are valid
+ * on all architectures.
+ */
+#define ZYREX_BARRIER_GENERATION_BITS   (32 - ZYREX_BARRIER_SLOT_BITS - 1)
+
+/**
+ * @brief   The mask used to truncate slot generations to `ZYREX_BARRIER_GENERATION_BITS` bits.
+ */
+#define ZYREX_BARRIER_GENERATION_MASK   ((1u << ZYREX_BARRIER_GENERATION_BITS) - 1)
+
+/**
+ * @brief   Defines a value that signals an invalid/unused barrier slot.
+ */
+#define ZYREX_BARRIER_SLOT_INVALID  (ZyanU32)(-1)
+
+/**
+ * @brief   The number of bits used to index the per-thread barrier context table.
+ */
+#define ZYREX_BARRIER_TABLE_BITS    6
+
+/**
+ * @brief   The number of slots in the per-thread barrier context table.
+ *
+ * The table only holds contexts for hooks that are currently entered by the thread (contexts are
+ * released as soon as their recursion depth drops back to `0`). This value limits the number of
+ * distinct barriers a single thread can have entered at the same time.
+ */
+#define ZYREX_BARRIER_TABLE_SIZE    (1 << ZYREX_BARRIER_TABLE_BITS)
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/**
+ * @brief   Checks, if the given barrier `handle` is an indexed handle.
+ *
+ * @param   handle  The barrier handle.
+ *
+ * Regular barrier handles are derived from pointer values which are always aligned to at least 2
+ * bytes. Indexed handles use the least significant bit to distinguish them from regular ones.
+ */
+#define ZYREX_BARRIER_IS_INDEXED_HANDLE(handle) \
+    (((handle) & 1) != 0)
+
+/**
+ * @brief   Creates an indexed barrier handle for the given barrier `slot` and `generation`.
+ *
+ * @param   slot        The barrier slot.
+ * @param   generation  The generation of the barrier slot.
+ */
+#define ZYREX_BARRIER_MAKE_INDEXED_HANDLE(slot, generation) \
+    (ZyrexBarrierHandle)( \
+        ((ZyrexBarrierHandle)((generation) & ZYREX_BARRIER_GENERATION_MASK) << \
+            (ZYREX_BARRIER_SLOT_BITS + 1)) | ((ZyrexBarrierHandle)(slot) << 1) | 1)
+
+/**
+ * @brief   Checks, if the given indexed barrier `handle` only uses the bits of a valid handle.
+ *
+ * @param   handle  The indexed barrier handle.
+ */
+#define ZYREX_BARRIER_IS_VALID_INDEXED_HANDLE(handle) \
+    (((handle) >> (ZYREX_BARRIER_SLOT_BITS + 1)) <= ZYREX_BARRIER_GENERATION_MASK)
+
+/**
+ * @brief   Returns the barrier slot of the given indexed barrier `handle`.
+ *
+ * @param   handle  The indexed barrier handle.
+ */
+#define ZYREX_BARRIER_GET_HANDLE_SLOT(handle) \
+    (ZyanUSize)(((handle) >> 1) & (ZYREX_BARRIER_MAX_SLOTS - 1))
+
+/**
+ * @brief   Returns the slot generation of the given indexed barrier `handle`.
+ *
+ * @param   handle  The indexed barrier handle.
+ */
+#define ZYREX_BARRIER_GET_HANDLE_GENERATION(handle) \
+    (ZyanU32)(((handle) >> (ZYREX_BARRIER_SLOT_BITS + 1)) & ZYREX_BARRIER_GENERATION_MASK)
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexBarrierContext` struct.
+ */
+typedef struct ZyrexBarrierContext_
+{
+    /**
+     * @brief   The barrier context id or `0`, if the slot is unused.
+     */
+    ZyrexBarrierHandle id;
+    /**
+     * @brief   The current recursion depth.
+     */
+    ZyanU32 recursion_depth;
+} ZyrexBarrierContext;
+
+/**
+ * @brief   Defines the `ZyrexBarrierThreadData` struct.
+ *
+ * The contexts are stored in a fixed-size open-addressed hash table (linear probing) that is
+ * keyed by the barrier handle.
+ */
+typedef struct ZyrexBarrierThreadData_
+{
+    /**
+     * @brief   The number of used slots in the `contexts` table.
+     */
+    ZyanUSize count;
+    /**
+     * @brief   The barrier context table.
+     */
+    ZyrexBarrierContext contexts[ZYREX_BARRIER_TABLE_SIZE];
+    /**
+     * @brief   The current recursion depth for the handle `0`, which can not be stored in the
+     *          `contexts` table, as it marks unused entries.
+     */
+    ZyanU32 null_depth;
+    /**
+     * @brief   The current recursion depth for each barrier slot (used by indexed handles).
+     */
+    ZyanU32 slots[ZYREX_BARRIER_MAX_SLOTS];
+    /**
+     * @brief   The time-stamp counter value of the outermost entry for each barrier slot (used by
+     *          indexed handles with cycle measurement enabled).
+     */
+    ZyanU64 timestamps[ZYREX_BARRIER_MAX_SLOTS];
+    /**
+     * @brief   The slot generation each entry of `slots` and `timestamps` belongs to.
+     *
+     * Barrier slots are reused after their hook was removed. The stored depth is discarded as
+     * soon as the thread enters a barrier with a handle of a newer generation of the slot.
+     */
+    ZyanU32 generations[ZYREX_BARRIER_MAX_SLOTS];
+} ZyrexBarrierThreadData;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Barrier slots                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Reserves a new barrier slot.
+ *
+ * @param   slot    Receives the reserved barrier slot.
+ *
+ * @return  A zyan status code.
+ *
+ * Every reservation starts a new generation of the slot, which invalidates all indexed handles
+ * obtained for previous reservations.
+ *
+ * This function is not thread-safe and has to be called with the region lock held.
+ */
+ZyanStatus ZyrexBarrierSlotReserve(ZyanU32* slot);
+
+/**
+ * @brief   Releases the given barrier slot.
+ *
+ * @param   slot    The barrier slot.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is not thread-safe and has to be called with the region lock held.
+ */
+ZyanStatus ZyrexBarrierSlotRelease(ZyanU32 slot);
+
+/**
+ * @brief   Associates the given trampoline counters with the given barrier slot.
+ *
+ * @param   slot        The barrier slot.
+ * @param   counters    A pointer to the `ZyrexTrampolineCounters` struct or `ZYAN_NULL` to remove
+ *                      the association.
+ *
+ * @return  A zyan status code.
+ *
+ * Barrier entries using an indexed handle of the given slot update the associated counters.
+ *
+ * This function has to be called with the region lock held. Concurrent barrier entries read the
+ * association without any lock, so the `counters` have to stay alive, until no thread is able to
+ * enter a barrier of the given slot anymore.
+ */
+ZyanStatus ZyrexBarrierSlotSetCounters(ZyanU32 slot, ZyrexTrampolineCounters* counters);
+
+/**
+ * @brief   Returns the current generation of the given barrier slot.
+ *
+ * @param   slot    The barrier slot.
+ *
+ * @return  The current generation of the given barrier slot.
+ *
+ * This function reads the generation without any lock. The slot must be reserved and stay
+ * reserved while the caller uses the generation.
+ */
+ZyanU32 ZyrexBarrierSlotGetGeneration(ZyanU32 slot);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_BARRIER_H */
\ No newline at end of file
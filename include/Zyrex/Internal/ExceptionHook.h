@@ -0,0 +1,208 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_EXCEPTION_HOOK_H
+#define ZYREX_INTERNAL_EXCEPTION_HOOK_H
+
+#include <Zycore/Defines.h>
+#ifdef ZYAN_WINDOWS
+#   include <windows.h>
+#endif
+#include <Zycore/Types.h>
+#include <Zyrex/Transaction.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum number of context hooks that can be installed at the same time.
+ *
+ * Every context hook occupies one of the debug address registers `DR0` - `DR3`.
+ */
+#define ZYREX_CONTEXT_HOOK_MAX_COUNT        4
+
+/**
+ * @brief   Defines the opcode of the `INT 3` instruction that is used by exception hooks.
+ */
+#define ZYREX_EXCEPTION_HOOK_OPCODE         0xCC
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexExceptionHook` struct.
+ */
+typedef struct ZyrexExceptionHook_
+{
+    /**
+     * @brief   The hook type (`ZYREX_HOOK_TYPE_EXCEPTION` or `ZYREX_HOOK_TYPE_CONTEXT`).
+     */
+    ZyrexHookType type;
+    /**
+     * @brief   The address of the hooked function.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The address of the callback function.
+     */
+    ZyanUPointer callback;
+} ZyrexExceptionHook;
+
+/**
+ * @brief   Defines the `ZyrexExceptionHookTable` struct.
+ *
+ * The table is an immutable open-addressed hash table (linear probing) that is built once per 
+ * transaction and then published to the exception dispatcher. Unused entries have an `address` 
+ * of `0`. At least half of the entries are always unused, which keeps the probe sequences short.
+ */
+typedef struct ZyrexExceptionHookTable_
+{
+    /**
+     * @brief   The number of bits used to index the `entries`.
+     */
+    ZyanU8 bits;
+    /**
+     * @brief   The hash table entries.
+     */
+    ZyrexExceptionHook* entries;
+    /**
+     * @brief   The next table in the list of retired tables.
+     */
+    struct ZyrexExceptionHookTable_* next;
+} ZyrexExceptionHookTable;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook table                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Creates a new exception hook table.
+ *
+ * @param   hooks   A pointer to the `ZyrexExceptionHook` items to store in the table.
+ * @param   count   The number of items.
+ * @param   table   Receives the newly created table.
+ *
+ * @return  A zyan status code.
+ *
+ * Multiple items with the same address are rejected with `ZYAN_STATUS_INVALID_OPERATION`.
+ */
+ZyanStatus ZyrexExceptionHookTableCreate(const ZyrexExceptionHook* hooks, ZyanUSize count,
+    ZyrexExceptionHookTable** table);
+
+/**
+ * @brief   Destroys the given exception hook table.
+ *
+ * @param   table   The exception hook table.
+ *
+ * Tables that have been published to the exception dispatcher must not be destroyed.
+ */
+void ZyrexExceptionHookTableDestroy(ZyrexExceptionHookTable* table);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exception dispatcher                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Installs the exception dispatcher, if not already done.
+ *
+ * @return  A zyan status code.
+ *
+ * On Windows, the dispatcher is registered as the first vectored exception handler. On POSIX 
+ * systems, it is installed as the `SIGTRAP` signal handler and forwards all unrelated signals to
+ * the previously installed handler.
+ *
+ * This function is not thread-safe and has to be called with the commit lock held. It is safe
+ * to call it again after the dispatcher has been installed.
+ */
+ZyanStatus ZyrexExceptionDispatcherInstall(void);
+
+/**
+ * @brief   Publishes the given exception hook table to the exception dispatcher.
+ *
+ * @param   table   The exception hook table or `ZYAN_NULL` to unpublish the current one. The 
+ *                  exception dispatcher takes ownership of the table.
+ *
+ * The table is exchanged using a single atomic pointer store. The previous table is retired and 
+ * released as soon as no thread is executing the dispatcher anymore. This never blocks, so it is
+ * safe to call this function while threads are suspended inside the dispatcher.
+ *
+ * Publishers have to be serialized by holding the commit lock. The dispatcher itself reads the
+ * table without any lock.
+ */
+void ZyrexExceptionDispatcherPublish(ZyrexExceptionHookTable* table);
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Writes the given context hook addresses to the debug registers of the given thread
+ *          `context`.
+ *
+ * @param   context     A pointer to the `CONTEXT` struct. The struct has to contain at least 
+ *                      the `CONTEXT_DEBUG_REGISTERS` part.
+ * @param   addresses   The addresses to assign to `DR0` - `DR3`. Registers with an address of 
+ *                      `0` are disabled.
+ *
+ * All four breakpoints are configured as local execution breakpoints.
+ */
+void ZyrexDebugRegistersWrite(CONTEXT* context, 
+    const ZyanUPointer addresses[ZYREX_CONTEXT_HOOK_MAX_COUNT]);
+
+/**
+ * @brief   Writes the given context hook addresses to the debug registers of the calling thread.
+ *
+ * @param   addresses   The addresses to assign to `DR0` - `DR3`. Registers with an address of 
+ *                      `0` are disabled.
+ *
+ * @return  A zyan status code.
+ *
+ * A thread can not change its own debug registers using `SetThreadContext`. This function raises
+ * a private exception instead, which is handled by the exception dispatcher by updating the 
+ * context record of the calling thread. The exception dispatcher has to be installed.
+ */
+ZyanStatus ZyrexDebugRegistersWriteCurrentThread(
+    const ZyanUPointer addresses[ZYREX_CONTEXT_HOOK_MAX_COUNT]);
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_EXCEPTION_HOOK_H */
\ No newline at end of file
@@ -0,0 +1,81 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_IMPORT_TABLE_H
+#define ZYREX_INTERNAL_IMPORT_TABLE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ZYAN_WINDOWS
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Import table                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Searches the import address table of the given `module` for the slot of the given 
+ *          import.
+ *
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the module that exports the function (case-insensitive)
+ *                          or `ZYAN_NULL` to match the first import with the given name.
+ * @param   import_name     The name of the imported function or its ordinal value, if the upper
+ *                          bits of the pointer are zero (like for `GetProcAddress`).
+ * @param   slot            Receives the address of the import address table slot.
+ *
+ * @return  A zyan status code.
+ *
+ * The import directory of every module is parsed only once and cached in a list that is sorted 
+ * by function name. The cached list is validated against the `TimeDateStamp` and `SizeOfImage`
+ * of the module headers and rebuilt, if a different module was loaded at the same address.
+ *
+ * This function is not thread-safe and has to be called with the region lock held, which also
+ * protects the cached import tables.
+ */
+ZyanStatus ZyrexImportTableFindSlot(const void* module, const char* import_module, 
+    const char* import_name, void*** slot);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_IMPORT_TABLE_H */
\ No newline at end of file
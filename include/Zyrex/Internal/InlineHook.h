@@ -46,8 +46,74 @@ extern "C" {
 /* Attaching and detaching                                                                        */
 /* ---------------------------------------------------------------------------------------------- */
 
+/**
+ * @brief   Translates the given `instruction_pointer` from the `source` code to the `destination` 
+ *          code.
+ *
+ * @param   instruction_pointer A pointer to the instruction pointer value of a suspended thread.
+ * @param   source              The address of the source code.
+ * @param   source_length       The length of the source code.
+ * @param   destination         The address of the destination code.
+ * @param   destination_length  The length of the destination code.
+ * @param   translation_map     A pointer to the `ZyrexInstructionTranslationMap` struct that
+ *                              maps the original instructions to the trampoline instructions.
+ * @param   reverse             Pass `ZYAN_TRUE` to translate from trampoline code (`source`) 
+ *                              back to original code (`destination`).
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer was updated, `ZYAN_STATUS_FALSE`, if
+ *          the instruction pointer is not inside the `source` code or an other zyan status code,
+ *          if an error occured.
+ *
+ * This is the platform independent part of the thread migration.
+ */
+ZyanStatus ZyrexMigrateInstructionPointer(ZyanUPointer* instruction_pointer, const void* source, 
+    ZyanUSize source_length, const void* destination, ZyanUSize destination_length, 
+    const ZyrexInstructionTranslationMap* translation_map, ZyanBool reverse);
+
 #ifdef ZYAN_WINDOWS
 
+/**
+ * @brief   Translates the instruction pointer in the given thread `context` from the `source` 
+ *          code to the `destination` code.
+ *
+ * @param   context             A pointer to the `CONTEXT` struct of a suspended thread.
+ *                              The struct has to contain at least the `CONTEXT_CONTROL` part.
+ * @param   source              The address of the source code.
+ * @param   source_length       The length of the source code.
+ * @param   destination         The address of the destination code.
+ * @param   destination_length  The length of the destination code.
+ * @param   translation_map     A pointer to the `ZyrexInstructionTranslationMap` struct that
+ *                              maps the original instructions to the trampoline instructions.
+ * @param   reverse             Pass `ZYAN_TRUE` to translate from trampoline code (`source`) 
+ *                              back to original code (`destination`).
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer was updated, `ZYAN_STATUS_FALSE`, if
+ *          the instruction pointer is not inside the `source` code or an other zyan status code,
+ *          if an error occured.
+ *
+ * This function does not perform any system calls. It is up to the caller to read and write back
+ * the thread context.
+ */
+ZyanStatus ZyrexMigrateThreadContext(CONTEXT* context, const void* source, 
+    ZyanUSize source_length, const void* destination, ZyanUSize destination_length, 
+    const ZyrexInstructionTranslationMap* translation_map, ZyanBool reverse);
+
+/**
+ * @brief   Suspends the given thread and translates its instruction pointer from the `source`
+ *          code to the `destination` code, if required.
+ *
+ * @param   thread_id           The id of the thread.
+ * @param   source              The address of the source code.
+ * @param   source_length       The length of the source code.
+ * @param   destination         The address of the destination code.
+ * @param   destination_length  The length of the destination code.
+ * @param   translation_map     A pointer to the `ZyrexInstructionTranslationMap` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * Prefer `ZyrexMigrateThreadContext` when migrating multiple threads for multiple hooks, as this 
+ * function opens, suspends and resumes the thread on every call.
+ */
 ZyanStatus ZyrexMigrateThread(DWORD thread_id, const void* source, ZyanUSize source_length, 
     const void* destination, ZyanUSize destination_length, 
     const ZyrexInstructionTranslationMap* translation_map);
@@ -0,0 +1,164 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_MEMORY_MAP_H
+#define ZYREX_INTERNAL_MEMORY_MAP_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexMemoryRange` struct.
+ *
+ * On POSIX platforms, a memory range describes a contiguous block of mapped memory with uniform
+ * page protection. On Windows, a memory range describes a single (reserved or committed) 
+ * allocation.
+ */
+typedef struct ZyrexMemoryRange_
+{
+    /**
+     * @brief   The start address of the memory range.
+     */
+    ZyanUPointer start;
+    /**
+     * @brief   The end address (exclusive) of the memory range.
+     */
+    ZyanUPointer end;
+    /**
+     * @brief   The native page protection flags of the memory range (`PROT_*` values on POSIX
+     *          platforms and the `PAGE_*` allocation protection on Windows).
+     */
+    ZyanU32 protection;
+} ZyrexMemoryRange;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Memory map                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Marks the cached memory map as outdated.
+ *
+ * The map is rebuilt on the next access. This function is called at the start of every 
+ * transaction, so that all trampoline allocations of a transaction share a single snapshot of the
+ * address space.
+ */
+void ZyrexMemoryMapInvalidate(void);
+
+/**
+ * @brief   Rebuilds the cached memory map of the current process.
+ *
+ * @return  A zyan status code.
+ *
+ * The memory map is built lazily by all other memory map functions. This function only needs to
+ * be called, if the cached map is known to be outdated.
+ *
+ * This function is not thread-safe and has to be called with the region lock held.
+ */
+ZyanStatus ZyrexMemoryMapUpdate(void);
+
+/**
+ * @brief   Searches the cached memory map for the memory range that contains the given 
+ *          `address`.
+ *
+ * @param   address The address to search for.
+ * @param   range   Receives a pointer to the `ZyrexMemoryRange` struct that contains the given
+ *                  `address`. The pointer is only valid until the memory map is modified.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the address is mapped, `ZYAN_STATUS_FALSE` if not, or a generic
+ *          zyan status code if an error occured.
+ *
+ * The memory map is rebuilt once, if the `address` is not covered by the cached map. This allows
+ * to find memory that was mapped after the map has been built (e.g. by loading a new module).
+ */
+ZyanStatus ZyrexMemoryMapFind(ZyanUPointer address, const ZyrexMemoryRange** range);
+
+/**
+ * @brief   Searches the cached memory map for the unmapped block that is closest to the given
+ *          `address`.
+ *
+ * @param   address     The preferred address.
+ * @param   min_address The lowest acceptable start address of the block.
+ * @param   max_address The highest acceptable start address of the block.
+ * @param   size        The size of the block.
+ * @param   alignment   The alignment of the block start address. Must be a power of 2.
+ * @param   result      Receives the start address of the block.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if a matching block was found, `ZYAN_STATUS_FALSE` if not, or a
+ *          generic zyan status code if an error occured.
+ *
+ * The gap that contains the given `address` is located by binary search. The search then walks
+ * outwards in both directions and stops at the first matching gap of each direction, so gaps are
+ * only visited, if they are too small or out of range.
+ */
+ZyanStatus ZyrexMemoryMapFindFree(ZyanUPointer address, ZyanUPointer min_address, 
+    ZyanUPointer max_address, ZyanUSize size, ZyanUSize alignment, ZyanUPointer* result);
+
+/**
+ * @brief   Inserts a new memory range into the cached memory map.
+ *
+ * @param   address     The start address of the memory range.
+ * @param   size        The size of the memory range.
+ * @param   protection  The native page protection flags of the memory range.
+ *
+ * @return  A zyan status code.
+ *
+ * This function should be used to register memory that was mapped by the library itself, which
+ * prevents a full rebuild of the memory map.
+ */
+ZyanStatus ZyrexMemoryMapInsert(ZyanUPointer address, ZyanUSize size, ZyanU32 protection);
+
+/**
+ * @brief   Removes the memory range that starts at the given `address` from the cached memory
+ *          map.
+ *
+ * @param   address The start address of the memory range.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexMemoryMapRemove(ZyanUPointer address);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_MEMORY_MAP_H */
\ No newline at end of file
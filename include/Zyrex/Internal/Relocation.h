@@ -28,18 +28,80 @@
 #define ZYREX_INTERNAL_RELOCATION_H
 
 #include <Zycore/Types.h>
+#include <Zydis/Zydis.h>
 #include <Zyrex/Internal/Trampoline.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexRelocationFixup` struct.
+ *
+ * A fixup describes a relative offset inside the relocated code that refers to an address outside
+ * of the relocated code chunk. All other bytes of the relocated code do not depend on the source
+ * or destination address.
+ */
+typedef struct ZyrexRelocationFixup_
+{
+    /**
+     * @brief   The target address of the relative offset relative to the start of the source
+     *          buffer.
+     */
+    ZyanI64 target;
+    /**
+     * @brief   The offset of the relative value relative to the start of the destination buffer.
+     */
+    ZyanU8 offset;
+    /**
+     * @brief   The size of the relative value (in bits).
+     */
+    ZyanU8 size;
+    /**
+     * @brief   The offset the relative value is calculated from relative to the start of the
+     *          destination buffer.
+     */
+    ZyanU8 base;
+} ZyrexRelocationFixup;
+
+/**
+ * @brief   Defines the `ZyrexRelocationFixups` struct.
+ */
+typedef struct ZyrexRelocationFixups_
+{
+    /**
+     * @brief   The number of items in the `items` array.
+     */
+    ZyanU8 count;
+    /**
+     * @brief   The fixups. Every relocated source instruction produces at most one fixup.
+     */
+    ZyrexRelocationFixup items[ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT];
+} ZyrexRelocationFixups;
+
 /* ============================================================================================== */
 /* Functions                                                                                      */
 /* ============================================================================================== */
 
 /* ---------------------------------------------------------------------------------------------- */
-/*                                                                                                */
+/* Decoder                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the shared instruction decoder for the current architecture.
+ *
+ * @return  A pointer to the shared `ZydisDecoder` instance.
+ *
+ * The decoder is initialized on first use and never modified afterwards.
+ */
+const ZydisDecoder* ZyrexGetDecoder(void);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation                                                                                     */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
@@ -55,12 +117,52 @@ extern "C" {
  *                              instructions intact.
  * @param   bytes_read          Returns the number of bytes read from the source buffer.
  * @param   bytes_written       Returns the number of bytes written to the destination buffer.
+ * @param   fixups              Receives the fixups of the relocated code. This argument is 
+ *                              optional and might be `ZYAN_NULL`.
  *
  * @return  A zyan status code.
  */
 ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length, 
     ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
-    ZyanUSize* bytes_written);
+    ZyanUSize* bytes_written, ZyrexRelocationFixups* fixups);
+
+/**
+ * @brief   Re-applies the given `fixups` to code that was previously relocated from a source 
+ *          buffer with identical content.
+ *
+ * @param   source      A pointer to the source buffer.
+ * @param   destination A pointer to the destination buffer that contains a copy of the relocated
+ *                      code.
+ * @param   fixups      A pointer to the `ZyrexRelocationFixups` struct recorded during the original
+ *                      relocation.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all fixups were applied, `ZYAN_STATUS_OUT_OF_RANGE`, if any
+ *          of the relative values does not fit into its original size.
+ *
+ * The result is identical to relocating the `source` code to the `destination` buffer again. The
+ * `destination` buffer is not modified, if any of the fixups is out of range.
+ */
+ZyanStatus ZyrexRelocationApplyFixups(const void* source, void* destination, 
+    const ZyrexRelocationFixups* fixups);
+
+/**
+ * @brief   Re-applies the given `fixups` to a copy of the relocated code, that is going to be 
+ *          executed at a different address.
+ *
+ * @param   source      The runtime address of the source code.
+ * @param   destination The runtime address of the destination code.
+ * @param   buffer      A pointer to the buffer that contains a copy of the relocated code.
+ * @param   fixups      A pointer to the `ZyrexRelocationFixups` struct recorded during the original
+ *                      relocation.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all fixups were applied, `ZYAN_STATUS_OUT_OF_RANGE`, if any
+ *          of the relative values does not fit into its original size.
+ *
+ * This function is used to generate code for other processes. The `buffer` is not modified, if 
+ * any of the fixups is out of range.
+ */
+ZyanStatus ZyrexRelocationApplyFixupsEx(ZyanUPointer source, ZyanUPointer destination, 
+    void* buffer, const ZyrexRelocationFixups* fixups);
 
 /* ---------------------------------------------------------------------------------------------- */
 
@@ -0,0 +1,107 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_RELOCATION_CACHE_H
+#define ZYREX_INTERNAL_RELOCATION_CACHE_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Internal/Trampoline.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation cache                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Opens the relocation cache file at the given `path`.
+ *
+ * @param   path    The path of the cache file.
+ *
+ * @return  A zyan status code.
+ *
+ * A missing or incompatible cache file is not an error. The cache starts empty in this case.
+ *
+ * This function is not thread-safe and has to be called with the region lock held, as the
+ * trampoline allocator might access the cache at the same time.
+ */
+ZyanStatus ZyrexRelocationCacheOpen(const char* path);
+
+/**
+ * @brief   Closes the relocation cache.
+ *
+ * @param   save    Set `ZYAN_TRUE` to write all entries back to the cache file, if new entries 
+ *                  were added since the cache was opened.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is not thread-safe and has to be called with the region lock held. Pending
+ * entries are discarded, if `save` is `ZYAN_FALSE`.
+ */
+ZyanStatus ZyrexRelocationCacheClose(ZyanBool save);
+
+/**
+ * @brief   Relocates the code at the given `source` address to the given `trampoline` chunk 
+ *          using the relocation cache.
+ *
+ * @param   source              A pointer to the source buffer.
+ * @param   source_length       The maximum amount of bytes that can be safely read from the 
+ *                              source buffer.
+ * @param   trampoline          A pointer to the destination trampoline chunk.
+ * @param   min_bytes_to_reloc  Specifies the minimum amount of bytes that should be relocated.
+ * @param   bytes_read          Returns the number of bytes read from the source buffer.
+ * @param   bytes_written       Returns the number of bytes written to the destination buffer.
+ *
+ * @return  A zyan status code.
+ *
+ * This function behaves exactly like `ZyrexRelocateCode`. If the cache is open and contains an 
+ * entry for the `source` code, the cached code template and translation map are copied to the
+ * `trampoline` and only the relative offsets to external targets are updated. Otherwise, the code 
+ * is relocated and the result is added to the cache.
+ *
+ * This function is not thread-safe and has to be called with the region lock held.
+ */
+ZyanStatus ZyrexRelocationCacheRelocateCode(const void* source, ZyanUSize source_length, 
+    ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
+    ZyanUSize* bytes_written);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_RELOCATION_CACHE_H */
\ No newline at end of file
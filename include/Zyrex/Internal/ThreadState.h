@@ -0,0 +1,140 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_THREADSTATE_H
+#define ZYREX_INTERNAL_THREADSTATE_H
+
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Internal/Barrier.h>
+#include <Zyrex/Internal/Trace.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The size of the per-thread instrumentation buffer (in bytes).
+ */
+#define ZYREX_THREAD_STATE_BUFFER_SIZE  1024
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexThreadState` struct.
+ *
+ * This struct bundles all per-thread data used by the hook runtime (barrier contexts, trampoline
+ * counter shard assignment, the trace ring buffer and the instrumentation buffer). It is never
+ * allocated from the heap, which makes it safe to create the state from inside hooked memory
+ * allocation functions.
+ */
+typedef struct ZyrexThreadState_
+{
+    /**
+     * @brief   The barrier data.
+     */
+    ZyrexBarrierThreadData barrier;
+    /**
+     * @brief   The index of the trampoline counter shard used by this thread incremented by one,
+     *          or `0`, if no shard has been assigned so far.
+     */
+    ZyanU32 counter_shard;
+    /**
+     * @brief   Signals, if the thread is currently excluded from tracing and barriers (while
+     *          draining trace events), if greater than `0`.
+     */
+    ZyanU32 exclusion_depth;
+    /**
+     * @brief   The trace ring buffer owned by this thread or `ZYAN_NULL`, if the thread did not
+     *          record any events so far.
+     */
+    ZyrexTraceRing* trace_ring;
+    /**
+     * @brief   The instrumentation buffer.
+     */
+    ZyanU64 buffer[ZYREX_THREAD_STATE_BUFFER_SIZE / sizeof(ZyanU64)];
+} ZyrexThreadState;
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Initializes the thread state system.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexThreadStateInitialize(void);
+
+/**
+ * @brief   Finalizes the thread state system.
+ *
+ * @return  A zyan status code.
+ *
+ * All thread state blocks are released by this function. Callers have to make sure that no other
+ * thread is still using its state block.
+ */
+ZyanStatus ZyrexThreadStateShutdown(void);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread state                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the state block of the current thread.
+ *
+ * @param   state   Receives a pointer to the `ZyrexThreadState` struct of the current thread or
+ *                  `ZYAN_NULL`, if no state block has been assigned so far.
+ * @param   create  Signals, if a state block should be assigned in case the current thread does
+ *                  not own one yet.
+ *
+ * @return  A zyan status code.
+ *
+ * State blocks are taken from a lock-free pool and returned to it when the thread exits. New
+ * blocks are always zero-initialized. If `ZYREX_BARRIER_STATIC_TLS` is defined, the state block is
+ * stored in static TLS instead and only its trace ring buffer is released when the thread exits.
+ */
+ZyanStatus ZyrexThreadStateGet(ZyrexThreadState** state, ZyanBool create);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_THREADSTATE_H */
\ No newline at end of file
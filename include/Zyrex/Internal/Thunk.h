@@ -0,0 +1,100 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_INTERNAL_THUNK_H
+#define ZYREX_INTERNAL_THUNK_H
+
+#include <Zycore/Defines.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Transaction.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thunks                                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Generates a new thunk for the given `signature`.
+ *
+ * @param   address     The hooked address.
+ * @param   signature   A pointer to the `ZyrexThunkSignature` struct.
+ * @param   handler     The handler function.
+ * @param   user_data   The user data passed to the handler.
+ * @param   thunk       Receives the entry point of the thunk.
+ *
+ * @return  A zyan status code.
+ *
+ * The thunk does not have an original function until `ZyrexThunkSetOriginal` is called and must
+ * not be executed before.
+ *
+ * This function is not thread-safe and has to be called with the region lock held. The lock has
+ * to be kept until `ZyrexThunkSetOriginal` was called for the new thunk.
+ */
+ZyanStatus ZyrexThunkCreate(const void* address, const ZyrexThunkSignature* signature, 
+    ZyrexThunkHandler handler, void* user_data, const void** thunk);
+
+/**
+ * @brief   Sets the address the given `thunk` uses to call the original function.
+ *
+ * @param   thunk       The entry point of the thunk.
+ * @param   original    The address of the original function (usually the `code_buffer` of the 
+ *                      trampoline).
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexThunkSetOriginal(const void* thunk, const void* original);
+
+/**
+ * @brief   Releases the given `thunk`.
+ *
+ * @param   thunk       The entry point of the thunk.
+ * @param   is_attached `ZYAN_TRUE`, if the thunk might have been executed before.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if the thunk was released, `ZYAN_STATUS_NOT_FOUND`, if the
+ *          address is not a thunk or another zyan status code, if an error occured.
+ *
+ * Attached thunks that call the original function are marked as retired instead, as threads
+ * might still return into them. Their memory is never reused.
+ */
+ZyanStatus ZyrexThunkFree(const void* thunk, ZyanBool is_attached);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_INTERNAL_THUNK_H */
\ No newline at end of file
@@ -28,7 +28,9 @@
 #define ZYREX_INTERNAL_TRAMPOLINE_H
 
 #include <Zycore/Types.h>
+#include <Zycore/Vector.h>
 #include <Zyrex/Status.h>
+#include <Zyrex/Transaction.h>
 #include <Zyrex/Internal/Utils.h>
 
 #ifdef __cplusplus
@@ -78,15 +80,187 @@ extern "C" {
 #define ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT_BONUS \
     2
 
+/**
+ * @brief   Defines the size of the sampling stub of a trampoline.
+ */
+#define ZYREX_TRAMPOLINE_SAMPLING_STUB_SIZE \
+    28
+
+/**
+ * @brief   Defines the offset of the `pop [sampling_counter]` instruction inside the sampling 
+ *          stub of a trampoline.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_TRAMPOLINE_SAMPLING_STUB_POP_OFFSET \
+        16
+#else
+#   define ZYREX_TRAMPOLINE_SAMPLING_STUB_POP_OFFSET \
+        15
+#endif
+
+/**
+ * @brief   Defines the size and alignment of the executable code slot of a trampoline chunk.
+ */
+#define ZYREX_TRAMPOLINE_CODE_SLOT_SIZE \
+    64
+
 /**
  * @brief   Defines the trampoline region signature.
  */
 #define ZYREX_TRAMPOLINE_REGION_SIGNATURE   0x7A726578
 
+/**
+ * @brief   Defines the number of shards of the trampoline counters.
+ *
+ * Each thread updates the shard selected by its barrier data, which keeps concurrent updates by
+ * different threads on different cache lines.
+ */
+#define ZYREX_TRAMPOLINE_COUNTER_SHARDS     16
+
+/**
+ * @brief   Defines the size and alignment of a single trampoline counter shard.
+ */
+#define ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE 64
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline flags                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTrampolineFlags` data-type.
+ */
+typedef ZyanU32 ZyrexTrampolineFlags;
+
+/**
+ * @brief   No special flags.
+ */
+#define ZYREX_TRAMPOLINE_FLAG_NONE              0x00000000
+
+/**
+ * @brief   Redirects the trampoline to its callback using a callback stub, that is not shared
+ *          with other trampolines.
+ *
+ * The callback of such trampolines can be replaced at runtime using 
+ * `ZyrexTrampolineSetCallback`.
+ */
+#define ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK  0x00000001
+
+/**
+ * @brief   Allocates counters for the trampoline.
+ */
+#define ZYREX_TRAMPOLINE_FLAG_COUNTERS          0x00000002
+
+/**
+ * @brief   Signals, that the trampoline counters should accumulate the time spent inside the 
+ *          hook barrier (implies `ZYREX_TRAMPOLINE_FLAG_COUNTERS`).
+ */
+#define ZYREX_TRAMPOLINE_FLAG_MEASURE_CYCLES    0x00000004
+
+/**
+ * @brief   Redirects the trampoline to its callback using a sampling stub, which invokes the 
+ *          callback only once per sampling interval (implies 
+ *          `ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK`).
+ *
+ * The sampling counter is shared by all threads and decremented atomically by the stub. The 
+ * sampling interval can be changed at runtime using `ZyrexTrampolineSetSamplingInterval`.
+ */
+#define ZYREX_TRAMPOLINE_FLAG_SAMPLING          0x00000008
+
+/**
+ * @brief   Prepares the trampoline for a hot-patch style hook, if the hooked function is preceded
+ *          by at least `ZYREX_SIZEOF_RELATIVE_JUMP` bytes of `INT 3` or `NOP` padding.
+ *
+ * Hot-patch hooks place a relative jump into the padding and only overwrite the first
+ * `ZYREX_SIZEOF_SHORT_JUMP` bytes of the function with a short jump to it. The flag is silently
+ * ignored, if no suitable padding is found.
+ */
+#define ZYREX_TRAMPOLINE_FLAG_HOT_PATCH         0x00000010
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline counters                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTrampolineCounterShard` struct.
+ */
+typedef struct ZyrexTrampolineCounterShard_
+{
+    /**
+     * @brief   The number of successful barrier entries.
+     */
+    volatile ZyanU64 calls;
+    /**
+     * @brief   The number of barrier entries rejected due to the recursion depth.
+     */
+    volatile ZyanU64 rejections;
+    /**
+     * @brief   The accumulated number of time-stamp counter ticks spent inside the barrier.
+     */
+    volatile ZyanU64 cycles;
+    /**
+     * @brief   Pads the shard to a full cache line.
+     */
+    ZyanU8 padding[ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE - 3 * sizeof(ZyanU64)];
+} ZyrexTrampolineCounterShard;
+
+ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineCounterShard) == ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE);
+
+/**
+ * @brief   Defines the `ZyrexTrampolineCounters` struct.
+ *
+ * The counters are allocated on the heap, as the trampoline chunk itself is write-protected. The
+ * shards are aligned to `ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE` bytes.
+ */
+typedef struct ZyrexTrampolineCounters_
+{
+    /**
+     * @brief   The counter shards.
+     */
+    ZyrexTrampolineCounterShard shards[ZYREX_TRAMPOLINE_COUNTER_SHARDS];
+    /**
+     * @brief   Signals, if the time spent inside the barrier should be measured.
+     */
+    ZyanBool measure_cycles;
+    /**
+     * @brief   The unaligned address of the allocation.
+     */
+    void* allocation;
+} ZyrexTrampolineCounters;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline listeners                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTrampolineListener` struct.
+ *
+ * A listener is an additional callback that shares the trampoline of an existing hook. The 
+ * callback stub of the trampoline redirects to the first listener. Each listener continues the
+ * chain by jumping to its own private callback stub, which redirects to the next listener or to
+ * the callback of the trampoline.
+ */
+typedef struct ZyrexTrampolineListener_
+{
+    /**
+     * @brief   The address of the listener callback function.
+     */
+    ZyanUPointer callback_address;
+    /**
+     * @brief   A pointer to the private callback stub that continues the callback chain.
+     *
+     * This address is returned to the user instead of the `code_buffer` of the trampoline.
+     */
+    ZyanU8* callback_jump;
+    /**
+     * @brief   Signals, if the listener is currently linked into the callback chain.
+     */
+    ZyanBool is_linked;
+} ZyrexTrampolineListener;
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Translation map                                                                                */
 /* ---------------------------------------------------------------------------------------------- */
@@ -127,10 +301,6 @@ typedef struct ZyrexInstructionTranslationItem_
      *          buffer.
      */
     ZyanU8 offset_destination;
-    /**
-     * @brief   An absolute target address outside the destination buffer.
-     */
-    ZyanUPointer target_address;
 } ZyrexInstructionTranslationItem;
 
 /**
@@ -149,12 +319,50 @@ typedef struct ZyrexInstructionTranslationMap_
                                           ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT_BONUS];
 } ZyrexInstructionTranslationMap;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline code                                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexTrampolineCode` struct.
+ *
+ * This struct contains the executable code of a trampoline. Each instance occupies a 
+ * `ZYREX_TRAMPOLINE_CODE_SLOT_SIZE` aligned slot in the code area of a trampoline region. All
+ * remaining data is stored in the corresponding `ZyrexTrampolineChunk`, which lives in the 
+ * non-executable metadata area of the same region.
+ *
+ * On x64, the jump to the callback function is not part of the trampoline code, but lives in one
+ * of the callback stubs that are shared by all trampolines of the region with the same callback.
+ * Trampolines created with `ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK` use a callback stub of their 
+ * own on all architectures.
+ */
+typedef struct ZyrexTrampolineCode_
+{
+    /**
+     * @brief   The buffer that holds the trampoline code and the backjump to the hooked function.
+     */
+    ZyanU8 code_buffer[ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + 
+                       ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS];
+    /**
+     * @brief   The buffer that holds the sampling stub.
+     *
+     * The stub decrements the `sampling_counter` of the chunk and continues with the
+     * `code_buffer` until the counter reaches zero. It then resets the counter to the
+     * `sampling_interval` and jumps to the `callback_address`. No registers are modified.
+     */
+    ZyanU8 sampling_stub[ZYREX_TRAMPOLINE_SAMPLING_STUB_SIZE];
+} ZyrexTrampolineCode;
+
+ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineCode) <= ZYREX_TRAMPOLINE_CODE_SLOT_SIZE);
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Trampoline chunk                                                                               */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
  * @brief   Defines the `ZyrexTrampolineChunk` struct.
+ *
+ * The trampoline chunk contains the bookkeeping data of a trampoline and is never executed. 
  */
 typedef struct ZyrexTrampolineChunk_
 {
@@ -162,34 +370,80 @@ typedef struct ZyrexTrampolineChunk_
      * @brief   Signals, if the trampoline chunk is currently in use.
      */
     ZyanBool is_used;
+    /**
+     * @brief   The number of instruction bytes in the code buffer (not counting the backjump
+     *          instruction).
+     */
+    ZyanU8 code_buffer_size;
+    /**
+     * @brief   The number of instruction bytes saved from the hooked function.
+     */
+    ZyanU8 original_code_size;
+    /**
+     * @brief   The number of padding bytes in front of the hooked function used by the hot-patch
+     *          jump or `0`, if this is a regular trampoline.
+     */
+    ZyanU8 hot_patch_size;
+    /**
+     * @brief   The barrier slot reserved for this trampoline or `ZYREX_BARRIER_SLOT_INVALID`, if
+     *          none.
+     */
+    ZyanU32 barrier_slot;
     /**
      * @brief   The address of the callback function.
      */
     ZyanUPointer callback_address;
-
-#if defined(ZYAN_X64)
-
     /**
-     * @brief   The absolute jump to the callback function.
+     * @brief   A pointer to the callback stub, which performs an absolute jump to the 
+     *          `callback_address`.
+     *
+     * On x86, this value is `ZYAN_NULL` for trampolines without a private callback stub.
      */
-    ZyanU8 callback_jump[ZYREX_SIZEOF_ABSOLUTE_JUMP];
-
-#endif
+    ZyanU8* callback_jump;
+    /**
+     * @brief   Signals, if the callback stub currently bypasses the callback and jumps directly
+     *          to the `code_buffer`.
+     */
+    ZyanBool is_bypassed;
+    /**
+     * @brief   Signals, if the hook that created the trampoline was removed, while listeners 
+     *          were still linked.
+     *
+     * The callback of a detached trampoline is bypassed permanently. The trampoline is released
+     * together with its last listener.
+     */
+    ZyanBool is_detached;
+    /**
+     * @brief   The `ZyrexTrampolineListener` items of the callback chain in the order they are
+     *          invoked or `ZYAN_NULL`, if no listener was ever added.
+     *
+     * Listeners that are not linked yet or anymore are skipped by the chain.
+     */
+    ZyanVector* listeners;
+    /**
+     * @brief   A pointer to the counters of this trampoline or `ZYAN_NULL`, if the trampoline was
+     *          not created with `ZYREX_TRAMPOLINE_FLAG_COUNTERS`.
+     */
+    ZyrexTrampolineCounters* counters;
+    /**
+     * @brief   The number of remaining calls (by any thread) until the sampling stub invokes the
+     *          callback.
+     */
+    volatile ZyanIPointer sampling_counter;
+    /**
+     * @brief   The sampling interval or `0`, if the trampoline was not created with 
+     *          `ZYREX_TRAMPOLINE_FLAG_SAMPLING`.
+     */
+    volatile ZyanIPointer sampling_interval;
 
     /**
      * @brief   The backjump address.
      */
     ZyanUPointer backjump_address;
     /**
-     * @brief   The buffer that holds the trampoline code and the backjump to the hooked function.
+     * @brief   A pointer to the executable code of the trampoline.
      */
-    ZyanU8 code_buffer[ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + 
-                       ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS];
-    /**
-     * @brief   The number of instruction bytes in the code buffer (not counting the backjump
-     *          instruction).
-     */
-    ZyanU8 code_buffer_size;
+    ZyrexTrampolineCode* code;
     /**
      * @brief   The instruction translation map.
      */
@@ -199,9 +453,10 @@ typedef struct ZyrexTrampolineChunk_
      */
     ZyanU8 original_code[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
     /**
-     * @brief   The number of instruction bytes saved from the hooked function.
+     * @brief   The buffer that holds the original padding bytes in front of the hooked function,
+     *          if this is a hot-patch trampoline.
      */
-    ZyanU8 original_code_size;
+    ZyanU8 hot_patch_code[ZYREX_SIZEOF_RELATIVE_JUMP];
 } ZyrexTrampolineChunk;
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -224,12 +479,16 @@ typedef struct ZyrexTrampolineChunk_
  *                              instruction used for hooking).
  *                              This function might copy more bytes on demand to keep individual
  *                              instructions intact.
+ * @param   barrier_slot        The barrier slot to associate with the trampoline or
+ *                              `ZYREX_BARRIER_SLOT_INVALID`, if none.
+ * @param   flags               A combination of `ZYREX_TRAMPOLINE_FLAG_*` values.
  * @param   trampoline          Receives the newly created trampoline chunk.
  *
  * @return  A zyan status code.
  */
 ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
-    ZyanUSize min_bytes_to_reloc, ZyrexTrampolineChunk** trampoline);
+    ZyanUSize min_bytes_to_reloc, ZyanU32 barrier_slot, ZyrexTrampolineFlags flags, 
+    ZyrexTrampolineChunk** trampoline);
 
 /**
  * @brief   Destroys the given trampoline.
@@ -240,6 +499,35 @@ ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
  */
 ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline);
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Batching                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Starts a new trampoline batch.
+ *
+ * @return  A zyan status code.
+ *
+ * While a batch is active, `ZyrexTrampolineCreate` and `ZyrexTrampolineFree` reuse the most
+ * recently used trampoline-region and the most recently validated readable memory range of the
+ * target code. Code pages of the trampoline-regions are made writable only once and are not
+ * protected and flushed before the batch ends.
+ *
+ * Creating trampolines for targets sorted by address maximizes the benefit of batching.
+ */
+ZyanStatus ZyrexTrampolineBatchBegin(void);
+
+/**
+ * @brief   Ends the current trampoline batch.
+ *
+ * @return  A zyan status code.
+ *
+ * This function restores the memory protection of all code pages that were modified during the
+ * batch and flushes the instruction cache for these pages. The batch is always ended, even if an
+ * error occurs.
+ */
+ZyanStatus ZyrexTrampolineBatchEnd(void);
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Searching                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
@@ -255,6 +543,211 @@ ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline);
  */
 ZyanStatus ZyrexTrampolineFind(const void* original, ZyrexTrampolineChunk** trampoline);
 
+/**
+ * @brief   Defines the `ZyrexTrampolineEnumCallback` function prototype.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   context     The user-defined context.
+ *
+ * @return  `ZYAN_TRUE` to continue the enumeration or `ZYAN_FALSE` to stop it.
+ */
+typedef ZyanBool (*ZyrexTrampolineEnumCallback)(const ZyrexTrampolineChunk* trampoline, 
+    void* context);
+
+/**
+ * @brief   Invokes the given `callback` for every used trampoline chunk of all 
+ *          trampoline-regions.
+ *
+ * @param   callback    The callback function.
+ * @param   context     A user-defined context to pass to the `callback`.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexTrampolineEnumerate(ZyrexTrampolineEnumCallback callback, void* context);
+
+/**
+ * @brief   Returns statistics about all trampoline-regions.
+ *
+ * @param   statistics  Receives the trampoline statistics.
+ *
+ * @return  A zyan status code.
+ *
+ * This function only accesses the region headers.
+ */
+ZyanStatus ZyrexTrampolineGetStatistics(ZyrexTrampolineStatistics* statistics);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the `ZyrexTrampolineChunk` that belongs to the given `trampoline` code buffer.
+ *
+ * @param   trampoline  A pointer to the `code_buffer` of a trampoline.
+ *
+ * @return  A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * This function does not perform any checks. The `trampoline` has to be the exact value of the
+ * `code_buffer` address of a valid trampoline.
+ */
+ZyrexTrampolineChunk* ZyrexTrampolineGetChunk(const void* trampoline);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Callback                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the current destination of the given callback stub.
+ *
+ * @param   callback_jump   A pointer to a callback stub of a trampoline or listener.
+ *
+ * @return  The destination address of the callback stub.
+ */
+ZyanUPointer ZyrexTrampolineGetCallbackJumpDestination(const void* callback_jump);
+
+/**
+ * @brief   Atomically replaces the callback of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   callback    The address of the new callback function.
+ *
+ * @return  A zyan status code.
+ *
+ * Only trampolines created with `ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK` that are not detached
+ * are supported. The callback stub is not modified, so this function neither requires memory 
+ * protection changes nor instruction cache flushes.
+ */
+ZyanStatus ZyrexTrampolineSetCallback(ZyrexTrampolineChunk* trampoline, const void* callback);
+
+/**
+ * @brief   Enables or disables the bypass mode of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   bypass      Signals, if the callback should be bypassed.
+ *
+ * @return  A zyan status code.
+ *
+ * While the bypass mode is enabled, the callback stub jumps directly to the `code_buffer` of the
+ * trampoline, which continues execution of the original function. Only trampolines created with 
+ * `ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK` are supported. 
+ */
+ZyanStatus ZyrexTrampolineSetBypass(ZyrexTrampolineChunk* trampoline, ZyanBool bypass);
+
+/**
+ * @brief   Changes the sampling interval of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   interval    The new sampling interval. The callback is invoked once every `interval`
+ *                      calls. Must not be `0`.
+ *
+ * @return  A zyan status code.
+ *
+ * Only trampolines created with `ZYREX_TRAMPOLINE_FLAG_SAMPLING` are supported. The sampling
+ * counter is restarted with the new interval.
+ */
+ZyanStatus ZyrexTrampolineSetSamplingInterval(ZyrexTrampolineChunk* trampoline, 
+    ZyanU32 interval);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Listeners                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Searches for a trampoline of the hook at the given `address` that accepts listeners.
+ *
+ * @param   address     The address of the hooked function.
+ * @param   trampoline  Receives the trampoline chunk, if found.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if a trampoline was found, `ZYAN_STATUS_FALSE` if not or another
+ *          zyan status code if an error occured.
+ *
+ * Only trampolines with a private callback stub that are not detached accept listeners.
+ */
+ZyanStatus ZyrexTrampolineFindChain(const void* address, ZyrexTrampolineChunk** trampoline);
+
+/**
+ * @brief   Searches for the trampoline that owns the given `listener`.
+ *
+ * @param   listener    The listener address received from `ZyrexTrampolineListenerCreate`.
+ * @param   trampoline  Receives the trampoline chunk, if found.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the listener was found, `ZYAN_STATUS_FALSE` if not or another
+ *          zyan status code if an error occured.
+ */
+ZyanStatus ZyrexTrampolineListenerFind(const void* listener, ZyrexTrampolineChunk** trampoline);
+
+/**
+ * @brief   Creates a new listener for the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   callback    The address of the listener callback function.
+ * @param   listener    Receives the address the listener has to call to continue the callback
+ *                      chain.
+ *
+ * @return  A zyan status code.
+ *
+ * The listener is not linked into the callback chain before `ZyrexTrampolineListenerLink` is
+ * called. This function fails with `ZYAN_STATUS_OUT_OF_RESOURCES`, if the trampoline-region has
+ * no unused callback stub left.
+ */
+ZyanStatus ZyrexTrampolineListenerCreate(ZyrexTrampolineChunk* trampoline, const void* callback,
+    const void** listener);
+
+/**
+ * @brief   Links the given listener to the front of the callback chain.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   listener    The listener address.
+ *
+ * @return  A zyan status code.
+ *
+ * The listener is published using a single atomic pointer store.
+ */
+ZyanStatus ZyrexTrampolineListenerLink(ZyrexTrampolineChunk* trampoline, const void* listener);
+
+/**
+ * @brief   Unlinks the given listener from the callback chain.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   listener    The listener address.
+ *
+ * @return  A zyan status code.
+ *
+ * The predecessor of the listener is redirected to its successor using a single atomic pointer 
+ * store. Threads that already entered the listener are able to continue the chain, until the
+ * listener is released.
+ */
+ZyanStatus ZyrexTrampolineListenerUnlink(ZyrexTrampolineChunk* trampoline, const void* listener);
+
+/**
+ * @brief   Releases the given unlinked listener.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   listener    The listener address.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexTrampolineListenerFree(ZyrexTrampolineChunk* trampoline, const void* listener);
+
+/**
+ * @brief   Returns the number of linked listeners of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ *
+ * @return  The number of linked listeners.
+ */
+ZyanUSize ZyrexTrampolineGetListenerCount(const ZyrexTrampolineChunk* trampoline);
+
+/**
+ * @brief   Permanently bypasses the callback of the given trampoline, while keeping all of its
+ *          listeners linked.
+ *
+ * @param   trampoline  The trampoline chunk.
+ *
+ * @return  A zyan status code.
+ */
+ZyanStatus ZyrexTrampolineDetach(ZyrexTrampolineChunk* trampoline);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
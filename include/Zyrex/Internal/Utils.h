@@ -31,6 +31,10 @@
 #include <Zycore/Types.h>
 #include <Zydis/Zydis.h>
 
+#ifdef ZYAN_MSVC
+#   include <intrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -43,6 +47,11 @@ extern "C" {
 /* Constants                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
 
+/**
+ * @brief   The size of the short relative jump instruction (in bytes).
+ */
+#define ZYREX_SIZEOF_SHORT_JUMP         2
+
 /**
  * @brief   The size of the relative jump instruction (in bytes).
  */
@@ -84,6 +93,57 @@ ZYAN_INLINE ZyanI32 ZyrexCalculateRelativeOffset(ZyanU8 instruction_length,
     return (ZyanI32)(destination_address - source_address - instruction_length);    
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Bit manipulation                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the index of the least significant set bit in the given `value`.
+ *
+ * @param   value   The value. Must not be zero.
+ *
+ * @return  The index of the least significant set bit.
+ */
+ZYAN_INLINE ZyanU8 ZyrexBitScanForward64(ZyanU64 value)
+{
+    ZYAN_ASSERT(value);
+
+#if defined(ZYAN_MSVC)
+    unsigned long index;
+#   if defined(ZYAN_X64)
+    _BitScanForward64(&index, value);
+#   else
+    if (_BitScanForward(&index, (unsigned long)value))
+    {
+        return (ZyanU8)index;
+    }
+    _BitScanForward(&index, (unsigned long)(value >> 32));
+    index += 32;
+#   endif
+    return (ZyanU8)index;
+#else
+    return (ZyanU8)__builtin_ctzll(value);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Timing                                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Reads the processor time-stamp counter.
+ *
+ * @return  The current value of the time-stamp counter.
+ */
+ZYAN_INLINE ZyanU64 ZyrexReadTimestampCounter(void)
+{
+#if defined(ZYAN_MSVC)
+    return __rdtsc();
+#else
+    return __builtin_ia32_rdtsc();
+#endif
+}
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Jumps                                                                                          */
 /* ---------------------------------------------------------------------------------------------- */
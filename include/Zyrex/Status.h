@@ -61,6 +61,20 @@ extern "C" {
 #define ZYREX_STATUS_COULD_NOT_ALLOCATE_TRAMPOLINE \
     ZYAN_MAKE_STATUS(1, ZYAN_MODULE_ZYDIS, 0x00)
 
+/**
+ * @brief   A transaction failed after the target code was patched and the original code could
+ *          not be restored.
+ */
+#define ZYREX_STATUS_PARTIALLY_APPLIED \
+    ZYAN_MAKE_STATUS(1, ZYAN_MODULE_ZYREX, 0x01)
+
+/**
+ * @brief   The target code or pointer slot of an operation was modified after the operation was
+ *          added to the transaction.
+ */
+#define ZYREX_STATUS_TARGET_MODIFIED \
+    ZYAN_MAKE_STATUS(1, ZYAN_MODULE_ZYREX, 0x02)
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
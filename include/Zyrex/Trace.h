@@ -0,0 +1,286 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef ZYREX_TRACE_H
+#define ZYREX_TRACE_H
+
+#include <ZyrexExportConfig.h>
+#include <Zycore/Status.h>
+#include <Zycore/Types.h>
+#include <Zyrex/Transaction.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Constants                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   The maximum number of arguments that can be recorded for a single trace event.
+ */
+#define ZYREX_TRACE_MAX_ARGUMENTS       4
+
+/**
+ * @brief   The magic value of a trace batch (`ZRXT`).
+ */
+#define ZYREX_TRACE_BATCH_MAGIC         0x5458525A
+
+/**
+ * @brief   The current version of the trace batch format.
+ */
+#define ZYREX_TRACE_BATCH_VERSION       1
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexTraceEvent` struct.
+ */
+typedef struct ZyrexTraceEvent_
+{
+    /**
+     * @brief   The time-stamp counter value at the time the event was recorded.
+     */
+    ZyanU64 timestamp;
+    /**
+     * @brief   The function address (or any other user-defined identifier).
+     */
+    ZyanU64 function;
+    /**
+     * @brief   The recorded arguments.
+     */
+    ZyanU64 arguments[ZYREX_TRACE_MAX_ARGUMENTS];
+    /**
+     * @brief   The id of the thread that recorded the event.
+     */
+    ZyanU32 thread_id;
+    /**
+     * @brief   The number of valid elements in the `arguments` array.
+     */
+    ZyanU8 argument_count;
+} ZyrexTraceEvent;
+
+/**
+ * @brief   Defines the `ZyrexTraceBatchHeader` struct.
+ *
+ * Every batch starts with this header, followed by `event_count` encoded events. Each event is
+ * stored as a sequence of LEB128 encoded values:
+ * - The thread id
+ * - The zigzag encoded difference to the timestamp of the previous event (or to the 
+ *   `base_timestamp` for the first event of the batch)
+ * - The function
+ * - The argument count (a single byte) followed by the arguments
+ *
+ * Use `ZyrexTraceDecodeBatch` to decode the events of a batch.
+ */
+typedef struct ZyrexTraceBatchHeader_
+{
+    /**
+     * @brief   The magic value (`ZYREX_TRACE_BATCH_MAGIC`).
+     */
+    ZyanU32 magic;
+    /**
+     * @brief   The format version (`ZYREX_TRACE_BATCH_VERSION`).
+     */
+    ZyanU16 version;
+    /**
+     * @brief   Reserved for future use.
+     */
+    ZyanU16 reserved;
+    /**
+     * @brief   The number of events in the batch.
+     */
+    ZyanU32 event_count;
+    /**
+     * @brief   The number of events that were dropped since the previous batch (because the 
+     *          ring buffer of the recording thread was full).
+     */
+    ZyanU32 dropped_count;
+    /**
+     * @brief   The base time-stamp counter value.
+     */
+    ZyanU64 base_timestamp;
+} ZyrexTraceBatchHeader;
+
+/**
+ * @brief   Defines the `ZyrexTraceBatchCallback` function prototype.
+ *
+ * @param   batch       A pointer to the encoded batch (starting with a `ZyrexTraceBatchHeader`).
+ * @param   size        The size of the batch (in bytes).
+ * @param   user_data   The user data passed to `ZyrexTraceDrain`.
+ *
+ * The batch memory is only valid for the duration of the callback.
+ */
+typedef void (*ZyrexTraceBatchCallback)(const void* batch, ZyanUSize size, void* user_data);
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Initializes the trace system.
+ *
+ * @param   capacity    The number of events each per-thread ring buffer can hold. Must be a power
+ *                      of two.
+ *
+ * @return  A zyan status code.
+ *
+ * The barrier system (`ZyrexBarrierSystemInitialize`) has to be initialized before.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceInitialize(ZyanUSize capacity);
+
+/**
+ * @brief   Finalizes the trace system.
+ *
+ * @return  A zyan status code.
+ *
+ * All ring buffers are released by this function. Callers have to make sure that no hook is
+ * still recording events. Pending events are discarded.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceShutdown(void);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Recording                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Records a new trace event in the ring buffer of the current thread.
+ *
+ * @param   function        The function address (or any other user-defined identifier).
+ * @param   arguments       A pointer to the arguments. Might be `ZYAN_NULL`, if `argument_count`
+ *                          is `0`.
+ * @param   argument_count  The number of arguments. Additional arguments beyond
+ *                          `ZYREX_TRACE_MAX_ARGUMENTS` are ignored.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if the event was recorded, `ZYAN_STATUS_FALSE` if the event was
+ *          dropped, or a generic zyan status code if an error occured.
+ *
+ * Events are dropped, if the ring buffer is full or if the current thread is draining events. The
+ * function never blocks and never allocates heap memory. The ring buffer of a thread is created
+ * directly from the operating system the first time the thread records an event.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceRecord(ZyanU64 function, const ZyanU64* arguments, 
+    ZyanU8 argument_count);
+
+/**
+ * @brief   A thunk handler that records a trace event for every call of the hooked function.
+ *
+ * @param   context A pointer to the `ZyrexThunkContext` struct of the current call.
+ * @param   event   The `ZyrexThunkEvent` that caused the invocation.
+ *
+ * Pass this function to `ZyrexInstallThunkHook` to trace a function without writing a callback.
+ * The event records the hooked address and the first `ZYREX_TRACE_MAX_ARGUMENTS` integer 
+ * argument registers.
+ */
+ZYREX_EXPORT void ZyrexTraceThunkHandler(ZyrexThunkContext* context, ZyrexThunkEvent event);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Draining                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Drains the ring buffers of all threads.
+ *
+ * @param   callback    The callback that receives the encoded batches.
+ * @param   user_data   The user data passed to the callback.
+ * @param   count       Receives the number of drained events. Might be `ZYAN_NULL`.
+ *
+ * @return  A zyan status code.
+ *
+ * The current thread is excluded from tracing while draining. All barriers (including the ones
+ * entered by hooks) fail to enter during this time, which prevents the callback from triggering
+ * any hooks itself.
+ *
+ * Concurrent calls are serialized. The callback must not call this function itself.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceDrain(ZyrexTraceBatchCallback callback, void* user_data, 
+    ZyanUSize* count);
+
+/**
+ * @brief   Starts a background thread that periodically drains the ring buffers of all threads.
+ *
+ * @param   callback    The callback that receives the encoded batches.
+ * @param   user_data   The user data passed to the callback.
+ * @param   interval    The drain interval (in milliseconds).
+ *
+ * @return  A zyan status code.
+ *
+ * The drain thread is permanently excluded from tracing (see `ZyrexTraceDrain`).
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceStartDrainThread(ZyrexTraceBatchCallback callback, 
+    void* user_data, ZyanU32 interval);
+
+/**
+ * @brief   Stops the background drain thread.
+ *
+ * @return  A zyan status code.
+ *
+ * This function waits for the drain thread to perform a final drain and exit.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceStopDrainThread(void);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Decoding                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Decodes the events of the given trace batch.
+ *
+ * @param   batch   A pointer to the encoded batch.
+ * @param   size    The size of the batch (in bytes).
+ * @param   events  A pointer to the buffer that receives the decoded events.
+ * @param   count   The capacity of the `events` buffer. Receives the number of decoded events.
+ *
+ * @return  A zyan status code.
+ *
+ * `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE` is returned, if the `events` buffer can not hold all
+ * events of the batch. In this case `count` receives the required capacity.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTraceDecodeBatch(const void* batch, ZyanUSize size, 
+    ZyrexTraceEvent* events, ZyanUSize* count);
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZYREX_TRACE_H */
\ No newline at end of file
@@ -31,6 +31,7 @@
 #include <Zycore/Status.h>
 #include <Zycore/API/Thread.h>
 #include <ZyrexExportConfig.h>
+#include <Zyrex/Status.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -74,7 +75,21 @@ typedef enum ZyrexHookType_
      *
      * This hook 
      */
-    ZYREX_HOOK_TYPE_CONTEXT
+    ZYREX_HOOK_TYPE_CONTEXT,
+    /**
+     * @brief   Import address table hook.
+     *
+     * The IAT hook replaces the import address table entry of an imported function in a specific
+     * module with the address of the callback function.
+     */
+    ZYREX_HOOK_TYPE_IAT,
+    /**
+     * @brief   VTable hook.
+     *
+     * The VTable hook replaces an entry of a virtual function table with the address of the 
+     * callback function.
+     */
+    ZYREX_HOOK_TYPE_VTABLE
 } ZyrexHookType;
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -100,6 +115,446 @@ typedef struct ZyrexHook_
 
 } ZyrexHook;
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Inline hook flags                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexInlineHookFlags` data-type.
+ */
+typedef ZyanU32 ZyrexInlineHookFlags;
+
+/**
+ * @brief   No special flags.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_NONE                 0x00000000
+
+/**
+ * @brief   Reserves a dense barrier slot for the hook.
+ *
+ * Use `ZyrexBarrierGetIndexedHandle` to obtain an indexed barrier handle for hooks installed with
+ * this flag. Indexed handles allow the barrier API to access the per-thread recursion counter of
+ * the hook in constant time.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_RESERVE_BARRIER_SLOT 0x00000001
+
+/**
+ * @brief   Allows the callback of the hook to be replaced at runtime.
+ *
+ * Hooks installed with this flag redirect to their callback using an indirect jump through a 
+ * pointer that is not shared with other hooks. Use `ZyrexSetInlineHookCallback` to replace the
+ * callback and `ZyrexSetInlineHookEnabled` to temporarily bypass it without starting a
+ * transaction.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK     0x00000002
+
+/**
+ * @brief   Enables call counters for the hook (implies 
+ *          `ZYREX_INLINE_HOOK_FLAG_RESERVE_BARRIER_SLOT`).
+ *
+ * The counters are updated by `ZyrexBarrierTryEnterEx` and `ZyrexBarrierLeave`, if the callback
+ * uses the indexed barrier handle of the hook. Use `ZyrexGetInlineHookCounters` or 
+ * `ZyrexGetAllInlineHookCounters` to read the counters.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_COUNTERS             0x00000004
+
+/**
+ * @brief   Additionally accumulates the time-stamp counter ticks spent between the outermost 
+ *          barrier entry and the matching barrier leave (implies 
+ *          `ZYREX_INLINE_HOOK_FLAG_COUNTERS`).
+ */
+#define ZYREX_INLINE_HOOK_FLAG_MEASURE_CYCLES       0x00000008
+
+/**
+ * @brief   Invokes the callback of the hook only once every N calls (implies 
+ *          `ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK`).
+ *
+ * All other calls continue directly with the original function without ever entering the 
+ * callback. The interval defaults to `1` and can be changed at any time using 
+ * `ZyrexSetInlineHookSamplingInterval`.
+ *
+ * Calls are counted per hook, not per thread. All threads share a single counter, which is
+ * decremented atomically, so a hook that is called by many threads at the same time keeps the
+ * cache line of the counter busy.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_SAMPLING             0x00000010
+
+/**
+ * @brief   Installs the hook as a hot-patch hook, if possible.
+ *
+ * If the hooked function is preceded by at least 5 bytes of `INT 3` or `NOP` padding (e.g. 
+ * functions compiled with the MSVC `/hotpatch` and `/FUNCTIONPADMIN` options), a relative jump
+ * is written to the padding and only the first 2 bytes of the function are replaced by a short
+ * jump to it. This reduces the number of instructions that have to be relocated to the 
+ * trampoline. Falls back to a regular hook, if no suitable padding is found.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_HOT_PATCH            0x00000020
+
+/**
+ * @brief   Joins the callback chain of an existing hook at the same address instead of stacking
+ *          another trampoline on top of it (implies `ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK`).
+ *
+ * If the address is already hooked by a hook with a dynamic callback, the new callback is added
+ * as a listener to the front of its callback chain. All listeners share the relocated prologue
+ * of the existing hook and each is linked or unlinked using a single atomic pointer store. The 
+ * trampoline address received by a listener continues with the next callback of the chain.
+ *
+ * Otherwise, a regular hook with a dynamic callback is installed, so that later hooks with this
+ * flag are able to join its chain. Hooks that combine this flag with any other flag except
+ * `ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK` never join an existing chain.
+ *
+ * Listeners are removed using `ZyrexRemoveInlineHook`. They can not be used with any of the hook
+ * modification and counter functions. Removing the hook that owns the chain while listeners are
+ * still linked permanently bypasses its callback. Its trampoline stays alive, until the last 
+ * listener is removed.
+ */
+#define ZYREX_INLINE_HOOK_FLAG_CHAIN                0x00000040
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Inline hook entry                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexInlineHookEntry` struct.
+ *
+ * This struct describes a single inline hook to install with `ZyrexInstallInlineHooks`.
+ */
+typedef struct ZyrexInlineHookEntry_
+{
+    /**
+     * @brief   The address to hook.
+     */
+    void* address;
+    /**
+     * @brief   The callback address.
+     */
+    const void* callback;
+    /**
+     * @brief   A combination of `ZYREX_INLINE_HOOK_FLAG_*` values.
+     */
+    ZyrexInlineHookFlags flags;
+    /**
+     * @brief   Receives the address of the trampoline to the original function, if the
+     *          operation succeeded.
+     */
+    ZyanConstVoidPointer* trampoline;
+    /**
+     * @brief   Receives the status code of the operation.
+     */
+    ZyanStatus status;
+} ZyrexInlineHookEntry;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Remote inline hook entry                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexRemoteInlineHookEntry` struct.
+ *
+ * This struct describes a single inline hook to install in another process with 
+ * `ZyrexInstallRemoteInlineHooks`. All addresses refer to the address space of the target process.
+ */
+typedef struct ZyrexRemoteInlineHookEntry_
+{
+    /**
+     * @brief   The address to hook.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The callback address.
+     */
+    ZyanUPointer callback;
+    /**
+     * @brief   The address of a pointer variable that receives the address of the trampoline,
+     *          before the hook gets activated, or `0`.
+     */
+    ZyanUPointer trampoline_slot;
+    /**
+     * @brief   Receives the address of the trampoline to the original function, if the
+     *          operation succeeded.
+     */
+    ZyanUPointer trampoline;
+    /**
+     * @brief   Receives the status code of the operation.
+     */
+    ZyanStatus status;
+} ZyrexRemoteInlineHookEntry;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Inline hook counters                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexInlineHookCounters` struct.
+ *
+ * This struct receives a snapshot of the counters of a hook installed with the
+ * `ZYREX_INLINE_HOOK_FLAG_COUNTERS` flag.
+ */
+typedef struct ZyrexInlineHookCounters_
+{
+    /**
+     * @brief   The hooked address.
+     */
+    const void* address;
+    /**
+     * @brief   The trampoline address of the hook.
+     */
+    ZyanConstVoidPointer trampoline;
+    /**
+     * @brief   The number of successful barrier entries.
+     */
+    ZyanU64 calls;
+    /**
+     * @brief   The number of barrier entries rejected due to the recursion depth.
+     */
+    ZyanU64 rejections;
+    /**
+     * @brief   The accumulated number of time-stamp counter ticks spent inside the barrier or `0`,
+     *          if the hook was not installed with `ZYREX_INLINE_HOOK_FLAG_MEASURE_CYCLES`.
+     */
+    ZyanU64 cycles;
+} ZyrexInlineHookCounters;
+
+/**
+ * @brief   Defines the `ZyrexTrampolineStatistics` struct.
+ *
+ * This struct receives a snapshot of the memory used by the trampoline-regions of all inline 
+ * hooks.
+ */
+typedef struct ZyrexTrampolineStatistics_
+{
+    /**
+     * @brief   The number of allocated trampoline-regions.
+     */
+    ZyanUSize region_count;
+    /**
+     * @brief   The number of trampoline-regions with at most a quarter of their chunks in use.
+     */
+    ZyanUSize sparse_region_count;
+    /**
+     * @brief   The total number of trampoline-chunks of all regions.
+     */
+    ZyanUSize chunk_count;
+    /**
+     * @brief   The number of used trampoline-chunks.
+     */
+    ZyanUSize used_chunk_count;
+    /**
+     * @brief   The total size of the reserved address space (in bytes).
+     */
+    ZyanUSize reserved_size;
+    /**
+     * @brief   The total size of the committed memory (in bytes).
+     */
+    ZyanUSize committed_size;
+} ZyrexTrampolineStatistics;
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thunk hooks                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   The number of integer argument registers saved by thunk hooks.
+ *
+ * The registers are `RCX`, `RDX`, `R8` and `R9` on Windows x64, `RDI`, `RSI`, `RDX`, `RCX`, `R8`
+ * and `R9` on System V x64, and `ECX` and `EDX` (`fastcall` and `thiscall`) on x86.
+ */
+#if   defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+#   define ZYREX_THUNK_REGISTER_ARGUMENTS       4
+#elif defined(ZYAN_X64)
+#   define ZYREX_THUNK_REGISTER_ARGUMENTS       6
+#else
+#   define ZYREX_THUNK_REGISTER_ARGUMENTS       2
+#endif
+
+/**
+ * @brief   The number of vector argument registers saved by thunk hooks installed with the
+ *          `ZYREX_THUNK_FLAG_FLOAT_ARGUMENTS` flag.
+ *
+ * The registers are `XMM0` to `XMM3` on Windows x64 and `XMM0` to `XMM7` on System V x64. 
+ * Floating-point arguments are always passed on the stack on x86.
+ */
+#if   defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+#   define ZYREX_THUNK_FLOAT_ARGUMENTS          4
+#elif defined(ZYAN_X64)
+#   define ZYREX_THUNK_FLOAT_ARGUMENTS          8
+#else
+#   define ZYREX_THUNK_FLOAT_ARGUMENTS          0
+#endif
+
+/**
+ * @brief   The maximum number of stack arguments copied by thunk hooks installed with the 
+ *          `ZYREX_THUNK_FLAG_POST` flag.
+ */
+#define ZYREX_THUNK_MAX_STACK_ARGUMENTS     64
+
+/**
+ * @brief   Defines the `ZyrexThunkFlags` data-type.
+ */
+typedef ZyanU32 ZyrexThunkFlags;
+
+/**
+ * @brief   No special flags.
+ *
+ * The thunk only invokes the handler before the original function is called and then jumps to
+ * the original function with the (possibly modified) register arguments.
+ */
+#define ZYREX_THUNK_FLAG_NONE               0x00000000
+
+/**
+ * @brief   Additionally invokes the handler after the original function returned.
+ *
+ * The thunk calls the original function itself, which requires it to copy the stack arguments.
+ * Their number has to be passed in the `stack_argument_count` field of the `ZyrexThunkSignature`.
+ */
+#define ZYREX_THUNK_FLAG_POST               0x00000001
+
+/**
+ * @brief   Saves and restores the vector argument registers.
+ *
+ * Without this flag, the vector registers are not touched by the thunk at all. The handler must
+ * not modify them in this case, as they might still contain arguments of the original function.
+ */
+#define ZYREX_THUNK_FLAG_FLOAT_ARGUMENTS    0x00000002
+
+/**
+ * @brief   Saves and restores the floating-point return value (`XMM0` on x64 or `ST(0)` on x86)
+ *          around the post handler (requires `ZYREX_THUNK_FLAG_POST`).
+ */
+#define ZYREX_THUNK_FLAG_FLOAT_RESULT       0x00000004
+
+/**
+ * @brief   Declares that the original function removes its stack arguments from the stack 
+ *          (`stdcall`, `fastcall` and `thiscall`).
+ *
+ * Only relevant for x86 thunks installed with the `ZYREX_THUNK_FLAG_POST` flag, which have to
+ * return to the caller in the same way. This flag is ignored on x64.
+ */
+#define ZYREX_THUNK_FLAG_CALLEE_CLEANUP     0x00000008
+
+/**
+ * @brief   Defines the `ZyrexThunkSignature` struct.
+ *
+ * This struct describes the parts of the signature of the hooked function that affect the code 
+ * generated for the thunk.
+ */
+typedef struct ZyrexThunkSignature_
+{
+    /**
+     * @brief   A combination of `ZYREX_THUNK_FLAG_*` values.
+     */
+    ZyrexThunkFlags flags;
+    /**
+     * @brief   The number of pointer-sized stack arguments, that have to be copied when calling 
+     *          the original function from a post thunk.
+     *
+     * Must not exceed `ZYREX_THUNK_MAX_STACK_ARGUMENTS`. On Windows x64, the stack arguments start
+     * after the 32 byte shadow space.
+     */
+    ZyanU8 stack_argument_count;
+} ZyrexThunkSignature;
+
+/**
+ * @brief   Defines the `ZyrexThunkEvent` enum.
+ */
+typedef enum ZyrexThunkEvent_
+{
+    /**
+     * @brief   The original function is about to be called.
+     */
+    ZYREX_THUNK_EVENT_PRE,
+    /**
+     * @brief   The original function returned.
+     */
+    ZYREX_THUNK_EVENT_POST
+} ZyrexThunkEvent;
+
+/**
+ * @brief   Defines the `ZyrexThunkVector` struct.
+ */
+typedef struct ZyrexThunkVector_
+{
+    /**
+     * @brief   The 128 bit value of the vector register.
+     */
+    ZyanU64 value[2];
+} ZyrexThunkVector;
+
+/**
+ * @brief   Defines the `ZyrexThunkContext` struct.
+ *
+ * The context is passed to the handler of a thunk hook. Changes to the `arguments` (and the 
+ * `float_arguments`, if saved) during the pre event are passed to the original function. Changes 
+ * to the `return_value` (and the `float_return_value`, if saved) during the post event are 
+ * returned to the caller.
+ */
+typedef struct ZyrexThunkContext_
+{
+    /**
+     * @brief   The user data of the hook.
+     */
+    void* user_data;
+    /**
+     * @brief   The hooked address.
+     */
+    const void* address;
+    /**
+     * @brief   A pointer to the return address of the call. The stack arguments directly follow 
+     *          the return address (and the shadow space on Windows x64).
+     */
+    ZyanUPointer* stack;
+    /**
+     * @brief   The integer argument registers.
+     */
+    ZyanUPointer arguments[ZYREX_THUNK_REGISTER_ARGUMENTS];
+    /**
+     * @brief   The integer return value registers (`RAX` and `RDX`, or `EAX` and `EDX`).
+     *
+     * Only valid during the post event. On System V x64, the first element contains the value of
+     * `RAX` (the number of vector registers used by variadic functions) during the pre event.
+     */
+    ZyanUPointer return_value[2];
+#if ZYREX_THUNK_FLOAT_ARGUMENTS
+    /**
+     * @brief   The vector argument registers.
+     *
+     * Only valid for thunks installed with the `ZYREX_THUNK_FLAG_FLOAT_ARGUMENTS` flag.
+     */
+    ZyrexThunkVector float_arguments[ZYREX_THUNK_FLOAT_ARGUMENTS];
+#endif
+    /**
+     * @brief   The floating-point return value (on x86, the first element contains `ST(0)` as a
+     *          `double`).
+     *
+     * Only valid during the post event of thunks installed with the 
+     * `ZYREX_THUNK_FLAG_FLOAT_RESULT` flag.
+     */
+    ZyrexThunkVector float_return_value;
+} ZyrexThunkContext;
+
+/**
+ * @brief   Defines the `ZyrexThunkHandler` function prototype.
+ *
+ * @param   context A pointer to the `ZyrexThunkContext` struct of the current call.
+ * @param   event   The `ZyrexThunkEvent` that caused the invocation.
+ *
+ * A single handler can be shared by any number of thunk hooks. The handler is called on the
+ * stack of the hooked function and may use the barrier API to guard against recursion.
+ */
+typedef void (*ZyrexThunkHandler)(ZyrexThunkContext* context, ZyrexThunkEvent event);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction object                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the opaque `ZyrexTransaction` struct.
+ *
+ * Transaction objects are created by `ZyrexTransactionBeginEx` and are independent of the global
+ * transaction that is started by `ZyrexTransactionBegin`.
+ */
+typedef struct ZyrexTransaction_ ZyrexTransaction;
+
 /* ---------------------------------------------------------------------------------------------- */
 /* Hook operation                                                                                 */
 /* ---------------------------------------------------------------------------------------------- */
@@ -120,6 +575,11 @@ typedef struct ZyrexHook_
  * @brief   Starts a new transaction.
  *
  * @return  A zyan status code.
+ *
+ * Only one global transaction can be active at a time. It is bound to the calling thread and 
+ * suspends threads immediately, so it holds the transaction locks until it is committed or
+ * cancelled. Transaction objects created by `ZyrexTransactionBeginEx` are unable to prepare or 
+ * commit hooks during that time.
  */
 ZYREX_EXPORT ZyanStatus ZyrexTransactionBegin();
 
@@ -129,11 +589,12 @@ ZYREX_EXPORT ZyanStatus ZyrexTransactionBegin();
  * The given thread is immediately suspended and later on resumed after the transaction was either
  * been committed or canceled.
  *
- * @param   thread_id   The id of the thread to add to the update list.
+ * @param   thread_id   The id of the thread to add to the update list. On Linux, this is the
+ *                      kernel thread id as returned by `gettid`.
  *
  * @return  A zyan status code.
  */
-ZYREX_EXPORT ZyanStatus ZyrexUpdateThread(DWORD thread_id);
+ZYREX_EXPORT ZyanStatus ZyrexUpdateThread(ZyanThreadId thread_id);
 
 /**
  * @brief   Adds all threads (except the calling one) to the update list.
@@ -141,6 +602,10 @@ ZYREX_EXPORT ZyanStatus ZyrexUpdateThread(DWORD thread_id);
  * All threads are immediately suspended and later on resumed after the transaction was either
  * been committed or canceled.
  *
+ * Only threads of the current process are enumerated. Each thread is suspended as soon as it is
+ * discovered and the enumeration is repeated until no new threads show up. Threads that are
+ * already contained in the update list are skipped.
+ *
  * @return  A zyan status code.
  */
 ZYREX_EXPORT ZyanStatus ZyrexUpdateAllThreads();
@@ -151,6 +616,16 @@ ZYREX_EXPORT ZyanStatus ZyrexUpdateAllThreads();
  * This function performs the pending hook attach/remove operations and updates all threads in the
  * thread-update list.
  *
+ * All code patches are applied in a single batch. Each affected page is unprotected and restored 
+ * only once and the instruction cache is flushed once for every contiguous range of pages.
+ *
+ * Afterwards, the context of every thread in the thread-update list is read once. Threads whose
+ * instruction pointer is located inside of patched code are migrated using the instruction
+ * translation map of the corresponding trampoline. All threads are resumed right after.
+ *
+ * If the function fails, the transaction stays active and has to be cancelled by calling
+ * `ZyrexTransactionAbort`.
+ *
  * @return  A zyan status code.
  */
 ZYREX_EXPORT ZyanStatus ZyrexTransactionCommit();
@@ -158,9 +633,18 @@ ZYREX_EXPORT ZyanStatus ZyrexTransactionCommit();
 /**
  * @brief   Commits the current transaction.
  *
- * @param   failed_operation    Receives a pointer to the operation that failed the transaction.
+ * @param   failed_operation    Receives the target address of the operation that failed the
+ *                              transaction.
  *
  * @return  A zyan status code.
+ *
+ * If the function fails after the target code was patched, all patches are reverted using an 
+ * undo log of the original code bytes. `ZYREX_STATUS_PARTIALLY_APPLIED` is returned, if the 
+ * original code could not be restored. The trampolines of the pending hooks are never released in 
+ * this case and the transaction can only be aborted.
+ *
+ * `ZYREX_STATUS_TARGET_MODIFIED` is returned without patching any code, if the target of a hook
+ * installation was modified by someone else after the hook was added to the transaction.
  */
 ZYREX_EXPORT ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation);
 
@@ -172,60 +656,692 @@ ZYREX_EXPORT ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation);
 ZYREX_EXPORT ZyanStatus ZyrexTransactionAbort();
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Hook installation                                                                              */
+/* Transaction objects                                                                            */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Installs an inline hook at the given `address`.
+ * @brief   Starts a new transaction object.
+ *
+ * @param   transaction Receives the new transaction object.
  *
+ * @return  A zyan status code.
+ *
+ * Multiple transaction objects can be prepared concurrently by different threads. Trampoline
+ * creation and relocation only briefly lock the shared trampoline-region bookkeeping for each
+ * hook. Threads are not suspended before `ZyrexTransactionSubmit`, which serializes the final 
+ * thread suspension, code patching and thread migration with all other transactions.
+ *
+ * Concurrent transactions must operate on disjoint sets of hooks. A single transaction object
+ * must not be used by multiple threads at the same time.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionBeginEx(ZyrexTransaction** transaction);
+
+/**
+ * @brief   Adds a specific thread to the thread-update list of the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   thread_id   The id of the thread to add to the update list. On Linux, this is the
+ *                      kernel thread id as returned by `gettid`.
+ *
+ * @return  A zyan status code.
+ *
+ * The thread is suspended by `ZyrexTransactionSubmit`. Threads that exited in the meantime are
+ * skipped.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionUpdateThread(ZyrexTransaction* transaction, 
+    ZyanThreadId thread_id);
+
+/**
+ * @brief   Adds all threads (except the submitting one) to the update list of the given 
+ *          transaction object.
+ *
+ * @param   transaction The transaction object.
+ *
+ * @return  A zyan status code.
+ *
+ * The threads are enumerated and suspended by `ZyrexTransactionSubmit`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionUpdateAllThreads(ZyrexTransaction* transaction);
+
+/**
+ * @brief   Adds an inline hook installation to the given transaction object.
+ *
+ * @param   transaction The transaction object.
  * @param   address     The address to hook.
  * @param   callback    The callback address.
+ * @param   flags       A combination of `ZYREX_INLINE_HOOK_FLAG_*` values.
  * @param   trampoline  Receives the address of the trampoline to the original function, if the
  *                      operation succeeded.
  *
- * @return  A zyan status code.                                                                  
+ * @return  A zyan status code.
  */
-ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback, 
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallInlineHook(ZyrexTransaction* transaction, 
+    void* address, const void* callback, ZyrexInlineHookFlags flags, 
     ZyanConstVoidPointer* trampoline);
 
-///**
-// * @brief   Attaches an exception hook.
-// *
-// * @param   address     Pointer to the code address. Receives the trampoline address, if the
-// *                      transaction succeeded.
-// * @param   callback    The callback address.
-// *
-// * @return  A zyan status code.
-// */
-//ZYREX_EXPORT ZyanStatus ZyrexAttachExceptionHook(const void** address, const void* callback);
-//
-///**
-// * @brief   Attaches a context hook.
-// *
-// * @param   address     Pointer to the code address. Receives the trampoline address, if the
-// *                      transaction succeeded.
-// * @param   callback    The callback address.
-// *
-// * @return  A zyan status code.
-// */
-//ZYREX_EXPORT ZyanStatus ZyrexAttachContextHook(const void** address, const void* callback);
-
-// TODO: IAT/EAT, VTable, ..
-
-/* ---------------------------------------------------------------------------------------------- */
-/* Hook removal                                                                                   */
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Removes an inline hook at the given `address`.
+ * @brief   Adds multiple inline hook installations to the given transaction object.
  *
- * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
- *                      Receives the address of the original function after removing the hook.
+ * @param   transaction The transaction object.
+ * @param   entries     The inline hook entries.
+ * @param   count       The number of entries.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all hooks were installed, the status code of the first
+ *          failed entry (in array order), or a generic zyan status code if the batch could not be
+ *          started.
+ *
+ * See `ZyrexInstallInlineHooks` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallInlineHooks(ZyrexTransaction* transaction,
+    ZyrexInlineHookEntry* entries, ZyanUSize count);
+
+/**
+ * @brief   Adds a thunk hook installation to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   address     The address to hook.
+ * @param   signature   A pointer to the `ZyrexThunkSignature` struct.
+ * @param   handler     The handler function.
+ * @param   user_data   The user data passed to the handler.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * See `ZyrexInstallThunkHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallThunkHook(ZyrexTransaction* transaction, 
+    void* address, const ZyrexThunkSignature* signature, ZyrexThunkHandler handler, 
+    void* user_data, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds an inline hook removal to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionRemoveInlineHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds an exception hook installation to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * See `ZyrexInstallExceptionHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallExceptionHook(ZyrexTransaction* transaction, 
+    void* address, const void* callback, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds a context hook installation to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * See `ZyrexInstallContextHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallContextHook(ZyrexTransaction* transaction, 
+    void* address, const void* callback, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds an exception hook removal to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionRemoveExceptionHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds a context hook removal to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionRemoveContextHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Adds an import address table hook installation to the given transaction object.
+ *
+ * @param   transaction     The transaction object.
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL` to match any module.
+ * @param   import_name     The name of the imported function or an ordinal value.
+ * @param   callback        The callback address.
+ * @param   original        Receives the original address of the imported function, if the
+ *                          operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * See `ZyrexInstallIatHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallIatHook(ZyrexTransaction* transaction, 
+    const void* module, const char* import_module, const char* import_name, 
+    const void* callback, ZyanConstVoidPointer* original);
+
+/**
+ * @brief   Adds a VTable hook installation to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   vtable      The address of the virtual function table.
+ * @param   index       The index of the entry to hook.
+ * @param   callback    The callback address.
+ * @param   original    Receives the original address of the virtual function, if the operation
+ *                      succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * See `ZyrexInstallVTableHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionInstallVTableHook(ZyrexTransaction* transaction, 
+    void* vtable, ZyanUSize index, const void* callback, ZyanConstVoidPointer* original);
+
+/**
+ * @brief   Adds an import address table hook removal to the given transaction object.
+ *
+ * @param   transaction     The transaction object.
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL` to match any module.
+ * @param   import_name     The name of the imported function or an ordinal value.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionRemoveIatHook(ZyrexTransaction* transaction, 
+    const void* module, const char* import_module, const char* import_name);
+
+/**
+ * @brief   Adds a VTable hook removal to the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ * @param   vtable      The address of the virtual function table.
+ * @param   index       The index of the hooked entry.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionRemoveVTableHook(ZyrexTransaction* transaction, 
+    void* vtable, ZyanUSize index);
+
+/**
+ * @brief   Commits and destroys the given transaction object.
+ *
+ * @param   transaction         The transaction object.
+ * @param   failed_operation    Receives the target address of the operation that failed the
+ *                              transaction. This parameter is optional.
+ *
+ * @return  A zyan status code.
+ *
+ * This function waits for the commit phase of other transactions to complete, suspends all 
+ * threads in the thread-update list, performs the pending operations and migrates and resumes
+ * the threads.
+ *
+ * If the function fails, the transaction object stays valid and has to be destroyed by calling
+ * `ZyrexTransactionDiscard`. Code patches are reverted like described for 
+ * `ZyrexTransactionCommitEx`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionSubmit(ZyrexTransaction* transaction, 
+    const void** failed_operation);
+
+/**
+ * @brief   Cancels and destroys the given transaction object.
+ *
+ * @param   transaction The transaction object.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexTransactionDiscard(ZyrexTransaction* transaction);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook installation                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Installs an inline hook at the given `address`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.                                                                  
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs an inline hook at the given `address`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   flags       A combination of `ZYREX_INLINE_HOOK_FLAG_*` values.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHookEx(void* address, const void* callback,
+    ZyrexInlineHookFlags flags, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs multiple inline hooks at once.
+ *
+ * @param   entries The inline hook entries.
+ * @param   count   The number of entries.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all hooks were installed, the status code of the first
+ *          failed entry (in array order), or a generic zyan status code if the batch could not be
+ *          started.
+ *
+ * The entries are processed in the order of their target addresses. This allows consecutive
+ * hooks to share trampoline-regions and memory queries. The code pages of all affected
+ * trampoline-regions are made writable only once for the whole batch.
+ *
+ * The `status` field of every entry receives the result of the individual operation. Entries that
+ * failed do not affect the other entries. Successfully installed hooks are committed or
+ * cancelled together with the remaining operations of the current transaction.
+ *
+ * Multiple entries with the same target address are rejected with `ZYAN_STATUS_INVALID_OPERATION`,
+ * except for the first one.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallInlineHooks(ZyrexInlineHookEntry* entries, ZyanUSize count);
+
+/**
+ * @brief   Installs an inline hook at the given `address`, that redirects to a generated thunk 
+ *          which invokes the given `handler`.
+ *
+ * @param   address     The address to hook.
+ * @param   signature   A pointer to the `ZyrexThunkSignature` struct.
+ * @param   handler     The handler function.
+ * @param   user_data   The user data passed to the handler.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * The thunk is generated for the calling convention of the current platform. It only saves the 
+ * integer argument registers (and the vector argument registers, if requested by the signature)
+ * to a `ZyrexThunkContext` on its stack frame and passes it to the handler. It then calls or 
+ * jumps to the original function through the trampoline.
+ *
+ * Thunk hooks are removed using `ZyrexRemoveInlineHook`. The code of thunks installed with the
+ * `ZYREX_THUNK_FLAG_POST` flag is never released, as threads might still return into it from 
+ * the original function.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallThunkHook(void* address, const ZyrexThunkSignature* signature,
+    ZyrexThunkHandler handler, void* user_data, ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs an exception hook at the given `address`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * Exception hooks replace the first byte of the hooked function with an `INT 3` instruction. The
+ * resulting exception is caught by a single process-wide exception dispatcher, which redirects 
+ * the calling thread to the callback function. The dispatcher finds the hook using a hash table 
+ * that is built when the transaction is committed, so the dispatch cost does not depend on the
+ * number of installed hooks.
+ *
+ * On Windows, the dispatcher is registered as the first vectored exception handler. On POSIX
+ * systems, it replaces the `SIGTRAP` signal handler and forwards all unrelated signals to the 
+ * previous one.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallExceptionHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs a context hook at the given `address`.
+ *
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * Context hooks do not modify any code. Instead, an execution breakpoint is set in one of the 
+ * debug registers `DR0` - `DR3`, which limits the number of context hooks to four. The resulting
+ * exception is handled by the same dispatcher as exception hooks.
+ *
+ * The debug registers of all threads in the thread-update list and of the committing thread are
+ * written during a single pass, when the transaction is committed. Threads that are not updated
+ * by the transaction, as well as threads created afterwards, do not hit the hook.
+ *
+ * Context hooks are only supported on Windows. On other platforms, this function fails with
+ * `ZYAN_STATUS_INVALID_OPERATION`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallContextHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Installs an import address table hook in the given `module`.
+ *
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL` to match any module.
+ * @param   import_name     The name of the imported function or an ordinal value.
+ * @param   callback        The callback address.
+ * @param   original        Receives the original address of the imported function, if the
+ *                          operation succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * Functions imported by ordinal are selected by passing the ordinal value (`<= 0xFFFF`) casted
+ * to a string pointer as `import_name`. The exporting module name is compared case-insensitive.
+ *
+ * The import directory of every module is parsed only once and cached afterwards. The cached
+ * entries are invalidated, if the module at the given base address changes.
+ *
+ * IAT and VTable hooks do not require a trampoline. The entry is replaced using a single atomic 
+ * pointer store, when the transaction is committed. All pointer hooks of a transaction are 
+ * written in one batch with the containing pages made writable only once.
+ *
+ * IAT hooks are only supported on Windows. On other platforms, this function fails with
+ * `ZYAN_STATUS_INVALID_OPERATION`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallIatHook(const void* module, const char* import_module, 
+    const char* import_name, const void* callback, ZyanConstVoidPointer* original);
+
+/**
+ * @brief   Installs a VTable hook for the entry at the given `index`.
+ *
+ * @param   vtable      The address of the virtual function table.
+ * @param   index       The index of the entry to hook.
+ * @param   callback    The callback address.
+ * @param   original    Receives the original address of the virtual function, if the operation
+ *                      succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * The entry is replaced using a single atomic pointer store, when the transaction is committed. 
+ * See `ZyrexInstallIatHook` for details.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallVTableHook(void* vtable, ZyanUSize index, 
+    const void* callback, ZyanConstVoidPointer* original);
+
+/**
+ * @brief   Installs multiple inline hooks in another process at once.
+ *
+ * @param   process The handle of the target process. The handle requires the 
+ *                  `PROCESS_QUERY_INFORMATION`, `PROCESS_VM_OPERATION`, `PROCESS_VM_READ` and 
+ *                  `PROCESS_VM_WRITE` access rights.
+ * @param   entries The remote inline hook entries.
+ * @param   count   The number of entries.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all hooks were installed, the status code of the first
+ *          failed entry (in array order), or a generic zyan status code if the batch could not be
+ *          started.
+ *
+ * The hooks are applied immediately in a single pass and do not take part in the current 
+ * transaction. The original code of all entries is read and relocated locally. Trampolines are 
+ * packed into as few remote trampoline-regions as possible, which are written using a single 
+ * `WriteProcessMemory` call each. All threads of the target process are suspended only once, 
+ * while the hook jumps of neighbouring functions are written together. Threads that are located 
+ * inside of the overwritten instructions are migrated to the trampoline code.
+ *
+ * Remote hooks only support the features of `ZYREX_INLINE_HOOK_FLAG_NONE`. They can not be 
+ * removed or modified by any of the other functions. The target process has to use the same 
+ * architecture as the current process.
+ *
+ * The `status` field of every entry receives the result of the individual operation. Entries that
+ * failed do not affect the other entries. If the batch could not be started, every entry receives
+ * the returned status code.
+ *
+ * Remote hooks are only supported on Windows. On other platforms, this function fails with
+ * `ZYAN_STATUS_INVALID_OPERATION`.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexInstallRemoteInlineHooks(void* process, 
+    ZyrexRemoteInlineHookEntry* entries, ZyanUSize count);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook removal                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Removes an inline hook at the given `address`.
+ *
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
  *
  * @return  A zyan status code.                                                                  
  */
 ZYREX_EXPORT ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* trampoline);
 
+/**
+ * @brief   Removes an exception hook.
+ *
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveExceptionHook(ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Removes a context hook.
+ *
+ * @param   trampoline  A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveContextHook(ZyanConstVoidPointer* trampoline);
+
+/**
+ * @brief   Removes an import address table hook.
+ *
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL` to match any module.
+ * @param   import_name     The name of the imported function or an ordinal value.
+ *
+ * @return  A zyan status code.
+ *
+ * The original address of the imported function is restored, when the transaction is committed.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveIatHook(const void* module, const char* import_module, 
+    const char* import_name);
+
+/**
+ * @brief   Removes a VTable hook.
+ *
+ * @param   vtable  The address of the virtual function table.
+ * @param   index   The index of the hooked entry.
+ *
+ * @return  A zyan status code.
+ *
+ * The original address of the virtual function is restored, when the transaction is committed.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexRemoveVTableHook(void* vtable, ZyanUSize index);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook modification                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Replaces the callback of an inline hook.
+ *
+ * @param   trampoline  The trampoline address received during the hook attaching.
+ * @param   callback    The address of the new callback function.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook has to be installed with the `ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK` flag. The new
+ * callback is published using a single atomic pointer store. No transaction is required and no
+ * threads are suspended. Threads that already entered the previous callback keep executing it.
+ *
+ * This function must not be called concurrently with a transaction that removes the same hook.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexSetInlineHookCallback(ZyanConstVoidPointer trampoline, 
+    const void* callback);
+
+/**
+ * @brief   Enables or disables an inline hook without removing it.
+ *
+ * @param   trampoline  The trampoline address received during the hook attaching.
+ * @param   enabled     `ZYAN_TRUE` to redirect to the callback, `ZYAN_FALSE` to bypass it.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook has to be installed with the `ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK` flag. A disabled
+ * hook keeps its patch at the target function, but its callback stub jumps directly to the 
+ * trampoline, which executes the original function. No code bytes are modified, no transaction is
+ * required and no threads are suspended.
+ *
+ * This function must not be called concurrently with `ZyrexSetInlineHookCallback` or a 
+ * transaction that removes the same hook.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexSetInlineHookEnabled(ZyanConstVoidPointer trampoline, 
+    ZyanBool enabled);
+
+/**
+ * @brief   Enables or disables a group of inline hooks without removing them.
+ *
+ * @param   trampolines The trampoline addresses received during the hook attaching.
+ * @param   count       The number of trampolines.
+ * @param   enabled     `ZYAN_TRUE` to redirect to the callbacks, `ZYAN_FALSE` to bypass them.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all hooks were updated, or the status code of the first
+ *          failed hook (in array order).
+ *
+ * Every hook is switched individually using `ZyrexSetInlineHookEnabled`. Failed hooks do not 
+ * affect the other hooks of the group.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexSetInlineHooksEnabled(const ZyanConstVoidPointer* trampolines,
+    ZyanUSize count, ZyanBool enabled);
+
+/**
+ * @brief   Changes the sampling interval of an inline hook.
+ *
+ * @param   trampoline  The trampoline address received during the hook attaching.
+ * @param   interval    The callback is invoked once every `interval` calls. Must not be `0`.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook has to be installed with the `ZYREX_INLINE_HOOK_FLAG_SAMPLING` flag. The sampling 
+ * counter is shared by all threads and restarted with the new interval. No transaction is 
+ * required and no threads are suspended.
+ *
+ * This function must not be called concurrently with a transaction that removes the same hook.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexSetInlineHookSamplingInterval(ZyanConstVoidPointer trampoline,
+    ZyanU32 interval);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook counters                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Reads the counters of an inline hook.
+ *
+ * @param   trampoline  The trampoline address received during the hook attaching.
+ * @param   counters    Receives the counter values.
+ *
+ * @return  A zyan status code.
+ *
+ * The hook has to be installed with the `ZYREX_INLINE_HOOK_FLAG_COUNTERS` flag. The individual 
+ * counters are read one after another and do not form a consistent snapshot while the hook is
+ * executed concurrently.
+ *
+ * This function must not be called concurrently with a transaction that removes the same hook.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexGetInlineHookCounters(ZyanConstVoidPointer trampoline,
+    ZyrexInlineHookCounters* counters);
+
+/**
+ * @brief   Reads the counters of all installed inline hooks that have counters enabled.
+ *
+ * @param   buffer      The buffer that receives the counter values.
+ * @param   capacity    The number of elements the `buffer` can hold.
+ * @param   count       Receives the number of inline hooks with counters enabled.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if the counters of all hooks were written to the `buffer`, 
+ *          `ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE`, if the `buffer` is too small, or another zyan 
+ *          status code, if an error occured.
+ *
+ * Pass a `buffer` of `ZYAN_NULL` and a `capacity` of `0` to query the required number of 
+ * elements. Hooks that are still pending in a transaction are included as well.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexGetAllInlineHookCounters(ZyrexInlineHookCounters* buffer,
+    ZyanUSize capacity, ZyanUSize* count);
+
+/**
+ * @brief   Returns statistics about the memory used by the trampolines of all inline hooks.
+ *
+ * @param   statistics  Receives the trampoline statistics.
+ *
+ * @return  A zyan status code.
+ *
+ * New trampolines are always placed in the most populated trampoline-region in range of the 
+ * hooked function, which lets sparsely populated regions drain and get released over time. The 
+ * `sparse_region_count` indicates how many regions are currently waiting for that to happen.
+ *
+ * Live trampolines are never moved to compact sparse regions. The trampoline code is handed out
+ * as the pointer to the original function and callers may keep copies of it, which can not be
+ * fixed up like the instruction pointers of suspended threads.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexGetTrampolineStatistics(ZyrexTrampolineStatistics* statistics);
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation cache                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Opens the persistent relocation cache.
+ *
+ * @param   path    The path of the cache file. The file is created by 
+ *                  `ZyrexCloseRelocationCache`, if it does not exist.
+ *
+ * @return  A zyan status code.
+ *
+ * The cache file is mapped into memory and stores the relocated code and instruction translation
+ * map of every inline hook target, keyed by the identity of the containing module and the 
+ * relative address of the target. Creating a trampoline for a cached target only copies the 
+ * relocated code and updates the relative offsets to external addresses. Targets outside of 
+ * loaded modules are never cached.
+ *
+ * A missing or incompatible cache file is not an error. Every cache entry is validated against the
+ * original code bytes before it is used.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexOpenRelocationCache(const char* path);
+
+/**
+ * @brief   Closes the persistent relocation cache.
+ *
+ * @param   save    Set `ZYAN_TRUE` to write the cache file, if new entries were added since the 
+ *                  cache was opened.
+ *
+ * @return  A zyan status code.
+ *
+ * The cache file is atomically replaced, which allows multiple processes to share the same file.
+ * On Windows, replacing the file fails while another process has it mapped. The cache is closed 
+ * in any case and installed hooks are not affected.
+ */
+ZYREX_EXPORT ZyanStatus ZyrexCloseRelocationCache(ZyanBool save);
+
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -24,80 +24,266 @@
 
 ***************************************************************************************************/
 
-#include <Zycore/API/Thread.h>
-#include <Zycore/LibC.h>
-#include <Zycore/Vector.h>
 #include <Zyrex/Barrier.h>
+#include <Zyrex/Internal/Barrier.h>
+#include <Zyrex/Internal/ThreadState.h>
+#include <Zyrex/Internal/Trampoline.h>
+#include <Zyrex/Internal/Utils.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#endif
 
 /* ============================================================================================== */
 /* Globals                                                                                        */
 /* ============================================================================================== */
 
 /**
- * @brief   The TLS slot used by the barrier system.
+ * @brief   A bitmap that contains one bit for each barrier slot, signaling if the slot is
+ *          currently reserved.
+ *
+ * The bitmap is only accessed by `ZyrexBarrierSlotReserve` and `ZyrexBarrierSlotRelease`, which 
+ * are always called with the region lock held.
  */
-static ZyanThreadTlsIndex g_barrier_tls_index = 0;
-
-/* ============================================================================================== */
-/* Enums and types                                                                                */
-/* ============================================================================================== */
+static ZyanU32 g_barrier_slots[ZYREX_BARRIER_MAX_SLOTS / 32];
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Barrier context                                                                                */
-/* ---------------------------------------------------------------------------------------------- */
+/**
+ * @brief   Contains the trampoline counters associated with each barrier slot.
+ *
+ * Entries are written with the region lock held, but read by the barrier functions without any
+ * lock. Each entry is updated using a single pointer store.
+ */
+static ZyrexTrampolineCounters* volatile g_barrier_counters[ZYREX_BARRIER_MAX_SLOTS];
 
 /**
- * @brief   Defines the `ZyrexBarrierContext` struct.
+ * @brief   Contains the current generation of each barrier slot.
+ *
+ * Entries are incremented by `ZyrexBarrierSlotReserve` with the region lock held, but read by the
+ * barrier functions without any lock.
  */
-typedef struct ZyrexBarrierContext_
-{
-    /**
-     * @brief   The barrier context id.
-     */
-    ZyrexBarrierHandle id;
-    /**
-     * @brief   The current recursion depth.
-     */
-    ZyanU32 recursion_depth;
-} ZyrexBarrierContext;
+static volatile ZyanU32 g_barrier_generations[ZYREX_BARRIER_MAX_SLOTS];
 
-/* ---------------------------------------------------------------------------------------------- */
+/**
+ * @brief   The number of trampoline counter shards assigned to threads so far.
+ */
+static volatile ZyanU32 g_barrier_counter_shards = 0;
 
 /* ============================================================================================== */
 /* Internal functions                                                                             */
 /* ============================================================================================== */
 
 /* ---------------------------------------------------------------------------------------------- */
-/* TLS cleanup                                                                                    */
+/* Barrier context                                                                                */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   This function is invoked every time a thread exists.
+ * @brief   Returns the preferred slot index for the given barrier `handle`.
+ *
+ * @param   handle  The barrier hook handle.
  *
- * @param   data    The data currently stored in the TLS slot.
+ * @return  The preferred slot index for the given barrier `handle`.
  */
-ZYAN_THREAD_DECLARE_TLS_CALLBACK(ZyrexBarrierTlsCleanup, ZyanVector, data)
+ZYAN_INLINE ZyanUSize ZyrexBarrierHash(ZyrexBarrierHandle handle)
 {
-    if (!data)
+    // Fibonacci hashing spreads the (usually aligned) pointer values across all slots
+    return (ZyanUSize)(((ZyanU64)handle * 0x9E3779B97F4A7C15ULL) >>
+        (64 - ZYREX_BARRIER_TABLE_BITS));
+}
+
+/**
+ * @brief   Searches the barrier context table for the given barrier `handle`.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct.
+ * @param   handle  The barrier hook handle.
+ * @param   index   Receives the index of the matching context, or the index of the first unused
+ *                  slot in the probe sequence, if no context was found.
+ *
+ * @return  `ZYAN_TRUE` if a context was found for the given `handle`, `ZYAN_FALSE` if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexBarrierFindContext(const ZyrexBarrierThreadData* data,
+    ZyrexBarrierHandle handle, ZyanUSize* index)
+{
+    ZYAN_ASSERT(data);
+    ZYAN_ASSERT(index);
+    ZYAN_ASSERT(handle != 0);
+    ZYAN_ASSERT(data->count < ZYREX_BARRIER_TABLE_SIZE);
+
+    ZyanUSize i = ZyrexBarrierHash(handle);
+    while (ZYAN_TRUE)
     {
-        return;
+        const ZyrexBarrierHandle id = data->contexts[i].id;
+        if (id == handle)
+        {
+            *index = i;
+            return ZYAN_TRUE;
+        }
+        if (id == 0)
+        {
+            *index = i;
+            return ZYAN_FALSE;
+        }
+        i = (i + 1) & (ZYREX_BARRIER_TABLE_SIZE - 1);
     }
+}
 
-    ZyanVectorDestroy(data);
+/**
+ * @brief   Releases the context at the given `index` from the barrier context table.
+ *
+ * @param   data    A pointer to the `ZyrexBarrierThreadData` struct.
+ * @param   index   The index of the context to release.
+ *
+ * Subsequent entries of the same probe sequence are shifted backwards to close the gap. This
+ * avoids the need for tombstones and keeps all probe sequences as short as possible.
+ */
+static void ZyrexBarrierReleaseContext(ZyrexBarrierThreadData* data, ZyanUSize index)
+{
+    ZYAN_ASSERT(data);
+    ZYAN_ASSERT(data->count > 0);
+
+    ZyanUSize i = index;
+    ZyanUSize j = index;
+    while (ZYAN_TRUE)
+    {
+        j = (j + 1) & (ZYREX_BARRIER_TABLE_SIZE - 1);
+        const ZyrexBarrierHandle id = data->contexts[j].id;
+        if (id == 0)
+        {
+            break;
+        }
 
-    // TODO: Replace with ZyanMemoryFree in the future
-    ZYAN_FREE(data);
+        // Keep the entry in place, if its preferred slot lies cyclically in `(i, j]`
+        const ZyanUSize k = ZyrexBarrierHash(id);
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+        {
+            continue;
+        }
+
+        data->contexts[i] = data->contexts[j];
+        i = j;
+    }
+
+    data->contexts[i].id = 0;
+    data->contexts[i].recursion_depth = 0;
+    --data->count;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Barrier context                                                                                */
+/* Trampoline counters                                                                            */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Defines a comparison function for the `ZyrexBarrierContext` struct that uses the `id`
- *          field to create an absolute order.
+ * @brief   Atomically adds the given `value` to the given `counter`.
+ *
+ * @param   counter A pointer to the counter.
+ * @param   value   The value to add.
  */
-ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexBarrierCompareContext, ZyrexBarrierContext, id)
+ZYAN_INLINE void ZyrexBarrierCounterAdd(volatile ZyanU64* counter, ZyanU64 value)
+{
+#if defined(ZYAN_WINDOWS)
+    InterlockedExchangeAdd64((volatile LONGLONG*)counter, (LONGLONG)value);
+#elif defined(ZYAN_POSIX)
+    __sync_fetch_and_add(counter, value);
+#else
+#   error "Unsupported platform detected"
+#endif
+}
+
+/**
+ * @brief   Returns the trampoline counter shard of the current thread for the given `counters`.
+ *
+ * @param   state       A pointer to the `ZyrexThreadState` struct.
+ * @param   counters    A pointer to the `ZyrexTrampolineCounters` struct.
+ *
+ * @return  A pointer to the `ZyrexTrampolineCounterShard` struct.
+ *
+ * Shards are assigned to threads in a round-robin fashion the first time a thread updates any
+ * trampoline counters.
+ */
+ZYAN_INLINE ZyrexTrampolineCounterShard* ZyrexBarrierGetCounterShard(
+    ZyrexThreadState* state, ZyrexTrampolineCounters* counters)
+{
+    ZYAN_ASSERT(state);
+    ZYAN_ASSERT(counters);
+
+    if (!state->counter_shard)
+    {
+#if defined(ZYAN_WINDOWS)
+        const ZyanU32 index = 
+            (ZyanU32)InterlockedIncrement((volatile LONG*)&g_barrier_counter_shards) - 1;
+#elif defined(ZYAN_POSIX)
+        const ZyanU32 index = __sync_fetch_and_add(&g_barrier_counter_shards, 1);
+#else
+#   error "Unsupported platform detected"
+#endif
+        state->counter_shard = (index % ZYREX_TRAMPOLINE_COUNTER_SHARDS) + 1;
+    }
+
+    return &counters->shards[state->counter_shard - 1];
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Barrier slots                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexBarrierSlotReserve(ZyanU32* slot)
+{
+    ZYAN_ASSERT(slot);
+
+    for (ZyanU32 i = 0; i < ZYAN_ARRAY_LENGTH(g_barrier_slots); ++i)
+    {
+        if (g_barrier_slots[i] == (ZyanU32)(-1))
+        {
+            continue;
+        }
+
+        ZyanU32 bit = 0;
+        while (g_barrier_slots[i] & (1u << bit))
+        {
+            ++bit;
+        }
+
+        g_barrier_slots[i] |= (1u << bit);
+        *slot = i * 32 + bit;
+        g_barrier_generations[*slot] = 
+            (g_barrier_generations[*slot] + 1) & ZYREX_BARRIER_GENERATION_MASK;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    return ZYAN_STATUS_OUT_OF_RESOURCES;
+}
+
+ZyanStatus ZyrexBarrierSlotRelease(ZyanU32 slot)
+{
+    if (slot >= ZYREX_BARRIER_MAX_SLOTS)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!(g_barrier_slots[slot / 32] & (1u << (slot % 32))))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    g_barrier_slots[slot / 32] &= ~(1u << (slot % 32));
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexBarrierSlotSetCounters(ZyanU32 slot, ZyrexTrampolineCounters* counters)
+{
+    if (slot >= ZYREX_BARRIER_MAX_SLOTS)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    g_barrier_counters[slot] = counters;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanU32 ZyrexBarrierSlotGetGeneration(ZyanU32 slot)
+{
+    ZYAN_ASSERT(slot < ZYREX_BARRIER_MAX_SLOTS);
+
+    return g_barrier_generations[slot];
+}
 
 /* ---------------------------------------------------------------------------------------------- */
 
@@ -111,12 +297,12 @@ ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexBarrierCompareContext, ZyrexBarrierContex
 
 ZyanStatus ZyrexBarrierSystemInitialize()
 {
-    return ZyanThreadTlsAlloc(&g_barrier_tls_index, (ZyanThreadTlsCallback)&ZyrexBarrierTlsCleanup);
+    return ZyrexThreadStateInitialize();
 }
 
 ZyanStatus ZyrexBarrierSystemShutdown()
 {
-    return ZyanThreadTlsFree(g_barrier_tls_index);
+    return ZyrexThreadStateShutdown();
 }
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -128,6 +314,24 @@ ZyrexBarrierHandle ZyrexBarrierGetHandle(const void* trampoline)
     return (ZyrexBarrierHandle)trampoline;
 }
 
+ZyanStatus ZyrexBarrierGetIndexedHandle(const void* trampoline, ZyrexBarrierHandle* handle)
+{
+    if (!trampoline || !handle)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyrexTrampolineChunk* const chunk = ZyrexTrampolineGetChunk(trampoline);
+    if (chunk->barrier_slot == ZYREX_BARRIER_SLOT_INVALID)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    *handle = ZYREX_BARRIER_MAKE_INDEXED_HANDLE(chunk->barrier_slot, 
+        ZyrexBarrierSlotGetGeneration(chunk->barrier_slot));
+    return ZYAN_STATUS_SUCCESS;
+}
+
 ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle)
 {
     return ZyrexBarrierTryEnterEx(handle, 0);
@@ -135,30 +339,77 @@ ZyanStatus ZyrexBarrierTryEnter(ZyrexBarrierHandle handle)
 
 ZyanStatus ZyrexBarrierTryEnterEx(ZyrexBarrierHandle handle, ZyanU32 max_recursion_depth)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_TRUE));
+
+    // Excluded threads (e.g. while draining trace events) must never pass any barrier
+    if (state->exclusion_depth)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
 
-    if (vector == ZYAN_NULL)
+    ZyrexBarrierThreadData* const data = &state->barrier;
+
+    if (ZYREX_BARRIER_IS_INDEXED_HANDLE(handle))
     {
-        // TODO: Replace with ZyanMemoryAlloc in the future
-        vector = ZYAN_MALLOC(sizeof(ZyanVector));
-        ZYAN_CHECK(ZyanVectorInit(vector, sizeof(ZyrexBarrierContext), 32, ZYAN_NULL));
-        ZYAN_CHECK(ZyanThreadTlsSetValue(g_barrier_tls_index, vector));
+        const ZyanUSize slot = ZYREX_BARRIER_GET_HANDLE_SLOT(handle);
+        const ZyanU32 generation = ZYREX_BARRIER_GET_HANDLE_GENERATION(handle);
+
+        // Handles obtained for a previous reservation of the slot are rejected
+        if (!ZYREX_BARRIER_IS_VALID_INDEXED_HANDLE(handle) || 
+            (generation != g_barrier_generations[slot]))
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+
+        ZyanU32* const depth = &data->slots[slot];
+        if (data->generations[slot] != generation)
+        {
+            // The slot was reused since the last time this thread entered it
+            data->generations[slot] = generation;
+            *depth = 0;
+        }
+
+        ZyrexTrampolineCounters* const counters = g_barrier_counters[slot];
+        if (*depth > max_recursion_depth)
+        {
+            if (counters)
+            {
+                ZyrexBarrierCounterAdd(
+                    &ZyrexBarrierGetCounterShard(state, counters)->rejections, 1);
+            }
+            return ZYAN_STATUS_FALSE;
+        }
+
+        if (counters)
+        {
+            ZyrexBarrierCounterAdd(&ZyrexBarrierGetCounterShard(state, counters)->calls, 1);
+            if (counters->measure_cycles && (*depth == 0))
+            {
+                data->timestamps[slot] = ZyrexReadTimestampCounter();
+            }
+        }
+
+        ++*depth;
+        return ZYAN_STATUS_TRUE;
     }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
+    // The handle `0` marks unused entries of the context table
+    if (handle == 0)
+    {
+        if (data->null_depth > max_recursion_depth)
+        {
+            return ZYAN_STATUS_FALSE;
+        }
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+        ++data->null_depth;
+        return ZYAN_STATUS_TRUE;
+    }
 
-    if (status == ZYAN_STATUS_TRUE)
+    ZyanUSize index;
+    if (ZyrexBarrierFindContext(data, handle, &index))
     {
-        ZyrexBarrierContext* const context =
-            (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
+        ZyrexBarrierContext* const context = &data->contexts[index];
         if (context->recursion_depth > max_recursion_depth)
         {
             return ZYAN_STATUS_FALSE;
@@ -168,46 +419,79 @@ ZyanStatus ZyrexBarrierTryEnterEx(ZyrexBarrierHandle handle, ZyanU32 max_recursi
         return ZYAN_STATUS_TRUE;
     }
 
-    context_element.recursion_depth = 1;
-    ZYAN_CHECK(ZyanVectorInsert(vector, found_index, &context_element));
+    // Always keep at least one slot unused to guarantee termination of the probe sequence
+    if (data->count == ZYREX_BARRIER_TABLE_SIZE - 1)
+    {
+        return ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
+
+    data->contexts[index].id = handle;
+    data->contexts[index].recursion_depth = 1;
+    ++data->count;
 
     return ZYAN_STATUS_TRUE;
 }
 
 ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_FALSE));
 
-    if (vector == ZYAN_NULL)
+    if (state == ZYAN_NULL)
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
+    ZyrexBarrierThreadData* const data = &state->barrier;
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+    if (ZYREX_BARRIER_IS_INDEXED_HANDLE(handle))
+    {
+        if (!ZYREX_BARRIER_IS_VALID_INDEXED_HANDLE(handle))
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
 
-    if (status != ZYAN_STATUS_TRUE)
+        const ZyanUSize slot = ZYREX_BARRIER_GET_HANDLE_SLOT(handle);
+        ZyanU32* const depth = &data->slots[slot];
+        if ((data->generations[slot] != ZYREX_BARRIER_GET_HANDLE_GENERATION(handle)) || 
+            (*depth == 0))
+        {
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
+
+        ZyrexTrampolineCounters* const counters = g_barrier_counters[slot];
+        if ((--*depth == 0) && counters && counters->measure_cycles)
+        {
+            ZyrexBarrierCounterAdd(&ZyrexBarrierGetCounterShard(state, counters)->cycles, 
+                ZyrexReadTimestampCounter() - data->timestamps[slot]);
+        }
+
+        return ZYAN_STATUS_TRUE;
+    }
+
+    if (handle == 0)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        if (data->null_depth == 0)
+        {
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
+
+        --data->null_depth;
+        return ZYAN_STATUS_TRUE;
     }
 
-    ZyrexBarrierContext* const context =
-        (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
-    if (context->recursion_depth == 0)
+    ZyanUSize index;
+    if (!ZyrexBarrierFindContext(data, handle, &index))
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
+    ZyrexBarrierContext* const context = &data->contexts[index];
+    ZYAN_ASSERT(context->recursion_depth > 0);
+
     if (--context->recursion_depth == 0)
     {
-        ZYAN_CHECK(ZyanVectorDelete(vector, found_index));
+        ZyrexBarrierReleaseContext(data, index);
     }
 
     return ZYAN_STATUS_TRUE;
@@ -219,34 +503,55 @@ ZyanStatus ZyrexBarrierLeave(ZyrexBarrierHandle handle)
 
 ZyanStatus ZyrexBarrierGetRecursionDepth(ZyrexBarrierHandle handle, ZyanU32* current_depth)
 {
-    ZyanVector* vector;
-    ZYAN_CHECK(ZyanThreadTlsGetValue(g_barrier_tls_index, (void*)&vector));
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_FALSE));
+
+    const ZyrexBarrierThreadData* const data = state ? &state->barrier : ZYAN_NULL;
+
+    if (ZYREX_BARRIER_IS_INDEXED_HANDLE(handle))
+    {
+        if (!ZYREX_BARRIER_IS_VALID_INDEXED_HANDLE(handle))
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+
+        const ZyanUSize slot = ZYREX_BARRIER_GET_HANDLE_SLOT(handle);
+        *current_depth = ((data != ZYAN_NULL) && 
+            (data->generations[slot] == ZYREX_BARRIER_GET_HANDLE_GENERATION(handle))) ? 
+            data->slots[slot] : 0;
+        return (*current_depth > 0) ? ZYAN_STATUS_TRUE : ZYAN_STATUS_FALSE;
+    }
 
-    if (vector == ZYAN_NULL)
+    if ((data != ZYAN_NULL) && (handle == 0))
+    {
+        *current_depth = data->null_depth;
+        return (*current_depth > 0) ? ZYAN_STATUS_TRUE : ZYAN_STATUS_FALSE;
+    }
+
+    ZyanUSize index;
+    if ((data == ZYAN_NULL) || !ZyrexBarrierFindContext(data, handle, &index))
     {
         *current_depth = 0;
         return ZYAN_STATUS_FALSE;
     }
 
-    ZyrexBarrierContext context_element;
-    context_element.id = handle;
-
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(vector, &context_element, &found_index,
-            (ZyanComparison)&ZyrexBarrierCompareContext);
-    ZYAN_CHECK(status);
+    *current_depth = data->contexts[index].recursion_depth;
+    return ZYAN_STATUS_TRUE;
+}
 
-    if (status == ZYAN_STATUS_TRUE)
+ZyanStatus ZyrexBarrierGetThreadBuffer(void** buffer, ZyanUSize* size)
+{
+    if (!buffer || !size)
     {
-        ZyrexBarrierContext* const context =
-            (ZyrexBarrierContext*)ZyanVectorGetMutable(vector, found_index);
-
-        *current_depth = context->recursion_depth;
-        return ZYAN_STATUS_TRUE;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    return ZYAN_STATUS_FALSE;
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_TRUE));
+
+    *buffer = state->buffer;
+    *size = sizeof(state->buffer);
+    return ZYAN_STATUS_SUCCESS;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -0,0 +1,524 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef _GNU_SOURCE
+    // Required for the `REG_RIP`/`REG_EIP` register indices of the `ucontext_t` struct
+#   define _GNU_SOURCE
+#endif
+
+#include <Zycore/LibC.h>
+#include <Zyrex/Internal/ExceptionHook.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <signal.h>
+#   include <ucontext.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The minimum number of bits used to index the entries of an exception hook table.
+ */
+#define ZYREX_EXCEPTION_HOOK_TABLE_MIN_BITS         3
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the code of the private exception that is raised to update the debug 
+ *          registers of the calling thread.
+ */
+#define ZYREX_EXCEPTION_CODE_WRITE_DEBUG_REGISTERS  0xE07A7278
+
+/**
+ * @brief   Defines the resume flag of the `EFLAGS` register, which suppresses instruction 
+ *          breakpoints for the next instruction.
+ */
+#define ZYREX_EFLAGS_RF                             0x00010000
+
+#endif
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains the state of the exception dispatcher.
+ *
+ * The dispatcher reads the current hook table without taking any locks. Every reader increments
+ * the `readers` counter before loading the table pointer and decrements it after the lookup. 
+ * Published tables are exchanged atomically and retired tables are only released, if no reader 
+ * is active after the exchange.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the exception dispatcher has been installed.
+     */
+    ZyanBool is_installed;
+#if   defined(ZYAN_WINDOWS)
+    /**
+     * @brief   The handle of the vectored exception handler.
+     */
+    PVOID handle;
+#elif defined(ZYAN_POSIX)
+    /**
+     * @brief   The previously installed `SIGTRAP` signal action.
+     */
+    struct sigaction previous_action;
+#endif
+    /**
+     * @brief   The currently published hook table or `ZYAN_NULL`, if none.
+     */
+    ZyrexExceptionHookTable* volatile table;
+    /**
+     * @brief   The number of threads that are currently executing a table lookup.
+     */
+    volatile ZyanU32 readers;
+    /**
+     * @brief   The list of retired hook tables that still have to be released.
+     */
+    ZyrexExceptionHookTable* retired;
+} g_exception_dispatcher;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook table                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the preferred entry index for the given `address`.
+ *
+ * @param   address The hooked address.
+ * @param   bits    The number of bits used to index the table entries.
+ *
+ * @return  The preferred entry index for the given `address`.
+ */
+ZYAN_INLINE ZyanUSize ZyrexExceptionHookHash(ZyanUPointer address, ZyanU8 bits)
+{
+    // Fibonacci hashing spreads the function addresses across all entries
+    return (ZyanUSize)(((ZyanU64)address * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+/**
+ * @brief   Searches the given exception hook `table` for the given `address`.
+ *
+ * @param   table   A pointer to the `ZyrexExceptionHookTable` struct.
+ * @param   address The address to search for.
+ *
+ * @return  A pointer to the entry of the given `address` or the first unused entry in its probe
+ *          sequence, if the `address` was not found.
+ */
+ZYAN_INLINE ZyrexExceptionHook* ZyrexExceptionHookTableFind(const ZyrexExceptionHookTable* table,
+    ZyanUPointer address)
+{
+    ZYAN_ASSERT(table);
+
+    const ZyanUSize mask = ((ZyanUSize)1 << table->bits) - 1;
+
+    ZyanUSize i = ZyrexExceptionHookHash(address, table->bits);
+    while ((table->entries[i].address != address) && (table->entries[i].address != 0))
+    {
+        i = (i + 1) & mask;
+    }
+
+    return &table->entries[i];
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exception dispatcher                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Searches the currently published hook table for a hook of the given `type` at the
+ *          given `address`.
+ *
+ * @param   address     The address to search for.
+ * @param   type        The hook type.
+ * @param   callback    Receives the callback address of the hook.
+ *
+ * @return  `ZYAN_TRUE`, if a matching hook was found, `ZYAN_FALSE` if not.
+ *
+ * This function is lock-free and safe to be called from a signal handler. The lookup costs a 
+ * single hash computation and usually touches only one table entry.
+ */
+static ZyanBool ZyrexExceptionDispatcherLookup(ZyanUPointer address, ZyrexHookType type,
+    ZyanUPointer* callback)
+{
+    ZYAN_ASSERT(callback);
+
+#if   defined(ZYAN_WINDOWS)
+    InterlockedIncrement((volatile LONG*)&g_exception_dispatcher.readers);
+#elif defined(ZYAN_POSIX)
+    __sync_add_and_fetch(&g_exception_dispatcher.readers, 1);
+#endif
+
+    ZyanBool result = ZYAN_FALSE;
+
+    const ZyrexExceptionHookTable* const table = g_exception_dispatcher.table;
+    if (table)
+    {
+        const ZyrexExceptionHook* const hook = ZyrexExceptionHookTableFind(table, address);
+        if ((hook->address == address) && (hook->type == type))
+        {
+            *callback = hook->callback;
+            result = ZYAN_TRUE;
+        }
+    }
+
+#if   defined(ZYAN_WINDOWS)
+    InterlockedDecrement((volatile LONG*)&g_exception_dispatcher.readers);
+#elif defined(ZYAN_POSIX)
+    __sync_sub_and_fetch(&g_exception_dispatcher.readers, 1);
+#endif
+
+    return result;
+}
+
+#if   defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   The vectored exception handler that dispatches exception and context hooks.
+ *
+ * @param   info    A pointer to the `EXCEPTION_POINTERS` struct.
+ *
+ * @return  `EXCEPTION_CONTINUE_EXECUTION`, if the exception was caused by a hook or 
+ *          `EXCEPTION_CONTINUE_SEARCH`, if not.
+ */
+static LONG CALLBACK ZyrexExceptionHandler(PEXCEPTION_POINTERS info)
+{
+    const PEXCEPTION_RECORD record = info->ExceptionRecord;
+    CONTEXT* const context = info->ContextRecord;
+
+    ZyrexHookType type;
+    switch (record->ExceptionCode)
+    {
+    case ZYREX_EXCEPTION_CODE_WRITE_DEBUG_REGISTERS:
+        ZyrexDebugRegistersWrite(context, (const ZyanUPointer*)record->ExceptionInformation[0]);
+        context->ContextFlags |= CONTEXT_DEBUG_REGISTERS;
+        return EXCEPTION_CONTINUE_EXECUTION;
+    case EXCEPTION_BREAKPOINT:
+        type = ZYREX_HOOK_TYPE_EXCEPTION;
+        break;
+    case EXCEPTION_SINGLE_STEP:
+        type = ZYREX_HOOK_TYPE_CONTEXT;
+        break;
+    default:
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    const ZyanUPointer address = (ZyanUPointer)record->ExceptionAddress;
+
+    ZyanUPointer destination;
+    if (!ZyrexExceptionDispatcherLookup(address, type, &destination))
+    {
+        // The hook might have been removed after the breakpoint was hit
+        if ((type != ZYREX_HOOK_TYPE_EXCEPTION) || 
+            (*(volatile const ZyanU8*)address == ZYREX_EXCEPTION_HOOK_OPCODE))
+        {
+            return EXCEPTION_CONTINUE_SEARCH;
+        }
+        destination = address;
+    } else
+    if (!destination)
+    {
+        // Removed context hooks stay in the table until the next commit, as threads that were not
+        // updated by the transaction might still have the debug register set
+        context->EFlags |= ZYREX_EFLAGS_RF;
+        destination = address;
+    }
+
+#   if defined(ZYAN_X64)
+    context->Rip = destination;
+#   elif defined(ZYAN_X86)
+    context->Eip = (DWORD)destination;
+#   else
+#       error "Unsupported architecture detected"
+#   endif
+
+    return EXCEPTION_CONTINUE_EXECUTION;
+}
+
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   The `SIGTRAP` signal handler that dispatches exception hooks.
+ *
+ * @param   signal  The signal number.
+ * @param   info    A pointer to the `siginfo_t` struct.
+ * @param   context A pointer to the `ucontext_t` struct of the interrupted thread.
+ *
+ * Signals that are not caused by a hook are forwarded to the previously installed handler.
+ */
+static void ZyrexExceptionSignalHandler(int signal, siginfo_t* info, void* context)
+{
+    ucontext_t* const ucontext = (ucontext_t*)context;
+#   if defined(ZYAN_X64)
+    greg_t* const ip = &ucontext->uc_mcontext.gregs[REG_RIP];
+#   elif defined(ZYAN_X86)
+    greg_t* const ip = &ucontext->uc_mcontext.gregs[REG_EIP];
+#   else
+#       error "Unsupported architecture detected"
+#   endif
+
+#   if defined(SI_KERNEL)
+    // The `INT 3` instruction reports `SI_KERNEL`, while single steps and `kill` use other codes
+    const ZyanBool is_breakpoint = (info->si_code == SI_KERNEL);
+#   else
+    const ZyanBool is_breakpoint = ZYAN_TRUE;
+#   endif
+
+    // The instruction pointer already points to the instruction following the `INT 3`
+    const ZyanUPointer address = (ZyanUPointer)*ip - 1;
+
+    if (is_breakpoint)
+    {
+        ZyanUPointer destination;
+        if (ZyrexExceptionDispatcherLookup(address, ZYREX_HOOK_TYPE_EXCEPTION, &destination))
+        {
+            *ip = (greg_t)destination;
+            return;
+        }
+        if (*(volatile const ZyanU8*)address != ZYREX_EXCEPTION_HOOK_OPCODE)
+        {
+            // The hook was removed after the breakpoint was hit
+            *ip = (greg_t)address;
+            return;
+        }
+    }
+
+    const struct sigaction* const previous = &g_exception_dispatcher.previous_action;
+    if (previous->sa_flags & SA_SIGINFO)
+    {
+        previous->sa_sigaction(signal, info, context);
+        return;
+    }
+    if (previous->sa_handler == SIG_IGN)
+    {
+        return;
+    }
+    if (previous->sa_handler != SIG_DFL)
+    {
+        previous->sa_handler(signal);
+        return;
+    }
+
+    // Restore the default action and trigger it again after returning from the handler
+    sigaction(SIGTRAP, previous, ZYAN_NULL);
+    if (is_breakpoint)
+    {
+        *ip = (greg_t)address;
+    } else
+    {
+        raise(SIGTRAP);
+    }
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook table                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexExceptionHookTableCreate(const ZyrexExceptionHook* hooks, ZyanUSize count,
+    ZyrexExceptionHookTable** table)
+{
+    if ((!hooks && count) || !table)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanU8 bits = ZYREX_EXCEPTION_HOOK_TABLE_MIN_BITS;
+    while (((ZyanUSize)1 << bits) < count * 2)
+    {
+        ++bits;
+    }
+    const ZyanUSize capacity = (ZyanUSize)1 << bits;
+
+    ZyrexExceptionHookTable* const value = 
+        ZYAN_MALLOC(sizeof(ZyrexExceptionHookTable) + capacity * sizeof(ZyrexExceptionHook));
+    if (!value)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    value->bits = bits;
+    value->entries = (ZyrexExceptionHook*)(value + 1);
+    value->next = ZYAN_NULL;
+    ZYAN_MEMSET(value->entries, 0, capacity * sizeof(ZyrexExceptionHook));
+
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        ZyrexExceptionHook* const entry = ZyrexExceptionHookTableFind(value, hooks[i].address);
+        if (!hooks[i].address || entry->address)
+        {
+            ZYAN_FREE(value);
+            return hooks[i].address ? ZYAN_STATUS_INVALID_OPERATION : ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        *entry = hooks[i];
+    }
+
+    *table = value;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+void ZyrexExceptionHookTableDestroy(ZyrexExceptionHookTable* table)
+{
+    ZYAN_FREE(table);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exception dispatcher                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexExceptionDispatcherInstall(void)
+{
+    if (g_exception_dispatcher.is_installed)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+#if   defined(ZYAN_WINDOWS)
+    g_exception_dispatcher.handle = AddVectoredExceptionHandler(1, &ZyrexExceptionHandler);
+    if (!g_exception_dispatcher.handle)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    struct sigaction action;
+    ZYAN_MEMSET(&action, 0, sizeof(action));
+    action.sa_sigaction = &ZyrexExceptionSignalHandler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGTRAP, &action, &g_exception_dispatcher.previous_action) != 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    g_exception_dispatcher.is_installed = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+void ZyrexExceptionDispatcherPublish(ZyrexExceptionHookTable* table)
+{
+#if   defined(ZYAN_WINDOWS)
+    ZyrexExceptionHookTable* const previous = InterlockedExchangePointer(
+        (PVOID volatile*)&g_exception_dispatcher.table, table);
+#elif defined(ZYAN_POSIX)
+    ZyrexExceptionHookTable* const previous = g_exception_dispatcher.table;
+    __sync_synchronize();
+    g_exception_dispatcher.table = table;
+    __sync_synchronize();
+#endif
+
+    if (previous)
+    {
+        previous->next = g_exception_dispatcher.retired;
+        g_exception_dispatcher.retired = previous;
+    }
+
+    // Readers that start after the exchange are guaranteed to see the new table
+    if (g_exception_dispatcher.readers != 0)
+    {
+        return;
+    }
+
+    while (g_exception_dispatcher.retired)
+    {
+        ZyrexExceptionHookTable* const next = g_exception_dispatcher.retired->next;
+        ZyrexExceptionHookTableDestroy(g_exception_dispatcher.retired);
+        g_exception_dispatcher.retired = next;
+    }
+}
+
+#ifdef ZYAN_WINDOWS
+
+void ZyrexDebugRegistersWrite(CONTEXT* context, 
+    const ZyanUPointer addresses[ZYREX_CONTEXT_HOOK_MAX_COUNT])
+{
+    ZYAN_ASSERT(context);
+    ZYAN_ASSERT(addresses);
+
+    context->Dr0 = addresses[0];
+    context->Dr1 = addresses[1];
+    context->Dr2 = addresses[2];
+    context->Dr3 = addresses[3];
+
+    ZyanUPointer dr7 = (ZyanUPointer)context->Dr7;
+    for (ZyanU8 i = 0; i < ZYREX_CONTEXT_HOOK_MAX_COUNT; ++i)
+    {
+        // Clear the local and global enable bits as well as the condition and length fields. 
+        // This configures a 1-byte execution breakpoint
+        dr7 &= ~((ZyanUPointer)0x03 << (i * 2));
+        dr7 &= ~((ZyanUPointer)0x0F << (16 + i * 4));
+        if (addresses[i])
+        {
+            dr7 |= (ZyanUPointer)0x01 << (i * 2);
+        }
+    }
+    context->Dr7 = dr7;
+}
+
+ZyanStatus ZyrexDebugRegistersWriteCurrentThread(
+    const ZyanUPointer addresses[ZYREX_CONTEXT_HOOK_MAX_COUNT])
+{
+    if (!addresses)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_exception_dispatcher.is_installed)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    const ULONG_PTR argument = (ULONG_PTR)addresses;
+    RaiseException(ZYREX_EXCEPTION_CODE_WRITE_DEBUG_REGISTERS, 0, 1, &argument);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
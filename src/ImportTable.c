@@ -0,0 +1,436 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/Defines.h>
+
+#ifdef ZYAN_WINDOWS
+
+#include <Zycore/Comparison.h>
+#include <Zycore/LibC.h>
+#include <Zycore/Vector.h>
+#include <Zyrex/Internal/ImportTable.h>
+#include <Windows.h>
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexImportEntry` struct.
+ */
+typedef struct ZyrexImportEntry_
+{
+    /**
+     * @brief   The name of the exporting module.
+     */
+    const char* module_name;
+    /**
+     * @brief   The name of the imported function or `ZYAN_NULL`, if the function is imported by
+     *          ordinal.
+     */
+    const char* function_name;
+    /**
+     * @brief   The ordinal of the imported function, if the `function_name` is `ZYAN_NULL`.
+     */
+    ZyanU16 ordinal;
+    /**
+     * @brief   The address of the import address table slot.
+     */
+    void** slot;
+} ZyrexImportEntry;
+
+/**
+ * @brief   Defines the `ZyrexImportTable` struct.
+ */
+typedef struct ZyrexImportTable_
+{
+    /**
+     * @brief   The base address of the importing module.
+     */
+    ZyanUPointer base;
+    /**
+     * @brief   The `TimeDateStamp` of the module headers at the time the table was parsed.
+     */
+    ZyanU32 time_date_stamp;
+    /**
+     * @brief   The `SizeOfImage` of the module headers at the time the table was parsed.
+     */
+    ZyanU32 size_of_image;
+    /**
+     * @brief   The import entries sorted by function name. Entries imported by ordinal are sorted
+     *          by ordinal in front of all named entries.
+     */
+    ZyanVector/*<ZyrexImportEntry>*/ entries;
+} ZyrexImportTable;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains the cached import tables of all modules sorted by base address.
+ */
+static ZyanVector/*<ZyrexImportTable>*/ g_import_tables = ZYAN_VECTOR_INITIALIZER;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Import entries                                                                                 */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexImportEntry` struct.
+ *
+ * @param   left    A pointer to the first entry.
+ * @param   right   A pointer to the second entry.
+ *
+ * @return  Returns `0` if the function names (or ordinals) are equal, a negative value if the 
+ *          `left` entry is less than the `right` entry, or a positive value if it is greater. 
+ *          Entries imported by ordinal are less than all named entries.
+ */
+static ZyanI32 ZyrexCompareImportEntry(const ZyrexImportEntry* left, 
+    const ZyrexImportEntry* right)
+{
+    ZYAN_ASSERT(left);
+    ZYAN_ASSERT(right);
+
+    if (!left->function_name || !right->function_name)
+    {
+        if (left->function_name)
+        {
+            return 1;
+        }
+        if (right->function_name)
+        {
+            return -1;
+        }
+        return (ZyanI32)left->ordinal - (ZyanI32)right->ordinal;
+    }
+
+    return ZYAN_STRCMP(left->function_name, right->function_name);
+}
+
+/**
+ * @brief   Compares two module names (ASCII, case-insensitive).
+ *
+ * @param   left    The first module name.
+ * @param   right   The second module name.
+ *
+ * @return  `ZYAN_TRUE`, if both names are equal, `ZYAN_FALSE` if not.
+ */
+static ZyanBool ZyrexModuleNameEquals(const char* left, const char* right)
+{
+    ZYAN_ASSERT(left);
+    ZYAN_ASSERT(right);
+
+    for (;; ++left, ++right)
+    {
+        char a = *left;
+        char b = *right;
+        if ((a >= 'A') && (a <= 'Z'))
+        {
+            a = (char)(a - 'A' + 'a');
+        }
+        if ((b >= 'A') && (b <= 'Z'))
+        {
+            b = (char)(b - 'A' + 'a');
+        }
+        if (a != b)
+        {
+            return ZYAN_FALSE;
+        }
+        if (!a)
+        {
+            return ZYAN_TRUE;
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Import table                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexImportTable` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareImportTable, ZyrexImportTable, base);
+
+/**
+ * @brief   Finalizes the given `ZyrexImportTable` item.
+ *
+ * @param   item    A pointer to the `ZyrexImportTable` item.
+ */
+static void ZyrexImportTableDestroy(ZyrexImportTable* item)
+{
+    ZYAN_ASSERT(item);
+
+    ZyanVectorDestroy(&item->entries);
+}
+
+/**
+ * @brief   Returns the NT headers of the given `module`.
+ *
+ * @param   module  The base address of the module.
+ *
+ * @return  A pointer to the NT headers of the given `module` or `ZYAN_NULL`, if the `module` 
+ *          does not start with a valid PE header.
+ */
+static const IMAGE_NT_HEADERS* ZyrexImportTableGetHeaders(const void* module)
+{
+    ZYAN_ASSERT(module);
+
+    const IMAGE_DOS_HEADER* const dos_header = (const IMAGE_DOS_HEADER*)module;
+    if (dos_header->e_magic != IMAGE_DOS_SIGNATURE)
+    {
+        return ZYAN_NULL;
+    }
+
+    const IMAGE_NT_HEADERS* const nt_headers = 
+        (const IMAGE_NT_HEADERS*)((const ZyanU8*)module + dos_header->e_lfanew);
+    if (nt_headers->Signature != IMAGE_NT_SIGNATURE)
+    {
+        return ZYAN_NULL;
+    }
+
+    return nt_headers;
+}
+
+/**
+ * @brief   Parses the import directory of the module described by the given `table`.
+ *
+ * @param   table       A pointer to the `ZyrexImportTable` struct.
+ * @param   nt_headers  A pointer to the NT headers of the module.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTableParse(ZyrexImportTable* table, 
+    const IMAGE_NT_HEADERS* nt_headers)
+{
+    ZYAN_ASSERT(table);
+    ZYAN_ASSERT(nt_headers);
+
+    table->time_date_stamp = nt_headers->FileHeader.TimeDateStamp;
+    table->size_of_image = nt_headers->OptionalHeader.SizeOfImage;
+
+    const IMAGE_DATA_DIRECTORY* const directory = 
+        &nt_headers->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+    if (!directory->VirtualAddress || !directory->Size)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanU8* const base = (ZyanU8*)table->base;
+    for (const IMAGE_IMPORT_DESCRIPTOR* descriptor = 
+        (const IMAGE_IMPORT_DESCRIPTOR*)(base + directory->VirtualAddress); descriptor->Name; 
+        ++descriptor)
+    {
+        // Modules without an import name table only provide the names until they are bound
+        const IMAGE_THUNK_DATA* const names = (const IMAGE_THUNK_DATA*)(base + 
+            (descriptor->OriginalFirstThunk ? 
+                descriptor->OriginalFirstThunk : descriptor->FirstThunk));
+        IMAGE_THUNK_DATA* const slots = (IMAGE_THUNK_DATA*)(base + descriptor->FirstThunk);
+
+        for (ZyanUSize i = 0; names[i].u1.AddressOfData; ++i)
+        {
+            ZyrexImportEntry entry;
+            entry.module_name = (const char*)(base + descriptor->Name);
+            entry.function_name = ZYAN_NULL;
+            entry.ordinal = 0;
+            entry.slot = (void**)&slots[i].u1.Function;
+
+            if (IMAGE_SNAP_BY_ORDINAL(names[i].u1.Ordinal))
+            {
+                entry.ordinal = (ZyanU16)IMAGE_ORDINAL(names[i].u1.Ordinal);
+            } else
+            {
+                entry.function_name = (const char*)((const IMAGE_IMPORT_BY_NAME*)
+                    (base + names[i].u1.AddressOfData))->Name;
+            }
+
+            ZyanUSize found_index;
+            ZYAN_CHECK(ZyanVectorBinarySearch(&table->entries, &entry, &found_index, 
+                (ZyanComparison)&ZyrexCompareImportEntry));
+            ZYAN_CHECK(ZyanVectorInsert(&table->entries, found_index, &entry));
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Returns the cached import table of the given `module` and parses it, if required.
+ *
+ * @param   module  The base address of the module.
+ * @param   table   Receives a pointer to the `ZyrexImportTable` of the module.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexImportTableGet(const void* module, const ZyrexImportTable** table)
+{
+    ZYAN_ASSERT(module);
+    ZYAN_ASSERT(table);
+
+    const IMAGE_NT_HEADERS* const nt_headers = ZyrexImportTableGetHeaders(module);
+    if (!nt_headers)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (!g_import_tables.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_import_tables, sizeof(ZyrexImportTable), 8, 
+            (ZyanMemberProcedure)&ZyrexImportTableDestroy));
+    }
+
+    ZyrexImportTable item;
+    item.base = (ZyanUPointer)module;
+
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(&g_import_tables, &item, &found_index, 
+        (ZyanComparison)&ZyrexCompareImportTable);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        ZyrexImportTable* const cached = ZyanVectorGetMutable(&g_import_tables, found_index);
+        ZYAN_ASSERT(cached);
+
+        if ((cached->time_date_stamp == nt_headers->FileHeader.TimeDateStamp) && 
+            (cached->size_of_image == nt_headers->OptionalHeader.SizeOfImage))
+        {
+            *table = cached;
+            return ZYAN_STATUS_SUCCESS;
+        }
+
+        // A different module was loaded at the same address
+        ZYAN_CHECK(ZyanVectorClear(&cached->entries));
+        const ZyanStatus status_parse = ZyrexImportTableParse(cached, nt_headers);
+        if (!ZYAN_SUCCESS(status_parse))
+        {
+            ZYAN_UNUSED(ZyanVectorDelete(&g_import_tables, found_index));
+            return status_parse;
+        }
+
+        *table = cached;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZYAN_CHECK(ZyanVectorInit(&item.entries, sizeof(ZyrexImportEntry), 64, ZYAN_NULL));
+    ZyanStatus status_insert = ZyrexImportTableParse(&item, nt_headers);
+    if (ZYAN_SUCCESS(status_insert))
+    {
+        status_insert = ZyanVectorInsert(&g_import_tables, found_index, &item);
+    }
+    if (!ZYAN_SUCCESS(status_insert))
+    {
+        ZyrexImportTableDestroy(&item);
+        return status_insert;
+    }
+
+    *table = ZyanVectorGet(&g_import_tables, found_index);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Import table                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexImportTableFindSlot(const void* module, const char* import_module, 
+    const char* import_name, void*** slot)
+{
+    if (!module || !import_name || !slot)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyrexImportTable* table;
+    ZYAN_CHECK(ZyrexImportTableGet(module, &table));
+
+    ZyrexImportEntry key;
+    key.module_name = import_module;
+    key.function_name = ZYAN_NULL;
+    key.ordinal = 0;
+    key.slot = ZYAN_NULL;
+    if ((ZyanUPointer)import_name <= 0xFFFF)
+    {
+        key.ordinal = (ZyanU16)(ZyanUPointer)import_name;
+    } else
+    {
+        key.function_name = import_name;
+    }
+
+    // Find the first entry that is not less than the key
+    ZyanUSize lo = 0;
+    ZyanUSize hi = table->entries.size;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        const ZyrexImportEntry* const entry = ZyanVectorGet(&table->entries, mid);
+        ZYAN_ASSERT(entry);
+
+        if (ZyrexCompareImportEntry(entry, &key) < 0)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    // Multiple modules might export a function with the same name
+    for (; lo < table->entries.size; ++lo)
+    {
+        const ZyrexImportEntry* const entry = ZyanVectorGet(&table->entries, lo);
+        ZYAN_ASSERT(entry);
+
+        if (ZyrexCompareImportEntry(entry, &key) != 0)
+        {
+            break;
+        }
+        if (!import_module || ZyrexModuleNameEquals(entry->module_name, import_module))
+        {
+            *slot = entry->slot;
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    return ZYAN_STATUS_NOT_FOUND;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+
+#endif
\ No newline at end of file
@@ -36,16 +36,77 @@
 /* Runtime thread migration                                                                       */
 /* ---------------------------------------------------------------------------------------------- */
 
+ZyanStatus ZyrexMigrateInstructionPointer(ZyanUPointer* instruction_pointer, const void* source, 
+    ZyanUSize source_length, const void* destination, ZyanUSize destination_length, 
+    const ZyrexInstructionTranslationMap* translation_map, ZyanBool reverse)
+{
+    ZYAN_ASSERT(instruction_pointer);
+    ZYAN_ASSERT(translation_map);
+
+    ZYAN_UNUSED(destination_length);
+
+    const ZyanUPointer current_ip = *instruction_pointer;
+    if ((current_ip < (ZyanUPointer)source) || 
+        (current_ip >= (ZyanUPointer)source + source_length))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyanU8 source_offset = (ZyanU8)(current_ip - (ZyanUPointer)source);
+    for (ZyanUSize i = 0; i < translation_map->count; ++i)
+    {
+        const ZyrexInstructionTranslationItem* const item = &translation_map->items[i];
+        if ((reverse ? item->offset_destination : item->offset_source) != source_offset)
+        {
+            continue;
+        }
+
+        *instruction_pointer = (ZyanUPointer)destination + 
+            (reverse ? item->offset_source : item->offset_destination);
+
+        return ZYAN_STATUS_TRUE;
+    }
+
+    // The instruction pointer does not point to the start of a translated instruction
+    return ZYAN_STATUS_NOT_FOUND;
+}
+
 #ifdef ZYAN_WINDOWS
 
+ZyanStatus ZyrexMigrateThreadContext(CONTEXT* context, const void* source, 
+    ZyanUSize source_length, const void* destination, ZyanUSize destination_length, 
+    const ZyrexInstructionTranslationMap* translation_map, ZyanBool reverse)
+{
+    ZYAN_ASSERT(context);
+
+#if defined(ZYAN_X64)
+    ZyanUPointer instruction_pointer = context->Rip;
+#elif defined(ZYAN_X86)
+    ZyanUPointer instruction_pointer = context->Eip;
+#else
+#   error "Unsupported architecture detected"
+#endif
+
+    const ZyanStatus status = ZyrexMigrateInstructionPointer(&instruction_pointer, source, 
+        source_length, destination, destination_length, translation_map, reverse);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+#if defined(ZYAN_X64)
+        context->Rip = instruction_pointer;
+#elif defined(ZYAN_X86)
+        context->Eip = (DWORD)instruction_pointer;
+#else
+#   error "Unsupported architecture detected"
+#endif
+    }
+
+    return status;
+}
+
 ZyanStatus ZyrexMigrateThread(DWORD thread_id, const void* source, ZyanUSize source_length, 
     const void* destination, ZyanUSize destination_length, 
     const ZyrexInstructionTranslationMap* translation_map)
 {
-    ZYAN_UNUSED(destination_length);
-
-    ZyanStatus status = ZYAN_STATUS_SUCCESS;
-
     HANDLE const handle = 
         OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, 
             (BOOL)ZYAN_FALSE, thread_id);
@@ -61,8 +122,10 @@ ZyanStatus ZyrexMigrateThread(DWORD thread_id, const void* source, ZyanUSize sou
         return ZYAN_STATUS_BAD_SYSTEMCALL;
     }
 
-    CONTEXT context = { 0 };
-    //ZYAN_MEMSET(&context, 0, sizeof(context));
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+
+    CONTEXT context;
+    ZYAN_MEMSET(&context, 0, sizeof(context));
     context.ContextFlags = CONTEXT_CONTROL;
     if (!GetThreadContext(handle, &context))
     {
@@ -70,43 +133,19 @@ ZyanStatus ZyrexMigrateThread(DWORD thread_id, const void* source, ZyanUSize sou
         goto CleanupAndResume;
     }
 
-#if defined(ZYAN_X64)
-    const ZyanUPointer current_ip = context.Rip;
-#elif defined(ZYAN_X86)
-    const ZyanUPointer current_ip = context.Eip;
-#else
-#   error "Unsupported architecture detected"
-#endif
-    if ((current_ip < (ZyanUPointer)source) || (current_ip > (ZyanUPointer)source + source_length))
+    status = ZyrexMigrateThreadContext(&context, source, source_length, destination, 
+        destination_length, translation_map, ZYAN_FALSE);
+    if (status == ZYAN_STATUS_TRUE)
     {
-        goto CleanupAndResume;       
-    }
-
-    const ZyanUPointer source_offset = (ZyanUPointer)source - current_ip;
-    for (ZyanUSize i = 0; i < translation_map->count; ++i)
+        status = SetThreadContext(handle, &context) 
+            ? ZYAN_STATUS_SUCCESS 
+            : ZYAN_STATUS_BAD_SYSTEMCALL;
+    } else
+    if (status == ZYAN_STATUS_FALSE)
     {
-        if (translation_map->items[i].offset_source == (ZyanU8)source_offset)
-        {
-#if defined(ZYAN_X64)
-    context.Rip = (ZyanUPointer)destination + translation_map->items[i].offset_destination;
-#elif defined(ZYAN_X86)
-    context.Eip = (ZyanUPointer)destination + translation_map->items[i].offset_destination;
-#else
-#   error "Unsupported architecture detected"
-#endif
-
-            if (!SetThreadContext(handle, &context))
-            {
-                status = ZYAN_STATUS_BAD_SYSTEMCALL;
-            }
-
-            goto CleanupAndResume;
-        }
+        status = ZYAN_STATUS_SUCCESS;
     }
 
-    // This should never happen
-    ZYAN_UNREACHABLE;
-
 CleanupAndResume:
     while (ZYAN_TRUE)
     {
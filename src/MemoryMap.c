@@ -0,0 +1,596 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/Comparison.h>
+#include <Zycore/Defines.h>
+#include <Zycore/LibC.h>
+#include <Zycore/Vector.h>
+#include <Zyrex/Internal/MemoryMap.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <stdio.h>
+#   include <stdlib.h>
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+#ifdef ZYAN_POSIX
+
+/**
+ * @brief   Defines the lowest address that is considered for new memory blocks.
+ */
+#define ZYREX_MEMORY_MAP_MIN_ADDRESS    0x10000
+
+/**
+ * @brief   Defines the highest address (exclusive) that is considered for new memory blocks.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_MEMORY_MAP_MAX_ADDRESS 0x00007FFFFFFF0000
+#else
+#   define ZYREX_MEMORY_MAP_MAX_ADDRESS 0xFFFF0000
+#endif
+
+#endif
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains the cached memory map of the current process.
+ *
+ * The map is only accessed by the trampoline allocator and the thread update functions, which
+ * always hold the region lock.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the memory map has been built.
+     */
+    ZyanBool is_initialized;
+    /**
+     * @brief   The lowest address that is considered for new memory blocks.
+     */
+    ZyanUPointer min_address;
+    /**
+     * @brief   The highest address (exclusive) that is considered for new memory blocks.
+     */
+    ZyanUPointer max_address;
+    /**
+     * @brief   Contains all mapped memory ranges (sorted by address).
+     */
+    ZyanVector/*<ZyrexMemoryRange>*/ ranges;
+} g_memory_map =
+{
+    ZYAN_FALSE, 0, 0, ZYAN_VECTOR_INITIALIZER
+};
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* ZyanVector<ZyrexMemoryRange>                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexMemoryRange` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareMemoryRange, ZyrexMemoryRange, start);
+
+/**
+ * @brief   Returns the index of the first memory range that starts above the given `address`.
+ *
+ * @param   address The address.
+ *
+ * @return  The index of the first memory range that starts above the given `address` or the
+ *          number of ranges, if there is none.
+ */
+static ZyanUSize ZyrexMemoryMapUpperBound(ZyanUPointer address)
+{
+    ZyanUSize lo = 0;
+    ZyanUSize hi = g_memory_map.ranges.size;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        const ZyrexMemoryRange* const range = ZyanVectorGet(&g_memory_map.ranges, mid);
+        ZYAN_ASSERT(range);
+
+        if (range->start <= address)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Platform specific                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+#if   defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   Reads all allocations of the current process by walking the address space with 
+ *          `VirtualQuery`.
+ *
+ * @param   ranges  A pointer to the `ZyanVector` that receives the `ZyrexMemoryRange` items.
+ *
+ * @return  A zyan status code.
+ *
+ * Adjacent regions that belong to the same allocation are merged into a single range. Free 
+ * regions are skipped by a single query each, so the number of system calls is proportional to
+ * the number of allocations.
+ */
+static ZyanStatus ZyrexMemoryMapRead(ZyanVector* ranges)
+{
+    ZYAN_ASSERT(ranges);
+
+    MEMORY_BASIC_INFORMATION info;
+    ZyanUPointer address = g_memory_map.min_address;
+    while (address < g_memory_map.max_address)
+    {
+        ZYAN_MEMSET(&info, 0, sizeof(info));
+        if (!VirtualQuery((LPCVOID)address, &info, sizeof(info)))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        const ZyanUPointer end = (ZyanUPointer)info.BaseAddress + info.RegionSize;
+        if (end <= address)
+        {
+            break;
+        }
+        address = end;
+
+        if (info.State == MEM_FREE)
+        {
+            continue;
+        }
+
+        if (ranges->size > 0)
+        {
+            ZyrexMemoryRange* const previous = ZyanVectorGetMutable(ranges, ranges->size - 1);
+            ZYAN_ASSERT(previous);
+            if (previous->start == (ZyanUPointer)info.AllocationBase)
+            {
+                previous->end = end;
+                continue;
+            }
+        }
+
+        const ZyrexMemoryRange range = 
+        { 
+            (ZyanUPointer)info.AllocationBase, end, (ZyanU32)info.AllocationProtect
+        };
+        ZYAN_CHECK(ZyanVectorPushBack(ranges, &range));
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   Parses a hexadecimal number from the given string.
+ *
+ * @param   string  A pointer to the string. Receives a pointer to the first character following
+ *                  the number.
+ *
+ * @return  The parsed number.
+ */
+static ZyanUPointer ZyrexMemoryMapParseHex(const char** string)
+{
+    ZYAN_ASSERT(string && *string);
+
+    ZyanUPointer value = 0;
+    for (;; ++*string)
+    {
+        const char c = **string;
+        if ((c >= '0') && (c <= '9'))
+        {
+            value = (value << 4) | (ZyanUPointer)(c - '0');
+        } else
+        if ((c >= 'a') && (c <= 'f'))
+        {
+            value = (value << 4) | (ZyanUPointer)(c - 'a' + 10);
+        } else
+        {
+            break;
+        }
+    }
+
+    return value;
+}
+
+/**
+ * @brief   Reads all mapped memory ranges of the current process from `/proc/self/maps`.
+ *
+ * @param   ranges  A pointer to the `ZyanVector` that receives the `ZyrexMemoryRange` items.
+ *
+ * @return  A zyan status code.
+ *
+ * The kernel reports the ranges sorted by address, so no additional sorting is required.
+ */
+static ZyanStatus ZyrexMemoryMapRead(ZyanVector* ranges)
+{
+    ZYAN_ASSERT(ranges);
+
+    FILE* const file = fopen("/proc/self/maps", "r");
+    if (!file)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZyanBool is_continuation = ZYAN_FALSE;
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        // Skip the remainder of lines that did not fit into the buffer
+        const ZyanBool was_continuation = is_continuation;
+        is_continuation = !ZYAN_STRCHR(line, '\n');
+        if (was_continuation)
+        {
+            continue;
+        }
+
+        // Format: `start-end perms offset dev inode path`
+        const char* current = line;
+        ZyrexMemoryRange range;
+        range.start = ZyrexMemoryMapParseHex(&current);
+        if (*current++ != '-')
+        {
+            status = ZYAN_STATUS_INVALID_OPERATION;
+            break;
+        }
+        range.end = ZyrexMemoryMapParseHex(&current);
+        if ((*current++ != ' ') || (range.end <= range.start))
+        {
+            status = ZYAN_STATUS_INVALID_OPERATION;
+            break;
+        }
+        range.protection = PROT_NONE;
+        if (current[0] == 'r')
+        {
+            range.protection |= PROT_READ;
+        }
+        if ((current[0] != '\0') && (current[1] == 'w'))
+        {
+            range.protection |= PROT_WRITE;
+        }
+        if ((current[0] != '\0') && (current[1] != '\0') && (current[2] == 'x'))
+        {
+            range.protection |= PROT_EXEC;
+        }
+
+        status = ZyanVectorPushBack(ranges, &range);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+    }
+
+    if (fclose(file) && ZYAN_SUCCESS(status))
+    {
+        status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    return status;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Free blocks                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the bounds of the unmapped gap in front of the memory range with the given
+ *          `index`.
+ *
+ * @param   index   The index of the gap. The gap with index `n` is located between the ranges
+ *                  `n - 1` and `n`. The last gap follows the last range.
+ * @param   start   Receives the start address of the gap.
+ * @param   end     Receives the end address (exclusive) of the gap.
+ */
+static void ZyrexMemoryMapGetGap(ZyanUSize index, ZyanUPointer* start, ZyanUPointer* end)
+{
+    ZYAN_ASSERT(index <= g_memory_map.ranges.size);
+    ZYAN_ASSERT(start);
+    ZYAN_ASSERT(end);
+
+    *start = g_memory_map.min_address;
+    *end   = g_memory_map.max_address;
+    if (index > 0)
+    {
+        const ZyrexMemoryRange* const range = ZyanVectorGet(&g_memory_map.ranges, index - 1);
+        ZYAN_ASSERT(range);
+        *start = ZYAN_MAX(*start, range->end);
+    }
+    if (index < g_memory_map.ranges.size)
+    {
+        const ZyrexMemoryRange* const range = ZyanVectorGet(&g_memory_map.ranges, index);
+        ZYAN_ASSERT(range);
+        *end = ZYAN_MIN(*end, range->start);
+    }
+}
+
+/**
+ * @brief   Calculates the block inside the given gap that is closest to the given `address`.
+ *
+ * @param   start       The start address of the gap.
+ * @param   end         The end address (exclusive) of the gap.
+ * @param   address     The preferred address.
+ * @param   min_address The lowest acceptable start address of the block.
+ * @param   max_address The highest acceptable start address of the block.
+ * @param   size        The size of the block.
+ * @param   alignment   The alignment of the block start address.
+ * @param   result      Receives the start address of the block.
+ *
+ * @return  `ZYAN_TRUE` if the gap contains a matching block or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexMemoryMapGetGapBlock(ZyanUPointer start, ZyanUPointer end,
+    ZyanUPointer address, ZyanUPointer min_address, ZyanUPointer max_address, ZyanUSize size,
+    ZyanUSize alignment, ZyanUPointer* result)
+{
+    ZYAN_ASSERT(result);
+
+    if ((end <= start) || (end - start < size))
+    {
+        return ZYAN_FALSE;
+    }
+
+    const ZyanUPointer lo = ZYAN_ALIGN_UP(ZYAN_MAX(start, min_address), alignment);
+    const ZyanUPointer hi = ZYAN_ALIGN_DOWN(ZYAN_MIN(end - size, max_address), alignment);
+    if ((lo > hi) || (lo < start))
+    {
+        return ZYAN_FALSE;
+    }
+
+    const ZyanUPointer preferred = ZYAN_ALIGN_DOWN(address, alignment);
+    *result = (preferred < lo) ? lo : ((preferred > hi) ? hi : preferred);
+
+    return ZYAN_TRUE;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Memory map                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+void ZyrexMemoryMapInvalidate(void)
+{
+    g_memory_map.is_initialized = ZYAN_FALSE;
+}
+
+ZyanStatus ZyrexMemoryMapUpdate(void)
+{
+    if (!g_memory_map.ranges.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_memory_map.ranges, sizeof(ZyrexMemoryRange), 256, 
+            ZYAN_NULL));
+
+#if   defined(ZYAN_WINDOWS)
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        g_memory_map.min_address = (ZyanUPointer)system_info.lpMinimumApplicationAddress;
+        g_memory_map.max_address = (ZyanUPointer)system_info.lpMaximumApplicationAddress + 1;
+#elif defined(ZYAN_POSIX)
+        g_memory_map.min_address = ZYREX_MEMORY_MAP_MIN_ADDRESS;
+        g_memory_map.max_address = ZYREX_MEMORY_MAP_MAX_ADDRESS;
+#endif
+    }
+    ZYAN_CHECK(ZyanVectorClear(&g_memory_map.ranges));
+
+    const ZyanStatus status = ZyrexMemoryMapRead(&g_memory_map.ranges);
+
+    g_memory_map.is_initialized = ZYAN_SUCCESS(status);
+
+    return status;
+}
+
+ZyanStatus ZyrexMemoryMapFind(ZyanUPointer address, const ZyrexMemoryRange** range)
+{
+    if (!range)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanBool is_updated = ZYAN_FALSE;
+    if (!g_memory_map.is_initialized)
+    {
+        ZYAN_CHECK(ZyrexMemoryMapUpdate());
+        is_updated = ZYAN_TRUE;
+    }
+
+    while (ZYAN_TRUE)
+    {
+        const ZyanUSize index = ZyrexMemoryMapUpperBound(address);
+        if (index > 0)
+        {
+            const ZyrexMemoryRange* const item = ZyanVectorGet(&g_memory_map.ranges, index - 1);
+            ZYAN_ASSERT(item);
+            if (address < item->end)
+            {
+                *range = item;
+                return ZYAN_STATUS_TRUE;
+            }
+        }
+
+        if (is_updated)
+        {
+            return ZYAN_STATUS_FALSE;
+        }
+        ZYAN_CHECK(ZyrexMemoryMapUpdate());
+        is_updated = ZYAN_TRUE;
+    }
+}
+
+ZyanStatus ZyrexMemoryMapFindFree(ZyanUPointer address, ZyanUPointer min_address, 
+    ZyanUPointer max_address, ZyanUSize size, ZyanUSize alignment, ZyanUPointer* result)
+{
+    if (!size || !alignment || (alignment & (alignment - 1)) || (min_address > max_address) || 
+        !result)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    if (!g_memory_map.is_initialized)
+    {
+        ZYAN_CHECK(ZyrexMemoryMapUpdate());
+    }
+
+    // The gap with this index either contains the `address`, or directly follows the range that
+    // contains the `address`
+    const ZyanUSize index = ZyrexMemoryMapUpperBound(address);
+    const ZyanUSize count = g_memory_map.ranges.size;
+
+    ZyanUPointer start;
+    ZyanUPointer end;
+
+    // Walk downwards. The first matching block is the closest one in this direction
+    ZyanBool found_lo = ZYAN_FALSE;
+    ZyanUPointer block_lo = 0;
+    for (ZyanUSize i = index + 1; i-- > 0;)
+    {
+        ZyrexMemoryMapGetGap(i, &start, &end);
+        if (end <= min_address)
+        {
+            break;
+        }
+        if (ZyrexMemoryMapGetGapBlock(start, end, address, min_address, max_address, size, 
+            alignment, &block_lo))
+        {
+            found_lo = ZYAN_TRUE;
+            break;
+        }
+    }
+
+    // Walk upwards
+    ZyanBool found_hi = ZYAN_FALSE;
+    ZyanUPointer block_hi = 0;
+    for (ZyanUSize i = index + 1; i <= count; ++i)
+    {
+        ZyrexMemoryMapGetGap(i, &start, &end);
+        if (start > max_address)
+        {
+            break;
+        }
+        if (ZyrexMemoryMapGetGapBlock(start, end, address, min_address, max_address, size, 
+            alignment, &block_hi))
+        {
+            found_hi = ZYAN_TRUE;
+            break;
+        }
+    }
+
+    if (!found_lo && !found_hi)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+    if (found_lo && found_hi)
+    {
+        const ZyanUPointer distance_lo = 
+            (block_lo > address) ? block_lo - address : address - block_lo;
+        const ZyanUPointer distance_hi = 
+            (block_hi > address) ? block_hi - address : address - block_hi;
+        *result = (distance_lo <= distance_hi) ? block_lo : block_hi;
+    } else
+    {
+        *result = found_lo ? block_lo : block_hi;
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+ZyanStatus ZyrexMemoryMapInsert(ZyanUPointer address, ZyanUSize size, ZyanU32 protection)
+{
+    if (!size)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_memory_map.is_initialized)
+    {
+        // The range is going to be contained in the map once it gets built
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyrexMemoryRange range = { address, address + size, protection };
+
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(&g_memory_map.ranges, &range, &found_index,
+        (ZyanComparison)&ZyrexCompareMemoryRange);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        return ZyanVectorSet(&g_memory_map.ranges, found_index, &range);
+    }
+
+    return ZyanVectorInsert(&g_memory_map.ranges, found_index, &range);
+}
+
+ZyanStatus ZyrexMemoryMapRemove(ZyanUPointer address)
+{
+    if (!g_memory_map.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyrexMemoryRange range = { address, address, 0 };
+
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(&g_memory_map.ranges, &range, &found_index,
+        (ZyanComparison)&ZyrexCompareMemoryRange);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    return ZyanVectorDelete(&g_memory_map.ranges, found_index);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
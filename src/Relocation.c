@@ -27,7 +27,6 @@
 #include <Zycore/LibC.h>
 #include <Zycore/Status.h>
 #include <Zycore/Types.h>
-#include <Zycore/Vector.h>
 #include <Zydis/Zydis.h>
 #include <Zyrex/Internal/Relocation.h>
 
@@ -79,7 +78,11 @@ typedef struct ZyrexAnalyzedInstruction_
      * @brief   Contains the ids of all instructions inside the analyzed code chunk that are
      *          targeting this instruction using a relative offset.
      */
-    ZyanVector/*<ZyanU8>*/ incomming;
+    ZyanU8 incomming[ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT];
+    /**
+     * @brief   The number of valid items in the `incomming` array.
+     */
+    ZyanU8 incomming_count;
     /**
      * @brief   The id of an instruction inside the analyzed code chunk which is targeted by
      *          this instruction using a relative offset, or `-1` if not applicable.
@@ -104,7 +107,11 @@ typedef struct ZyrexRelocationContext_
      * @brief   Contains a `ZyrexAnalyzedInstruction` struct for each instruction in the source
      *          buffer.
      */
-    ZyanVector/*<ZyrexAnalyzedInstruction>*/ instructions;
+    ZyrexAnalyzedInstruction instructions[ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT];
+    /**
+     * @brief   The number of valid items in the `instructions` array.
+     */
+    ZyanU8 instruction_count;
     /**
      * @brief   A pointer to the source buffer.
      */
@@ -125,6 +132,10 @@ typedef struct ZyrexRelocationContext_
      * @brief   The instruction translation map.
      */
     ZyrexInstructionTranslationMap* translation_map;
+    /**
+     * @brief   Receives the fixups of the relocated code or `ZYAN_NULL`, if not requested.
+     */
+    ZyrexRelocationFixups* fixups;
     /**
      * @brief   The number of instructions read from the source buffer.
      */
@@ -146,27 +157,30 @@ typedef struct ZyrexRelocationContext_
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
-/* Internal functions                                                                             */
+/* Globals                                                                                        */
 /* ============================================================================================== */
 
-/* ---------------------------------------------------------------------------------------------- */
-/* ZyrexAnalyzedInstruction                                                                       */
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Finalizes the given `ZyrexAnalyzedInstruction` struct.
- *
- * @param   item    A pointer to the `ZyrexAnalyzedInstruction` struct.
+ * @brief   Contains the shared instruction decoder.
  */
-static void ZyrexAnalyzedInstructionDestroy(ZyrexAnalyzedInstruction* item)
+static struct
+{
+    /**
+     * @brief   Signals, if the decoder is initialized.
+     */
+    volatile ZyanBool is_initialized;
+    /**
+     * @brief   The decoder instance.
+     */
+    ZydisDecoder decoder;
+} g_decoder_data =
 {
-    ZYAN_ASSERT(item);
+    ZYAN_FALSE
+};
 
-    if (item->is_internal_target)
-    {
-        ZyanVectorDestroy(&item->incomming);   
-    }
-}
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
 
 /* ---------------------------------------------------------------------------------------------- */
 /* Instruction analysis                                                                           */
@@ -179,101 +193,116 @@ static void ZyrexAnalyzedInstructionDestroy(ZyrexAnalyzedInstruction* item)
  * @param   length              The length of the buffer.
  * @param   bytes_to_analyze    The minimum number of bytes to analyze. More bytes might get
  *                              accessed on demand to keep individual instructions intact.
- * @param   instructions        Returns a new `ZyanVector` instance which contains all analyzed
- *                              instructions.
- *                              The vector needs to manually get destroyed by calling
- *                              `ZyanVectorDestroy` when no longer needed.
+ * @param   instructions        Receives a `ZyrexAnalyzedInstruction` struct for each analyzed
+ *                              instruction. The array must be able to hold
+ *                              `ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT` items.
+ * @param   instruction_count   Receives the number of analyzed instructions.
  * @param   bytes_read          Returns the exact amount of bytes read from the buffer.
  *
  * @return  A zyan status code.
+ *
+ * This function does not allocate any heap memory.
  */
 static ZyanStatus ZyrexAnalyzeCode(const void* buffer, ZyanUSize length, 
-    ZyanUSize bytes_to_analyze, ZyanVector/*<ZyrexAnalyzedInstruction>*/* instructions,
-    ZyanUSize* bytes_read)
+    ZyanUSize bytes_to_analyze, ZyrexAnalyzedInstruction* instructions, 
+    ZyanU8* instruction_count, ZyanUSize* bytes_read)
 {
     ZYAN_ASSERT(buffer);
     ZYAN_ASSERT(length);
     ZYAN_ASSERT(bytes_to_analyze);
+    ZYAN_ASSERT(instructions);
+    ZYAN_ASSERT(instruction_count);
 
-    ZydisDecoder decoder;
-#if defined(ZYAN_X86)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_ADDRESS_WIDTH_32);
-#elif defined(ZYAN_X64)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_ADDRESS_WIDTH_64);
-#else
-#   error "Unsupported architecture detected"
-#endif
-
-    ZYAN_CHECK(ZyanVectorInit(instructions, sizeof(ZyrexAnalyzedInstruction), 
-        ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT, 
-        (ZyanMemberProcedure)&ZyrexAnalyzedInstructionDestroy));
+    const ZydisDecoder* const decoder = ZyrexGetDecoder();
 
     // First pass:
     //   - Determine exact amount of instructions and instruction bytes
     //   - Decode all instructions and calculate relative target address for instructions with
     //     relative offsets
     //
+    ZyanU8 count = 0;
     ZyanUSize offset = 0;
     while (offset < bytes_to_analyze)
     {
-        ZyrexAnalyzedInstruction item;
+        if (count == ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT)
+        {
+            return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+        }
+
+        ZyrexAnalyzedInstruction* const item = &instructions[count];
 
-        ZYAN_CHECK(ZydisDecoderDecodeBuffer(&decoder, (const ZyanU8*)buffer + offset,
-            length - offset, &item.instruction));
+        ZYAN_CHECK(ZydisDecoderDecodeBuffer(decoder, (const ZyanU8*)buffer + offset,
+            length - offset, &item->instruction));
 
-        item.address_offset = offset;
-        item.address = (ZyanUPointer)(const ZyanU8*)buffer + offset;
-        item.has_relative_target = (item.instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
+        item->address_offset = offset;
+        item->address = (ZyanUPointer)(const ZyanU8*)buffer + offset;
+        item->has_relative_target = (item->instruction.attributes & ZYDIS_ATTRIB_IS_RELATIVE)
             ? ZYAN_TRUE
             : ZYAN_FALSE;
-        item.has_external_target = item.has_relative_target;
-        item.absolute_target_address = 0;
-        if (item.has_relative_target)
+        item->has_external_target = item->has_relative_target;
+        item->absolute_target_address = 0;
+        if (item->has_relative_target)
         {
-            ZYAN_CHECK(ZyrexCalcAbsoluteAddress(&item.instruction, 
-                (ZyanU64)buffer + offset, &item.absolute_target_address));    
+            ZYAN_CHECK(ZyrexCalcAbsoluteAddress(&item->instruction, 
+                (ZyanU64)buffer + offset, &item->absolute_target_address));    
         }
-        item.is_internal_target = ZYAN_FALSE;
-        item.outgoing = (ZyanU8)(-1);
-        ZYAN_CHECK(ZyanVectorPushBack(instructions, &item));
+        item->is_internal_target = ZYAN_FALSE;
+        item->incomming_count = 0;
+        item->outgoing = (ZyanU8)(-1);
+        ++count;
 
-        offset += item.instruction.length;
+        offset += item->instruction.length;
     }
 
     ZYAN_ASSERT(offset >= bytes_to_analyze);
+    *instruction_count = count;
     *bytes_read = offset;
 
     // Second pass:
     //   - Find internal outgoing target for instructions with relative offsets
     //   - Find internal incoming targets from instructions with relative offsets
     //
-    for (ZyanUSize i = 0; i < instructions->size; ++i)
+    // The instructions are sorted by address, which allows us to lookup the target instruction
+    // using a binary search
+    //
+    for (ZyanU8 i = 0; i < count; ++i)
     {
-        ZyrexAnalyzedInstruction* const current = ZyanVectorGetMutable(instructions, i);
-        ZYAN_ASSERT(current);
-
-        for (ZyanUSize j = 0; j < instructions->size; ++j)
+        ZyrexAnalyzedInstruction* const item = &instructions[i];
+        if (!item->has_relative_target ||
+            (item->absolute_target_address < (ZyanU64)(ZyanUPointer)buffer) ||
+            (item->absolute_target_address >= (ZyanU64)(ZyanUPointer)buffer + offset))
         {
-            ZyrexAnalyzedInstruction* const item = ZyanVectorGetMutable(instructions, j);
-            ZYAN_ASSERT(item);
+            continue;
+        }
 
-            if (item->has_relative_target && (item->absolute_target_address == current->address))
+        ZyanU8 lo = 0;
+        ZyanU8 hi = count;
+        while (lo < hi)
+        {
+            const ZyanU8 mid = lo + (hi - lo) / 2;
+            if (instructions[mid].address < item->absolute_target_address)
             {
-                // The `item` instruction targets the `current` instruction
-                item->has_external_target = ZYAN_FALSE;
-                item->outgoing = (ZyanU8)i;
-
-                // The `current` instruction is an internal target of the `item` instruction
-                if (!current->is_internal_target)
-                {
-                    current->is_internal_target = ZYAN_TRUE;
-                    ZYAN_CHECK(ZyanVectorInit(&current->incomming, sizeof(ZyanU8), 2, 
-                        ZYAN_NULL));    
-                }
-                const ZyanU8 value = (ZyanU8)j;
-                ZYAN_CHECK(ZyanVectorPushBack(&current->incomming, &value));
+                lo = mid + 1;
+            } else
+            {
+                hi = mid;
             }
         }
+        if ((lo == count) || (instructions[lo].address != item->absolute_target_address))
+        {
+            // The target is located in the middle of an instruction
+            continue;
+        }
+
+        // The `item` instruction targets the `current` instruction
+        ZyrexAnalyzedInstruction* const current = &instructions[lo];
+        item->has_external_target = ZYAN_FALSE;
+        item->outgoing = lo;
+
+        // The `current` instruction is an internal target of the `item` instruction
+        ZYAN_ASSERT(current->incomming_count < ZYAN_ARRAY_LENGTH(current->incomming));
+        current->is_internal_target = ZYAN_TRUE;
+        current->incomming[current->incomming_count++] = i;
     }
     
     return ZYAN_STATUS_SUCCESS;
@@ -426,6 +455,84 @@ static void ZyrexUpdateRelocationContext(ZyrexRelocationContext* context, ZyanUS
     context->bytes_written += length;
 }
 
+/**
+ * @brief   Records a fixup for a relative value that refers to an address outside of the 
+ *          relocated code chunk.
+ *
+ * @param   context     A pointer to the `ZyrexRelocationContext` struct.
+ * @param   address     The address of the relative value in the destination buffer.
+ * @param   size        The size of the relative value (in bits).
+ * @param   base        The address the relative value is calculated from.
+ * @param   target      The absolute target address.
+ */
+static void ZyrexRecordRelocationFixup(ZyrexRelocationContext* context, const void* address,
+    ZyanU8 size, ZyanUPointer base, ZyanU64 target)
+{
+    ZYAN_ASSERT(context);
+    ZYAN_ASSERT(address);
+
+    if (!context->fixups)
+    {
+        return;
+    }
+
+    ZYAN_ASSERT(context->fixups->count < ZYAN_ARRAY_LENGTH(context->fixups->items));
+
+    ZyrexRelocationFixup* const fixup = &context->fixups->items[context->fixups->count++];
+    fixup->target = (ZyanI64)(target - (ZyanU64)(ZyanUPointer)context->source);
+    fixup->offset = (ZyanU8)((ZyanUPointer)address - (ZyanUPointer)context->destination);
+    fixup->size = size;
+    fixup->base = (ZyanU8)(base - (ZyanUPointer)context->destination);
+}
+
+/**
+ * @brief   Calculates the relative value of the given `fixup`.
+ *
+ * @param   source      The runtime address of the source code.
+ * @param   destination The runtime address of the destination code.
+ * @param   fixup       A pointer to the `ZyrexRelocationFixup` struct.
+ * @param   value       Receives the relative value.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if the relative value fits into the size of the fixup, or
+ *          `ZYAN_STATUS_OUT_OF_RANGE`, if not.
+ */
+static ZyanStatus ZyrexCalculateRelocationFixup(ZyanUPointer source, ZyanUPointer destination,
+    const ZyrexRelocationFixup* fixup, ZyanI32* value)
+{
+    ZYAN_ASSERT(fixup);
+    ZYAN_ASSERT(value);
+
+    const ZyanUPointer target = (ZyanUPointer)((ZyanI64)source + fixup->target);
+    const ZyanI64 offset = (ZyanI64)(ZyanIPointer)(target - (destination + fixup->base));
+
+    switch (fixup->size)
+    {
+    case  8:
+        if (offset != (ZyanI8)offset)
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        break;
+    case 16:
+        if (offset != (ZyanI16)offset)
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        break;
+    case 32:
+        if (offset != (ZyanI32)offset)
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        break;
+    default:
+        ZYAN_UNREACHABLE;
+    }
+
+    *value = (ZyanI32)offset;
+    return ZYAN_STATUS_SUCCESS;
+}
+
 /**
  * @brief   Relocates a single common instruction (without a relative offset) and updates the
  *          relocation-context.
@@ -525,6 +632,9 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
 
             // Generate `JMP` to `1` branch
             ZyrexWriteRelativeJump(address, (ZyanUPointer)instruction->absolute_target_address);
+            ZyrexRecordRelocationFixup(context, address + 1, 32, 
+                (ZyanUPointer)address + ZYREX_SIZEOF_RELATIVE_JUMP, 
+                instruction->absolute_target_address);
             ZyrexUpdateRelocationContext(context, 2, (ZyanU8)context->bytes_read, 
                 (ZyanU8)context->bytes_written + instruction->instruction.length + 2);
 
@@ -580,6 +690,8 @@ static ZyanStatus ZyrexRelocateRelativeBranchInstruction(ZyrexRelocationContext*
         *(ZyanI32*)(address) = 
             ZyrexCalculateRelativeOffset(length, (ZyanUPointer)address, 
                 (ZyanUPointer)instruction->absolute_target_address);
+        ZyrexRecordRelocationFixup(context, address, 32, (ZyanUPointer)address + length, 
+            instruction->absolute_target_address);
 
         // Update relocation context
         ZyrexUpdateRelocationContext(context, length, (ZyanU8)context->bytes_read, 
@@ -630,6 +742,9 @@ static ZyanStatus ZyrexRelocateRelativeMemoryInstruction(ZyrexRelocationContext*
         default:
             ZYAN_UNREACHABLE;
         }
+        ZyrexRecordRelocationFixup(context, offset_address, instruction->instruction.raw.disp.size,
+            (ZyanUPointer)context->destination + context->bytes_written + 
+            instruction->instruction.length, instruction->absolute_target_address);
 
         return ZYAN_STATUS_SUCCESS;
     }
@@ -702,7 +817,7 @@ static ZyanStatus ZyrexGetRelocatedInstructionOffset(ZyrexRelocationContext* con
 {
     ZYAN_ASSERT(context);
     ZYAN_ASSERT(offset_destination);
-    ZYAN_ASSERT(context->instructions.size <= context->translation_map->count);
+    ZYAN_ASSERT(context->instruction_count <= context->translation_map->count);
 
     for (ZyanUSize i = 0; i < context->translation_map->count; ++i)
     {
@@ -733,10 +848,9 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
 {
     ZYAN_ASSERT(context);
 
-    for (ZyanUSize i = 0; i < context->instructions.size; ++i)
+    for (ZyanU8 i = 0; i < context->instruction_count; ++i)
     {
-        const ZyrexAnalyzedInstruction* const instruction = 
-            ZyanVectorGet(&context->instructions, i);
+        const ZyrexAnalyzedInstruction* const instruction = &context->instructions[i];
 
         if (!instruction->has_relative_target || instruction->has_external_target)
         {
@@ -770,9 +884,9 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
             &offset_instruction));
 
         // Lookup the offset of the destination instruction in the destination buffer
+        ZYAN_ASSERT(instruction->outgoing < context->instruction_count);
         const ZyrexAnalyzedInstruction* const destination = 
-            ZyanVectorGet(&context->instructions, instruction->outgoing);
-        ZYAN_ASSERT(destination);
+            &context->instructions[instruction->outgoing];
         ZyanU8 offset_destination;
         ZYAN_CHECK(ZyrexGetRelocatedInstructionOffset(context, (ZyanU8)destination->address_offset, 
             &offset_destination));
@@ -800,9 +914,37 @@ static ZyanStatus ZyrexUpdateInstructionOffsets(ZyrexRelocationContext* context)
 /* Functions                                                                                      */
 /* ============================================================================================== */
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Decoder                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+const ZydisDecoder* ZyrexGetDecoder(void)
+{
+    if (!g_decoder_data.is_initialized)
+    {
+        // Concurrent initialization is harmless, as every thread writes the exact same state
+#if defined(ZYAN_X86)
+        ZydisDecoderInit(&g_decoder_data.decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, 
+            ZYDIS_ADDRESS_WIDTH_32);
+#elif defined(ZYAN_X64)
+        ZydisDecoderInit(&g_decoder_data.decoder, ZYDIS_MACHINE_MODE_LONG_64, 
+            ZYDIS_ADDRESS_WIDTH_64);
+#else
+#   error "Unsupported architecture detected"
+#endif
+        g_decoder_data.is_initialized = ZYAN_TRUE;
+    }
+
+    return &g_decoder_data.decoder;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
 ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length, 
     ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
-    ZyanUSize* bytes_written)
+    ZyanUSize* bytes_written, ZyrexRelocationFixups* fixups)
 {
     ZYAN_ASSERT(source);
     ZYAN_ASSERT(source_length);
@@ -813,31 +955,37 @@ ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length,
 
     ZyrexRelocationContext context;
     context.bytes_to_reloc       = 0;
+    context.instruction_count    = 0;
     context.source               = source;
     context.source_length        = source_length;
-    context.destination          = &trampoline->code_buffer;
+    context.destination          = &trampoline->code->code_buffer;
     context.destination_length   = ZYREX_TRAMPOLINE_MAX_CODE_SIZE + 
                                    ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS;
     context.translation_map      = &trampoline->translation_map;
+    context.fixups               = fixups;
     context.instructions_read    = 0;
     context.instructions_written = 0;
     context.bytes_read           = 0;
     context.bytes_written        = 0;
 
-    ZYAN_CHECK(ZyrexAnalyzeCode(source, source_length, min_bytes_to_reloc, &context.instructions, 
-        &context.bytes_to_reloc));
-    ZYAN_ASSERT(context.instructions.data);
+    context.translation_map->count = 0;
+    if (fixups)
+    {
+        fixups->count = 0;
+    }
+
+    ZYAN_CHECK(ZyrexAnalyzeCode(source, source_length, min_bytes_to_reloc, context.instructions, 
+        &context.instruction_count, &context.bytes_to_reloc));
 
     // Relocate instructions
-    for (ZyanUSize i = 0; i < context.instructions.size; ++i)
+    for (ZyanU8 i = 0; i < context.instruction_count; ++i)
     {
         // The code buffer is full
         ZYAN_ASSERT(context.bytes_written < context.destination_length);
         // The translation map is full
         ZYAN_ASSERT(context.instructions_read < ZYAN_ARRAY_LENGTH(context.translation_map->items));
 
-        const ZyrexAnalyzedInstruction* const item = ZyanVectorGet(&context.instructions, i);
-        ZYAN_ASSERT(item);
+        const ZyrexAnalyzedInstruction* const item = &context.instructions[i];
 
         if (item->has_relative_target)
         {
@@ -861,4 +1009,48 @@ ZyanStatus ZyrexRelocateCode(const void* source, ZyanUSize source_length,
     return ZYAN_STATUS_SUCCESS;
 }
 
+ZyanStatus ZyrexRelocationApplyFixups(const void* source, void* destination, 
+    const ZyrexRelocationFixups* fixups)
+{
+    ZYAN_ASSERT(source);
+    ZYAN_ASSERT(destination);
+
+    return ZyrexRelocationApplyFixupsEx((ZyanUPointer)source, (ZyanUPointer)destination, 
+        destination, fixups);
+}
+
+ZyanStatus ZyrexRelocationApplyFixupsEx(ZyanUPointer source, ZyanUPointer destination, 
+    void* buffer, const ZyrexRelocationFixups* fixups)
+{
+    ZYAN_ASSERT(buffer);
+    ZYAN_ASSERT(fixups);
+
+    // Validate all fixups first, so the buffer is never left with only some of them applied
+    ZyanI32 values[ZYREX_TRAMPOLINE_MAX_INSTRUCTION_COUNT];
+    for (ZyanU8 i = 0; i < fixups->count; ++i)
+    {
+        ZYAN_CHECK(ZyrexCalculateRelocationFixup(source, destination, &fixups->items[i], 
+            &values[i]));
+    }
+
+    for (ZyanU8 i = 0; i < fixups->count; ++i)
+    {
+        const ZyrexRelocationFixup* const fixup = &fixups->items[i];
+
+        void* const address = (ZyanU8*)buffer + fixup->offset;
+        const ZyanI32 value = values[i];
+
+        switch (fixup->size)
+        {
+        case  8: *((ZyanI8* )address) = (ZyanI8 )value; break;
+        case 16: *((ZyanI16*)address) = (ZyanI16)value; break;
+        case 32: *((ZyanI32*)address) = (ZyanI32)value; break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
 /* ============================================================================================== */
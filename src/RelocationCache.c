@@ -0,0 +1,906 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#ifndef _GNU_SOURCE
+    // Required for the `dladdr` function
+#   define _GNU_SOURCE
+#endif
+
+#include <Zycore/Comparison.h>
+#include <Zycore/LibC.h>
+#include <Zycore/Vector.h>
+#include <Zyrex/Internal/Relocation.h>
+#include <Zyrex/Internal/RelocationCache.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <dlfcn.h>
+#   include <fcntl.h>
+#   include <stdio.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The magic value of the relocation cache file header (`ZRXC`).
+ */
+#define ZYREX_RELOCATION_CACHE_MAGIC    0x4358525A
+
+/**
+ * @brief   The version of the relocation cache file format.
+ */
+#define ZYREX_RELOCATION_CACHE_VERSION  1
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheHeader` struct.
+ */
+typedef struct ZyrexRelocationCacheHeader_
+{
+    /**
+     * @brief   The magic value (`ZYREX_RELOCATION_CACHE_MAGIC`).
+     */
+    ZyanU32 magic;
+    /**
+     * @brief   The version of the file format (`ZYREX_RELOCATION_CACHE_VERSION`).
+     */
+    ZyanU16 version;
+    /**
+     * @brief   The size of a pointer on the architecture the file was written for.
+     */
+    ZyanU16 pointer_size;
+    /**
+     * @brief   The size of a single `ZyrexRelocationCacheEntry`.
+     */
+    ZyanU32 entry_size;
+    /**
+     * @brief   The number of entries following the header.
+     */
+    ZyanU32 entry_count;
+} ZyrexRelocationCacheHeader;
+
+/**
+ * @brief   Defines the `ZyrexRelocationCacheEntry` struct.
+ *
+ * The entries are stored sorted by `module_hash`, `rva` and `min_bytes_to_reloc`.
+ */
+typedef struct ZyrexRelocationCacheEntry_
+{
+    /**
+     * @brief   The hash of the module identity.
+     */
+    ZyanU64 module_hash;
+    /**
+     * @brief   The address of the relocated code relative to the module base.
+     */
+    ZyanU32 rva;
+    /**
+     * @brief   The minimum amount of bytes requested to be relocated.
+     */
+    ZyanU8 min_bytes_to_reloc;
+    /**
+     * @brief   The number of bytes read from the source buffer.
+     */
+    ZyanU8 bytes_read;
+    /**
+     * @brief   The number of bytes written to the destination buffer.
+     */
+    ZyanU8 bytes_written;
+    /**
+     * @brief   The original code the entry was created from.
+     */
+    ZyanU8 original_code[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
+    /**
+     * @brief   The relocated code template.
+     */
+    ZyanU8 code[ZYREX_TRAMPOLINE_MAX_CODE_SIZE + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS];
+    /**
+     * @brief   The instruction translation map.
+     */
+    ZyrexInstructionTranslationMap translation_map;
+    /**
+     * @brief   The fixups that have to be applied to the code template.
+     */
+    ZyrexRelocationFixups fixups;
+} ZyrexRelocationCacheEntry;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global relocation cache data.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the relocation cache is open.
+     */
+    ZyanBool is_open;
+    /**
+     * @brief   The path of the cache file.
+     */
+    char* path;
+    /**
+     * @brief   The mapped view of the cache file or `ZYAN_NULL`, if the file could not be mapped.
+     */
+    void* view;
+    /**
+     * @brief   The size of the mapped view.
+     */
+    ZyanUSize view_size;
+    /**
+     * @brief   The entries of the mapped cache file.
+     */
+    const ZyrexRelocationCacheEntry* entries;
+    /**
+     * @brief   The number of entries in the mapped cache file.
+     */
+    ZyanUSize entry_count;
+    /**
+     * @brief   The entries added since the cache was opened sorted in the same order as the
+     *          entries of the cache file.
+     */
+    ZyanVector/*<ZyrexRelocationCacheEntry>*/ added;
+#if defined(ZYAN_POSIX)
+    /**
+     * @brief   The base address of the module that was last identified.
+     */
+    ZyanUPointer module_base;
+    /**
+     * @brief   The hash of the module that was last identified.
+     */
+    ZyanU64 module_hash;
+#endif
+} g_relocation_cache =
+{
+    ZYAN_FALSE, ZYAN_NULL, ZYAN_NULL, 0, ZYAN_NULL, 0, ZYAN_VECTOR_INITIALIZER
+#if defined(ZYAN_POSIX)
+    , 0, 0
+#endif
+};
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Module identification                                                                          */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Updates the given FNV-1a `hash` with the given `data`.
+ *
+ * @param   hash    The current hash value.
+ * @param   data    A pointer to the data.
+ * @param   size    The size of the data.
+ *
+ * @return  The updated hash value.
+ */
+static ZyanU64 ZyrexRelocationCacheHash(ZyanU64 hash, const void* data, ZyanUSize size)
+{
+    ZYAN_ASSERT(data);
+
+    for (ZyanUSize i = 0; i < size; ++i)
+    {
+        hash ^= ((const ZyanU8*)data)[i];
+        hash *= 0x00000100000001B3;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief   Identifies the module that contains the given `address`.
+ *
+ * @param   address The address.
+ * @param   base    Receives the base address of the module.
+ * @param   hash    Receives the hash of the module identity.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS` if succeeded, `ZYAN_STATUS_NOT_FOUND` if the `address` does not
+ *          belong to a module, or another zyan status code, if an error occured.
+ *
+ * The module hash does not have to be unique, as every cache entry is validated against the 
+ * original code bytes before it is used.
+ */
+static ZyanStatus ZyrexRelocationCacheGetModule(const void* address, ZyanUPointer* base, 
+    ZyanU64* hash)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(base);
+    ZYAN_ASSERT(hash);
+
+#if   defined(ZYAN_WINDOWS)
+
+    HMODULE module;
+    if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | 
+        GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCWSTR)address, &module))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    const IMAGE_DOS_HEADER* const dos_header = (const IMAGE_DOS_HEADER*)module;
+    if (dos_header->e_magic != IMAGE_DOS_SIGNATURE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+    const IMAGE_NT_HEADERS* const nt_headers = 
+        (const IMAGE_NT_HEADERS*)((const ZyanU8*)module + dos_header->e_lfanew);
+    if (nt_headers->Signature != IMAGE_NT_SIGNATURE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    // The linker timestamp, image size and checksum identify a specific build of the module
+    const ZyanU32 identity[3] =
+    {
+        nt_headers->FileHeader.TimeDateStamp,
+        nt_headers->OptionalHeader.SizeOfImage,
+        nt_headers->OptionalHeader.CheckSum
+    };
+
+    *base = (ZyanUPointer)module;
+    *hash = ZyrexRelocationCacheHash(0xCBF29CE484222325, identity, sizeof(identity));
+
+    return ZYAN_STATUS_SUCCESS;
+
+#elif defined(ZYAN_POSIX)
+
+    Dl_info info;
+    if (!dladdr(address, &info) || !info.dli_fbase || !info.dli_fname || !info.dli_fname[0])
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    if ((ZyanUPointer)info.dli_fbase == g_relocation_cache.module_base)
+    {
+        *base = g_relocation_cache.module_base;
+        *hash = g_relocation_cache.module_hash;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    struct stat file_info;
+    if (stat(info.dli_fname, &file_info) != 0)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    // The file identity, size and modification time identify a specific build of the module
+    const ZyanU64 identity[4] =
+    {
+        (ZyanU64)file_info.st_dev,
+        (ZyanU64)file_info.st_ino,
+        (ZyanU64)file_info.st_size,
+        (ZyanU64)file_info.st_mtime
+    };
+
+    g_relocation_cache.module_base = (ZyanUPointer)info.dli_fbase;
+    g_relocation_cache.module_hash = 
+        ZyrexRelocationCacheHash(0xCBF29CE484222325, identity, sizeof(identity));
+
+    *base = g_relocation_cache.module_base;
+    *hash = g_relocation_cache.module_hash;
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Cache file                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Maps the file at the given `path` into memory.
+ *
+ * @param   path    The path of the file.
+ * @param   view    Receives the address of the mapped view.
+ * @param   size    Receives the size of the mapped view.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexRelocationCacheMapFile(const char* path, void** view, ZyanUSize* size)
+{
+    ZYAN_ASSERT(path);
+    ZYAN_ASSERT(view);
+    ZYAN_ASSERT(size);
+
+#if   defined(ZYAN_WINDOWS)
+
+    const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, 
+        ZYAN_NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, ZYAN_NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || (file_size.QuadPart <= 0) || 
+        ((ZyanU64)file_size.QuadPart != (ZyanUSize)file_size.QuadPart))
+    {
+        CloseHandle(file);
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    // The view keeps the file mapping alive after the handles have been closed
+    const HANDLE mapping = CreateFileMappingA(file, ZYAN_NULL, PAGE_READONLY, 0, 0, ZYAN_NULL);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    void* const address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!address)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    *view = address;
+    *size = (ZyanUSize)file_size.QuadPart;
+
+#elif defined(ZYAN_POSIX)
+
+    const int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    struct stat file_info;
+    if ((fstat(file, &file_info) != 0) || (file_info.st_size <= 0))
+    {
+        close(file);
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    // The mapping stays valid after the file descriptor has been closed
+    void* const address = mmap(ZYAN_NULL, (ZyanUSize)file_info.st_size, PROT_READ, MAP_PRIVATE, 
+        file, 0);
+    close(file);
+    if (address == MAP_FAILED)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    *view = address;
+    *size = (ZyanUSize)file_info.st_size;
+
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Unmaps the given `view`.
+ *
+ * @param   view    The address of the mapped view.
+ * @param   size    The size of the mapped view.
+ */
+static void ZyrexRelocationCacheUnmapFile(void* view, ZyanUSize size)
+{
+    ZYAN_ASSERT(view);
+
+#if   defined(ZYAN_WINDOWS)
+    ZYAN_UNUSED(size);
+    UnmapViewOfFile(view);
+#elif defined(ZYAN_POSIX)
+    ZYAN_UNUSED(munmap(view, size));
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Entries                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexRelocationCacheEntry` struct.
+ *
+ * @param   left    A pointer to the first entry.
+ * @param   right   A pointer to the second entry.
+ *
+ * @return  Returns `0` if the keys of both entries are equal, a negative value if the `left` 
+ *          entry is less than the `right` entry, or a positive value if it is greater.
+ */
+static ZyanI32 ZyrexCompareRelocationCacheEntry(const ZyrexRelocationCacheEntry* left, 
+    const ZyrexRelocationCacheEntry* right)
+{
+    ZYAN_ASSERT(left);
+    ZYAN_ASSERT(right);
+
+    if (left->module_hash != right->module_hash)
+    {
+        return (left->module_hash < right->module_hash) ? -1 : 1;
+    }
+    if (left->rva != right->rva)
+    {
+        return (left->rva < right->rva) ? -1 : 1;
+    }
+    return (ZyanI32)left->min_bytes_to_reloc - (ZyanI32)right->min_bytes_to_reloc;
+}
+
+/**
+ * @brief   Checks if the given cache file `entry` is well-formed.
+ *
+ * @param   entry   A pointer to the `ZyrexRelocationCacheEntry` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the entry is well-formed or `ZYAN_FALSE`, if not.
+ *
+ * The cache file is not trusted to be intact, as it might have been truncated or modified. 
+ */
+static ZyanBool ZyrexRelocationCacheEntryIsValid(const ZyrexRelocationCacheEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+
+    if ((entry->bytes_read < entry->min_bytes_to_reloc) ||
+        (entry->bytes_read > ZYAN_ARRAY_LENGTH(entry->original_code)) ||
+        (entry->bytes_written > ZYAN_ARRAY_LENGTH(entry->code)) ||
+        (entry->translation_map.count > ZYAN_ARRAY_LENGTH(entry->translation_map.items)) ||
+        (entry->fixups.count > ZYAN_ARRAY_LENGTH(entry->fixups.items)))
+    {
+        return ZYAN_FALSE;
+    }
+
+    for (ZyanU8 i = 0; i < entry->translation_map.count; ++i)
+    {
+        const ZyrexInstructionTranslationItem* const item = &entry->translation_map.items[i];
+        if ((item->offset_source >= entry->bytes_read) ||
+            (item->offset_destination >= entry->bytes_written))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    for (ZyanU8 i = 0; i < entry->fixups.count; ++i)
+    {
+        const ZyrexRelocationFixup* const fixup = &entry->fixups.items[i];
+        if (((fixup->size != 8) && (fixup->size != 16) && (fixup->size != 32)) ||
+            (fixup->offset + fixup->size / 8 > entry->bytes_written))
+        {
+            return ZYAN_FALSE;
+        }
+    }
+
+    return ZYAN_TRUE;
+}
+
+/**
+ * @brief   Searches the cache for an entry with the same key as the given `key` entry.
+ *
+ * @param   key The entry that contains the search key.
+ *
+ * @return  A pointer to the found `ZyrexRelocationCacheEntry` struct or `ZYAN_NULL`, if no 
+ *          matching entry was found.
+ *
+ * Entries added since the cache was opened take precedence over the entries of the cache file.
+ */
+static const ZyrexRelocationCacheEntry* ZyrexRelocationCacheFind(
+    const ZyrexRelocationCacheEntry* key)
+{
+    ZYAN_ASSERT(key);
+
+    ZyanUSize found_index;
+    if (ZyanVectorBinarySearch(&g_relocation_cache.added, key, &found_index, 
+        (ZyanComparison)&ZyrexCompareRelocationCacheEntry) == ZYAN_STATUS_TRUE)
+    {
+        return ZyanVectorGet(&g_relocation_cache.added, found_index);
+    }
+
+    ZyanUSize lo = 0;
+    ZyanUSize hi = g_relocation_cache.entry_count;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + (hi - lo) / 2;
+        const ZyrexRelocationCacheEntry* const entry = &g_relocation_cache.entries[mid];
+        const ZyanI32 result = ZyrexCompareRelocationCacheEntry(entry, key);
+        if (result == 0)
+        {
+            return ZyrexRelocationCacheEntryIsValid(entry) ? entry : ZYAN_NULL;
+        }
+        if (result < 0)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/**
+ * @brief   Adds the given `entry` to the cache or replaces an existing entry with the same key.
+ *
+ * @param   entry   A pointer to the `ZyrexRelocationCacheEntry` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexRelocationCacheInsert(const ZyrexRelocationCacheEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(&g_relocation_cache.added, entry, 
+        &found_index, (ZyanComparison)&ZyrexCompareRelocationCacheEntry);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        ZyrexRelocationCacheEntry* const existing = 
+            ZyanVectorGetMutable(&g_relocation_cache.added, found_index);
+        ZYAN_ASSERT(existing);
+
+        ZYAN_MEMCPY(existing, entry, sizeof(ZyrexRelocationCacheEntry));
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    return ZyanVectorInsert(&g_relocation_cache.added, found_index, entry);
+}
+
+/**
+ * @brief   Merges the entries of the cache file with the added entries.
+ *
+ * @param   file    The file that receives the merged entries or `ZYAN_NULL` to just count them.
+ * @param   count   Receives the number of merged entries.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexRelocationCacheMerge(ZYAN_FILE* file, ZyanUSize* count)
+{
+    ZYAN_ASSERT(count);
+
+    *count = 0;
+
+    ZyanUSize i = 0;
+    ZyanUSize j = 0;
+    while ((i < g_relocation_cache.entry_count) || (j < g_relocation_cache.added.size))
+    {
+        const ZyrexRelocationCacheEntry* entry;
+        if (j == g_relocation_cache.added.size)
+        {
+            entry = &g_relocation_cache.entries[i++];
+        } else
+        {
+            const ZyrexRelocationCacheEntry* const added = 
+                ZyanVectorGet(&g_relocation_cache.added, j);
+            ZYAN_ASSERT(added);
+
+            const ZyanI32 result = (i < g_relocation_cache.entry_count)
+                ? ZyrexCompareRelocationCacheEntry(&g_relocation_cache.entries[i], added)
+                : 1;
+            if (result < 0)
+            {
+                entry = &g_relocation_cache.entries[i++];
+            } else
+            {
+                // Added entries replace outdated entries with the same key
+                if (result == 0)
+                {
+                    ++i;
+                }
+                entry = added;
+                ++j;
+            }
+        }
+
+        if (file && (ZYAN_FWRITE(entry, sizeof(ZyrexRelocationCacheEntry), 1, file) != 1))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        ++*count;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Writes all entries to the cache file.
+ *
+ * @return  A zyan status code.
+ *
+ * The entries are written to a temporary file first, which then atomically replaces the cache
+ * file. This keeps the cache file intact for other processes that have it mapped. The cache file
+ * is unmapped by this function.
+ */
+static ZyanStatus ZyrexRelocationCacheSave(void)
+{
+    ZyanUSize count;
+    ZYAN_CHECK(ZyrexRelocationCacheMerge(ZYAN_NULL, &count));
+    if (count > 0xFFFFFFFF)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // The process id makes the temporary file name unique for concurrent writers
+#if   defined(ZYAN_WINDOWS)
+    ZyanU32 id = GetCurrentProcessId();
+#elif defined(ZYAN_POSIX)
+    ZyanU32 id = (ZyanU32)getpid();
+#endif
+    const ZyanUSize length = ZYAN_STRLEN(g_relocation_cache.path);
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    char* const path = ZYAN_MALLOC(length + 14);
+    if (!path)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMCPY(path, g_relocation_cache.path, length);
+    ZYAN_MEMCPY(path + length, ".tmp", 4);
+    for (ZyanUSize i = 0; i < 8; ++i, id >>= 4)
+    {
+        path[length + 11 - i] = "0123456789ABCDEF"[id & 0xF];
+    }
+    path[length + 12] = '\0';
+
+    ZyanStatus status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    ZYAN_FILE* const file = ZYAN_FOPEN(path, "wb");
+    if (file)
+    {
+        ZyrexRelocationCacheHeader header;
+        header.magic = ZYREX_RELOCATION_CACHE_MAGIC;
+        header.version = ZYREX_RELOCATION_CACHE_VERSION;
+        header.pointer_size = sizeof(void*);
+        header.entry_size = sizeof(ZyrexRelocationCacheEntry);
+        header.entry_count = (ZyanU32)count;
+
+        status = (ZYAN_FWRITE(&header, sizeof(header), 1, file) == 1)
+            ? ZyrexRelocationCacheMerge(file, &count)
+            : ZYAN_STATUS_BAD_SYSTEMCALL;
+        if ((ZYAN_FCLOSE(file) != 0) && ZYAN_SUCCESS(status))
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+
+        // Windows does not allow to replace a file while it is mapped
+        if (g_relocation_cache.view)
+        {
+            ZyrexRelocationCacheUnmapFile(g_relocation_cache.view, g_relocation_cache.view_size);
+            g_relocation_cache.view = ZYAN_NULL;
+            g_relocation_cache.entries = ZYAN_NULL;
+            g_relocation_cache.entry_count = 0;
+        }
+
+        if (ZYAN_SUCCESS(status))
+        {
+#if   defined(ZYAN_WINDOWS)
+            if (!MoveFileExA(path, g_relocation_cache.path, MOVEFILE_REPLACE_EXISTING))
+#elif defined(ZYAN_POSIX)
+            if (rename(path, g_relocation_cache.path) != 0)
+#endif
+            {
+                status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            }
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(remove(path));
+        }
+    }
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(path);
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Relocation cache                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexRelocationCacheOpen(const char* path)
+{
+    ZYAN_ASSERT(path);
+
+    if (g_relocation_cache.is_open)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    const ZyanUSize length = ZYAN_STRLEN(path);
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    g_relocation_cache.path = ZYAN_MALLOC(length + 1);
+    if (!g_relocation_cache.path)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    ZYAN_MEMCPY(g_relocation_cache.path, path, length + 1);
+
+    const ZyanStatus status = ZyanVectorInit(&g_relocation_cache.added, 
+        sizeof(ZyrexRelocationCacheEntry), 64, ZYAN_NULL);
+    if (!ZYAN_SUCCESS(status))
+    {
+        // TODO: Replace with ZyanMemoryFree in the future
+        ZYAN_FREE(g_relocation_cache.path);
+        g_relocation_cache.path = ZYAN_NULL;
+        return status;
+    }
+
+    g_relocation_cache.view = ZYAN_NULL;
+    g_relocation_cache.view_size = 0;
+    g_relocation_cache.entries = ZYAN_NULL;
+    g_relocation_cache.entry_count = 0;
+    g_relocation_cache.is_open = ZYAN_TRUE;
+
+    // A missing or incompatible cache file results in an empty cache
+    if (!ZYAN_SUCCESS(ZyrexRelocationCacheMapFile(path, &g_relocation_cache.view, 
+        &g_relocation_cache.view_size)))
+    {
+        g_relocation_cache.view = ZYAN_NULL;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyrexRelocationCacheHeader* const header = g_relocation_cache.view;
+    const ZyrexRelocationCacheEntry* const entries = 
+        (const ZyrexRelocationCacheEntry*)(header + 1);
+    ZyanBool is_valid = 
+        (g_relocation_cache.view_size >= sizeof(ZyrexRelocationCacheHeader)) &&
+        (header->magic == ZYREX_RELOCATION_CACHE_MAGIC) &&
+        (header->version == ZYREX_RELOCATION_CACHE_VERSION) &&
+        (header->pointer_size == sizeof(void*)) &&
+        (header->entry_size == sizeof(ZyrexRelocationCacheEntry)) &&
+        (header->entry_count <= (g_relocation_cache.view_size - 
+            sizeof(ZyrexRelocationCacheHeader)) / sizeof(ZyrexRelocationCacheEntry));
+
+    // The lookup requires the entries to be strictly sorted
+    for (ZyanUSize i = 1; is_valid && (i < header->entry_count); ++i)
+    {
+        is_valid = (ZyrexCompareRelocationCacheEntry(&entries[i - 1], &entries[i]) < 0);
+    }
+
+    if (!is_valid)
+    {
+        ZyrexRelocationCacheUnmapFile(g_relocation_cache.view, g_relocation_cache.view_size);
+        g_relocation_cache.view = ZYAN_NULL;
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    g_relocation_cache.entries = entries;
+    g_relocation_cache.entry_count = header->entry_count;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexRelocationCacheClose(ZyanBool save)
+{
+    if (!g_relocation_cache.is_open)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    if (save && (g_relocation_cache.added.size > 0))
+    {
+        status = ZyrexRelocationCacheSave();
+    }
+
+    if (g_relocation_cache.view)
+    {
+        ZyrexRelocationCacheUnmapFile(g_relocation_cache.view, g_relocation_cache.view_size);
+    }
+    ZYAN_UNUSED(ZyanVectorDestroy(&g_relocation_cache.added));
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(g_relocation_cache.path);
+
+    g_relocation_cache.is_open = ZYAN_FALSE;
+    g_relocation_cache.path = ZYAN_NULL;
+    g_relocation_cache.view = ZYAN_NULL;
+    g_relocation_cache.view_size = 0;
+    g_relocation_cache.entries = ZYAN_NULL;
+    g_relocation_cache.entry_count = 0;
+
+    return status;
+}
+
+ZyanStatus ZyrexRelocationCacheRelocateCode(const void* source, ZyanUSize source_length, 
+    ZyrexTrampolineChunk* trampoline, ZyanUSize min_bytes_to_reloc, ZyanUSize* bytes_read, 
+    ZyanUSize* bytes_written)
+{
+    ZYAN_ASSERT(source);
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(bytes_read);
+    ZYAN_ASSERT(bytes_written);
+
+    ZyanUPointer base;
+    ZyrexRelocationCacheEntry key;
+    // The whole entry is written to the cache file, including its padding bytes
+    ZYAN_MEMSET(&key, 0, sizeof(key));
+    if (!g_relocation_cache.is_open || (min_bytes_to_reloc > 0xFF) ||
+        !ZYAN_SUCCESS(ZyrexRelocationCacheGetModule(source, &base, &key.module_hash)) ||
+        ((ZyanUPointer)source - base > 0xFFFFFFFF))
+    {
+        return ZyrexRelocateCode(source, source_length, trampoline, min_bytes_to_reloc, 
+            bytes_read, bytes_written, ZYAN_NULL);
+    }
+    key.rva = (ZyanU32)((ZyanUPointer)source - base);
+    key.min_bytes_to_reloc = (ZyanU8)min_bytes_to_reloc;
+
+    // The relocation result only depends on the original code bytes, which also protects us 
+    // from hash collisions and patched modules
+    const ZyrexRelocationCacheEntry* const entry = ZyrexRelocationCacheFind(&key);
+    if (entry && (entry->bytes_read <= source_length) &&
+        !ZYAN_MEMCMP(entry->original_code, source, entry->bytes_read))
+    {
+        ZYAN_MEMCPY(&trampoline->code->code_buffer, entry->code, entry->bytes_written);
+
+        // The relative values of the cached code might not reach their targets from this 
+        // trampoline, in which case the code has to be relocated from scratch
+        if (ZYAN_SUCCESS(ZyrexRelocationApplyFixups(source, &trampoline->code->code_buffer, 
+            &entry->fixups)))
+        {
+            ZYAN_MEMCPY(&trampoline->translation_map, &entry->translation_map, 
+                sizeof(ZyrexInstructionTranslationMap));
+
+            *bytes_read = entry->bytes_read;
+            *bytes_written = entry->bytes_written;
+
+            return ZYAN_STATUS_SUCCESS;
+        }
+
+        return ZyrexRelocateCode(source, source_length, trampoline, min_bytes_to_reloc, 
+            bytes_read, bytes_written, ZYAN_NULL);
+    }
+
+    ZYAN_CHECK(ZyrexRelocateCode(source, source_length, trampoline, min_bytes_to_reloc, 
+        bytes_read, bytes_written, &key.fixups));
+    ZYAN_ASSERT(*bytes_read <= ZYAN_ARRAY_LENGTH(key.original_code));
+    ZYAN_ASSERT(*bytes_written <= ZYAN_ARRAY_LENGTH(key.code));
+
+    key.bytes_read = (ZyanU8)*bytes_read;
+    key.bytes_written = (ZyanU8)*bytes_written;
+    ZYAN_MEMSET(key.original_code, 0, sizeof(key.original_code));
+    ZYAN_MEMSET(key.code, 0, sizeof(key.code));
+    ZYAN_MEMCPY(key.original_code, source, *bytes_read);
+    ZYAN_MEMCPY(key.code, &trampoline->code->code_buffer, *bytes_written);
+    ZYAN_MEMCPY(&key.translation_map, &trampoline->translation_map, 
+        sizeof(ZyrexInstructionTranslationMap));
+
+    // The cache is an optimization only and must never fail the relocation
+    ZYAN_UNUSED(ZyrexRelocationCacheInsert(&key));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
@@ -0,0 +1,448 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/API/Memory.h>
+#include <Zycore/API/Thread.h>
+#include <Zycore/LibC.h>
+#include <Zyrex/Internal/ThreadState.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The number of thread state blocks in a single pool chunk.
+ *
+ * Must be `32` as the slot usage of each chunk is tracked by a single 32-bit bitmap.
+ */
+#define ZYREX_THREAD_STATE_POOL_SIZE    32
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+#ifndef ZYREX_BARRIER_STATIC_TLS
+
+typedef struct ZyrexThreadStatePool_ ZyrexThreadStatePool;
+
+/**
+ * @brief   Defines the `ZyrexThreadStateEntry` struct.
+ */
+typedef struct ZyrexThreadStateEntry_
+{
+    /**
+     * @brief   The thread state block.
+     *
+     * This has to be the first member, as the TLS slot stores a pointer to the state block which
+     * is casted back to the containing entry by the TLS cleanup callback.
+     */
+    ZyrexThreadState state;
+    /**
+     * @brief   A pointer to the pool chunk that owns this entry.
+     */
+    ZyrexThreadStatePool* pool;
+    /**
+     * @brief   The index of this entry inside of the pool chunk.
+     */
+    ZyanU32 index;
+} ZyrexThreadStateEntry;
+
+/**
+ * @brief   Defines the `ZyrexThreadStatePool` struct.
+ *
+ * Pool chunks are allocated directly from the operating system and are never released before
+ * `ZyrexThreadStateShutdown` is called. This allows threads to traverse the chunk list without
+ * any locking.
+ */
+struct ZyrexThreadStatePool_
+{
+    /**
+     * @brief   A pointer to the next pool chunk.
+     */
+    ZyrexThreadStatePool* next;
+    /**
+     * @brief   The total size of this pool chunk (in bytes).
+     */
+    ZyanUSize size;
+    /**
+     * @brief   A bitmap that contains one bit for each entry, signaling if the entry is in use.
+     */
+    volatile ZyanU32 used;
+    /**
+     * @brief   The thread state entries.
+     */
+    ZyrexThreadStateEntry entries[ZYREX_THREAD_STATE_POOL_SIZE];
+};
+
+#endif
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+#ifdef ZYREX_BARRIER_STATIC_TLS
+
+#if defined(ZYAN_MSVC)
+#   define ZYREX_THREAD_LOCAL __declspec(thread)
+#else
+#   define ZYREX_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @brief   The state block of the current thread.
+ *
+ * The block is large (mostly the barrier tables and the instrumentation buffer). On glibc, loading
+ * a shared object with a TLS segment this size via `dlopen` can fail with "cannot allocate memory
+ * in static TLS block", and implicit TLS of DLLs loaded by `LoadLibrary` is not initialized on
+ * Windows versions before Vista. Static TLS mode is meant for code linked into the executable.
+ */
+static ZYREX_THREAD_LOCAL ZyrexThreadState g_thread_state;
+
+/**
+ * @brief   Signals, if the state block of the current thread has been registered with the TLS
+ *          slot, which makes sure the TLS cleanup callback is invoked when the thread exits.
+ */
+static ZYREX_THREAD_LOCAL ZyanBool g_thread_state_registered;
+
+#endif
+
+/**
+ * @brief   The TLS slot that holds a pointer to the state block of the current thread.
+ *
+ * In static TLS mode the slot is only used to receive a notification when a thread exits.
+ */
+static ZyanThreadTlsIndex g_thread_state_tls_index = 0;
+
+#ifndef ZYREX_BARRIER_STATIC_TLS
+
+/**
+ * @brief   The head of the pool chunk list.
+ */
+static ZyrexThreadStatePool* volatile g_thread_state_pools = ZYAN_NULL;
+
+#endif
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+#ifndef ZYREX_BARRIER_STATIC_TLS
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Atomic operations                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically replaces the given `destination` value with `exchange`, if it currently
+ *          contains the `comparand` value.
+ *
+ * @param   destination A pointer to the destination value.
+ * @param   exchange    The new value.
+ * @param   comparand   The expected value.
+ *
+ * @return  `ZYAN_TRUE`, if the value was replaced or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexThreadStateCompareExchange(volatile ZyanU32* destination, 
+    ZyanU32 exchange, ZyanU32 comparand)
+{
+#if defined(ZYAN_WINDOWS)
+    return (ZyanU32)InterlockedCompareExchange((volatile LONG*)destination, (LONG)exchange, 
+        (LONG)comparand) == comparand;
+#elif defined(ZYAN_POSIX)
+    return __sync_bool_compare_and_swap(destination, comparand, exchange);
+#endif
+}
+
+/**
+ * @brief   Atomically replaces the given `destination` pointer with `exchange`, if it currently
+ *          contains the `comparand` value.
+ *
+ * @param   destination A pointer to the destination pointer.
+ * @param   exchange    The new pointer value.
+ * @param   comparand   The expected pointer value.
+ *
+ * @return  `ZYAN_TRUE`, if the pointer was replaced or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexThreadStateCompareExchangePointer(
+    ZyrexThreadStatePool* volatile* destination, ZyrexThreadStatePool* exchange, 
+    ZyrexThreadStatePool* comparand)
+{
+#if defined(ZYAN_WINDOWS)
+    return InterlockedCompareExchangePointer((void* volatile*)destination, exchange, 
+        comparand) == comparand;
+#elif defined(ZYAN_POSIX)
+    return __sync_bool_compare_and_swap(destination, comparand, exchange);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Pool                                                                                           */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Tries to claim an unused entry of the given pool chunk.
+ *
+ * @param   pool    A pointer to the `ZyrexThreadStatePool` struct.
+ *
+ * @return  A pointer to the claimed `ZyrexThreadStateEntry` struct or `ZYAN_NULL`, if all
+ *          entries of the chunk are in use.
+ */
+static ZyrexThreadStateEntry* ZyrexThreadStatePoolClaim(ZyrexThreadStatePool* pool)
+{
+    ZYAN_ASSERT(pool);
+
+    while (ZYAN_TRUE)
+    {
+        const ZyanU32 used = pool->used;
+        if (used == (ZyanU32)(-1))
+        {
+            return ZYAN_NULL;
+        }
+
+        ZyanU32 bit = 0;
+        while (used & (1u << bit))
+        {
+            ++bit;
+        }
+
+        if (ZyrexThreadStateCompareExchange(&pool->used, used | (1u << bit), used))
+        {
+            return &pool->entries[bit];
+        }
+    }
+}
+
+/**
+ * @brief   Allocates a new pool chunk and claims its first entry.
+ *
+ * @return  A pointer to the claimed `ZyrexThreadStateEntry` struct or `ZYAN_NULL`, if the
+ *          allocation failed.
+ *
+ * The chunk is published to the chunk list after claiming the entry, so other threads can only
+ * observe the remaining unused entries.
+ */
+static ZyrexThreadStateEntry* ZyrexThreadStatePoolCreate(void)
+{
+    const ZyanUSize page_size = ZyanMemoryGetSystemPageSize();
+    const ZyanUSize size = ZYAN_ALIGN_UP(sizeof(ZyrexThreadStatePool), page_size);
+
+#if defined(ZYAN_WINDOWS)
+    ZyrexThreadStatePool* const pool = 
+        VirtualAlloc(ZYAN_NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!pool)
+    {
+        return ZYAN_NULL;
+    }
+#elif defined(ZYAN_POSIX)
+    ZyrexThreadStatePool* const pool = 
+        mmap(ZYAN_NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (pool == MAP_FAILED)
+    {
+        return ZYAN_NULL;
+    }
+#endif
+
+    // Fresh pages are always zero-initialized
+    pool->size = size;
+    pool->used = 1;
+    for (ZyanU32 i = 0; i < ZYREX_THREAD_STATE_POOL_SIZE; ++i)
+    {
+        pool->entries[i].pool = pool;
+        pool->entries[i].index = i;
+    }
+
+    ZyrexThreadStatePool* head;
+    do
+    {
+        head = g_thread_state_pools;
+        pool->next = head;
+    } while (!ZyrexThreadStateCompareExchangePointer(&g_thread_state_pools, pool, head));
+
+    return &pool->entries[0];
+}
+
+/**
+ * @brief   Claims an unused thread state entry.
+ *
+ * @return  A pointer to the claimed `ZyrexThreadStateEntry` struct or `ZYAN_NULL`, if no entry
+ *          could be claimed.
+ */
+static ZyrexThreadStateEntry* ZyrexThreadStateEntryAcquire(void)
+{
+    for (ZyrexThreadStatePool* pool = g_thread_state_pools; pool; pool = pool->next)
+    {
+        ZyrexThreadStateEntry* const entry = ZyrexThreadStatePoolClaim(pool);
+        if (entry)
+        {
+            ZYAN_MEMSET(&entry->state, 0, sizeof(entry->state));
+            return entry;
+        }
+    }
+
+    return ZyrexThreadStatePoolCreate();
+}
+
+/**
+ * @brief   Returns the given thread state entry to its pool chunk.
+ *
+ * @param   entry   A pointer to the `ZyrexThreadStateEntry` struct.
+ */
+static void ZyrexThreadStateEntryRelease(ZyrexThreadStateEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+    ZYAN_ASSERT(entry->pool->used & (1u << entry->index));
+
+#if defined(ZYAN_WINDOWS)
+    InterlockedAnd((volatile LONG*)&entry->pool->used, (LONG)~(1u << entry->index));
+#elif defined(ZYAN_POSIX)
+    __sync_fetch_and_and(&entry->pool->used, ~(1u << entry->index));
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* TLS                                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   This function is invoked every time a thread exists.
+ *
+ * @param   state   The data currently stored in the TLS slot.
+ */
+ZYAN_THREAD_DECLARE_TLS_CALLBACK(ZyrexThreadStateTlsCleanup, ZyrexThreadState, state)
+{
+    if (!state)
+    {
+        return;
+    }
+
+    if (state->trace_ring)
+    {
+        ZyrexTraceRingRelease(state->trace_ring);
+    }
+
+#ifdef ZYREX_BARRIER_STATIC_TLS
+    state->trace_ring = ZYAN_NULL;
+    // Destructors of other TLS slots might still use the state block and register it again
+    g_thread_state_registered = ZYAN_FALSE;
+#else
+    ZyrexThreadStateEntryRelease((ZyrexThreadStateEntry*)state);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexThreadStateInitialize(void)
+{
+    return ZyanThreadTlsAlloc(&g_thread_state_tls_index, 
+        (ZyanThreadTlsCallback)&ZyrexThreadStateTlsCleanup);
+}
+
+ZyanStatus ZyrexThreadStateShutdown(void)
+{
+    ZYAN_CHECK(ZyanThreadTlsFree(g_thread_state_tls_index));
+
+#ifndef ZYREX_BARRIER_STATIC_TLS
+    ZyrexThreadStatePool* pool = g_thread_state_pools;
+    g_thread_state_pools = ZYAN_NULL;
+    while (pool)
+    {
+        ZyrexThreadStatePool* const next = pool->next;
+        ZYAN_CHECK(ZyanMemoryVirtualFree(pool, pool->size));
+        pool = next;
+    }
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread state                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexThreadStateGet(ZyrexThreadState** state, ZyanBool create)
+{
+    ZYAN_ASSERT(state);
+
+#ifdef ZYREX_BARRIER_STATIC_TLS
+
+    if (!g_thread_state_registered && create)
+    {
+        ZYAN_CHECK(ZyanThreadTlsSetValue(g_thread_state_tls_index, &g_thread_state));
+        g_thread_state_registered = ZYAN_TRUE;
+    }
+
+    *state = &g_thread_state;
+
+#else
+
+    ZYAN_CHECK(ZyanThreadTlsGetValue(g_thread_state_tls_index, (void**)state));
+
+    if ((*state == ZYAN_NULL) && create)
+    {
+        ZyrexThreadStateEntry* const entry = ZyrexThreadStateEntryAcquire();
+        if (!entry)
+        {
+            return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+        }
+
+        const ZyanStatus status = ZyanThreadTlsSetValue(g_thread_state_tls_index, &entry->state);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexThreadStateEntryRelease(entry);
+            return status;
+        }
+
+        *state = &entry->state;
+    }
+
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
@@ -0,0 +1,1098 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/API/Memory.h>
+#include <Zycore/API/Process.h>
+#include <Zycore/LibC.h>
+#include <Zycore/Vector.h>
+#include <Zyrex/Internal/Thunk.h>
+#include <Zyrex/Internal/Utils.h>
+
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The size of a single thunk page.
+ *
+ * This matches the allocation granularity of Windows, so no address space is wasted.
+ */
+#define ZYREX_THUNK_PAGE_SIZE           0x10000
+
+/**
+ * @brief   The allocation granularity inside a thunk page.
+ *
+ * Every thunk occupies one granule for its `ZyrexThunkHeader`, followed by the granules of its
+ * code.
+ */
+#define ZYREX_THUNK_GRANULE_SIZE        64
+
+/**
+ * @brief   The number of granules of a thunk page.
+ */
+#define ZYREX_THUNK_PAGE_GRANULES       (ZYREX_THUNK_PAGE_SIZE / ZYREX_THUNK_GRANULE_SIZE)
+
+/**
+ * @brief   The maximum size of the code of a single thunk.
+ */
+#define ZYREX_THUNK_MAX_CODE_SIZE       2048
+
+/**
+ * @brief   The size of the shadow space, that has to be allocated by the caller of a function.
+ */
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+#   define ZYREX_THUNK_SHADOW_SPACE     32
+#else
+#   define ZYREX_THUNK_SHADOW_SPACE     0
+#endif
+
+/**
+ * @brief   The scratch register used to copy the stack arguments, which is neither used to pass 
+ *          arguments nor has to be preserved.
+ */
+#if defined(ZYAN_X64)
+#   define ZYREX_THUNK_SCRATCH_REGISTER ZYREX_THUNK_REG_R11
+#else
+#   define ZYREX_THUNK_SCRATCH_REGISTER ZYREX_THUNK_REG_RAX
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Opcodes                                                                                        */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   `MOV r/m, reg`
+ */
+#define ZYREX_THUNK_OPCODE_MOV_STORE    0x0089
+
+/**
+ * @brief   `MOV reg, r/m`
+ */
+#define ZYREX_THUNK_OPCODE_MOV_LOAD     0x008B
+
+/**
+ * @brief   `LEA reg, m`
+ */
+#define ZYREX_THUNK_OPCODE_LEA          0x008D
+
+/**
+ * @brief   `FLD m64` (`/0`) and `FSTP m64` (`/3`)
+ */
+#define ZYREX_THUNK_OPCODE_FPU_QWORD    0x00DD
+
+/**
+ * @brief   `CALL r/m` (`/2`) and `JMP r/m` (`/4`)
+ */
+#define ZYREX_THUNK_OPCODE_BRANCH       0x00FF
+
+/**
+ * @brief   `MOVUPS xmm, m128`
+ */
+#define ZYREX_THUNK_OPCODE_MOVUPS_LOAD  0x0F10
+
+/**
+ * @brief   `MOVUPS m128, xmm`
+ */
+#define ZYREX_THUNK_OPCODE_MOVUPS_STORE 0x0F11
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexThunkRegister` enum.
+ *
+ * The values match the register encoding used by the `ModRM` byte and the `REX` prefix.
+ */
+typedef enum ZyrexThunkRegister_
+{
+    ZYREX_THUNK_REG_RAX,
+    ZYREX_THUNK_REG_RCX,
+    ZYREX_THUNK_REG_RDX,
+    ZYREX_THUNK_REG_RBX,
+    ZYREX_THUNK_REG_RSP,
+    ZYREX_THUNK_REG_RBP,
+    ZYREX_THUNK_REG_RSI,
+    ZYREX_THUNK_REG_RDI,
+    ZYREX_THUNK_REG_R8,
+    ZYREX_THUNK_REG_R9,
+    ZYREX_THUNK_REG_R10,
+    ZYREX_THUNK_REG_R11
+} ZyrexThunkRegister;
+
+/**
+ * @brief   Defines the `ZyrexThunkHeader` struct.
+ *
+ * The header occupies the first granule of every thunk and is addressed by the generated code 
+ * using `RIP`-relative (x64) or absolute (x86) memory operands.
+ */
+typedef struct ZyrexThunkHeader_
+{
+    /**
+     * @brief   The handler function.
+     */
+    ZyrexThunkHandler handler;
+    /**
+     * @brief   The address of the original function.
+     */
+    const void* original;
+    /**
+     * @brief   The user data passed to the handler.
+     */
+    void* user_data;
+    /**
+     * @brief   The hooked address.
+     */
+    const void* address;
+    /**
+     * @brief   The thunk flags.
+     */
+    ZyrexThunkFlags flags;
+    /**
+     * @brief   The number of granules occupied by the thunk (including the header).
+     */
+    ZyanU32 granule_count;
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+    /**
+     * @brief   The function table entry of the thunk code, which is registered using
+     *          `RtlAddFunctionTable`.
+     */
+    RUNTIME_FUNCTION function;
+    /**
+     * @brief   The `UNWIND_INFO` of the thunk code.
+     *
+     * Describes the `PUSH RBP`, `MOV RBP, RSP` and `SUB RSP, imm32` instructions of the prolog, 
+     * which allows exceptions of the original function to unwind through post thunks.
+     */
+    ZyanU8 unwind_info[12];
+#endif
+} ZyrexThunkHeader;
+
+/**
+ * @brief   Defines the `ZyrexThunkPage` struct.
+ */
+typedef struct ZyrexThunkPage_
+{
+    /**
+     * @brief   The address of the page.
+     */
+    ZyanU8* address;
+    /**
+     * @brief   A bitmap of the used granules.
+     *
+     * The granules of retired thunks are never cleared.
+     */
+    ZyanU64 used_granules[ZYREX_THUNK_PAGE_GRANULES / 64];
+} ZyrexThunkPage;
+
+/**
+ * @brief   Defines the `ZyrexThunkWriter` struct.
+ */
+typedef struct ZyrexThunkWriter_
+{
+    /**
+     * @brief   The buffer that receives the code.
+     */
+    ZyanU8* buffer;
+    /**
+     * @brief   The runtime address of the code.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The runtime address of the `ZyrexThunkHeader` struct.
+     */
+    ZyanUPointer header;
+    /**
+     * @brief   The current write offset.
+     */
+    ZyanUSize offset;
+    /**
+     * @brief   The size of the prolog.
+     */
+    ZyanU8 prolog_size;
+    /**
+     * @brief   The size of the stack frame allocated by the prolog.
+     */
+    ZyanU32 frame_size;
+} ZyrexThunkWriter;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains the integer argument registers in argument order.
+ */
+static const ZyanU8 g_thunk_argument_registers[ZYREX_THUNK_REGISTER_ARGUMENTS] =
+{
+#if   defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+    ZYREX_THUNK_REG_RCX, ZYREX_THUNK_REG_RDX, ZYREX_THUNK_REG_R8, ZYREX_THUNK_REG_R9
+#elif defined(ZYAN_X64)
+    ZYREX_THUNK_REG_RDI, ZYREX_THUNK_REG_RSI, ZYREX_THUNK_REG_RDX, ZYREX_THUNK_REG_RCX, 
+    ZYREX_THUNK_REG_R8, ZYREX_THUNK_REG_R9
+#else
+    ZYREX_THUNK_REG_RCX, ZYREX_THUNK_REG_RDX
+#endif
+};
+
+/**
+ * @brief   Contains all thunk pages.
+ */
+static ZyanVector/*<ZyrexThunkPage>*/ g_thunk_pages = ZYAN_VECTOR_INITIALIZER;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Code generation                                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Emits a single byte.
+ *
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct.
+ * @param   value   The value.
+ */
+static void ZyrexThunkEmitByte(ZyrexThunkWriter* writer, ZyanU8 value)
+{
+    ZYAN_ASSERT(writer);
+    ZYAN_ASSERT(writer->offset < ZYREX_THUNK_MAX_CODE_SIZE);
+
+    writer->buffer[writer->offset++] = value;
+}
+
+/**
+ * @brief   Emits a little-endian 32 bit value.
+ *
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct.
+ * @param   value   The value.
+ */
+static void ZyrexThunkEmitDword(ZyrexThunkWriter* writer, ZyanU32 value)
+{
+    for (ZyanU8 i = 0; i < 4; ++i)
+    {
+        ZyrexThunkEmitByte(writer, (ZyanU8)(value >> (i * 8)));
+    }
+}
+
+/**
+ * @brief   Emits the `REX` prefix for an instruction with the given operands, if required.
+ *
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct.
+ * @param   is_wide `ZYAN_TRUE` for instructions with a 64 bit operand size.
+ * @param   reg     The register encoded in the `ModRM.reg` field.
+ * @param   base    The register encoded in the `ModRM.rm` field.
+ *
+ * This function does not emit anything on x86.
+ */
+static void ZyrexThunkEmitRex(ZyrexThunkWriter* writer, ZyanBool is_wide, ZyanU8 reg, 
+    ZyanU8 base)
+{
+#if defined(ZYAN_X64)
+    const ZyanU8 rex = 0x40 | (is_wide ? 0x08 : 0x00) | ((reg & 0x08) >> 1) | ((base & 0x08) >> 3);
+    if (rex != 0x40)
+    {
+        ZyrexThunkEmitByte(writer, rex);
+    }
+#else
+    ZYAN_UNUSED(writer);
+    ZYAN_UNUSED(is_wide);
+    ZYAN_UNUSED(reg);
+    ZYAN_UNUSED(base);
+#endif
+}
+
+/**
+ * @brief   Emits an instruction with a `[base + displacement]` memory operand.
+ *
+ * @param   writer          A pointer to the `ZyrexThunkWriter` struct.
+ * @param   is_wide         `ZYAN_TRUE` for instructions with a 64 bit operand size.
+ * @param   opcode          The opcode (`0x0Fxx` for two-byte opcodes).
+ * @param   reg             The register (or opcode extension) encoded in the `ModRM.reg` field.
+ * @param   base            The base register.
+ * @param   displacement    The displacement.
+ *
+ * The shortest displacement encoding is used.
+ */
+static void ZyrexThunkEmitMemory(ZyrexThunkWriter* writer, ZyanBool is_wide, ZyanU16 opcode,
+    ZyanU8 reg, ZyanU8 base, ZyanI32 displacement)
+{
+    ZyrexThunkEmitRex(writer, is_wide, reg, base);
+    if (opcode > 0xFF)
+    {
+        ZyrexThunkEmitByte(writer, (ZyanU8)(opcode >> 8));
+    }
+    ZyrexThunkEmitByte(writer, (ZyanU8)opcode);
+
+    // `[RBP]` can not be encoded without a displacement
+    const ZyanBool has_displacement = (displacement != 0) || ((base & 7) == ZYREX_THUNK_REG_RBP);
+    const ZyanBool is_short = (displacement >= -128) && (displacement <= 127);
+    const ZyanU8 mod = !has_displacement ? 0x00 : (is_short ? 0x40 : 0x80);
+
+    ZyrexThunkEmitByte(writer, mod | (ZyanU8)((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == ZYREX_THUNK_REG_RSP)
+    {
+        // `[RSP]` requires a `SIB` byte
+        ZyrexThunkEmitByte(writer, 0x24);
+    }
+    if (has_displacement && is_short)
+    {
+        ZyrexThunkEmitByte(writer, (ZyanU8)displacement);
+    } else
+    if (has_displacement)
+    {
+        ZyrexThunkEmitDword(writer, (ZyanU32)displacement);
+    }
+}
+
+/**
+ * @brief   Emits an instruction with a memory operand that references a field of the 
+ *          `ZyrexThunkHeader` struct.
+ *
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct.
+ * @param   is_wide `ZYAN_TRUE` for instructions with a 64 bit operand size.
+ * @param   opcode  The (single-byte) opcode.
+ * @param   reg     The register (or opcode extension) encoded in the `ModRM.reg` field.
+ * @param   field   The offset of the field.
+ *
+ * The field is addressed `RIP`-relative on x64 and absolute on x86.
+ */
+static void ZyrexThunkEmitHeaderMemory(ZyrexThunkWriter* writer, ZyanBool is_wide, 
+    ZyanU8 opcode, ZyanU8 reg, ZyanUSize field)
+{
+    ZyrexThunkEmitRex(writer, is_wide, reg, 0);
+    ZyrexThunkEmitByte(writer, opcode);
+    ZyrexThunkEmitByte(writer, 0x05 | (ZyanU8)((reg & 7) << 3));
+
+#if defined(ZYAN_X64)
+    ZyrexThunkEmitDword(writer, (ZyanU32)ZyrexCalculateRelativeOffset(4, 
+        writer->address + writer->offset, writer->header + field));
+#else
+    ZyrexThunkEmitDword(writer, (ZyanU32)(writer->header + field));
+#endif
+}
+
+/**
+ * @brief   Emits the code that saves or restores the argument registers.
+ *
+ * @param   writer          A pointer to the `ZyrexThunkWriter` struct.
+ * @param   flags           The thunk flags.
+ * @param   context_offset  The offset of the `ZyrexThunkContext` struct relative to the stack
+ *                          pointer.
+ * @param   is_restore      `ZYAN_TRUE` to restore the registers from the context.
+ */
+static void ZyrexThunkEmitArguments(ZyrexThunkWriter* writer, ZyrexThunkFlags flags, 
+    ZyanI32 context_offset, ZyanBool is_restore)
+{
+    const ZyanU16 opcode = is_restore ? ZYREX_THUNK_OPCODE_MOV_LOAD : ZYREX_THUNK_OPCODE_MOV_STORE;
+    for (ZyanU8 i = 0; i < ZYREX_THUNK_REGISTER_ARGUMENTS; ++i)
+    {
+        ZyrexThunkEmitMemory(writer, ZYAN_TRUE, opcode, g_thunk_argument_registers[i], 
+            ZYREX_THUNK_REG_RSP, context_offset + (ZyanI32)(offsetof(ZyrexThunkContext, arguments) 
+            + i * sizeof(ZyanUPointer)));
+    }
+
+#if defined(ZYAN_X64) && !defined(ZYAN_WINDOWS)
+    // `RAX` contains the number of vector registers used by variadic functions
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, opcode, ZYREX_THUNK_REG_RAX, ZYREX_THUNK_REG_RSP,
+        context_offset + (ZyanI32)offsetof(ZyrexThunkContext, return_value));
+#endif
+
+#if ZYREX_THUNK_FLOAT_ARGUMENTS
+    if (flags & ZYREX_THUNK_FLAG_FLOAT_ARGUMENTS)
+    {
+        const ZyanU16 vector_opcode = 
+            is_restore ? ZYREX_THUNK_OPCODE_MOVUPS_LOAD : ZYREX_THUNK_OPCODE_MOVUPS_STORE;
+        for (ZyanU8 i = 0; i < ZYREX_THUNK_FLOAT_ARGUMENTS; ++i)
+        {
+            ZyrexThunkEmitMemory(writer, ZYAN_FALSE, vector_opcode, i, ZYREX_THUNK_REG_RSP, 
+                context_offset + (ZyanI32)(offsetof(ZyrexThunkContext, float_arguments) 
+                + i * sizeof(ZyrexThunkVector)));
+        }
+    }
+#else
+    ZYAN_UNUSED(flags);
+#endif
+}
+
+/**
+ * @brief   Emits the code that saves or restores the return value registers.
+ *
+ * @param   writer          A pointer to the `ZyrexThunkWriter` struct.
+ * @param   flags           The thunk flags.
+ * @param   context_offset  The offset of the `ZyrexThunkContext` struct relative to the stack
+ *                          pointer.
+ * @param   is_restore      `ZYAN_TRUE` to restore the registers from the context.
+ */
+static void ZyrexThunkEmitReturnValue(ZyrexThunkWriter* writer, ZyrexThunkFlags flags, 
+    ZyanI32 context_offset, ZyanBool is_restore)
+{
+    const ZyanU16 opcode = is_restore ? ZYREX_THUNK_OPCODE_MOV_LOAD : ZYREX_THUNK_OPCODE_MOV_STORE;
+    const ZyanI32 offset = context_offset + (ZyanI32)offsetof(ZyrexThunkContext, return_value);
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, opcode, ZYREX_THUNK_REG_RAX, ZYREX_THUNK_REG_RSP, 
+        offset);
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, opcode, ZYREX_THUNK_REG_RDX, ZYREX_THUNK_REG_RSP, 
+        offset + (ZyanI32)sizeof(ZyanUPointer));
+
+    if (!(flags & ZYREX_THUNK_FLAG_FLOAT_RESULT))
+    {
+        return;
+    }
+
+    const ZyanI32 float_offset = 
+        context_offset + (ZyanI32)offsetof(ZyrexThunkContext, float_return_value);
+#if defined(ZYAN_X64)
+    ZyrexThunkEmitMemory(writer, ZYAN_FALSE, 
+        is_restore ? ZYREX_THUNK_OPCODE_MOVUPS_LOAD : ZYREX_THUNK_OPCODE_MOVUPS_STORE, 0, 
+        ZYREX_THUNK_REG_RSP, float_offset);
+#else
+    ZyrexThunkEmitMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_FPU_QWORD, is_restore ? 0 : 3, 
+        ZYREX_THUNK_REG_RSP, float_offset);
+#endif
+}
+
+/**
+ * @brief   Emits the call of the handler.
+ *
+ * @param   writer          A pointer to the `ZyrexThunkWriter` struct.
+ * @param   context_offset  The offset of the `ZyrexThunkContext` struct relative to the stack
+ *                          pointer.
+ * @param   event           The event passed to the handler.
+ */
+static void ZyrexThunkEmitHandlerCall(ZyrexThunkWriter* writer, ZyanI32 context_offset,
+    ZyrexThunkEvent event)
+{
+#if defined(ZYAN_X64)
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_LEA, 
+        g_thunk_argument_registers[0], ZYREX_THUNK_REG_RSP, context_offset);
+    ZYAN_ASSERT(g_thunk_argument_registers[1] < ZYREX_THUNK_REG_R8);
+    ZyrexThunkEmitByte(writer, 0xB8 + g_thunk_argument_registers[1]);
+    ZyrexThunkEmitDword(writer, (ZyanU32)event);
+    ZyrexThunkEmitHeaderMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_BRANCH, 2, 
+        offsetof(ZyrexThunkHeader, handler));
+#else
+    ZyrexThunkEmitMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_LEA, ZYREX_THUNK_REG_RAX, 
+        ZYREX_THUNK_REG_RSP, context_offset);
+    // `SUB ESP, 8` keeps the stack aligned to 16 bytes after pushing both arguments
+    ZyrexThunkEmitByte(writer, 0x83);
+    ZyrexThunkEmitByte(writer, 0xEC);
+    ZyrexThunkEmitByte(writer, 0x08);
+    ZyrexThunkEmitByte(writer, 0x6A);
+    ZyrexThunkEmitByte(writer, (ZyanU8)event);
+    ZyrexThunkEmitByte(writer, 0x50);
+    ZyrexThunkEmitHeaderMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_BRANCH, 2, 
+        offsetof(ZyrexThunkHeader, handler));
+    ZyrexThunkEmitByte(writer, 0x83);
+    ZyrexThunkEmitByte(writer, 0xC4);
+    ZyrexThunkEmitByte(writer, 0x10);
+#endif
+}
+
+/**
+ * @brief   Emits the epilog that restores the stack pointer and the frame pointer.
+ *
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct.
+ *
+ * `LEA RSP, [RBP]` is used instead of `LEAVE`, as only the former is a valid epilog instruction 
+ * for the unwinder on Windows x64.
+ */
+static void ZyrexThunkEmitEpilog(ZyrexThunkWriter* writer)
+{
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_LEA, ZYREX_THUNK_REG_RSP, 
+        ZYREX_THUNK_REG_RBP, 0);
+    ZyrexThunkEmitByte(writer, 0x58 + ZYREX_THUNK_REG_RBP);
+}
+
+/**
+ * @brief   Emits the code of a thunk for the given `signature`.
+ *
+ * @param   writer      A pointer to the `ZyrexThunkWriter` struct.
+ * @param   signature   A pointer to the `ZyrexThunkSignature` struct.
+ *
+ * The stack frame has the following layout (relative to the stack pointer after the prolog):
+ * - The shadow space (Windows x64 only)
+ * - The copied stack arguments (post thunks only)
+ * - The `ZyrexThunkContext` struct
+ *
+ * The size of the generated code only depends on the `signature` and not on the runtime address.
+ */
+static void ZyrexThunkEmit(ZyrexThunkWriter* writer, const ZyrexThunkSignature* signature)
+{
+    ZYAN_ASSERT(writer);
+    ZYAN_ASSERT(signature);
+
+    const ZyrexThunkFlags flags = signature->flags;
+    const ZyanBool is_post = (flags & ZYREX_THUNK_FLAG_POST) ? ZYAN_TRUE : ZYAN_FALSE;
+    const ZyanI32 copy_count = is_post ? signature->stack_argument_count : 0;
+    const ZyanI32 context_offset = (ZyanI32)ZYAN_ALIGN_UP(ZYREX_THUNK_SHADOW_SPACE + 
+        copy_count * (ZyanI32)sizeof(ZyanUPointer), 16);
+    ZyanI32 frame_size = 
+        (ZyanI32)ZYAN_ALIGN_UP(context_offset + (ZyanI32)sizeof(ZyrexThunkContext), 16);
+#if defined(ZYAN_X86)
+    // The return address and the frame pointer only occupy 8 bytes on x86
+    frame_size += 8;
+#endif
+    writer->frame_size = (ZyanU32)frame_size;
+
+    // PUSH RBP
+    // MOV RBP, RSP
+    // SUB RSP, frame_size
+    ZyrexThunkEmitByte(writer, 0x50 + ZYREX_THUNK_REG_RBP);
+    ZyrexThunkEmitRex(writer, ZYAN_TRUE, ZYREX_THUNK_REG_RSP, ZYREX_THUNK_REG_RBP);
+    ZyrexThunkEmitByte(writer, 0x89);
+    ZyrexThunkEmitByte(writer, 0xC0 | (ZYREX_THUNK_REG_RSP << 3) | ZYREX_THUNK_REG_RBP);
+    ZyrexThunkEmitRex(writer, ZYAN_TRUE, 0, ZYREX_THUNK_REG_RSP);
+    ZyrexThunkEmitByte(writer, 0x81);
+    ZyrexThunkEmitByte(writer, 0xC0 | (5 << 3) | ZYREX_THUNK_REG_RSP);
+    ZyrexThunkEmitDword(writer, (ZyanU32)frame_size);
+    writer->prolog_size = (ZyanU8)writer->offset;
+
+    ZyrexThunkEmitArguments(writer, flags, context_offset, ZYAN_FALSE);
+
+    // The scratch register is saved before, if it is used to pass arguments
+    ZyrexThunkEmitHeaderMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_LOAD, 
+        ZYREX_THUNK_REG_RAX, offsetof(ZyrexThunkHeader, user_data));
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_STORE, ZYREX_THUNK_REG_RAX,
+        ZYREX_THUNK_REG_RSP, context_offset + (ZyanI32)offsetof(ZyrexThunkContext, user_data));
+    ZyrexThunkEmitHeaderMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_LOAD, 
+        ZYREX_THUNK_REG_RAX, offsetof(ZyrexThunkHeader, address));
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_STORE, ZYREX_THUNK_REG_RAX,
+        ZYREX_THUNK_REG_RSP, context_offset + (ZyanI32)offsetof(ZyrexThunkContext, address));
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_LEA, ZYREX_THUNK_REG_RAX, 
+        ZYREX_THUNK_REG_RBP, (ZyanI32)sizeof(ZyanUPointer));
+    ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_STORE, ZYREX_THUNK_REG_RAX,
+        ZYREX_THUNK_REG_RSP, context_offset + (ZyanI32)offsetof(ZyrexThunkContext, stack));
+
+    ZyrexThunkEmitHandlerCall(writer, context_offset, ZYREX_THUNK_EVENT_PRE);
+
+    // The stack arguments follow the return address, the saved frame pointer and the shadow space
+    // of the caller
+    for (ZyanI32 i = 0; i < copy_count; ++i)
+    {
+        const ZyanI32 offset = i * (ZyanI32)sizeof(ZyanUPointer);
+        ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_LOAD, 
+            ZYREX_THUNK_SCRATCH_REGISTER, ZYREX_THUNK_REG_RBP, 
+            2 * (ZyanI32)sizeof(ZyanUPointer) + ZYREX_THUNK_SHADOW_SPACE + offset);
+        ZyrexThunkEmitMemory(writer, ZYAN_TRUE, ZYREX_THUNK_OPCODE_MOV_STORE, 
+            ZYREX_THUNK_SCRATCH_REGISTER, ZYREX_THUNK_REG_RSP, ZYREX_THUNK_SHADOW_SPACE + offset);
+    }
+
+    ZyrexThunkEmitArguments(writer, flags, context_offset, ZYAN_TRUE);
+
+    if (!is_post)
+    {
+        ZyrexThunkEmitEpilog(writer);
+        ZyrexThunkEmitHeaderMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_BRANCH, 4, 
+            offsetof(ZyrexThunkHeader, original));
+        return;
+    }
+
+    ZyrexThunkEmitHeaderMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_BRANCH, 2, 
+        offsetof(ZyrexThunkHeader, original));
+#if defined(ZYAN_X86)
+    // The original function might have removed its stack arguments
+    ZyrexThunkEmitMemory(writer, ZYAN_FALSE, ZYREX_THUNK_OPCODE_LEA, ZYREX_THUNK_REG_RSP, 
+        ZYREX_THUNK_REG_RBP, -frame_size);
+#endif
+
+    ZyrexThunkEmitReturnValue(writer, flags, context_offset, ZYAN_FALSE);
+    ZyrexThunkEmitHandlerCall(writer, context_offset, ZYREX_THUNK_EVENT_POST);
+    ZyrexThunkEmitReturnValue(writer, flags, context_offset, ZYAN_TRUE);
+    ZyrexThunkEmitEpilog(writer);
+
+#if defined(ZYAN_X86)
+    if ((flags & ZYREX_THUNK_FLAG_CALLEE_CLEANUP) && copy_count)
+    {
+        const ZyanU16 size = (ZyanU16)(copy_count * sizeof(ZyanUPointer));
+        ZyrexThunkEmitByte(writer, 0xC2);
+        ZyrexThunkEmitByte(writer, (ZyanU8)size);
+        ZyrexThunkEmitByte(writer, (ZyanU8)(size >> 8));
+        return;
+    }
+#endif
+    ZyrexThunkEmitByte(writer, 0xC3);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Unwind information                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   Initializes the function table entry and the unwind information of the given thunk.
+ *
+ * @param   header  A pointer to the `ZyrexThunkHeader` struct.
+ * @param   page    The address of the thunk page, which is used as the base address of the
+ *                  function table.
+ * @param   writer  A pointer to the `ZyrexThunkWriter` struct that generated the thunk code.
+ */
+static void ZyrexThunkInitUnwindInfo(ZyrexThunkHeader* header, const ZyanU8* page, 
+    const ZyrexThunkWriter* writer)
+{
+    ZYAN_ASSERT(header);
+    ZYAN_ASSERT(page);
+    ZYAN_ASSERT(writer);
+    ZYAN_ASSERT(writer->frame_size <= 0x7FFF8);
+
+    header->function.BeginAddress = (DWORD)(writer->address - (ZyanUPointer)page);
+    header->function.EndAddress = (DWORD)(header->function.BeginAddress + writer->offset);
+    header->function.UnwindData = (DWORD)((ZyanUPointer)header->unwind_info - (ZyanUPointer)page);
+
+    ZyanU8* const info = header->unwind_info;
+    // Version 1, no handlers, 4 unwind code slots and `RBP` as frame register without offset
+    info[0] = 0x01;
+    info[1] = writer->prolog_size;
+    info[2] = 0x04;
+    info[3] = ZYREX_THUNK_REG_RBP;
+    // UWOP_ALLOC_LARGE (the slot after contains the size divided by 8)
+    info[4] = writer->prolog_size;
+    info[5] = 0x01;
+    info[6] = (ZyanU8)(writer->frame_size / 8);
+    info[7] = (ZyanU8)(writer->frame_size / 8 >> 8);
+    // UWOP_SET_FPREG after `MOV RBP, RSP`
+    info[8] = 0x04;
+    info[9] = 0x03;
+    // UWOP_PUSH_NONVOL after `PUSH RBP`
+    info[10] = 0x01;
+    info[11] = 0x00 | (ZYREX_THUNK_REG_RBP << 4);
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Pages                                                                                          */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Changes the memory protection of all system pages that contain the given memory range.
+ *
+ * @param   address     The start address of the memory range.
+ * @param   size        The size of the memory range.
+ * @param   protection  The new page protection.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexThunkProtect(const void* address, ZyanUSize size, 
+    ZyanMemoryPageProtection protection)
+{
+    const ZyanUPointer page_size = ZyanMemoryGetSystemPageSize();
+    const ZyanUPointer begin = ZYAN_ALIGN_DOWN((ZyanUPointer)address, page_size);
+    const ZyanUPointer end = ZYAN_ALIGN_UP((ZyanUPointer)address + size, page_size);
+
+    return ZyanMemoryVirtualProtect((void*)begin, end - begin, protection);
+}
+
+/**
+ * @brief   Releases the memory of the given thunk page.
+ *
+ * @param   page    A pointer to the `ZyrexThunkPage` struct.
+ */
+static void ZyrexThunkPageRelease(ZyrexThunkPage* page)
+{
+    ZYAN_ASSERT(page);
+
+#if   defined(ZYAN_WINDOWS)
+    ZYAN_UNUSED(VirtualFree(page->address, 0, MEM_RELEASE));
+#elif defined(ZYAN_POSIX)
+    ZYAN_UNUSED(munmap(page->address, ZYREX_THUNK_PAGE_SIZE));
+#endif
+}
+
+/**
+ * @brief   Allocates a new thunk page.
+ *
+ * @param   page    Receives the new thunk page.
+ *
+ * @return  A zyan status code.
+ *
+ * The page is filled with `INT 3` instructions and protected as `RX`.
+ */
+static ZyanStatus ZyrexThunkPageAllocate(ZyrexThunkPage* page)
+{
+    ZYAN_ASSERT(page);
+
+#if   defined(ZYAN_WINDOWS)
+    page->address = VirtualAlloc(ZYAN_NULL, ZYREX_THUNK_PAGE_SIZE, MEM_COMMIT | MEM_RESERVE, 
+        PAGE_READWRITE);
+    if (!page->address)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    void* const address = mmap(ZYAN_NULL, ZYREX_THUNK_PAGE_SIZE, PROT_READ | PROT_WRITE, 
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    page->address = address;
+#endif
+
+    ZYAN_MEMSET(page->address, 0xCC, ZYREX_THUNK_PAGE_SIZE);
+    ZYAN_MEMSET(page->used_granules, 0, sizeof(page->used_granules));
+
+    const ZyanStatus status = 
+        ZyanMemoryVirtualProtect(page->address, ZYREX_THUNK_PAGE_SIZE, ZYAN_PAGE_EXECUTE_READ);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexThunkPageRelease(page);
+        return status;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Sets or clears a range of granules in the given thunk page.
+ *
+ * @param   page    A pointer to the `ZyrexThunkPage` struct.
+ * @param   index   The index of the first granule.
+ * @param   count   The number of granules.
+ * @param   is_used `ZYAN_TRUE` to mark the granules as used or `ZYAN_FALSE` to mark them as 
+ *                  unused.
+ */
+static void ZyrexThunkPageMark(ZyrexThunkPage* page, ZyanU32 index, ZyanU32 count, 
+    ZyanBool is_used)
+{
+    ZYAN_ASSERT(page);
+    ZYAN_ASSERT(index + count <= ZYREX_THUNK_PAGE_GRANULES);
+
+    for (ZyanU32 i = index; i < index + count; ++i)
+    {
+        if (is_used)
+        {
+            page->used_granules[i / 64] |= (1ULL << (i % 64));
+        } else
+        {
+            page->used_granules[i / 64] &= ~(1ULL << (i % 64));
+        }
+    }
+}
+
+/**
+ * @brief   Searches the given thunk page for a range of unused granules.
+ *
+ * @param   page    A pointer to the `ZyrexThunkPage` struct.
+ * @param   count   The number of granules.
+ * @param   index   Receives the index of the first granule.
+ *
+ * @return  `ZYAN_TRUE`, if a matching range was found or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexThunkPageFindFree(const ZyrexThunkPage* page, ZyanU32 count, 
+    ZyanU32* index)
+{
+    ZYAN_ASSERT(page);
+    ZYAN_ASSERT(index);
+
+    ZyanU32 length = 0;
+    for (ZyanU32 i = 0; i < ZYREX_THUNK_PAGE_GRANULES; ++i)
+    {
+        if (page->used_granules[i / 64] & (1ULL << (i % 64)))
+        {
+            length = 0;
+            continue;
+        }
+        if (++length == count)
+        {
+            *index = i + 1 - count;
+            return ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Searches the thunk page that contains the given `address`.
+ *
+ * @param   address The address.
+ * @param   index   Receives the index of the page in the global page list.
+ *
+ * @return  A pointer to the `ZyrexThunkPage` struct or `ZYAN_NULL`, if no matching page was 
+ *          found.
+ */
+static ZyrexThunkPage* ZyrexThunkPageFind(ZyanUPointer address, ZyanUSize* index)
+{
+    ZYAN_ASSERT(index);
+
+    for (ZyanUSize i = 0; i < g_thunk_pages.size; ++i)
+    {
+        ZyrexThunkPage* const page = ZyanVectorGetMutable(&g_thunk_pages, i);
+        if ((address >= (ZyanUPointer)page->address) && 
+            (address < (ZyanUPointer)page->address + ZYREX_THUNK_PAGE_SIZE))
+        {
+            *index = i;
+            return page;
+        }
+    }
+
+    return ZYAN_NULL;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Allocation                                                                                     */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Allocates the given number of granules.
+ *
+ * @param   count   The number of granules.
+ * @param   index   Receives the index of the page in the global page list.
+ * @param   header  Receives the address of the first granule.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexThunkAllocate(ZyanU32 count, ZyanUSize* index, ZyrexThunkHeader** header)
+{
+    ZYAN_ASSERT(count <= ZYREX_THUNK_PAGE_GRANULES);
+    ZYAN_ASSERT(index);
+    ZYAN_ASSERT(header);
+
+    if (!g_thunk_pages.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_thunk_pages, sizeof(ZyrexThunkPage), 4, ZYAN_NULL));
+    }
+
+    ZyanU32 granule;
+    for (ZyanUSize i = 0; i < g_thunk_pages.size; ++i)
+    {
+        ZyrexThunkPage* const page = ZyanVectorGetMutable(&g_thunk_pages, i);
+        if (ZyrexThunkPageFindFree(page, count, &granule))
+        {
+            ZyrexThunkPageMark(page, granule, count, ZYAN_TRUE);
+            *index = i;
+            *header = (ZyrexThunkHeader*)(page->address + granule * ZYREX_THUNK_GRANULE_SIZE);
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    ZyrexThunkPage page;
+    ZYAN_CHECK(ZyrexThunkPageAllocate(&page));
+    ZyrexThunkPageMark(&page, 0, count, ZYAN_TRUE);
+
+    const ZyanStatus status = ZyanVectorPushBack(&g_thunk_pages, &page);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexThunkPageRelease(&page);
+        return status;
+    }
+
+    *index = g_thunk_pages.size - 1;
+    *header = (ZyrexThunkHeader*)page.address;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Releases the granules of the given thunk.
+ *
+ * @param   index   The index of the page in the global page list.
+ * @param   header  A pointer to the `ZyrexThunkHeader` struct.
+ * @param   count   The number of granules.
+ *
+ * The page is released, if it does not contain any other thunks.
+ */
+static void ZyrexThunkRelease(ZyanUSize index, const ZyrexThunkHeader* header, ZyanU32 count)
+{
+    ZyrexThunkPage* const page = ZyanVectorGetMutable(&g_thunk_pages, index);
+    ZYAN_ASSERT(page);
+
+    const ZyanU32 granule = 
+        (ZyanU32)(((const ZyanU8*)header - page->address) / ZYREX_THUNK_GRANULE_SIZE);
+    ZyrexThunkPageMark(page, granule, count, ZYAN_FALSE);
+
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(page->used_granules); ++i)
+    {
+        if (page->used_granules[i])
+        {
+            return;
+        }
+    }
+
+    ZyrexThunkPageRelease(page);
+    ZYAN_UNUSED(ZyanVectorDelete(&g_thunk_pages, index));
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Public functions                                                                               */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thunks                                                                                         */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexThunkCreate(const void* address, const ZyrexThunkSignature* signature, 
+    ZyrexThunkHandler handler, void* user_data, const void** thunk)
+{
+    if (!address || !signature || !handler || !thunk)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    const ZyrexThunkFlags flags = signature->flags;
+    if ((flags & ~(ZYREX_THUNK_FLAG_POST | ZYREX_THUNK_FLAG_FLOAT_ARGUMENTS | 
+        ZYREX_THUNK_FLAG_FLOAT_RESULT | ZYREX_THUNK_FLAG_CALLEE_CLEANUP)) ||
+        ((flags & ZYREX_THUNK_FLAG_FLOAT_RESULT) && !(flags & ZYREX_THUNK_FLAG_POST)) ||
+        (signature->stack_argument_count > ZYREX_THUNK_MAX_STACK_ARGUMENTS))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // The first pass only determines the size of the code
+    ZyanU8 buffer[ZYREX_THUNK_MAX_CODE_SIZE];
+    ZyrexThunkWriter writer;
+    ZYAN_MEMSET(&writer, 0, sizeof(writer));
+    writer.buffer = buffer;
+    ZyrexThunkEmit(&writer, signature);
+
+    const ZyanU32 count = 
+        1 + (ZyanU32)(ZYAN_ALIGN_UP(writer.offset, ZYREX_THUNK_GRANULE_SIZE) / 
+        ZYREX_THUNK_GRANULE_SIZE);
+    ZyanUSize index;
+    ZyrexThunkHeader* header;
+    ZYAN_CHECK(ZyrexThunkAllocate(count, &index, &header));
+
+    ZyanU8* const code = (ZyanU8*)header + ZYREX_THUNK_GRANULE_SIZE;
+    writer.address = (ZyanUPointer)code;
+    writer.header = (ZyanUPointer)header;
+    writer.offset = 0;
+    ZyrexThunkEmit(&writer, signature);
+
+    // Other thunks in the same pages might be executed concurrently
+    ZyanStatus status = ZyrexThunkProtect(header, count * ZYREX_THUNK_GRANULE_SIZE, 
+        ZYAN_PAGE_EXECUTE_READWRITE);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexThunkRelease(index, header, count);
+        return status;
+    }
+
+    header->handler = handler;
+    header->original = ZYAN_NULL;
+    header->user_data = user_data;
+    header->address = address;
+    header->flags = flags;
+    header->granule_count = count;
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+    ZyrexThunkInitUnwindInfo(header, 
+        ((const ZyrexThunkPage*)ZyanVectorGet(&g_thunk_pages, index))->address, &writer);
+#endif
+    ZYAN_MEMCPY(code, buffer, writer.offset);
+
+    status = ZyrexThunkProtect(header, count * ZYREX_THUNK_GRANULE_SIZE, 
+        ZYAN_PAGE_EXECUTE_READ);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanProcessFlushInstructionCache(code, writer.offset);
+    }
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+    if (ZYAN_SUCCESS(status) && !RtlAddFunctionTable(&header->function, 1, 
+        (DWORD64)((const ZyrexThunkPage*)ZyanVectorGet(&g_thunk_pages, index))->address))
+    {
+        status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexThunkRelease(index, header, count);
+        return status;
+    }
+
+    *thunk = code;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexThunkSetOriginal(const void* thunk, const void* original)
+{
+    if (!thunk || !original)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexThunkHeader* const header = 
+        (ZyrexThunkHeader*)((ZyanU8*)thunk - ZYREX_THUNK_GRANULE_SIZE);
+
+    ZYAN_CHECK(ZyrexThunkProtect(header, sizeof(*header), ZYAN_PAGE_EXECUTE_READWRITE));
+    header->original = original;
+
+    return ZyrexThunkProtect(header, sizeof(*header), ZYAN_PAGE_EXECUTE_READ);
+}
+
+ZyanStatus ZyrexThunkFree(const void* thunk, ZyanBool is_attached)
+{
+    if (!thunk)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyanUSize index;
+    const ZyrexThunkPage* const page = ZyrexThunkPageFind((ZyanUPointer)thunk, &index);
+    if (!page)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    const ZyanUPointer offset = (ZyanUPointer)thunk - (ZyanUPointer)page->address;
+    if ((offset < ZYREX_THUNK_GRANULE_SIZE) || 
+        !ZYAN_IS_ALIGNED_TO(offset, ZYREX_THUNK_GRANULE_SIZE))
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZyrexThunkHeader* const header = 
+        (ZyrexThunkHeader*)((ZyanU8*)thunk - ZYREX_THUNK_GRANULE_SIZE);
+    if (is_attached && (header->flags & ZYREX_THUNK_FLAG_POST))
+    {
+        // Threads might still return from the original function into the thunk
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+#if defined(ZYAN_X64) && defined(ZYAN_WINDOWS)
+    ZYAN_UNUSED(RtlDeleteFunctionTable(&header->function));
+#endif
+    ZyrexThunkRelease(index, header, header->granule_count);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
@@ -0,0 +1,878 @@
+/***************************************************************************************************
+
+  Zyan Hook Library (Zyrex)
+
+  Original Author : Florian Bernd
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+
+***************************************************************************************************/
+
+#include <Zycore/API/Memory.h>
+#include <Zycore/API/Thread.h>
+#include <Zycore/LibC.h>
+#include <Zyrex/Trace.h>
+#include <Zyrex/Internal/ThreadState.h>
+#include <Zyrex/Internal/Trace.h>
+#include <Zyrex/Internal/Utils.h>
+
+#if defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#elif defined(ZYAN_POSIX)
+#   include <pthread.h>
+#   include <sched.h>
+#   include <time.h>
+#   include <sys/mman.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   The size of the batch buffer (in bytes).
+ */
+#define ZYREX_TRACE_BATCH_SIZE          (64 * 1024)
+
+/**
+ * @brief   The maximum size of a single encoded event (in bytes).
+ */
+#define ZYREX_TRACE_MAX_EVENT_SIZE      (10 * (3 + ZYREX_TRACE_MAX_ARGUMENTS) + 1)
+
+/**
+ * @brief   The size of a cache line (in bytes).
+ */
+#define ZYREX_TRACE_CACHE_LINE_SIZE     64
+
+/* ============================================================================================== */
+/* Macros                                                                                         */
+/* ============================================================================================== */
+
+/**
+ * @brief   Prevents the compiler from reordering memory accesses across this point.
+ *
+ * This is sufficient to order the accesses to the single-producer single-consumer ring buffers,
+ * as x86 never reorders stores with other stores or loads with other loads.
+ */
+#if defined(ZYAN_MSVC)
+#   define ZYREX_TRACE_COMPILER_BARRIER() _ReadWriteBarrier()
+#else
+#   define ZYREX_TRACE_COMPILER_BARRIER() __asm__ __volatile__("" ::: "memory")
+#endif
+
+/* ============================================================================================== */
+/* Enums and types                                                                                */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the `ZyrexTraceRing` struct.
+ *
+ * Every ring buffer is owned by at most one thread at a time (the producer), while the draining
+ * thread acts as the only consumer. The events directly follow the ring header in memory.
+ */
+struct ZyrexTraceRing_
+{
+    /**
+     * @brief   A pointer to the next ring buffer.
+     */
+    ZyrexTraceRing* next;
+    /**
+     * @brief   The number of events the ring buffer can hold (always a power of two).
+     */
+    ZyanUSize capacity;
+    /**
+     * @brief   Signals, if the ring buffer is currently owned by a thread.
+     */
+    volatile ZyanU32 in_use;
+    /**
+     * @brief   The id of the owning thread.
+     */
+    ZyanU32 thread_id;
+    /**
+     * @brief   The total number of dropped events (only written by the producer).
+     */
+    volatile ZyanU32 dropped_count;
+    /**
+     * @brief   The number of dropped events already reported to the consumer (only accessed by
+     *          the consumer).
+     */
+    ZyanU32 dropped_reported;
+    /**
+     * @brief   The index of the next event to be consumed (only written by the consumer).
+     */
+    volatile ZyanUSize tail;
+    /**
+     * @brief   Keeps the `head` index in a different cache line than the consumer fields.
+     */
+    ZyanU8 padding[ZYREX_TRACE_CACHE_LINE_SIZE];
+    /**
+     * @brief   The index of the next event to be produced (only written by the producer).
+     */
+    volatile ZyanUSize head;
+};
+
+/**
+ * @brief   Defines the `ZyrexTraceData` struct.
+ */
+typedef struct ZyrexTraceData_
+{
+    /**
+     * @brief   Signals, if the trace system is initialized.
+     */
+    ZyanBool is_initialized;
+    /**
+     * @brief   The capacity of newly created ring buffers.
+     */
+    ZyanUSize capacity;
+    /**
+     * @brief   The head of the ring buffer list.
+     *
+     * Ring buffers are never released, which allows threads to traverse the list without any
+     * locking. Threads that exit return their ring buffer to the list for reuse.
+     */
+    ZyrexTraceRing* volatile rings;
+    /**
+     * @brief   Serializes concurrent drain operations.
+     */
+    volatile ZyanU32 drain_lock;
+    /**
+     * @brief   The batch buffer used while draining.
+     */
+    ZyanU8* batch;
+    /**
+     * @brief   Signals, if the background drain thread is running.
+     */
+    ZyanBool is_drain_thread_running;
+    /**
+     * @brief   Signals the background drain thread to exit.
+     */
+    volatile ZyanBool stop_drain_thread;
+    /**
+     * @brief   The batch callback of the background drain thread.
+     */
+    ZyrexTraceBatchCallback drain_callback;
+    /**
+     * @brief   The user data of the background drain thread.
+     */
+    void* drain_user_data;
+    /**
+     * @brief   The drain interval of the background drain thread (in milliseconds).
+     */
+    ZyanU32 drain_interval;
+    /**
+     * @brief   The background drain thread.
+     */
+#if defined(ZYAN_WINDOWS)
+    HANDLE drain_thread;
+#elif defined(ZYAN_POSIX)
+    pthread_t drain_thread;
+#endif
+} ZyrexTraceData;
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains global data used by the trace system.
+ */
+static ZyrexTraceData g_trace_data;
+
+/* ============================================================================================== */
+/* Internal functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Atomic operations                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Atomically replaces the given `destination` value with `exchange`, if it currently
+ *          contains the `comparand` value.
+ *
+ * @param   destination A pointer to the destination value.
+ * @param   exchange    The new value.
+ * @param   comparand   The expected value.
+ *
+ * @return  `ZYAN_TRUE`, if the value was replaced or `ZYAN_FALSE`, if not.
+ */
+ZYAN_INLINE ZyanBool ZyrexTraceCompareExchange(volatile ZyanU32* destination, ZyanU32 exchange, 
+    ZyanU32 comparand)
+{
+#if defined(ZYAN_WINDOWS)
+    return (ZyanU32)InterlockedCompareExchange((volatile LONG*)destination, (LONG)exchange, 
+        (LONG)comparand) == comparand;
+#elif defined(ZYAN_POSIX)
+    return __sync_bool_compare_and_swap(destination, comparand, exchange);
+#endif
+}
+
+/**
+ * @brief   Atomically replaces the given `destination` value with `value`.
+ *
+ * @param   destination A pointer to the destination value.
+ * @param   value       The new value.
+ */
+ZYAN_INLINE void ZyrexTraceExchange(volatile ZyanU32* destination, ZyanU32 value)
+{
+#if defined(ZYAN_WINDOWS)
+    InterlockedExchange((volatile LONG*)destination, (LONG)value);
+#elif defined(ZYAN_POSIX)
+    __sync_lock_test_and_set(destination, value);
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Ring buffers                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns a pointer to the events of the given ring buffer.
+ *
+ * @param   ring    A pointer to the `ZyrexTraceRing` struct.
+ *
+ * @return  A pointer to the events of the given ring buffer.
+ */
+ZYAN_INLINE ZyrexTraceEvent* ZyrexTraceRingGetEvents(ZyrexTraceRing* ring)
+{
+    return (ZyrexTraceEvent*)(ring + 1);
+}
+
+/**
+ * @brief   Claims an unused ring buffer or creates a new one for the current thread.
+ *
+ * @return  A pointer to the claimed `ZyrexTraceRing` struct or `ZYAN_NULL`, if the allocation of
+ *          a new ring buffer failed.
+ *
+ * New ring buffers are allocated directly from the operating system.
+ */
+static ZyrexTraceRing* ZyrexTraceRingAcquire(void)
+{
+    ZyanThreadId thread_id;
+    if (!ZYAN_SUCCESS(ZyanThreadGetCurrentThreadId(&thread_id)))
+    {
+        thread_id = 0;
+    }
+
+    for (ZyrexTraceRing* ring = g_trace_data.rings; ring; ring = ring->next)
+    {
+        if (!ring->in_use && ZyrexTraceCompareExchange(&ring->in_use, 1, 0))
+        {
+            ring->thread_id = (ZyanU32)thread_id;
+            return ring;
+        }
+    }
+
+    const ZyanUSize page_size = ZyanMemoryGetSystemPageSize();
+    const ZyanUSize size = ZYAN_ALIGN_UP(sizeof(ZyrexTraceRing) + 
+        g_trace_data.capacity * sizeof(ZyrexTraceEvent), page_size);
+
+#if defined(ZYAN_WINDOWS)
+    ZyrexTraceRing* const ring = 
+        VirtualAlloc(ZYAN_NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!ring)
+    {
+        return ZYAN_NULL;
+    }
+#elif defined(ZYAN_POSIX)
+    ZyrexTraceRing* const ring = 
+        mmap(ZYAN_NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED)
+    {
+        return ZYAN_NULL;
+    }
+#endif
+
+    // Fresh pages are always zero-initialized
+    ring->capacity = g_trace_data.capacity;
+    ring->in_use = 1;
+    ring->thread_id = (ZyanU32)thread_id;
+
+    ZyrexTraceRing* head;
+    do
+    {
+        head = g_trace_data.rings;
+        ring->next = head;
+#if defined(ZYAN_WINDOWS)
+    } while (InterlockedCompareExchangePointer((void* volatile*)&g_trace_data.rings, ring, 
+        head) != head);
+#elif defined(ZYAN_POSIX)
+    } while (!__sync_bool_compare_and_swap(&g_trace_data.rings, head, ring));
+#endif
+
+    return ring;
+}
+
+/**
+ * @brief   Writes the given `value` as LEB128 encoded integer.
+ *
+ * @param   buffer  A pointer to the output buffer.
+ * @param   value   The value.
+ *
+ * @return  The number of bytes written.
+ */
+ZYAN_INLINE ZyanUSize ZyrexTraceWriteVarint(ZyanU8* buffer, ZyanU64 value)
+{
+    ZyanUSize length = 0;
+    while (value >= 0x80)
+    {
+        buffer[length++] = (ZyanU8)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[length++] = (ZyanU8)value;
+
+    return length;
+}
+
+/**
+ * @brief   Reads a LEB128 encoded integer.
+ *
+ * @param   buffer  A pointer to the input buffer.
+ * @param   size    The size of the input buffer.
+ * @param   offset  The current offset. Receives the offset of the next value.
+ * @param   value   Receives the decoded value.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTraceReadVarint(const ZyanU8* buffer, ZyanUSize size, ZyanUSize* offset, 
+    ZyanU64* value)
+{
+    ZYAN_ASSERT(buffer);
+    ZYAN_ASSERT(offset);
+    ZYAN_ASSERT(value);
+
+    *value = 0;
+    for (ZyanU8 shift = 0; shift < 64; shift += 7)
+    {
+        if (*offset >= size)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+
+        const ZyanU8 byte = buffer[(*offset)++];
+        *value |= (ZyanU64)(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    return ZYAN_STATUS_INVALID_ARGUMENT;
+}
+
+/**
+ * @brief   Initializes the batch header in the batch buffer.
+ *
+ * @param   timestamp       The base timestamp.
+ * @param   dropped_count   The number of dropped events.
+ *
+ * @return  The offset of the first event.
+ */
+static ZyanUSize ZyrexTraceBatchBegin(ZyanU64 timestamp, ZyanU32 dropped_count)
+{
+    ZyrexTraceBatchHeader* const header = (ZyrexTraceBatchHeader*)g_trace_data.batch;
+    header->magic = ZYREX_TRACE_BATCH_MAGIC;
+    header->version = ZYREX_TRACE_BATCH_VERSION;
+    header->reserved = 0;
+    header->event_count = 0;
+    header->dropped_count = dropped_count;
+    header->base_timestamp = timestamp;
+
+    return sizeof(ZyrexTraceBatchHeader);
+}
+
+/**
+ * @brief   Drains all pending events of the given ring buffer.
+ *
+ * @param   ring        A pointer to the `ZyrexTraceRing` struct.
+ * @param   callback    The callback that receives the encoded batches.
+ * @param   user_data   The user data passed to the callback.
+ *
+ * @return  The number of drained events.
+ *
+ * The tail index is advanced before invoking the callback, which allows the producer to reuse
+ * the consumed slots while the callback is still running.
+ */
+static ZyanUSize ZyrexTraceRingDrain(ZyrexTraceRing* ring, ZyrexTraceBatchCallback callback, 
+    void* user_data)
+{
+    ZYAN_ASSERT(ring);
+    ZYAN_ASSERT(callback);
+
+    const ZyanUSize head = ring->head;
+    const ZyanU32 dropped_count = ring->dropped_count;
+    ZYREX_TRACE_COMPILER_BARRIER();
+
+    ZyanUSize tail = ring->tail;
+    if ((tail == head) && (dropped_count == ring->dropped_reported))
+    {
+        return 0;
+    }
+
+    const ZyrexTraceEvent* const events = ZyrexTraceRingGetEvents(ring);
+    const ZyanUSize mask = ring->capacity - 1;
+    ZyrexTraceBatchHeader* const header = (ZyrexTraceBatchHeader*)g_trace_data.batch;
+    ZyanU64 timestamp = (tail != head) ? events[tail & mask].timestamp : 0;
+    ZyanUSize offset = ZyrexTraceBatchBegin(timestamp, dropped_count - ring->dropped_reported);
+    ring->dropped_reported = dropped_count;
+
+    const ZyanUSize count = head - tail;
+    for (; tail != head; ++tail)
+    {
+        const ZyrexTraceEvent* const event = &events[tail & mask];
+        if (offset + ZYREX_TRACE_MAX_EVENT_SIZE > ZYREX_TRACE_BATCH_SIZE)
+        {
+            ZYREX_TRACE_COMPILER_BARRIER();
+            ring->tail = tail;
+            callback(g_trace_data.batch, offset, user_data);
+
+            timestamp = event->timestamp;
+            offset = ZyrexTraceBatchBegin(timestamp, 0);
+        }
+
+        // Zigzag encoding keeps small negative differences (e.g. caused by unsynchronized 
+        // time-stamp counters on different processors) short
+        const ZyanU64 delta = event->timestamp - timestamp;
+        timestamp = event->timestamp;
+
+        ZyanU8* const buffer = g_trace_data.batch;
+        const ZyanU8 argument_count = event->argument_count;
+        offset += ZyrexTraceWriteVarint(&buffer[offset], event->thread_id);
+        offset += ZyrexTraceWriteVarint(&buffer[offset], 
+            (delta << 1) ^ (ZyanU64)((ZyanI64)delta >> 63));
+        offset += ZyrexTraceWriteVarint(&buffer[offset], event->function);
+        buffer[offset++] = argument_count;
+        for (ZyanU8 i = 0; i < argument_count; ++i)
+        {
+            offset += ZyrexTraceWriteVarint(&buffer[offset], event->arguments[i]);
+        }
+        ++header->event_count;
+    }
+
+    ZYREX_TRACE_COMPILER_BARRIER();
+    ring->tail = tail;
+    callback(g_trace_data.batch, offset, user_data);
+
+    return count;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Drain thread                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Implements the main loop of the background drain thread.
+ */
+static void ZyrexTraceDrainThreadRun(void)
+{
+    ZyrexThreadState* state;
+    if (ZYAN_SUCCESS(ZyrexThreadStateGet(&state, ZYAN_TRUE)))
+    {
+        // The drain thread is never traced and never passes any barrier
+        ++state->exclusion_depth;
+    }
+
+    while (!g_trace_data.stop_drain_thread)
+    {
+        ZYAN_UNUSED(ZyrexTraceDrain(g_trace_data.drain_callback, g_trace_data.drain_user_data, 
+            ZYAN_NULL));
+
+#if defined(ZYAN_WINDOWS)
+        Sleep(g_trace_data.drain_interval);
+#elif defined(ZYAN_POSIX)
+        struct timespec interval;
+        interval.tv_sec  = g_trace_data.drain_interval / 1000;
+        interval.tv_nsec = (long)(g_trace_data.drain_interval % 1000) * 1000000;
+        nanosleep(&interval, ZYAN_NULL);
+#endif
+    }
+
+    ZYAN_UNUSED(ZyrexTraceDrain(g_trace_data.drain_callback, g_trace_data.drain_user_data, 
+        ZYAN_NULL));
+}
+
+#if defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   The entry point of the background drain thread.
+ *
+ * @param   parameter   Unused.
+ *
+ * @return  The thread exit code.
+ */
+static DWORD WINAPI ZyrexTraceDrainThreadProc(LPVOID parameter)
+{
+    ZYAN_UNUSED(parameter);
+
+    ZyrexTraceDrainThreadRun();
+    return 0;
+}
+
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   The entry point of the background drain thread.
+ *
+ * @param   parameter   Unused.
+ *
+ * @return  The thread exit value.
+ */
+static void* ZyrexTraceDrainThreadProc(void* parameter)
+{
+    ZYAN_UNUSED(parameter);
+
+    ZyrexTraceDrainThreadRun();
+    return ZYAN_NULL;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Functions                                                                                      */
+/* ============================================================================================== */
+
+void ZyrexTraceRingRelease(ZyrexTraceRing* ring)
+{
+    ZYAN_ASSERT(ring);
+    ZYAN_ASSERT(ring->in_use);
+
+    ZyrexTraceExchange(&ring->in_use, 0);
+}
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Initialization and finalization                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTraceInitialize(ZyanUSize capacity)
+{
+    if (!capacity || (capacity & (capacity - 1)))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (g_trace_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    g_trace_data.batch = ZYAN_MALLOC(ZYREX_TRACE_BATCH_SIZE);
+    if (!g_trace_data.batch)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    g_trace_data.capacity = capacity;
+    g_trace_data.is_initialized = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTraceShutdown(void)
+{
+    if (!g_trace_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    if (g_trace_data.is_drain_thread_running)
+    {
+        ZYAN_CHECK(ZyrexTraceStopDrainThread());
+    }
+
+    // Ring buffers might still be referenced by the state blocks of running threads and are kept
+    // alive for later reuse
+    for (ZyrexTraceRing* ring = g_trace_data.rings; ring; ring = ring->next)
+    {
+        ring->tail = ring->head;
+        ring->dropped_reported = ring->dropped_count;
+    }
+
+    g_trace_data.is_initialized = ZYAN_FALSE;
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(g_trace_data.batch);
+    g_trace_data.batch = ZYAN_NULL;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Recording                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTraceRecord(ZyanU64 function, const ZyanU64* arguments, ZyanU8 argument_count)
+{
+    if (!arguments && argument_count)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trace_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_TRUE));
+
+    if (state->exclusion_depth)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    ZyrexTraceRing* ring = state->trace_ring;
+    if (!ring)
+    {
+        ring = ZyrexTraceRingAcquire();
+        if (!ring)
+        {
+            return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+        }
+        state->trace_ring = ring;
+    }
+
+    const ZyanUSize head = ring->head;
+    if (head - ring->tail >= ring->capacity)
+    {
+        ++ring->dropped_count;
+        return ZYAN_STATUS_FALSE;
+    }
+
+    if (argument_count > ZYREX_TRACE_MAX_ARGUMENTS)
+    {
+        argument_count = ZYREX_TRACE_MAX_ARGUMENTS;
+    }
+
+    ZyrexTraceEvent* const event = &ZyrexTraceRingGetEvents(ring)[head & (ring->capacity - 1)];
+    event->timestamp = ZyrexReadTimestampCounter();
+    event->function = function;
+    event->thread_id = ring->thread_id;
+    event->argument_count = argument_count;
+    for (ZyanU8 i = 0; i < argument_count; ++i)
+    {
+        event->arguments[i] = arguments[i];
+    }
+
+    // Publish the event
+    ZYREX_TRACE_COMPILER_BARRIER();
+    ring->head = head + 1;
+
+    return ZYAN_STATUS_TRUE;
+}
+
+void ZyrexTraceThunkHandler(ZyrexThunkContext* context, ZyrexThunkEvent event)
+{
+    if (event != ZYREX_THUNK_EVENT_PRE)
+    {
+        return;
+    }
+
+    ZyanU64 arguments[ZYREX_TRACE_MAX_ARGUMENTS];
+    for (ZyanU8 i = 0; i < ZYREX_TRACE_MAX_ARGUMENTS; ++i)
+    {
+#if defined(ZYAN_X64)
+        arguments[i] = context->arguments[i];
+#else
+        // Arguments are passed on the stack for most x86 calling conventions
+        arguments[i] = context->stack[1 + i];
+#endif
+    }
+
+    ZYAN_UNUSED(ZyrexTraceRecord((ZyanUPointer)context->address, arguments, 
+        ZYREX_TRACE_MAX_ARGUMENTS));
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Draining                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTraceDrain(ZyrexTraceBatchCallback callback, void* user_data, ZyanUSize* count)
+{
+    if (!callback)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trace_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZyrexThreadState* state;
+    ZYAN_CHECK(ZyrexThreadStateGet(&state, ZYAN_TRUE));
+    ++state->exclusion_depth;
+
+    while (!ZyrexTraceCompareExchange(&g_trace_data.drain_lock, 1, 0))
+    {
+#if defined(ZYAN_WINDOWS)
+        SwitchToThread();
+#elif defined(ZYAN_POSIX)
+        sched_yield();
+#endif
+    }
+
+    ZyanUSize total = 0;
+    for (ZyrexTraceRing* ring = g_trace_data.rings; ring; ring = ring->next)
+    {
+        total += ZyrexTraceRingDrain(ring, callback, user_data);
+    }
+
+    ZyrexTraceExchange(&g_trace_data.drain_lock, 0);
+    --state->exclusion_depth;
+
+    if (count)
+    {
+        *count = total;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTraceStartDrainThread(ZyrexTraceBatchCallback callback, void* user_data, 
+    ZyanU32 interval)
+{
+    if (!callback)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trace_data.is_initialized || g_trace_data.is_drain_thread_running)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    g_trace_data.drain_callback = callback;
+    g_trace_data.drain_user_data = user_data;
+    g_trace_data.drain_interval = interval;
+    g_trace_data.stop_drain_thread = ZYAN_FALSE;
+
+#if defined(ZYAN_WINDOWS)
+    g_trace_data.drain_thread = 
+        CreateThread(ZYAN_NULL, 0, &ZyrexTraceDrainThreadProc, ZYAN_NULL, 0, ZYAN_NULL);
+    if (!g_trace_data.drain_thread)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    if (pthread_create(&g_trace_data.drain_thread, ZYAN_NULL, &ZyrexTraceDrainThreadProc, 
+        ZYAN_NULL))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    g_trace_data.is_drain_thread_running = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTraceStopDrainThread(void)
+{
+    if (!g_trace_data.is_drain_thread_running)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    g_trace_data.stop_drain_thread = ZYAN_TRUE;
+
+#if defined(ZYAN_WINDOWS)
+    if (WaitForSingleObject(g_trace_data.drain_thread, INFINITE) != WAIT_OBJECT_0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+    ZYAN_UNUSED(CloseHandle(g_trace_data.drain_thread));
+#elif defined(ZYAN_POSIX)
+    if (pthread_join(g_trace_data.drain_thread, ZYAN_NULL))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    g_trace_data.is_drain_thread_running = ZYAN_FALSE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Decoding                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTraceDecodeBatch(const void* batch, ZyanUSize size, ZyrexTraceEvent* events, 
+    ZyanUSize* count)
+{
+    if (!batch || !count || (!events && *count) || (size < sizeof(ZyrexTraceBatchHeader)))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexTraceBatchHeader header;
+    ZYAN_MEMCPY(&header, batch, sizeof(header));
+    if ((header.magic != ZYREX_TRACE_BATCH_MAGIC) || 
+        (header.version != ZYREX_TRACE_BATCH_VERSION))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (*count < header.event_count)
+    {
+        *count = header.event_count;
+        return ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE;
+    }
+
+    const ZyanU8* const buffer = (const ZyanU8*)batch;
+    ZyanUSize offset = sizeof(ZyrexTraceBatchHeader);
+    ZyanU64 timestamp = header.base_timestamp;
+    for (ZyanU32 i = 0; i < header.event_count; ++i)
+    {
+        ZyrexTraceEvent* const event = &events[i];
+        ZyanU64 value;
+
+        ZYAN_CHECK(ZyrexTraceReadVarint(buffer, size, &offset, &value));
+        event->thread_id = (ZyanU32)value;
+        ZYAN_CHECK(ZyrexTraceReadVarint(buffer, size, &offset, &value));
+        timestamp += (value >> 1) ^ (~(value & 1) + 1);
+        event->timestamp = timestamp;
+        ZYAN_CHECK(ZyrexTraceReadVarint(buffer, size, &offset, &event->function));
+
+        if (offset >= size)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        event->argument_count = buffer[offset++];
+        if (event->argument_count > ZYREX_TRACE_MAX_ARGUMENTS)
+        {
+            return ZYAN_STATUS_INVALID_ARGUMENT;
+        }
+        for (ZyanU8 j = 0; j < event->argument_count; ++j)
+        {
+            ZYAN_CHECK(ZyrexTraceReadVarint(buffer, size, &offset, &event->arguments[j]));
+        }
+    }
+
+    *count = header.event_count;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
\ No newline at end of file
@@ -30,7 +30,9 @@
 #include <Zycore/API/Memory.h>
 #include <Zycore/API/Process.h>
 #include <Zydis/Zydis.h>
+#include <Zyrex/Internal/MemoryMap.h>
 #include <Zyrex/Internal/Relocation.h>
+#include <Zyrex/Internal/RelocationCache.h>
 #include <Zyrex/Internal/Trampoline.h>
 
 #if   defined(ZYAN_WINDOWS)
@@ -42,6 +44,65 @@
 #   error "Unsupported platform detected"
 #endif
 
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+/**
+ * @brief   Defines the maximum size of a trampoline-region.
+ *
+ * The trampoline-region size gets clamped to this value, if the allocation-granularity exceeds 
+ * it.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_SIZE    0x10000
+
+/**
+ * @brief   Defines the maximum amount of pages per trampoline-region (assuming a minimum page 
+ *          size of 4KiB).
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_PAGES \
+    (ZYREX_TRAMPOLINE_REGION_MAX_SIZE / 0x1000)
+
+/**
+ * @brief   Defines the maximum amount of chunks per trampoline-region.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS \
+    (ZYREX_TRAMPOLINE_REGION_MAX_SIZE / \
+        (sizeof(ZyrexTrampolineChunk) + ZYREX_TRAMPOLINE_CODE_SLOT_SIZE))
+
+/**
+ * @brief   Defines the number of 64-bit words in the free-chunk bitmap of a trampoline-region.
+ */
+#define ZYREX_TRAMPOLINE_REGION_BITMAP_WORDS \
+    ((ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS + 63) / 64)
+
+/**
+ * @brief   Defines the number of 64-bit words in the bitmap of non-empty density buckets.
+ *
+ * There is one density bucket for every possible number of unused chunks in a region.
+ */
+#define ZYREX_TRAMPOLINE_BUCKET_BITMAP_WORDS \
+    ((ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS + 1 + 63) / 64)
+
+/**
+ * @brief   Defines the maximum amount of distinct callbacks per trampoline-region.
+ */
+#define ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS \
+    64
+
+/**
+ * @brief   Defines the size and alignment of a shared callback stub.
+ */
+#define ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE \
+    8
+
+/**
+ * @brief   Defines the size of the callback stub area at the beginning of the code area of a 
+ *          trampoline-region.
+ */
+#define ZYREX_TRAMPOLINE_CALLBACK_AREA_SIZE \
+    (ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS * ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE)
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
@@ -51,11 +112,22 @@
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Defines the `ZyrexTrampolineRegion` union.
+ * @brief   Defines the `ZyrexTrampolineRegion` struct.
+ *
+ * A trampoline-region is split into two parts. The first part contains the region header, 
+ * directly followed by the `ZyrexTrampolineChunk` metadata array and never gets executable
+ * memory protection. The second part starts at a page boundary and contains the
+ * `ZyrexTrampolineCode` slots. The code slot with index `n` belongs to the chunk with index `n`.
  *
- * Note that the header shares memory with the first chunk in the trampoline-region.
+ * The code area starts with the callback stubs. The stub with index `n` performs an absolute
+ * indirect jump to the callback address with index `n` in the region header. Stubs are reference
+ * counted and shared by all chunks of the region that redirect to the same callback, except for
+ * private stubs, which belong to a single chunk and allow its callback to be replaced at runtime.
+ *
+ * On x64, every chunk uses a callback stub. On x86, only chunks with a private stub use one, as
+ * all other hooks jump directly to their callback.
  */
-typedef union ZyrexTrampolineRegion_
+typedef struct ZyrexTrampolineRegion_
 {
     /**
      * @brief   The header of the trampoline-region.
@@ -70,6 +142,34 @@ typedef union ZyrexTrampolineRegion_
          * @rief    The number of unused trampoline-chunks.
          */
         ZyanUSize number_of_unused_chunks;
+        /**
+         * @brief   The number of used trampoline-chunks overlapping each page of the 
+         *          trampoline-region.
+         *
+         * A page is committed, if its reference count is greater than zero. The first page is
+         * referenced by the header itself and thus never decommitted.
+         */
+        ZyanU8 page_references[ZYREX_TRAMPOLINE_REGION_MAX_PAGES];
+        /**
+         * @brief   A bitmap that contains a set bit for every unused trampoline-chunk.
+         */
+        ZyanU64 unused_chunks[ZYREX_TRAMPOLINE_REGION_BITMAP_WORDS];
+        /**
+         * @brief   The destination addresses of the callback stubs.
+         *
+         * Entries of private stubs are updated atomically and might change at any time.
+         */
+        volatile ZyanUPointer callback_addresses[ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS];
+        /**
+         * @brief   The number of trampoline-chunks using each callback stub.
+         *
+         * Every callback stub in use holds one reference to the page that contains it.
+         */
+        ZyanU16 callback_references[ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS];
+        /**
+         * @brief   A bitmap that contains a set bit for every private callback stub.
+         */
+        ZyanU64 private_callbacks;
     } header;
     /**
      * @brief   The trampoline-chunks.
@@ -77,8 +177,6 @@ typedef union ZyrexTrampolineRegion_
     ZyrexTrampolineChunk chunks[1];
 } ZyrexTrampolineRegion;
 
-ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineRegion) == sizeof(ZyrexTrampolineChunk));
-
 /* ---------------------------------------------------------------------------------------------- */
 
 /* ============================================================================================== */
@@ -88,8 +186,9 @@ ZYAN_STATIC_ASSERT(sizeof(ZyrexTrampolineRegion) == sizeof(ZyrexTrampolineChunk)
 /**
  * @brief   Contains global trampoline API data.
  *
- * Thread-safety is implicitly guaranteed by the transactional API as only one transaction can be
- * started at a time.
+ * All members are modified with the region lock held. The lock-free functions (like 
+ * `ZyrexTrampolineGetChunk` and the callback modification functions) only read the region 
+ * layout, which never changes after initialization.
  */
 static struct
 {
@@ -104,17 +203,84 @@ static struct
      * the page-size on most other platforms.
      */
     ZyanUSize region_size;
+    /**
+     * @brief   The system page size.
+     */
+    ZyanUSize page_size;
     /**
      * @brief   The maximum amount of chunks per trampoline-region.
      */
     ZyanUSize chunks_per_region;
+    /**
+     * @brief   The offset of the code area relative to the beginning of a trampoline-region.
+     */
+    ZyanUSize code_offset;
+    /**
+     * @brief   The offset of the first code slot relative to the beginning of a 
+     *          trampoline-region.
+     *
+     * On x64, the code slots follow the callback stubs. On all other platforms, this value
+     * equals `code_offset`.
+     */
+    ZyanUSize slot_offset;
     /**
      * @brief   Contains a list of all allocated trampoline-regions.
      */
     ZyanVector regions;
+    /**
+     * @brief   Contains all trampolines with a private callback stub sorted by the address of the
+     *          hooked function.
+     *
+     * Trampolines hooking the same address are kept in creation order.
+     */
+    ZyanVector/*<ZyrexTrampolineChunk*>*/ chains;
+    /**
+     * @brief   Contains the trampoline-regions grouped by their number of unused chunks.
+     *
+     * The bucket with index `n` contains all regions with exactly `n` unused chunks, sorted by
+     * address. Regions without any unused chunk are not part of any bucket.
+     */
+    ZyanVector/*<ZyrexTrampolineRegion*>*/ buckets[ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS + 1];
+    /**
+     * @brief   A bitmap that contains a set bit for every non-empty density bucket.
+     */
+    ZyanU64 bucket_mask[ZYREX_TRAMPOLINE_BUCKET_BITMAP_WORDS];
+    /**
+     * @brief   Contains the state of the current trampoline batch.
+     */
+    struct
+    {
+        /**
+         * @brief   Signals, if a batch is currently active.
+         */
+        ZyanBool is_active;
+        /**
+         * @brief   The trampoline-region that received the most recent trampoline of the batch
+         *          or `ZYAN_NULL`, if none.
+         */
+        ZyrexTrampolineRegion* last_region;
+        /**
+         * @brief   The start address of the most recently validated readable memory range.
+         */
+        ZyanUPointer readable_lo;
+        /**
+         * @brief   The end address (exclusive) of the most recently validated readable memory
+         *          range.
+         */
+        ZyanUPointer readable_hi;
+        /**
+         * @brief   Contains the base addresses of all code pages that have to be protected and
+         *          flushed at the end of the batch (sorted by address).
+         */
+        ZyanVector/*<ZyanUPointer>*/ pages;
+    } batch;
 } g_trampoline_data =
 {
-    ZYAN_FALSE, 0, 0, ZYAN_VECTOR_INITIALIZER
+    ZYAN_FALSE, 0, 0, 0, 0, 0, ZYAN_VECTOR_INITIALIZER, ZYAN_VECTOR_INITIALIZER,
+    { ZYAN_VECTOR_INITIALIZER }, { 0 },
+    {
+        ZYAN_FALSE, ZYAN_NULL, 0, 0, ZYAN_VECTOR_INITIALIZER
+    }
 };
 
 /* ============================================================================================== */
@@ -139,12 +305,24 @@ static struct
  *
  * This function is used to avoid invalid memory access. Note that this can not be guaranteed in
  * a preemptive multi-threading environment.
+ *
+ * While a batch is active, the most recently validated readable range is cached, so that 
+ * subsequent queries for nearby addresses (e.g. functions of the same module) do not require any
+ * additional system calls.
  */
 static ZyanStatus ZyrexGetSizeOfReadableMemoryRegion(const void* address, ZyanUSize* size)
 {
     ZYAN_ASSERT(address);
     ZYAN_ASSERT(size);
 
+    if (g_trampoline_data.batch.is_active &&
+        ((ZyanUPointer)address >= g_trampoline_data.batch.readable_lo) &&
+        ((ZyanUPointer)address <  g_trampoline_data.batch.readable_hi) &&
+        (g_trampoline_data.batch.readable_hi - (ZyanUPointer)address >= *size))
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
     static const DWORD read_mask =
         PAGE_EXECUTE_READ |
         PAGE_EXECUTE_READWRITE |
@@ -166,17 +344,68 @@ static ZyanStatus ZyrexGetSizeOfReadableMemoryRegion(const void* address, ZyanUS
         if ((info.State != MEM_COMMIT) || !(info.Protect & read_mask))
         {
             *size = current_size;
-            return ZYAN_STATUS_SUCCESS;
+            break;
         }
         current_address = (ZyanU8*)info.BaseAddress + info.RegionSize;
         if (current_size == 0)
         {
             current_size = (ZyanUPointer)current_address - (ZyanUPointer)address;
+            if (g_trampoline_data.batch.is_active)
+            {
+                g_trampoline_data.batch.readable_lo = (ZyanUPointer)info.BaseAddress;
+            }
             continue;
         }
         current_size += info.RegionSize;
     }
 
+    if (g_trampoline_data.batch.is_active && (current_size > 0))
+    {
+        g_trampoline_data.batch.readable_hi = (ZyanUPointer)current_address;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   Returns the amount of bytes that can be read from the memory region starting at the
+ *          given `address` up to a maximum size of `size`.
+ *
+ * @param   address The memory address.
+ * @param   size    Receives the amount of bytes that can be read from the memory region which
+ *                  contains `address` and defines the upper limit.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is used to avoid invalid memory access. Note that this can not be guaranteed in
+ * a preemptive multi-threading environment.
+ *
+ * The ranges are looked up in the cached process memory map, which is only rebuilt, if the 
+ * `address` is not contained in any known range.
+ */
+static ZyanStatus ZyrexGetSizeOfReadableMemoryRegion(const void* address, ZyanUSize* size)
+{
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(size);
+
+    ZyanUPointer current_address = (ZyanUPointer)address;
+    ZyanUSize current_size = 0;
+    while (current_size < *size)
+    {
+        const ZyrexMemoryRange* range;
+        const ZyanStatus status = ZyrexMemoryMapFind(current_address, &range);
+        ZYAN_CHECK(status);
+        if ((status == ZYAN_STATUS_FALSE) || !(range->protection & PROT_READ))
+        {
+            *size = current_size;
+            break;
+        }
+        current_size += range->end - current_address;
+        current_address = range->end;
+    }
+
     return ZYAN_STATUS_SUCCESS;
 }
 
@@ -205,14 +434,7 @@ static ZyanStatus ZyrexGetAddressRangeOfRelativeInstructions(const void* buffer,
 {
     ZyanStatus result = ZYAN_STATUS_FALSE;
 
-    ZydisDecoder decoder;
-#if defined(ZYAN_X86)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_COMPAT_32, ZYDIS_ADDRESS_WIDTH_32);
-#elif defined(ZYAN_X64)
-    ZydisDecoderInit(&decoder, ZYDIS_MACHINE_MODE_LONG_64, ZYDIS_ADDRESS_WIDTH_64);
-#else
-#   error "Unsupported architecture detected"
-#endif
+    const ZydisDecoder* const decoder = ZyrexGetDecoder();
 
     ZyanUPointer lo = (ZyanUPointer)(-1);
     ZyanUPointer hi = 0;
@@ -221,7 +443,7 @@ static ZyanStatus ZyrexGetAddressRangeOfRelativeInstructions(const void* buffer,
     while (offset < min_bytes_to_decode)
     {
         const ZyanStatus status =
-            ZydisDecoderDecodeBuffer(&decoder, (ZyanU8*)buffer + offset, size - offset,
+            ZydisDecoderDecodeBuffer(decoder, (ZyanU8*)buffer + offset, size - offset,
                 &instruction);
 
         ZYAN_CHECK(status);
@@ -260,716 +482,2678 @@ static ZyanStatus ZyrexGetAddressRangeOfRelativeInstructions(const void* buffer,
 
 #endif
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Trampoline region                                                                              */
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Checks, if the given region is in a +/-2GiB range to both passed address values.
+ * @brief   Checks, if the given function is preceded by padding bytes that can hold the 
+ *          relative jump of a hot-patch hook.
  *
- * @param   region_address      The base address of the trampoline region to check.
- * @param   address_lo          The memory address lower bound to be used as condition.
- * @param   address_hi          The memory address upper bound to be used as condition.
+ * @param   address The address of the function.
  *
- * @return  `ZYAN_STATUS_TRUE` if both address values are in range,
- *          `ZYAN_STATUS_FALSE` if only one address value is in range, or
- *          `ZYAN_STATUS_OUT_OF_RANGE`, if both address values are out of range.
+ * @return  `ZYAN_TRUE`, if the `ZYREX_SIZEOF_RELATIVE_JUMP` bytes in front of the function 
+ *          consist of `INT 3` and `NOP` instructions only, `ZYAN_FALSE` if not.
+ *
+ * MSVC emits this kind of padding for functions compiled with `/hotpatch` and 
+ * `/FUNCTIONPADMIN`. Most other compilers align functions using `INT 3` or `NOP` padding as
+ * well.
  */
-static ZyanBool ZyrexTrampolineRegionInRange(ZyanUPointer region_address,
-    ZyanUPointer address_lo, ZyanUPointer address_hi)
+static ZyanBool ZyrexIsHotPatchable(const void* address)
 {
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO(region_address, g_trampoline_data.region_size));
+    ZYAN_ASSERT(address);
 
-    // Skip the first chunk as it shares memory with the region-header
-    const ZyanIPointer region_base = region_address + sizeof(ZyrexTrampolineChunk);
+    const ZyanU8* const padding = (const ZyanU8*)address - ZYREX_SIZEOF_RELATIVE_JUMP;
 
-    const ZyanIPointer distance_lo =
-        region_base - (ZyanIPointer)address_lo + (ZyanIPointer)address_lo < region_base
-            ? sizeof(ZyrexTrampolineChunk)
-            : sizeof(ZyrexTrampolineChunk) * (g_trampoline_data.chunks_per_region - 1);
-    if ((ZYAN_ABS(distance_lo) > ZYREX_RANGEOF_RELATIVE_JUMP))
+    ZyanUSize size = ZYREX_SIZEOF_RELATIVE_JUMP;
+    if (!ZYAN_SUCCESS(ZyrexGetSizeOfReadableMemoryRegion(padding, &size)) || 
+        (size < ZYREX_SIZEOF_RELATIVE_JUMP))
     {
         return ZYAN_FALSE;
     }
 
-    const ZyanIPointer distance_hi =
-        region_base - (ZyanIPointer)address_hi + (ZyanIPointer)address_hi < region_base
-            ? sizeof(ZyrexTrampolineChunk)
-            : sizeof(ZyrexTrampolineChunk) * (g_trampoline_data.chunks_per_region - 1);
-    if ((ZYAN_ABS(distance_hi) > ZYREX_RANGEOF_RELATIVE_JUMP))
+    for (ZyanUSize i = 0; i < ZYREX_SIZEOF_RELATIVE_JUMP; ++i)
     {
-        return ZYAN_FALSE;
+        if ((padding[i] != 0xCC) && (padding[i] != 0x90))
+        {
+            return ZYAN_FALSE;
+        }
     }
 
     return ZYAN_TRUE;
 }
 
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline region                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
 /**
- * @brief   Searches the given trampoline-region for an unused `ZyrexTrampolineChunk` item that
- *          lies in a +/-2GiB range to both given addresses.
+ * @brief   Returns the index of the trampoline-region page that contains the given `address`.
  *
- * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
- * @param   address_lo  The memory address lower bound to be used as search condition.
- * @param   address_hi  The memory address upper bound to be used as search condition.
- * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   address The address.
+ *
+ * @return  The index of the page that contains the given `address`.
  */
-static ZyanBool ZyrexTrampolineRegionFindChunkInRegion(ZyrexTrampolineRegion* region,
-    ZyanUPointer address_lo, ZyanUPointer address_hi, ZyrexTrampolineChunk** chunk)
+static ZyanUSize ZyrexTrampolineRegionGetPageIndex(const ZyrexTrampolineRegion* region,
+    ZyanUPointer address)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(chunk);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-
-    if (region->header.number_of_unused_chunks == 0)
-    {
-        return ZYAN_FALSE;
-    }
-
-    if (!ZyrexTrampolineRegionInRange((ZyanUPointer)region, address_lo, address_hi))
-    {
-        return ZYAN_FALSE;
-    }
-
-    // Skip the first chunk as it shares memory with the region-header
-    for (ZyanUSize i = 1; i < g_trampoline_data.chunks_per_region; ++i)
-    {
-        if (region->chunks[i].is_used)
-        {
-            continue;
-        }
-
-        const ZyanIPointer chunk_base = (ZyanIPointer)&region->chunks[i];
-
-        const ZyanIPointer distance_lo_chunk = chunk_base - (ZyanIPointer)address_lo +
-            (((ZyanIPointer)address_lo < chunk_base) ? sizeof(ZyrexTrampolineChunk) : 0);
-        if ((ZYAN_ABS(distance_lo_chunk) > ZYREX_RANGEOF_RELATIVE_JUMP))
-        {
-            continue;
-        }
-
-        const ZyanIPointer distance_hi_chunk = chunk_base - (ZyanIPointer)address_hi +
-            (((ZyanIPointer)address_hi < chunk_base) ? sizeof(ZyrexTrampolineChunk) : 0);
-        if ((ZYAN_ABS(distance_hi_chunk) > ZYREX_RANGEOF_RELATIVE_JUMP))
-        {
-            continue;
-        }
-
-        *chunk = &region->chunks[i];
-        return ZYAN_TRUE;
-    }
+    ZYAN_ASSERT(address >= (ZyanUPointer)region);
+    ZYAN_ASSERT(address < (ZyanUPointer)region + g_trampoline_data.region_size);
 
-    return ZYAN_FALSE;
+    return (address - (ZyanUPointer)region) / g_trampoline_data.page_size;
 }
 
 /**
- * @brief   Searches the global trampoline-region list for an unused `ZyrexTrampolineChunk` item
- *          that lies in a +/-2GiB range to both given addresses.
+ * @brief   Returns the index of the given `chunk` inside its trampoline-region.
  *
- * @param   address_lo  The memory address lower bound to be used as search condition.
- * @param   address_hi  The memory address upper bound to be used as search condition.
- * @param   region      Receives a pointer to a matching `ZyrexTrampolineRegion` struct.
- * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
  *
- * @return  `ZYAN_STATUS_TRUE` if a valid chunk was found in an already allocated trampoline region,
- *          `ZYAN_STATUS_FALSE` if not, or a generic zyan status code if an error occured.
+ * @return  The index of the given `chunk`.
  */
-static ZyanStatus ZyrexTrampolineRegionFindChunk(ZyanUPointer address_lo, ZyanUPointer address_hi,
-    ZyrexTrampolineRegion** region, ZyrexTrampolineChunk** chunk)
+static ZyanUSize ZyrexTrampolineRegionGetChunkIndex(const ZyrexTrampolineRegion* region,
+    const ZyrexTrampolineChunk* chunk)
 {
     ZYAN_ASSERT(region);
     ZYAN_ASSERT(chunk);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-
-    ZyanUSize size;
-    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
-    if (size == 0)
-    {
-        goto RegionNotFound;
-    }
+    ZYAN_ASSERT((ZyanUPointer)chunk >= (ZyanUPointer)region);
 
-    const ZyanUSize mid = (address_lo + address_hi) / 2;
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &mid, &found_index,
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
+    const ZyanUSize index = chunk - &region->chunks[0];
+    ZYAN_ASSERT(index < g_trampoline_data.chunks_per_region);
 
-    if (found_index == size)
-    {
-        --found_index;
-    }
-    ZyanISize lo = found_index;
-    ZyanISize hi = found_index + 1;
-    ZyrexTrampolineRegion** element;
-    while (ZYAN_TRUE)
-    {
-        ZyanU8 c = 0;
+    return index;
+}
 
-        if (lo >= 0)
-        {
-            element = (ZyrexTrampolineRegion**)ZyanVectorGet(&g_trampoline_data.regions, lo--);
-            ZYAN_ASSERT(element);
-            if (ZyrexTrampolineRegionFindChunkInRegion(*element, address_lo, address_hi, chunk))
-            {
-                break;
-            }
-            ++c;
-        }
-        if (hi < (ZyanISize)size)
-        {
-            element = (ZyrexTrampolineRegion**)ZyanVectorGet(&g_trampoline_data.regions, hi++);
-            ZYAN_ASSERT(element);
-            if (ZyrexTrampolineRegionFindChunkInRegion(*element, address_lo, address_hi, chunk))
-            {
-                break;
-            }
-            ++c;
-        }
+/**
+ * @brief   Returns the code slot with the given `index` inside the given trampoline-region.
+ *
+ * @param   region_address  The base address of the trampoline-region.
+ * @param   index           The index of the code slot.
+ *
+ * @return  A pointer to the `ZyrexTrampolineCode` struct.
+ */
+static ZyrexTrampolineCode* ZyrexTrampolineRegionGetCode(ZyanUPointer region_address, 
+    ZyanUSize index)
+{
+    ZYAN_ASSERT(index < g_trampoline_data.chunks_per_region);
 
-        if (c == 0)
-        {
-            goto RegionNotFound;
-        }
-    }
+    return (ZyrexTrampolineCode*)(region_address + g_trampoline_data.slot_offset + 
+        index * ZYREX_TRAMPOLINE_CODE_SLOT_SIZE);
+}
 
-    *region = *element;
-    return ZYAN_STATUS_TRUE;
+/**
+ * @brief   Returns the callback stub with the given `index` inside the given trampoline-region.
+ *
+ * @param   region_address  The base address of the trampoline-region.
+ * @param   index           The index of the callback stub.
+ *
+ * @return  A pointer to the callback stub.
+ */
+static ZyanU8* ZyrexTrampolineRegionGetCallbackStub(ZyanUPointer region_address, ZyanUSize index)
+{
+    ZYAN_ASSERT(index < ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS);
 
-RegionNotFound:
-    return ZYAN_STATUS_FALSE;
+    return (ZyanU8*)(region_address + g_trampoline_data.code_offset + 
+        index * ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE);
 }
 
 /**
- * @brief   Inserts a new `ZyrexTrampolineRegion` item to the global trampoline-region list.
+ * @brief   Returns the index of the given callback stub inside the given trampoline-region.
  *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
+ * @param   region          A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   callback_jump   A pointer to the callback stub.
  *
- * @return  A zyan status code.
+ * @return  The index of the callback stub.
  */
-static ZyanStatus ZyrexTrampolineRegionInsert(ZyrexTrampolineRegion* region)
+static ZyanUSize ZyrexTrampolineRegionGetCallbackIndex(const ZyrexTrampolineRegion* region,
+    const ZyanU8* callback_jump)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+    ZYAN_ASSERT(callback_jump);
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region, &found_index,
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
+    const ZyanUSize index = ((ZyanUPointer)callback_jump - (ZyanUPointer)region - 
+        g_trampoline_data.code_offset) / ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE;
+    ZYAN_ASSERT(index < ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS);
 
-    ZYAN_ASSERT(status == ZYAN_STATUS_FALSE);
-    return ZyanVectorInsert(&g_trampoline_data.regions, found_index, &region);
+    return index;
 }
 
 /**
- * @brief   Removes the given `ZyrexTrampolineRegion` item from the global trampoline-region list.
+ * @brief   Returns the callback table entry of the given callback stub.
  *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
+ * @param   region          A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   callback_jump   A pointer to the callback stub.
  *
- * @return  A zyan status code.
+ * @return  A pointer to the callback table entry.
  */
-static ZyanStatus ZyrexTrampolineRegionRemove(ZyrexTrampolineRegion* region)
+static volatile ZyanUPointer* ZyrexTrampolineRegionGetCallbackEntry(ZyrexTrampolineRegion* region,
+    const ZyanU8* callback_jump)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
 
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region, &found_index,
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
+    return &region->header.callback_addresses[
+        ZyrexTrampolineRegionGetCallbackIndex(region, callback_jump)];
+}
 
-    ZYAN_ASSERT(status == ZYAN_STATUS_TRUE);
-    return ZyanVectorDelete(&g_trampoline_data.regions, found_index);
+/**
+ * @brief   Checks, if a trampoline redirects to its callback by using a callback stub.
+ *
+ * @param   is_private  Signals, if the trampoline requires a private callback stub.
+ *
+ * @return  `ZYAN_TRUE`, if the trampoline uses a callback stub, `ZYAN_FALSE` if it jumps
+ *          directly to its callback.
+ */
+static ZyanBool ZyrexTrampolineRequiresCallbackStub(ZyanBool is_private)
+{
+#if defined(ZYAN_X64)
+    ZYAN_UNUSED(is_private);
+    return ZYAN_TRUE;
+#else
+    return is_private;
+#endif
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-
 /**
- * @brief   Changes the memory protection of the passed trampoline-region to `RX`.
+ * @brief   Checks, if the given trampoline-chunk is in use.
  *
  * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the trampoline-chunk.
  *
- * @return  A zyan status code.
+ * @return  `ZYAN_TRUE`, if the chunk is in use or `ZYAN_FALSE`, if not.
+ *
+ * This function only accesses the region header. Chunks located on a page that is not committed
+ * are always unused.
  */
-static ZyanStatus ZyrexTrampolineRegionProtect(ZyrexTrampolineRegion* region)
+static ZyanBool ZyrexTrampolineRegionIsChunkUsed(const ZyrexTrampolineRegion* region,
+    ZyanUSize index)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+    ZYAN_ASSERT(index < g_trampoline_data.chunks_per_region);
 
-    return ZyanMemoryVirtualProtect(region, sizeof(ZyrexTrampolineChunk), 
-        ZYAN_PAGE_EXECUTE_READ);
+    return !(region->header.unused_chunks[index / 64] & ((ZyanU64)1 << (index % 64)));
 }
 
 /**
- * @brief   Changes the memory protection of the passed trampoline-region to `RWX`.
+ * @brief   Makes sure the given density bucket is able to receive another region without 
+ *          allocating memory.
  *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   number_of_unused_chunks The number of unused chunks of the bucket.
  *
  * @return  A zyan status code.
  */
-static ZyanStatus ZyrexTrampolineRegionUnprotect(ZyrexTrampolineRegion* region)
+static ZyanStatus ZyrexTrampolineBucketReserve(ZyanUSize number_of_unused_chunks)
 {
-    ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
-    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+    ZYAN_ASSERT(number_of_unused_chunks <= g_trampoline_data.chunks_per_region);
 
-    return ZyanMemoryVirtualProtect(region, sizeof(ZyrexTrampolineChunk),
-        ZYAN_PAGE_EXECUTE_READWRITE);
+    if (number_of_unused_chunks == 0)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanVector* const bucket = &g_trampoline_data.buckets[number_of_unused_chunks];
+    if (!bucket->data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(bucket, sizeof(ZyrexTrampolineRegion*), 8, ZYAN_NULL));
+    }
+
+    return ZyanVectorReserve(bucket, bucket->size + 1);
 }
 
 /**
- * Allocates memory for a new trampoline region in a +/-2GiB range of both passed address values
- * and initializes it.
- *
- * @param   address_lo  The memory address lower bound.
- * @param   address_hi  The memory address upper bound.
- * @param   region      Receives a pointer to the new `ZyrexTrampolineRegion` struct.
+ * @brief   Inserts the given trampoline-region into the density bucket that matches its current
+ *          number of unused chunks.
  *
- * Regions allocated by this function will have `RWX` memory protection.
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
  *
- * @return  A zyan status code.
+ * The bucket has to be reserved using `ZyrexTrampolineBucketReserve` before.
  */
-static ZyanStatus ZyrexTrampolineRegionAllocate(ZyanUPointer address_lo, ZyanUPointer address_hi,
-    ZyrexTrampolineRegion** region)
+static void ZyrexTrampolineBucketInsert(ZyrexTrampolineRegion* region)
 {
     ZYAN_ASSERT(region);
-    ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-#ifdef ZYAN_WINDOWS
+    const ZyanUSize number_of_unused_chunks = region->header.number_of_unused_chunks;
+    if (number_of_unused_chunks == 0)
+    {
+        return;
+    }
 
-    SYSTEM_INFO system_info;
-    GetSystemInfo(&system_info);
+    ZyanVector* const bucket = &g_trampoline_data.buckets[number_of_unused_chunks];
+    ZYAN_ASSERT(bucket->data && (bucket->size < bucket->capacity));
 
-    const ZyanUSize region_size = g_trampoline_data.region_size;
-    const ZyanUPointer mid = (address_lo + address_hi) / 2;
-    const ZyanU8* alloc_address_lo =
-        (const ZyanU8*)ZYAN_ALIGN_DOWN(mid, (ZyanUPointer)region_size);
-    const ZyanU8* alloc_address_hi =
-        (const ZyanU8*)ZYAN_ALIGN_UP(mid, (ZyanUPointer)region_size);
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(bucket, &region, &found_index, 
+        (ZyanComparison)&ZyanComparePointer);
+    ZYAN_ASSERT(status == ZYAN_STATUS_FALSE);
+    ZYAN_UNUSED(status);
 
-    MEMORY_BASIC_INFORMATION memory_info;
+    ZYAN_UNUSED(ZyanVectorInsert(bucket, found_index, &region));
+    g_trampoline_data.bucket_mask[number_of_unused_chunks / 64] |= 
+        (ZyanU64)1 << (number_of_unused_chunks % 64);
+}
 
-#endif
+/**
+ * @brief   Removes the given trampoline-region from the density bucket that matches its current
+ *          number of unused chunks.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * Regions that are not part of the bucket (e.g. new regions that were not inserted yet) are 
+ * silently ignored.
+ */
+static void ZyrexTrampolineBucketRemove(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
 
-    while (ZYAN_TRUE)
+    const ZyanUSize number_of_unused_chunks = region->header.number_of_unused_chunks;
+    ZyanVector* const bucket = &g_trampoline_data.buckets[number_of_unused_chunks];
+    if ((number_of_unused_chunks == 0) || !bucket->data)
     {
-#ifdef ZYAN_WINDOWS
+        return;
+    }
 
-        // Skip reserved address regions
-        if (alloc_address_lo < (ZyanU8*)system_info.lpMinimumApplicationAddress)
-        {
-            alloc_address_lo = (const ZyanU8*)system_info.lpMinimumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_UP((ZyanUPointer)alloc_address_lo, region_size));
-        }
-        if (alloc_address_lo > (ZyanU8*)system_info.lpMaximumApplicationAddress)
+    ZyanUSize found_index;
+    if (ZyanVectorBinarySearch(bucket, &region, &found_index, 
+        (ZyanComparison)&ZyanComparePointer) != ZYAN_STATUS_TRUE)
+    {
+        return;
+    }
+
+    // The region is removed, even if shrinking the bucket fails
+    ZYAN_UNUSED(ZyanVectorDelete(bucket, found_index));
+    if (bucket->size == 0)
+    {
+        g_trampoline_data.bucket_mask[number_of_unused_chunks / 64] &= 
+            ~((ZyanU64)1 << (number_of_unused_chunks % 64));
+    }
+}
+
+/**
+ * @brief   Releases the memory of all density buckets.
+ *
+ * This function has to be called after the last trampoline-region was removed.
+ */
+static void ZyrexTrampolineBucketDestroyAll(void)
+{
+    for (ZyanUSize i = 0; i < ZYAN_ARRAY_LENGTH(g_trampoline_data.buckets); ++i)
+    {
+        ZyanVector* const bucket = &g_trampoline_data.buckets[i];
+        ZYAN_ASSERT(bucket->size == 0);
+        if (bucket->data)
         {
-            alloc_address_lo = (const ZyanU8*)system_info.lpMaximumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_DOWN((ZyanUPointer)alloc_address_lo, region_size));
+            ZYAN_UNUSED(ZyanVectorDestroy(bucket));
+            bucket->data = ZYAN_NULL;
         }
-        if (alloc_address_hi < (ZyanU8*)system_info.lpMinimumApplicationAddress)
+    }
+    ZYAN_MEMSET(g_trampoline_data.bucket_mask, 0, sizeof(g_trampoline_data.bucket_mask));
+}
+
+/**
+ * @brief   Marks the given trampoline-chunk as used or unused.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   index   The index of the trampoline-chunk.
+ * @param   is_used `ZYAN_TRUE` to mark the chunk as used or `ZYAN_FALSE` to mark it as unused.
+ *
+ * The region is moved to the density bucket that matches its new number of unused chunks. The
+ * destination bucket has to be reserved using `ZyrexTrampolineBucketReserve` before.
+ */
+static void ZyrexTrampolineRegionSetChunkUsed(ZyrexTrampolineRegion* region, ZyanUSize index,
+    ZyanBool is_used)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(index < g_trampoline_data.chunks_per_region);
+    ZYAN_ASSERT(ZyrexTrampolineRegionIsChunkUsed(region, index) != is_used);
+
+    ZyrexTrampolineBucketRemove(region);
+
+    const ZyanU64 mask = (ZyanU64)1 << (index % 64);
+    if (is_used)
+    {
+        region->header.unused_chunks[index / 64] &= ~mask;
+        --region->header.number_of_unused_chunks;
+    } else
+    {
+        region->header.unused_chunks[index / 64] |= mask;
+        ++region->header.number_of_unused_chunks;
+    }
+
+    ZyrexTrampolineBucketInsert(region);
+}
+
+/**
+ * @brief   Increments the reference count of the given trampoline-region page and commits it, 
+ *          if required.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   page    The index of the page.
+ *
+ * @return  A zyan status code.
+ *
+ * Metadata pages are committed with `RW` memory protection. Code pages are committed with `RWX`
+ * memory protection and have to be protected by the caller after writing the code.
+ */
+static ZyanStatus ZyrexTrampolineRegionCommitPage(ZyrexTrampolineRegion* region, ZyanUSize page)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(page < ZYREX_TRAMPOLINE_REGION_MAX_PAGES);
+
+    if (region->header.page_references[page] == 0)
+    {
+        const ZyanBool is_code = 
+            (page * g_trampoline_data.page_size >= g_trampoline_data.code_offset);
+#if   defined(ZYAN_WINDOWS)
+        if (!VirtualAlloc((ZyanU8*)region + page * g_trampoline_data.page_size, 
+            g_trampoline_data.page_size, MEM_COMMIT, 
+            is_code ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE))
         {
-            alloc_address_hi = (const ZyanU8*)system_info.lpMinimumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_UP((ZyanUPointer)alloc_address_lo, region_size));
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
         }
-        if (alloc_address_hi > (ZyanU8*)system_info.lpMaximumApplicationAddress)
+#elif defined(ZYAN_POSIX)
+        // Anonymous mappings are backed by zero pages on first access
+        if (mprotect((ZyanU8*)region + page * g_trampoline_data.page_size, 
+            g_trampoline_data.page_size, 
+            is_code ? (PROT_READ | PROT_WRITE | PROT_EXEC) : (PROT_READ | PROT_WRITE)) != 0)
         {
-            alloc_address_hi = (const ZyanU8*)system_info.lpMaximumApplicationAddress;
-            alloc_address_lo = 
-                (const ZyanU8*)(ZYAN_ALIGN_DOWN((ZyanUPointer)alloc_address_lo, region_size));
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
         }
+#endif
+    }
 
-//#endif
+    ZYAN_ASSERT(region->header.page_references[page] < 0xFF);
+    ++region->header.page_references[page];
+
+    return ZYAN_STATUS_SUCCESS;
+}
 
-        // TODO: Only `RESERVE` the memory region and `COMMIT` pages on demand to reduce memory
-        // TODO: imprint
+/**
+ * @brief   Decrements the reference count of the given trampoline-region page and decommits it, 
+ *          if it is no longer in use.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   page    The index of the page.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionDecommitPage(ZyrexTrampolineRegion* region, 
+    ZyanUSize page)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(page < ZYREX_TRAMPOLINE_REGION_MAX_PAGES);
+    ZYAN_ASSERT(region->header.page_references[page] > 0);
 
-        ZyanU8 c = 0;
+    if (--region->header.page_references[page] > 0)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
 
-        if (ZyrexTrampolineRegionInRange((ZyanUPointer)alloc_address_lo, address_lo, address_hi))
-        {
-            ZYAN_MEMSET(&memory_info, 0, sizeof(memory_info));
-            if (!VirtualQuery(alloc_address_lo, &memory_info, sizeof(memory_info)))
-            {
-                return ZYAN_STATUS_BAD_SYSTEMCALL;
-            }
-            if ((memory_info.State == MEM_FREE) && (memory_info.RegionSize >= region_size))
-            {
-                *region = VirtualAlloc((void*)alloc_address_lo, region_size,
-                    MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
-                if (*region)
-                {
-                    goto InitializeRegion;
-                }
-            }
-            alloc_address_lo = (const ZyanU8*)((ZyanUPointer)memory_info.BaseAddress - region_size);
-            ++c;
-        }
+    void* const address = (ZyanU8*)region + page * g_trampoline_data.page_size;
+#if   defined(ZYAN_WINDOWS)
+    if (!VirtualFree(address, g_trampoline_data.page_size, MEM_DECOMMIT))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    if ((madvise(address, g_trampoline_data.page_size, MADV_DONTNEED) != 0) ||
+        (mprotect(address, g_trampoline_data.page_size, PROT_NONE) != 0))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Commits all pages of the given trampoline-region that overlap with the given `chunk`
+ *          or its code slot and increments their reference counts.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionCommitChunk(ZyrexTrampolineRegion* region,
+    const ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-        if (ZyrexTrampolineRegionInRange((ZyanUPointer)alloc_address_hi, address_lo, address_hi))
+    const ZyanUSize first = ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)chunk);
+    const ZyanUSize last  = ZyrexTrampolineRegionGetPageIndex(region, 
+        (ZyanUPointer)chunk + sizeof(ZyrexTrampolineChunk) - 1);
+    const ZyanUSize code  = ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)
+        ZyrexTrampolineRegionGetCode((ZyanUPointer)region, 
+            ZyrexTrampolineRegionGetChunkIndex(region, chunk)));
+    ZYAN_ASSERT(code > last);
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZyanUSize i = first;
+    for (; i <= last; ++i)
+    {
+        status = ZyrexTrampolineRegionCommitPage(region, i);
+        if (!ZYAN_SUCCESS(status))
         {
-            memset(&memory_info, 0, sizeof(memory_info));
-            if (!VirtualQuery(alloc_address_hi, &memory_info, sizeof(memory_info)))
-            {
-                return ZYAN_STATUS_BAD_SYSTEMCALL;
-            }
-            if ((memory_info.State == MEM_FREE) && (memory_info.RegionSize >= region_size))
-            {
-                *region = VirtualAlloc((void*)alloc_address_hi, region_size,
-                    MEM_RESERVE | MEM_COMMIT, PAGE_EXECUTE_READWRITE);
-                if (*region)
-                {
-                    goto InitializeRegion;
-                }
-            }
-            alloc_address_hi = (const ZyanU8*)((ZyanUPointer)memory_info.BaseAddress + region_size);
-            ++c;
+            break;
         }
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTrampolineRegionCommitPage(region, code);
+    }
 
-        if (c == 0)
+    if (!ZYAN_SUCCESS(status))
+    {
+        // Roll back the references of the pages we already committed
+        while (i-- > first)
         {
-            return ZYAN_STATUS_OUT_OF_RANGE;
+            ZYAN_UNUSED(ZyrexTrampolineRegionDecommitPage(region, i));
         }
-#else
-        ZYAN_UNUSED(address_lo);
-        ZYAN_UNUSED(address_hi);
-#endif
     }
 
-    // ZYAN_UNREACHABLE;
+    return status;
+}
 
-#ifdef ZYAN_WINDOWS
-InitializeRegion:
-    (*region)->header.signature = ZYREX_TRAMPOLINE_REGION_SIGNATURE;
-    (*region)->header.number_of_unused_chunks = g_trampoline_data.chunks_per_region - 1;
-#endif
+/**
+ * @brief   Decrements the reference counts of all pages of the given trampoline-region that 
+ *          overlap with the given `chunk` or its code slot and decommits pages that are no 
+ *          longer in use.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionDecommitChunk(ZyrexTrampolineRegion* region,
+    const ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
 
-    return ZYAN_STATUS_SUCCESS;
+    const ZyanUSize first = ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)chunk);
+    const ZyanUSize last  = ZyrexTrampolineRegionGetPageIndex(region, 
+        (ZyanUPointer)chunk + sizeof(ZyrexTrampolineChunk) - 1);
+    const ZyanUSize code  = ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)
+        ZyrexTrampolineRegionGetCode((ZyanUPointer)region, 
+            ZyrexTrampolineRegionGetChunkIndex(region, chunk)));
+
+    ZyanStatus status = ZyrexTrampolineRegionDecommitPage(region, code);
+    for (ZyanUSize i = first; i <= last; ++i)
+    {
+        const ZyanStatus status_page = ZyrexTrampolineRegionDecommitPage(region, i);
+        if (!ZYAN_SUCCESS(status_page))
+        {
+            status = status_page;
+        }
+    }
+
+    return status;
 }
 
 /**
- * @brief   Frees the memory of the given trampoline region.
+ * @brief   Changes the memory protection of the code page that contains the given `code` 
+ *          address.
  *
- * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   code        An address inside the code area of the trampoline-region.
+ * @param   protection  The new page protection.
  *
  * @return  A zyan status code.
+ *
+ * The metadata area always keeps its `RW` memory protection.
+ *
+ * While a batch is active, the code page is made writable once and stays writable until the end
+ * of the batch, regardless of the requested `protection`.
  */
-static ZyanStatus ZyrexTrampolineRegionFree(ZyrexTrampolineRegion* region)
+static ZyanStatus ZyrexTrampolineRegionProtectCode(ZyrexTrampolineRegion* region,
+    ZyanUPointer code, ZyanMemoryPageProtection protection)
 {
     ZYAN_ASSERT(region);
     ZYAN_ASSERT(g_trampoline_data.is_initialized);
     ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+    ZYAN_ASSERT(code >= (ZyanUPointer)region + g_trampoline_data.code_offset);
 
-    return ZyanMemoryVirtualFree(region, g_trampoline_data.region_size);
+    const ZyanUSize page = ZyrexTrampolineRegionGetPageIndex(region, code);
+    if (region->header.page_references[page] == 0)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanUPointer page_address = (ZyanUPointer)region + page * g_trampoline_data.page_size;
+    if (!g_trampoline_data.batch.is_active)
+    {
+        return ZyanMemoryVirtualProtect((void*)page_address, g_trampoline_data.page_size, 
+            protection);
+    }
+
+    ZyanUSize found_index;
+    const ZyanStatus status =
+        ZyanVectorBinarySearch(&g_trampoline_data.batch.pages, &page_address, &found_index,
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZYAN_CHECK(ZyanMemoryVirtualProtect((void*)page_address, g_trampoline_data.page_size, 
+        ZYAN_PAGE_EXECUTE_READWRITE));
+    return ZyanVectorInsert(&g_trampoline_data.batch.pages, found_index, &page_address);
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Trampoline chunk                                                                               */
-/* ---------------------------------------------------------------------------------------------- */
+/**
+ * @brief   Changes the memory protection of the code page that contains the code slot of the
+ *          given `chunk`.
+ *
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk       A pointer to the `ZyrexTrampolineChunk` struct.
+ * @param   protection  The new page protection.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionProtectChunk(ZyrexTrampolineRegion* region,
+    const ZyrexTrampolineChunk* chunk, ZyanMemoryPageProtection protection)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+
+    return ZyrexTrampolineRegionProtectCode(region, (ZyanUPointer)ZyrexTrampolineRegionGetCode(
+        (ZyanUPointer)region, ZyrexTrampolineRegionGetChunkIndex(region, chunk)), protection);
+}
 
 /**
- * @brief   Initializes a new trampoline chunk and relocates the instructions from the original
- *          function.
+ * @brief   Checks, if the given trampoline-region is able to provide a callback stub for the
+ *          given `callback`.
  *
- * @param   chunk               A pointer to the `ZyrexTrampolineChunk` struct.
- * @param   address             The address of the function to create the trampoline for.
- * @param   callback            The address of the callback function the hook will redirect to.
- * @param   min_bytes_to_reloc  Specifies the minimum amount of  bytes that need to be relocated
- *                              to the trampoline (usually equals the size of the branch
- *                              instruction used for hooking).
- *                              This function might copy more bytes on demand to keep individual
- *                              instructions intact.
- * @param   max_bytes_to_read   The maximum amount of bytes that can be safely read from the given
- *                              `address`.
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   callback    The address of the callback function.
+ * @param   is_private  Signals, if a private callback stub is required.
+ *
+ * @return  `ZYAN_TRUE` if the region already contains a shared stub for the `callback` or has at
+ *          least one unused stub left, `ZYAN_FALSE` if not.
+ */
+static ZyanBool ZyrexTrampolineRegionHasCallback(const ZyrexTrampolineRegion* region,
+    ZyanUPointer callback, ZyanBool is_private)
+{
+    ZYAN_ASSERT(region);
+
+    for (ZyanUSize i = 0; i < ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS; ++i)
+    {
+        if (region->header.callback_references[i] == 0)
+        {
+            return ZYAN_TRUE;
+        }
+        if (!is_private && !(region->header.private_callbacks & (1ULL << i)) &&
+            (region->header.callback_addresses[i] == callback))
+        {
+            return ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Acquires a reference to the callback stub for the given `callback` and creates the
+ *          stub, if required.
+ *
+ * @param   region          A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   callback        The address of the callback function.
+ * @param   is_private      Signals, if a private callback stub is required.
+ * @param   callback_jump   Receives a pointer to the callback stub.
  *
  * @return  A zyan status code.
+ *
+ * Existing stubs are shared by all chunks that redirect to the same `callback`. A new stub is
+ * committed and written only for callbacks that are not used by any other chunk of the region.
+ * Private stubs are never shared.
+ */
+static ZyanStatus ZyrexTrampolineRegionAcquireCallback(ZyrexTrampolineRegion* region,
+    ZyanUPointer callback, ZyanBool is_private, ZyanU8** callback_jump)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(callback_jump);
+
+    ZyanUSize index = ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS;
+    for (ZyanUSize i = 0; i < ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS; ++i)
+    {
+        if (region->header.callback_references[i] == 0)
+        {
+            if (index == ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS)
+            {
+                index = i;
+            }
+            continue;
+        }
+        if (!is_private && !(region->header.private_callbacks & (1ULL << i)) &&
+            (region->header.callback_addresses[i] == callback))
+        {
+            ZYAN_ASSERT(region->header.callback_references[i] < 0xFFFF);
+            ++region->header.callback_references[i];
+            *callback_jump = ZyrexTrampolineRegionGetCallbackStub((ZyanUPointer)region, i);
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    // The caller already checked the region using `ZyrexTrampolineRegionHasCallback`
+    ZYAN_ASSERT(index < ZYREX_TRAMPOLINE_REGION_MAX_CALLBACKS);
+
+    ZyanU8* const stub = ZyrexTrampolineRegionGetCallbackStub((ZyanUPointer)region, index);
+    const ZyanUSize page = ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)stub);
+
+    ZYAN_CHECK(ZyrexTrampolineRegionCommitPage(region, page));
+    ZyanStatus status = ZyrexTrampolineRegionProtectCode(region, (ZyanUPointer)stub, 
+        ZYAN_PAGE_EXECUTE_READWRITE);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_UNUSED(ZyrexTrampolineRegionDecommitPage(region, page));
+        return status;
+    }
+
+    region->header.callback_addresses[index] = callback;
+    region->header.callback_references[index] = 1;
+    if (is_private)
+    {
+        region->header.private_callbacks |= (1ULL << index);
+    }
+
+    ZYAN_MEMSET(stub, 0xCC, ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE);
+    ZyrexWriteAbsoluteJump(stub, (ZyanUPointer)&region->header.callback_addresses[index]);
+
+    status = ZyrexTrampolineRegionProtectCode(region, (ZyanUPointer)stub, ZYAN_PAGE_EXECUTE_READ);
+    if (ZYAN_SUCCESS(status) && !g_trampoline_data.batch.is_active)
+    {
+        status = ZyanProcessFlushInstructionCache(stub, ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE);
+    }
+
+    *callback_jump = stub;
+
+    return status;
+}
+
+/**
+ * @brief   Releases a reference to the given callback stub.
+ *
+ * @param   region          A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   callback_jump   A pointer to the callback stub.
+ *
+ * @return  A zyan status code.
+ *
+ * The page that contains the stub is decommitted, if it is no longer in use.
+ */
+static ZyanStatus ZyrexTrampolineRegionReleaseCallback(ZyrexTrampolineRegion* region,
+    const ZyanU8* callback_jump)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(callback_jump);
+
+    const ZyanUSize index = ZyrexTrampolineRegionGetCallbackIndex(region, callback_jump);
+    ZYAN_ASSERT(region->header.callback_references[index] > 0);
+
+    if (--region->header.callback_references[index] > 0)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    region->header.callback_addresses[index] = 0;
+    region->header.private_callbacks &= ~(1ULL << index);
+
+    return ZyrexTrampolineRegionDecommitPage(region, 
+        ZyrexTrampolineRegionGetPageIndex(region, (ZyanUPointer)callback_jump));
+}
+
+/**
+ * @brief   Calculates the range of trampoline-chunk indices inside the region at the given 
+ *          address, whose code slots are in a +/-2GiB range to both passed address values.
+ *
+ * @param   region_address      The base address of the trampoline region to check.
+ * @param   address_lo          The memory address lower bound to be used as condition.
+ * @param   address_hi          The memory address upper bound to be used as condition.
+ * @param   first               Receives the index of the first chunk in range.
+ * @param   last                Receives the index of the last chunk in range.
+ *
+ * @return  `ZYAN_TRUE` if at least one chunk is in range or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexTrampolineRegionGetChunkRange(ZyanUPointer region_address,
+    ZyanUPointer address_lo, ZyanUPointer address_hi, ZyanUSize* first, ZyanUSize* last)
+{
+    ZYAN_ASSERT(first);
+    ZYAN_ASSERT(last);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO(region_address, g_trampoline_data.region_size));
+
+    ZyanI64 lo = 0;
+    ZyanI64 hi = (ZyanI64)g_trampoline_data.chunks_per_region - 1;
+
+#if defined(ZYAN_X64)
+
+    // Every byte of a code slot at `c` is in range, if `c >= address_hi - RANGE` and
+    // `c + sizeof(slot) <= address_lo + RANGE`
+    const ZyanI64 slot_size = ZYREX_TRAMPOLINE_CODE_SLOT_SIZE;
+    const ZyanI64 code_base = (ZyanI64)region_address + (ZyanI64)g_trampoline_data.slot_offset;
+    const ZyanI64 offset_lo = (ZyanI64)address_hi - ZYREX_RANGEOF_RELATIVE_JUMP - code_base;
+    const ZyanI64 offset_hi = 
+        (ZyanI64)address_lo + ZYREX_RANGEOF_RELATIVE_JUMP - slot_size - code_base;
+
+    if (offset_hi < 0)
+    {
+        return ZYAN_FALSE;
+    }
+
+    // The callback stubs have to be in range as well
+    const ZyanI64 stub_base = (ZyanI64)region_address + (ZyanI64)g_trampoline_data.code_offset;
+    if ((stub_base < (ZyanI64)address_hi - ZYREX_RANGEOF_RELATIVE_JUMP) ||
+        (stub_base + ZYREX_TRAMPOLINE_CALLBACK_AREA_SIZE > 
+            (ZyanI64)address_lo + ZYREX_RANGEOF_RELATIVE_JUMP))
+    {
+        return ZYAN_FALSE;
+    }
+    if (offset_lo > 0)
+    {
+        lo = ZYAN_MAX(lo, (offset_lo + slot_size - 1) / slot_size);
+    }
+    hi = ZYAN_MIN(hi, offset_hi / slot_size);
+
+#else
+
+    // The relative jump is able to reach the whole address space
+    ZYAN_UNUSED(address_lo);
+    ZYAN_UNUSED(address_hi);
+
+#endif
+
+    if (lo > hi)
+    {
+        return ZYAN_FALSE;
+    }
+
+    *first = (ZyanUSize)lo;
+    *last  = (ZyanUSize)hi;
+    return ZYAN_TRUE;
+}
+
+/**
+ * @brief   Checks, if the given region is in a +/-2GiB range to both passed address values.
+ *
+ * @param   region_address      The base address of the trampoline region to check.
+ * @param   address_lo          The memory address lower bound to be used as condition.
+ * @param   address_hi          The memory address upper bound to be used as condition.
+ *
+ * @return  `ZYAN_TRUE` if at least one chunk of the region is in range of both address values or
+ *          `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexTrampolineRegionInRange(ZyanUPointer region_address,
+    ZyanUPointer address_lo, ZyanUPointer address_hi)
+{
+    ZyanUSize first;
+    ZyanUSize last;
+    return ZyrexTrampolineRegionGetChunkRange(region_address, address_lo, address_hi, &first,
+        &last);
+}
+
+/**
+ * @brief   Searches the given trampoline-region for an unused `ZyrexTrampolineChunk` item that
+ *          lies in a +/-2GiB range to both given addresses.
+ *
+ * @param   region      A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   address_lo  The memory address lower bound to be used as search condition.
+ * @param   address_hi  The memory address upper bound to be used as search condition.
+ * @param   callback    The address of the callback function.
+ * @param   is_private  Signals, if the chunk requires a private callback stub.
+ * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ *
+ * This function only scans the free-chunk bitmap and the callback table in the region header. 
+ */
+static ZyanBool ZyrexTrampolineRegionFindChunkInRegion(ZyrexTrampolineRegion* region,
+    ZyanUPointer address_lo, ZyanUPointer address_hi, ZyanUPointer callback, ZyanBool is_private,
+    ZyrexTrampolineChunk** chunk)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    if (region->header.number_of_unused_chunks == 0)
+    {
+        return ZYAN_FALSE;
+    }
+
+    if (ZyrexTrampolineRequiresCallbackStub(is_private) &&
+        !ZyrexTrampolineRegionHasCallback(region, callback, is_private))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZyanUSize first;
+    ZyanUSize last;
+    if (!ZyrexTrampolineRegionGetChunkRange((ZyanUPointer)region, address_lo, address_hi, &first,
+        &last))
+    {
+        return ZYAN_FALSE;
+    }
+
+    for (ZyanUSize word = first / 64; word <= last / 64; ++word)
+    {
+        ZyanU64 bits = region->header.unused_chunks[word];
+        if (word == first / 64)
+        {
+            bits &= ~(ZyanU64)0 << (first % 64);
+        }
+        if ((word == last / 64) && ((last % 64) != 63))
+        {
+            bits &= ((ZyanU64)1 << ((last % 64) + 1)) - 1;
+        }
+        if (!bits)
+        {
+            continue;
+        }
+
+        *chunk = &region->chunks[word * 64 + ZyrexBitScanForward64(bits)];
+        return ZYAN_TRUE;
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Searches the given density bucket for an unused `ZyrexTrampolineChunk` item that lies
+ *          in a +/-2GiB range to both given addresses.
+ *
+ * @param   bucket      A pointer to the `ZyanVector` that contains the sorted 
+ *                      `ZyrexTrampolineRegion` pointers of the bucket.
+ * @param   address_lo  The memory address lower bound to be used as search condition.
+ * @param   address_hi  The memory address upper bound to be used as search condition.
+ * @param   callback    The address of the callback function.
+ * @param   is_private  Signals, if the chunk requires a private callback stub.
+ * @param   region      Receives a pointer to a matching `ZyrexTrampolineRegion` struct.
+ * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ *
+ * @return  `ZYAN_TRUE` if a valid chunk was found or `ZYAN_FALSE`, if not.
+ *
+ * The search starts at the region nearest to the given addresses and expands in both directions,
+ * until the regions are out of range.
+ */
+static ZyanBool ZyrexTrampolineBucketFindChunk(const ZyanVector* bucket, ZyanUPointer address_lo,
+    ZyanUPointer address_hi, ZyanUPointer callback, ZyanBool is_private, 
+    ZyrexTrampolineRegion** region, ZyrexTrampolineChunk** chunk)
+{
+    ZYAN_ASSERT(bucket);
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+
+    const ZyanUPointer mid = (address_lo + address_hi) / 2;
+    ZyanUSize found_index;
+    if (!ZYAN_SUCCESS(ZyanVectorBinarySearch(bucket, &mid, &found_index,
+        (ZyanComparison)&ZyanComparePointer)))
+    {
+        return ZYAN_FALSE;
+    }
+
+    ZyanISize lo = (ZyanISize)found_index - 1;
+    ZyanISize hi = (ZyanISize)found_index;
+    while ((lo >= 0) || (hi < (ZyanISize)bucket->size))
+    {
+        // The regions are sorted by address. As soon as a region is out of range, all remaining
+        // regions in the same direction are out of range as well
+        if (lo >= 0)
+        {
+            ZyrexTrampolineRegion* const* element = ZyanVectorGet(bucket, lo--);
+            ZYAN_ASSERT(element && *element);
+            if (ZyrexTrampolineRegionFindChunkInRegion(*element, address_lo, address_hi, 
+                callback, is_private, chunk))
+            {
+                *region = *element;
+                return ZYAN_TRUE;
+            }
+            if (!ZyrexTrampolineRegionInRange((ZyanUPointer)*element, address_lo, address_hi))
+            {
+                lo = -1;
+            }
+        }
+        if (hi < (ZyanISize)bucket->size)
+        {
+            ZyrexTrampolineRegion* const* element = ZyanVectorGet(bucket, hi++);
+            ZYAN_ASSERT(element && *element);
+            if (ZyrexTrampolineRegionFindChunkInRegion(*element, address_lo, address_hi, 
+                callback, is_private, chunk))
+            {
+                *region = *element;
+                return ZYAN_TRUE;
+            }
+            if (!ZyrexTrampolineRegionInRange((ZyanUPointer)*element, address_lo, address_hi))
+            {
+                hi = (ZyanISize)bucket->size;
+            }
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Searches the global trampoline-region list for an unused `ZyrexTrampolineChunk` item
+ *          that lies in a +/-2GiB range to both given addresses.
+ *
+ * @param   address_lo  The memory address lower bound to be used as search condition.
+ * @param   address_hi  The memory address upper bound to be used as search condition.
+ * @param   callback    The address of the callback function.
+ * @param   is_private  Signals, if the chunk requires a private callback stub.
+ * @param   region      Receives a pointer to a matching `ZyrexTrampolineRegion` struct.
+ * @param   chunk       Receives a pointer to a matching `ZyrexTrampolineChunk` struct.
+ *
+ * @return  `ZYAN_STATUS_TRUE` if a valid chunk was found in an already allocated trampoline region,
+ *          `ZYAN_STATUS_FALSE` if not, or a generic zyan status code if an error occured.
+ *
+ * Out of all regions in range, the chunk is taken from the one with the fewest unused chunks. On
+ * ties, the nearest region wins. The density buckets are scanned from the most populated one 
+ * and every bucket is searched using a binary search, so regions of less populated buckets are 
+ * never inspected, once a chunk was found.
+ */
+static ZyanStatus ZyrexTrampolineRegionFindChunk(ZyanUPointer address_lo, ZyanUPointer address_hi,
+    ZyanUPointer callback, ZyanBool is_private, ZyrexTrampolineRegion** region, 
+    ZyrexTrampolineChunk** chunk)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    // Subsequent trampolines of a batch are likely to fit into the same region
+    if (g_trampoline_data.batch.last_region && 
+        ZyrexTrampolineRegionFindChunkInRegion(g_trampoline_data.batch.last_region, address_lo, 
+            address_hi, callback, is_private, chunk))
+    {
+        *region = g_trampoline_data.batch.last_region;
+        return ZYAN_STATUS_TRUE;
+    }
+
+    // Prefer the most populated region in range over the nearest one. New trampolines are packed
+    // into as few regions as possible, while sparsely populated regions drain over time and are
+    // released as soon as their last chunk is freed
+    for (ZyanUSize word = 0; word < ZYAN_ARRAY_LENGTH(g_trampoline_data.bucket_mask); ++word)
+    {
+        ZyanU64 bits = g_trampoline_data.bucket_mask[word];
+        while (bits)
+        {
+            const ZyanUSize index = word * 64 + ZyrexBitScanForward64(bits);
+            bits &= bits - 1;
+
+            if (ZyrexTrampolineBucketFindChunk(&g_trampoline_data.buckets[index], address_lo, 
+                address_hi, callback, is_private, region, chunk))
+            {
+                return ZYAN_STATUS_TRUE;
+            }
+        }
+    }
+
+    return ZYAN_STATUS_FALSE;
+}
+
+/**
+ * @brief   Inserts a new `ZyrexTrampolineRegion` item to the global trampoline-region list.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionInsert(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+
+    ZyanUSize found_index;
+    const ZyanStatus status =
+        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region, &found_index,
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+
+    ZYAN_ASSERT(status == ZYAN_STATUS_FALSE);
+    return ZyanVectorInsert(&g_trampoline_data.regions, found_index, &region);
+}
+
+/**
+ * @brief   Removes the given `ZyrexTrampolineRegion` item from the global trampoline-region list.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` item.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionRemove(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+
+    ZyanUSize found_index;
+    const ZyanStatus status =
+        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region, &found_index,
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+
+    ZYAN_ASSERT(status == ZYAN_STATUS_TRUE);
+    ZyrexTrampolineBucketRemove(region);
+    return ZyanVectorDelete(&g_trampoline_data.regions, found_index);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Changes the memory protection of the code page that contains the code slot of the
+ *          given `chunk` to `RX`.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The region header and the chunk metadata always keep their `RW` memory protection.
+ */
+static ZyanStatus ZyrexTrampolineRegionProtect(ZyrexTrampolineRegion* region, 
+    const ZyrexTrampolineChunk* chunk)
+{
+    return ZyrexTrampolineRegionProtectChunk(region, chunk, ZYAN_PAGE_EXECUTE_READ);
+}
+
+/**
+ * @brief   Changes the memory protection of the code page that contains the code slot of the
+ *          given `chunk` to `RWX`.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * The region header and the chunk metadata always keep their `RW` memory protection.
+ */
+static ZyanStatus ZyrexTrampolineRegionUnprotect(ZyrexTrampolineRegion* region,
+    const ZyrexTrampolineChunk* chunk)
+{
+    return ZyrexTrampolineRegionProtectChunk(region, chunk, ZYAN_PAGE_EXECUTE_READWRITE);
+}
+
+/**
+ * @brief   Reserves the memory of a trampoline region at the given `address`.
+ *
+ * @param   address The region aligned start address.
+ *
+ * @return  A pointer to the reserved memory or `ZYAN_NULL`, if the memory could not be reserved 
+ *          at the requested address.
+ *
+ * The whole region is reserved without any access rights. Pages are made accessible on demand by
+ * `ZyrexTrampolineRegionCommitPage`.
+ */
+static void* ZyrexTrampolineRegionReserve(ZyanUPointer address)
+{
+#if   defined(ZYAN_WINDOWS)
+
+    return VirtualAlloc((void*)address, g_trampoline_data.region_size, MEM_RESERVE, 
+        PAGE_EXECUTE_READWRITE);
+
+#elif defined(ZYAN_POSIX)
+
+#   ifdef MAP_FIXED_NOREPLACE
+    void* const result = mmap((void*)address, g_trampoline_data.region_size, PROT_NONE, 
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+#   else
+    void* const result = mmap((void*)address, g_trampoline_data.region_size, PROT_NONE, 
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#   endif
+    if (result == MAP_FAILED)
+    {
+        return ZYAN_NULL;
+    }
+    if ((ZyanUPointer)result != address)
+    {
+        // The kernel ignored the hint
+        ZYAN_UNUSED(munmap(result, g_trampoline_data.region_size));
+        return ZYAN_NULL;
+    }
+
+    return result;
+
+#endif
+}
+
+/**
+ * @brief   Allocates memory for a new trampoline region in a +/-2GiB range of both passed address 
+ *          values and initializes it.
+ *
+ * @param   address_lo  The memory address lower bound.
+ * @param   address_hi  The memory address upper bound.
+ * @param   region      Receives a pointer to the new `ZyrexTrampolineRegion` struct.
+ *
+ * The region memory is only reserved. The first page, which contains the region header, is 
+ * committed with `RW` memory protection. All other pages are committed on demand by 
+ * `ZyrexTrampolineRegionCommitChunk`.
+ *
+ * The free block closest to the midpoint of both addresses is looked up in the cached memory map,
+ * which is shared by all allocations of the current transaction. The map is only rebuilt, if it 
+ * does not contain a matching block or if the block turned out to be occupied concurrently.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionAllocate(ZyanUPointer address_lo, ZyanUPointer address_hi,
+    ZyrexTrampolineRegion** region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    // The whole region has to be in range of both addresses
+#if defined(ZYAN_X64)
+    const ZyanUPointer min_address = (address_hi > ZYREX_RANGEOF_RELATIVE_JUMP) 
+        ? address_hi - ZYREX_RANGEOF_RELATIVE_JUMP 
+        : 0;
+    const ZyanUPointer max_address = 
+        address_lo + ZYREX_RANGEOF_RELATIVE_JUMP - g_trampoline_data.region_size;
+#else
+    const ZyanUPointer min_address = 0;
+    const ZyanUPointer max_address = (ZyanUPointer)-1;
+#endif
+
+    // The initial protection of the reserved memory
+#if   defined(ZYAN_WINDOWS)
+    const ZyanU32 protection = PAGE_EXECUTE_READWRITE;
+#elif defined(ZYAN_POSIX)
+    const ZyanU32 protection = PROT_NONE;
+#endif
+
+    ZyanBool is_updated = ZYAN_FALSE;
+    while (ZYAN_TRUE)
+    {
+        ZyanUPointer address;
+        const ZyanStatus status = ZyrexMemoryMapFindFree((address_lo + address_hi) / 2, 
+            min_address, max_address, g_trampoline_data.region_size, 
+            g_trampoline_data.region_size, &address);
+        ZYAN_CHECK(status);
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            *region = ZyrexTrampolineRegionReserve(address);
+            if (*region)
+            {
+                ZYAN_CHECK(ZyrexMemoryMapInsert(address, g_trampoline_data.region_size, 
+                    protection));
+                break;
+            }
+        }
+
+        // The cached memory map is outdated
+        if (is_updated)
+        {
+            return (status == ZYAN_STATUS_TRUE) 
+                ? ZYAN_STATUS_BAD_SYSTEMCALL 
+                : ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        ZYAN_CHECK(ZyrexMemoryMapUpdate());
+        is_updated = ZYAN_TRUE;
+    }
+
+#if   defined(ZYAN_WINDOWS)
+    if (!VirtualAlloc(*region, g_trampoline_data.page_size, MEM_COMMIT, PAGE_READWRITE))
+    {
+        ZYAN_UNUSED(VirtualFree(*region, 0, MEM_RELEASE));
+        ZYAN_UNUSED(ZyrexMemoryMapRemove((ZyanUPointer)*region));
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    if (mprotect(*region, g_trampoline_data.page_size, PROT_READ | PROT_WRITE) != 0)
+    {
+        ZYAN_UNUSED(munmap(*region, g_trampoline_data.region_size));
+        ZYAN_UNUSED(ZyrexMemoryMapRemove((ZyanUPointer)*region));
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    // Freshly committed memory is zero-initialized
+    (*region)->header.signature = ZYREX_TRAMPOLINE_REGION_SIGNATURE;
+    (*region)->header.page_references[0] = 1;
+    for (ZyanUSize i = 0; i < g_trampoline_data.chunks_per_region; ++i)
+    {
+        (*region)->header.unused_chunks[i / 64] |= (ZyanU64)1 << (i % 64);
+    }
+    (*region)->header.number_of_unused_chunks = g_trampoline_data.chunks_per_region;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Removes all references to the given trampoline-region from the current batch.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * This function has to be called before the region memory is released.
+ */
+static void ZyrexTrampolineBatchRemoveRegion(const ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.batch.is_active);
+
+    if (g_trampoline_data.batch.last_region == region)
+    {
+        g_trampoline_data.batch.last_region = ZYAN_NULL;
+    }
+
+    const ZyanUPointer region_address = (ZyanUPointer)region;
+    ZyanUSize index;
+    ZYAN_UNUSED(ZyanVectorBinarySearch(&g_trampoline_data.batch.pages, &region_address, &index,
+        (ZyanComparison)&ZyanComparePointer));
+
+    ZyanUSize count = 0;
+    while (index + count < g_trampoline_data.batch.pages.size)
+    {
+        const ZyanUPointer* page = ZyanVectorGet(&g_trampoline_data.batch.pages, index + count);
+        ZYAN_ASSERT(page);
+        if (*page >= region_address + g_trampoline_data.region_size)
+        {
+            break;
+        }
+        ++count;
+    }
+    if (count > 0)
+    {
+        ZYAN_UNUSED(ZyanVectorDeleteRange(&g_trampoline_data.batch.pages, index, count));
+    }
+}
+
+/**
+ * @brief   Frees the memory of the given trampoline region.
+ *
+ * @param   region  A pointer to the `ZyrexTrampolineRegion` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineRegionFree(ZyrexTrampolineRegion* region)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+    ZYAN_ASSERT(ZYAN_IS_ALIGNED_TO((ZyanUPointer)region, g_trampoline_data.region_size));
+
+    if (g_trampoline_data.batch.is_active)
+    {
+        ZyrexTrampolineBatchRemoveRegion(region);
+    }
+
+    ZYAN_CHECK(ZyrexMemoryMapRemove((ZyanUPointer)region));
+
+    return ZyanMemoryVirtualFree(region, g_trampoline_data.region_size);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline counters                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Allocates a new `ZyrexTrampolineCounters` struct.
+ *
+ * @param   measure_cycles  Signals, if the time spent inside the barrier should be measured.
+ * @param   counters        Receives a pointer to the new `ZyrexTrampolineCounters` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineCountersCreate(ZyanBool measure_cycles, 
+    ZyrexTrampolineCounters** counters)
+{
+    ZYAN_ASSERT(counters);
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    void* const allocation = 
+        ZYAN_MALLOC(sizeof(ZyrexTrampolineCounters) + ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE - 1);
+    if (!allocation)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    ZyrexTrampolineCounters* const value = (ZyrexTrampolineCounters*)ZYAN_ALIGN_UP(
+        (ZyanUPointer)allocation, ZYREX_TRAMPOLINE_COUNTER_SHARD_SIZE);
+    ZYAN_MEMSET(value, 0, sizeof(ZyrexTrampolineCounters));
+    value->measure_cycles = measure_cycles;
+    value->allocation = allocation;
+
+    *counters = value;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Releases the given `ZyrexTrampolineCounters` struct.
+ *
+ * @param   counters    A pointer to the `ZyrexTrampolineCounters` struct or `ZYAN_NULL`.
+ */
+static void ZyrexTrampolineCountersDestroy(ZyrexTrampolineCounters* counters)
+{
+    if (!counters)
+    {
+        return;
+    }
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(counters->allocation);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Chain index                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns the address of the function hooked by the given trampoline `chunk`.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  The address of the hooked function.
+ */
+static ZyanUPointer ZyrexTrampolineChainGetAddress(const ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    return chunk->backjump_address - chunk->original_code_size;
+}
+
+/**
+ * @brief   Returns the index of the first entry in the chain index that hooks an address greater 
+ *          than or equal to the given `address`.
+ *
+ * @param   address The address of the hooked function.
+ *
+ * @return  The index of the first matching entry or the size of the chain index, if none.
+ */
+static ZyanUSize ZyrexTrampolineChainLowerBound(ZyanUPointer address)
+{
+    ZyanUSize lo = 0;
+    ZyanUSize hi = g_trampoline_data.chains.size;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        ZyrexTrampolineChunk* const* element = ZyanVectorGet(&g_trampoline_data.chains, mid);
+        ZYAN_ASSERT(element && *element);
+
+        if (ZyrexTrampolineChainGetAddress(*element) < address)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/**
+ * @brief   Inserts the given trampoline `chunk` into the chain index.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineChainInsert(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    const ZyanUPointer address = ZyrexTrampolineChainGetAddress(chunk);
+
+    ZyanUSize index = ZyrexTrampolineChainLowerBound(address);
+    for (; index < g_trampoline_data.chains.size; ++index)
+    {
+        ZyrexTrampolineChunk* const* element = ZyanVectorGet(&g_trampoline_data.chains, index);
+        ZYAN_ASSERT(element && *element);
+
+        if (ZyrexTrampolineChainGetAddress(*element) != address)
+        {
+            break;
+        }
+    }
+
+    return ZyanVectorInsert(&g_trampoline_data.chains, index, &chunk);
+}
+
+/**
+ * @brief   Removes the given trampoline `chunk` from the chain index.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * Trampolines without a private callback stub are not part of the index and are silently 
+ * ignored.
+ */
+static ZyanStatus ZyrexTrampolineChainRemove(const ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    const ZyanUPointer address = ZyrexTrampolineChainGetAddress(chunk);
+    for (ZyanUSize index = ZyrexTrampolineChainLowerBound(address); 
+        index < g_trampoline_data.chains.size; ++index)
+    {
+        ZyrexTrampolineChunk* const* element = ZyanVectorGet(&g_trampoline_data.chains, index);
+        ZYAN_ASSERT(element && *element);
+
+        if (*element == chunk)
+        {
+            return ZyanVectorDelete(&g_trampoline_data.chains, index);
+        }
+        if (ZyrexTrampolineChainGetAddress(*element) != address)
+        {
+            break;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Trampoline chunk                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Writes the sampling stub of the given trampoline chunk.
+ *
+ * @param   chunk   A pointer to the `ZyrexTrampolineChunk` struct.
+ *
+ * The stub is written to the `sampling_stub` buffer of the code slot of the chunk:
+ *
+ *     lock dec [sampling_counter]
+ *     jg   code_buffer
+ *     push [sampling_interval]
+ *     pop  [sampling_counter]
+ *     jmp  [callback_address]
+ *
+ * All threads share the counter of the trampoline. It is decremented atomically, so no call is
+ * lost and the callback is invoked once every `sampling_interval` calls. Only the reset is not 
+ * atomic: calls that decrement the counter past zero before it was reset take an additional 
+ * sample. Using a signed comparison guarantees that the counter is always reset.
+ */
+static void ZyrexTrampolineChunkWriteSamplingStub(ZyrexTrampolineChunk* chunk)
+{
+    ZYAN_ASSERT(chunk);
+
+    ZyanU8* const stub = chunk->code->sampling_stub;
+    ZyanU8* instr = stub;
+
+    // lock dec [sampling_counter]
+    *instr++ = 0xF0;
+#if defined(ZYAN_X64)
+    *instr++ = 0x48;
+#endif
+    *instr++ = 0xFF;
+    *instr++ = 0x0D;
+#if defined(ZYAN_X64)
+    *(ZyanI32*)instr = ZyrexCalculateRelativeOffset(4, (ZyanUPointer)instr, 
+        (ZyanUPointer)&chunk->sampling_counter);
+#else
+    *(ZyanU32*)instr = (ZyanU32)(ZyanUPointer)&chunk->sampling_counter;
+#endif
+    instr += 4;
+
+    // jg code_buffer
+    const ZyanI32 offset = ZyrexCalculateRelativeOffset(2, (ZyanUPointer)instr, 
+        (ZyanUPointer)&chunk->code->code_buffer);
+    ZYAN_ASSERT((offset >= -128) && (offset <= 127));
+    *instr++ = 0x7F;
+    *instr++ = (ZyanU8)(ZyanI8)offset;
+
+    // push [sampling_interval]
+    *instr++ = 0xFF;
+    *instr++ = 0x35;
+#if defined(ZYAN_X64)
+    *(ZyanI32*)instr = ZyrexCalculateRelativeOffset(4, (ZyanUPointer)instr, 
+        (ZyanUPointer)&chunk->sampling_interval);
+#else
+    *(ZyanU32*)instr = (ZyanU32)(ZyanUPointer)&chunk->sampling_interval;
+#endif
+    instr += 4;
+
+    // pop [sampling_counter]
+    ZYAN_ASSERT(instr - stub == ZYREX_TRAMPOLINE_SAMPLING_STUB_POP_OFFSET);
+    *instr++ = 0x8F;
+    *instr++ = 0x05;
+#if defined(ZYAN_X64)
+    *(ZyanI32*)instr = ZyrexCalculateRelativeOffset(4, (ZyanUPointer)instr, 
+        (ZyanUPointer)&chunk->sampling_counter);
+#else
+    *(ZyanU32*)instr = (ZyanU32)(ZyanUPointer)&chunk->sampling_counter;
+#endif
+    instr += 4;
+
+    // jmp [callback_address]
+    ZyrexWriteAbsoluteJump(instr, (ZyanUPointer)&chunk->callback_address);
+    instr += ZYREX_SIZEOF_ABSOLUTE_JUMP;
+
+    ZYAN_ASSERT(instr - stub <= ZYREX_TRAMPOLINE_SAMPLING_STUB_SIZE);
+}
+
+/**
+ * @brief   Initializes a new trampoline chunk and relocates the instructions from the original
+ *          function.
+ *
+ * @param   chunk               A pointer to the `ZyrexTrampolineChunk` struct.
+ * @param   code                A pointer to the `ZyrexTrampolineCode` slot of the chunk.
+ * @param   address             The address of the function to create the trampoline for.
+ * @param   callback            The address of the callback function the hook will redirect to.
+ * @param   min_bytes_to_reloc  Specifies the minimum amount of  bytes that need to be relocated
+ *                              to the trampoline (usually equals the size of the branch
+ *                              instruction used for hooking).
+ *                              This function might copy more bytes on demand to keep individual
+ *                              instructions intact.
+ * @param   max_bytes_to_read   The maximum amount of bytes that can be safely read from the given
+ *                              `address`.
+ * @param   barrier_slot        The barrier slot to associate with the trampoline or
+ *                              `ZYREX_BARRIER_SLOT_INVALID`, if none.
+ * @param   flags               A combination of `ZYREX_TRAMPOLINE_FLAG_*` values.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTrampolineChunkInit(ZyrexTrampolineChunk* chunk, 
+    ZyrexTrampolineCode* code, const void* address, const void* callback, 
+    ZyanUSize min_bytes_to_reloc, ZyanUSize max_bytes_to_read, ZyanU32 barrier_slot, 
+    ZyrexTrampolineFlags flags)
+{
+    ZYAN_ASSERT(chunk);
+    ZYAN_ASSERT(code);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(callback);
+    ZYAN_ASSERT(min_bytes_to_reloc <= max_bytes_to_read);
+
+    chunk->is_used = ZYAN_TRUE;
+    chunk->callback_address = (ZyanUPointer)callback;
+    chunk->callback_jump = ZYAN_NULL;
+    chunk->is_bypassed = ZYAN_FALSE;
+    chunk->is_detached = ZYAN_FALSE;
+    chunk->listeners = ZYAN_NULL;
+    chunk->counters = ZYAN_NULL;
+    chunk->hot_patch_size = 0;
+    chunk->sampling_counter = (flags & ZYREX_TRAMPOLINE_FLAG_SAMPLING) ? 1 : 0;
+    chunk->sampling_interval = chunk->sampling_counter;
+    chunk->barrier_slot = barrier_slot;
+    chunk->code = code;
+
+    // Fill the whole code slot with `INT 3` instructions
+    ZYAN_MEMSET(code, 0xCC, ZYREX_TRAMPOLINE_CODE_SLOT_SIZE);
+
+    ZyanUSize bytes_read;
+    ZyanUSize bytes_written;
+
+    // Relocate instructions
+    ZYAN_CHECK(ZyrexRelocationCacheRelocateCode(address, max_bytes_to_read, chunk, 
+        min_bytes_to_reloc, &bytes_read, &bytes_written));
+    ZYAN_ASSERT(bytes_written <= ZYREX_TRAMPOLINE_MAX_CODE_SIZE + 
+        ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS);
+    chunk->code_buffer_size = (ZyanU8)bytes_written;
+
+    // Write backjump
+    ZyrexWriteAbsoluteJump(&code->code_buffer[bytes_written],
+        (ZyanUPointer)&chunk->backjump_address);
+    chunk->backjump_address = (ZyanUPointer)address + bytes_read;
+
+    if (flags & ZYREX_TRAMPOLINE_FLAG_SAMPLING)
+    {
+        ZyrexTrampolineChunkWriteSamplingStub(chunk);
+    }
+
+    // Backup the padding bytes, which get overwritten by the hot-patch jump
+    if (flags & ZYREX_TRAMPOLINE_FLAG_HOT_PATCH)
+    {
+        chunk->hot_patch_size = ZYREX_SIZEOF_RELATIVE_JUMP;
+        ZYAN_MEMCPY(chunk->hot_patch_code, (const ZyanU8*)address - ZYREX_SIZEOF_RELATIVE_JUMP, 
+            ZYREX_SIZEOF_RELATIVE_JUMP);
+    }
+
+    // The instruction cache is flushed once per page at the end of a batch
+    if (!g_trampoline_data.batch.is_active)
+    {
+        ZYAN_CHECK(ZyanProcessFlushInstructionCache(code, ZYREX_TRAMPOLINE_CODE_SLOT_SIZE));
+    }
+
+    // Backup original instructions
+    ZYAN_ASSERT(bytes_read <= ZYAN_ARRAY_LENGTH(chunk->original_code));
+    chunk->original_code_size = (ZyanU8)bytes_read;
+    ZYAN_MEMCPY(chunk->original_code, address, bytes_read);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Public functions                                                                               */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Creation and destruction                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
+    ZyanUSize min_bytes_to_reloc, ZyanU32 barrier_slot, ZyrexTrampolineFlags flags, 
+    ZyrexTrampolineChunk** trampoline)
+{
+    if (!address || !callback || (min_bytes_to_reloc < 1) || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Check if the memory region of the target function has enough space for the hook code
+    ZyanUSize source_size = ZYREX_TRAMPOLINE_MAX_CODE_SIZE;
+    ZYAN_CHECK(ZyrexGetSizeOfReadableMemoryRegion(address, &source_size));
+    if (source_size < min_bytes_to_reloc)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // A hot-patch hook only overwrites the first instruction(s) with a short jump
+    if (flags & ZYREX_TRAMPOLINE_FLAG_HOT_PATCH)
+    {
+        if (ZyrexIsHotPatchable(address))
+        {
+            min_bytes_to_reloc = ZYAN_MIN(min_bytes_to_reloc, ZYREX_SIZEOF_SHORT_JUMP);
+        } else
+        {
+            flags &= ~ZYREX_TRAMPOLINE_FLAG_HOT_PATCH;
+        }
+    }
+
+    if (!g_trampoline_data.is_initialized)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.regions, sizeof(ZyrexTrampolineRegion*), 8, 
+            ZYAN_NULL));
+        const ZyanStatus status = ZyanVectorInit(&g_trampoline_data.chains, 
+            sizeof(ZyrexTrampolineChunk*), 8, ZYAN_NULL);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyanVectorDestroy(&g_trampoline_data.regions));
+            return status;
+        }
+
+        g_trampoline_data.page_size = ZyanMemoryGetSystemPageSize();
+        ZYAN_ASSERT(g_trampoline_data.page_size >= 0x1000);
+#if   defined(ZYAN_WINDOWS)
+        g_trampoline_data.region_size = ZYAN_MIN(ZyanMemoryGetSystemAllocationGranularity(),
+            ZYREX_TRAMPOLINE_REGION_MAX_SIZE);
+#elif defined(ZYAN_POSIX)
+        // The allocation granularity equals the page size on POSIX systems, which would waste 
+        // most of the region for metadata
+        g_trampoline_data.region_size = ZYREX_TRAMPOLINE_REGION_MAX_SIZE;
+#endif
+
+        // Split the region into the metadata area and the page aligned code area, which starts
+        // with the callback stubs
+        const ZyanUSize header_size = offsetof(ZyrexTrampolineRegion, chunks);
+        ZyanUSize count = (g_trampoline_data.region_size - header_size) /
+            (sizeof(ZyrexTrampolineChunk) + ZYREX_TRAMPOLINE_CODE_SLOT_SIZE);
+        while (ZYAN_ALIGN_UP(header_size + count * sizeof(ZyrexTrampolineChunk), 
+            g_trampoline_data.page_size) + ZYREX_TRAMPOLINE_CALLBACK_AREA_SIZE + 
+            count * ZYREX_TRAMPOLINE_CODE_SLOT_SIZE > g_trampoline_data.region_size)
+        {
+            --count;
+        }
+        ZYAN_ASSERT(count > 0);
+        ZYAN_ASSERT(count <= ZYREX_TRAMPOLINE_REGION_MAX_CHUNKS);
+        g_trampoline_data.chunks_per_region = count;
+        g_trampoline_data.code_offset = ZYAN_ALIGN_UP(header_size + 
+            count * sizeof(ZyrexTrampolineChunk), g_trampoline_data.page_size);
+        g_trampoline_data.slot_offset = 
+            g_trampoline_data.code_offset + ZYREX_TRAMPOLINE_CALLBACK_AREA_SIZE;
+
+        g_trampoline_data.is_initialized = ZYAN_TRUE;
+    }
+
+#ifdef ZYAN_X64
+
+    // Gather memory address lower and upper bounds in order to find a suitable memory region for
+    // the trampoline
+    ZyanUPointer lo = (ZyanUPointer)(-1);
+    ZyanUPointer hi = 0;
+    ZYAN_CHECK(ZyrexGetAddressRangeOfRelativeInstructions(address, source_size,
+        min_bytes_to_reloc, &lo, &hi));
+
+    // The relative jump of a hot-patch hook is located in front of the function
+    const ZyanUPointer address_value = (ZyanUPointer)address;
+    const ZyanUPointer jump_address = (flags & ZYREX_TRAMPOLINE_FLAG_HOT_PATCH) 
+        ? address_value - ZYREX_SIZEOF_RELATIVE_JUMP 
+        : address_value;
+    if (jump_address < lo)
+    {
+        lo = jump_address;
+    }
+    if (address_value > hi)
+    {
+        hi = address_value;
+    }
+
+    if ((hi - lo) > ZYREX_RANGEOF_RELATIVE_JUMP)
+    {
+        return ZYAN_STATUS_OUT_OF_RANGE;
+    }
+
+#else
+
+    const ZyanUPointer lo = (ZyanUPointer)address;
+    const ZyanUPointer hi = (ZyanUPointer)address;
+
+#endif
+
+    const ZyanBool is_private = 
+        (flags & (ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK | ZYREX_TRAMPOLINE_FLAG_SAMPLING)) ? 
+        ZYAN_TRUE : ZYAN_FALSE;
+
+    // Inserting into the chain index must not fail after the trampoline was created
+    if (is_private)
+    {
+        ZYAN_CHECK(ZyanVectorReserve(&g_trampoline_data.chains, 
+            g_trampoline_data.chains.size + 1));
+    }
+
+    ZyanBool is_new_region = ZYAN_FALSE;
+    ZyrexTrampolineRegion* region;
+    ZyrexTrampolineChunk* chunk;
+    ZyanStatus status = ZyrexTrampolineRegionFindChunk(lo, hi, (ZyanUPointer)callback, is_private,
+        &region, &chunk);
+    ZYAN_CHECK(status);
+
+    switch (status)
+    {
+    case ZYAN_STATUS_TRUE:
+    {
+        ZYAN_ASSERT(region);
+        ZYAN_ASSERT(chunk);
+        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region, chunk));
+        break;
+    }
+    case ZYAN_STATUS_FALSE:
+    {
+        ZYAN_CHECK(ZyrexTrampolineRegionAllocate(lo, hi, &region));
+        is_new_region = ZyrexTrampolineRegionFindChunkInRegion(region, lo, hi, 
+            (ZyanUPointer)callback, is_private, &chunk);
+        ZYAN_ASSERT(is_new_region);
+        ZYAN_ASSERT(region);
+        ZYAN_ASSERT(chunk);
+        break;
+    }
+    default:
+        ZYAN_UNREACHABLE;
+    }
+
+    ZYAN_ASSERT(region->header.number_of_unused_chunks > 0);
+
+    const ZyanUSize index = ZyrexTrampolineRegionGetChunkIndex(region, chunk);
+
+    // Moving the region to its new density bucket must not fail after the chunk was initialized
+    status = ZyrexTrampolineBucketReserve(region->header.number_of_unused_chunks - 1);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTrampolineRegionCommitChunk(region, chunk);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTrampolineChunkInit(chunk, 
+            ZyrexTrampolineRegionGetCode((ZyanUPointer)region, index), address, callback, 
+            min_bytes_to_reloc, source_size, barrier_slot, flags);
+        if (ZYAN_SUCCESS(status) && 
+            (flags & (ZYREX_TRAMPOLINE_FLAG_COUNTERS | ZYREX_TRAMPOLINE_FLAG_MEASURE_CYCLES)))
+        {
+            status = ZyrexTrampolineCountersCreate(
+                (flags & ZYREX_TRAMPOLINE_FLAG_MEASURE_CYCLES) ? ZYAN_TRUE : ZYAN_FALSE, 
+                &chunk->counters);
+        }
+        if (ZYAN_SUCCESS(status) && ZyrexTrampolineRequiresCallbackStub(is_private))
+        {
+            status = ZyrexTrampolineRegionAcquireCallback(region, (ZyanUPointer)callback, 
+                is_private, &chunk->callback_jump);
+        }
+        if (ZYAN_SUCCESS(status) && (flags & ZYREX_TRAMPOLINE_FLAG_SAMPLING))
+        {
+            // The hook is not attached yet, so the private stub can be redirected non-atomically
+            region->header.callback_addresses[ZyrexTrampolineRegionGetCallbackIndex(region, 
+                chunk->callback_jump)] = (ZyanUPointer)&chunk->code->sampling_stub;
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexTrampolineCountersDestroy(chunk->counters);
+            chunk->counters = ZYAN_NULL;
+            chunk->is_used = ZYAN_FALSE;
+            ZYAN_UNUSED(ZyrexTrampolineRegionDecommitChunk(region, chunk));
+        }
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        if (is_new_region)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
+        } else
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region, chunk));
+        }
+        return status;
+    }
+
+    ZyrexTrampolineRegionSetChunkUsed(region, index, ZYAN_TRUE);
+    ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region, chunk));
+
+    if (is_new_region)
+    {
+        ZYAN_UNUSED(ZyrexTrampolineRegionInsert(region));
+    }
+    if (is_private)
+    {
+        ZYAN_UNUSED(ZyrexTrampolineChainInsert(chunk));
+    }
+    if (g_trampoline_data.batch.is_active)
+    {
+        g_trampoline_data.batch.last_region = region;
+    }
+
+    *trampoline = chunk;
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline)
+{
+    if (!trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)trampoline, 
+        g_trampoline_data.region_size);
+    ZyanUSize found_index;
+    const ZyanStatus status =
+        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)region_address;
+    if (region->header.number_of_unused_chunks != g_trampoline_data.chunks_per_region - 1)
+    {
+        ZYAN_CHECK(ZyrexTrampolineBucketReserve(region->header.number_of_unused_chunks + 1));
+    }
+
+    ZYAN_CHECK(ZyrexTrampolineChainRemove(trampoline));
+
+    ZyrexTrampolineCounters* const counters = trampoline->counters;
+    ZyanVector* const listeners = trampoline->listeners;
+    if (region->header.number_of_unused_chunks == g_trampoline_data.chunks_per_region - 1)
+    {
+        ZYAN_CHECK(ZyrexTrampolineRegionRemove(region));
+        ZYAN_CHECK(ZyrexTrampolineRegionFree(region));
+    }
+    else
+    {
+        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region, trampoline));
+        ZyrexTrampolineRegionSetChunkUsed(region, 
+            ZyrexTrampolineRegionGetChunkIndex(region, trampoline), ZYAN_FALSE);
+        trampoline->is_used = ZYAN_FALSE;
+        if (trampoline->callback_jump)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionReleaseCallback(region, trampoline->callback_jump));
+        }
+        if (listeners)
+        {
+            ZYAN_VECTOR_FOREACH(ZyrexTrampolineListener, listeners, listener,
+            {
+                ZYAN_UNUSED(ZyrexTrampolineRegionReleaseCallback(region, listener.callback_jump));
+            });
+        }
+        const ZyanStatus status_decommit = ZyrexTrampolineRegionDecommitChunk(region, trampoline);
+        ZYAN_CHECK(ZyrexTrampolineRegionProtect(region, trampoline));
+        ZYAN_CHECK(status_decommit);
+    }
+
+    ZyrexTrampolineCountersDestroy(counters);
+    if (listeners)
+    {
+        ZYAN_UNUSED(ZyanVectorDestroy(listeners));
+        // TODO: Replace with ZyanMemoryFree in the future
+        ZYAN_FREE(listeners);
+    }
+
+    ZyanUSize size;
+    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
+    if (size == 0)
+    {
+        ZYAN_CHECK(ZyanVectorDestroy(&g_trampoline_data.regions));
+        ZYAN_CHECK(ZyanVectorDestroy(&g_trampoline_data.chains));
+        ZyrexTrampolineBucketDestroyAll();
+        g_trampoline_data.is_initialized = ZYAN_FALSE;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Batching                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTrampolineBatchBegin(void)
+{
+    if (g_trampoline_data.batch.is_active)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.batch.pages, sizeof(ZyanUPointer), 16, 
+        ZYAN_NULL));
+
+    g_trampoline_data.batch.is_active   = ZYAN_TRUE;
+    g_trampoline_data.batch.last_region = ZYAN_NULL;
+    g_trampoline_data.batch.readable_lo = 0;
+    g_trampoline_data.batch.readable_hi = 0;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineBatchEnd(void)
+{
+    if (!g_trampoline_data.batch.is_active)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    g_trampoline_data.batch.is_active   = ZYAN_FALSE;
+    g_trampoline_data.batch.last_region = ZYAN_NULL;
+
+    // Released regions have already been removed from the list, but pages might have been
+    // decommitted in the meantime
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZYAN_VECTOR_FOREACH(ZyanUPointer, &g_trampoline_data.batch.pages, page_address,
+    {
+        const ZyrexTrampolineRegion* const region = (const ZyrexTrampolineRegion*)
+            ZYAN_ALIGN_DOWN(page_address, g_trampoline_data.region_size);
+        const ZyanUSize page = ZyrexTrampolineRegionGetPageIndex(region, page_address);
+        if (region->header.page_references[page] == 0)
+        {
+            continue;
+        }
+
+        ZyanStatus status_page = ZyanMemoryVirtualProtect((void*)page_address, 
+            g_trampoline_data.page_size, ZYAN_PAGE_EXECUTE_READ);
+        if (ZYAN_SUCCESS(status_page))
+        {
+            status_page = ZyanProcessFlushInstructionCache((void*)page_address, 
+                g_trampoline_data.page_size);
+        }
+        if (!ZYAN_SUCCESS(status_page))
+        {
+            status = status_page;
+        }
+    });
+
+    ZYAN_UNUSED(ZyanVectorDestroy(&g_trampoline_data.batch.pages));
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Searching                                                                                      */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTrampolineFind(const void* original, ZyrexTrampolineChunk** trampoline)
+{
+    if (!original || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)original, 
+        g_trampoline_data.region_size);
+
+    ZyanUSize found_index;
+    const ZyanStatus status = 
+        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+    
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    ZyrexTrampolineRegion** const element = 
+        ZyanVectorGetMutable(&g_trampoline_data.regions, found_index);
+    ZYAN_ASSERT(element && *element);
+
+    ZyrexTrampolineRegion* const region = *element;
+    ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
+
+    // The chunk index can be calculated directly from the `code_buffer` address
+    const ZyanUPointer code_base = region_address + g_trampoline_data.slot_offset;
+    if ((ZyanUPointer)original < code_base)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+    const ZyanUSize offset = (ZyanUPointer)original - code_base;
+    const ZyanUSize index = offset / ZYREX_TRAMPOLINE_CODE_SLOT_SIZE;
+    if ((index >= g_trampoline_data.chunks_per_region) ||
+        (offset % ZYREX_TRAMPOLINE_CODE_SLOT_SIZE != offsetof(ZyrexTrampolineCode, code_buffer)) ||
+        !ZyrexTrampolineRegionIsChunkUsed(region, index))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    *trampoline = &region->chunks[index];
+    return ZYAN_STATUS_TRUE;
+}
+
+ZyanStatus ZyrexTrampolineEnumerate(ZyrexTrampolineEnumCallback callback, void* context)
+{
+    if (!callback)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanUSize size;
+    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
+
+    for (ZyanUSize i = 0; i < size; ++i)
+    {
+        ZyrexTrampolineRegion* const* element = ZyanVectorGet(&g_trampoline_data.regions, i);
+        ZYAN_ASSERT(element && *element);
+
+        const ZyrexTrampolineRegion* const region = *element;
+        ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
+
+        // Unused chunks might be decommitted and must not be accessed
+        for (ZyanUSize j = 0; j < g_trampoline_data.chunks_per_region; ++j)
+        {
+            if (!ZyrexTrampolineRegionIsChunkUsed(region, j))
+            {
+                continue;
+            }
+            if (!callback(&region->chunks[j], context))
+            {
+                return ZYAN_STATUS_SUCCESS;
+            }
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineGetStatistics(ZyrexTrampolineStatistics* statistics)
+{
+    if (!statistics)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_MEMSET(statistics, 0, sizeof(*statistics));
+    if (!g_trampoline_data.is_initialized)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanUSize size;
+    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
+
+    const ZyanUSize page_count = g_trampoline_data.region_size / g_trampoline_data.page_size;
+    for (ZyanUSize i = 0; i < size; ++i)
+    {
+        ZyrexTrampolineRegion* const* element = ZyanVectorGet(&g_trampoline_data.regions, i);
+        ZYAN_ASSERT(element && *element);
+
+        const ZyrexTrampolineRegion* const region = *element;
+        ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
+
+        const ZyanUSize used = 
+            g_trampoline_data.chunks_per_region - region->header.number_of_unused_chunks;
+        if (used * 4 <= g_trampoline_data.chunks_per_region)
+        {
+            ++statistics->sparse_region_count;
+        }
+        statistics->used_chunk_count += used;
+
+        for (ZyanUSize j = 0; j < page_count; ++j)
+        {
+            if (region->header.page_references[j])
+            {
+                statistics->committed_size += g_trampoline_data.page_size;
+            }
+        }
+    }
+
+    statistics->region_count = size;
+    statistics->chunk_count = size * g_trampoline_data.chunks_per_region;
+    statistics->reserved_size = size * g_trampoline_data.region_size;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Helper functions                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyrexTrampolineChunk* ZyrexTrampolineGetChunk(const void* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(g_trampoline_data.is_initialized);
+
+    const ZyanUPointer code = (ZyanUPointer)trampoline - offsetof(ZyrexTrampolineCode, code_buffer);
+    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN(code, g_trampoline_data.region_size);
+    const ZyanUSize index = (code - region_address - g_trampoline_data.slot_offset) / 
+        ZYREX_TRAMPOLINE_CODE_SLOT_SIZE;
+
+    return &((ZyrexTrampolineRegion*)region_address)->chunks[index];
+}
+
+/**
+ * @brief   Searches the listener list of the given trampoline for the given `listener`.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   listener    The listener address.
+ * @param   index       Receives the index of the listener, if found.
+ *
+ * @return  `ZYAN_TRUE`, if the listener was found or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexTrampolineListenerGetIndex(const ZyrexTrampolineChunk* trampoline,
+    const void* listener, ZyanUSize* index)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(index);
+
+    if (!trampoline->listeners)
+    {
+        return ZYAN_FALSE;
+    }
+
+    for (ZyanUSize i = 0; i < trampoline->listeners->size; ++i)
+    {
+        const ZyrexTrampolineListener* const item = ZyanVectorGet(trampoline->listeners, i);
+        ZYAN_ASSERT(item);
+
+        if (item->callback_jump == listener)
+        {
+            *index = i;
+            return ZYAN_TRUE;
+        }
+    }
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Returns the callback table entry that redirects to the listener at the given `index`
+ *          of the callback chain.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   index       The index of the listener. Pass the size of the listener list to receive
+ *                      the entry that redirects to the callback of the trampoline.
+ *
+ * @return  The entry of the last linked listener in front of the given `index` or the entry of
+ *          the callback stub of the trampoline, if there is none.
+ */
+static volatile ZyanUPointer* ZyrexTrampolineGetChainEntry(const ZyrexTrampolineChunk* trampoline,
+    ZyanUSize index)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(trampoline->callback_jump);
+
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+
+    const ZyanU8* callback_jump = trampoline->callback_jump;
+    for (ZyanUSize i = 0; i < index; ++i)
+    {
+        const ZyrexTrampolineListener* const item = ZyanVectorGet(trampoline->listeners, i);
+        ZYAN_ASSERT(item);
+
+        if (item->is_linked)
+        {
+            callback_jump = item->callback_jump;
+        }
+    }
+
+    return ZyrexTrampolineRegionGetCallbackEntry(region, callback_jump);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Callback                                                                                       */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Returns a pointer to the callback table entry of the private callback stub of the
+ *          given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ *
+ * @return  A pointer to the callback table entry or `ZYAN_NULL`, if the trampoline does not own a
+ *          private callback stub or is detached.
+ *
+ * If listeners are linked, the entry of the last linked listener is returned, as it redirects to 
+ * the callback of the trampoline.
+ */
+static volatile ZyanUPointer* ZyrexTrampolineGetPrivateCallbackEntry(
+    const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
+
+    if (!trampoline->is_used || !trampoline->callback_jump || trampoline->is_detached)
+    {
+        return ZYAN_NULL;
+    }
+
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+    const ZyanUSize index = 
+        ZyrexTrampolineRegionGetCallbackIndex(region, trampoline->callback_jump);
+    if (!(region->header.private_callbacks & (1ULL << index)))
+    {
+        return ZYAN_NULL;
+    }
+
+    // The callback of the trampoline is invoked by the last listener of the chain
+    return ZyrexTrampolineGetChainEntry(trampoline, 
+        trampoline->listeners ? trampoline->listeners->size : 0);
+}
+
+/**
+ * @brief   Atomically stores the given `value` into the given callback table `entry`.
+ *
+ * @param   entry   A pointer to the callback table entry.
+ * @param   value   The new destination address of the callback stub.
+ *
+ * The callback stub is an indirect jump, so a single aligned pointer store redirects all threads 
+ * that enter the stub afterwards.
+ */
+static void ZyrexTrampolineStoreCallbackEntry(volatile ZyanUPointer* entry, ZyanUPointer value)
+{
+    ZYAN_ASSERT(entry);
+
+#if   defined(ZYAN_WINDOWS)
+    InterlockedExchangePointer((PVOID volatile*)entry, (PVOID)value);
+#elif defined(ZYAN_POSIX)
+    __sync_lock_test_and_set(entry, value);
+    __sync_synchronize();
+#endif
+}
+
+/**
+ * @brief   Returns the destination of the private callback stub of the given trampoline, if the
+ *          callback is not bypassed.
+ *
+ * @param   trampoline  The trampoline chunk.
+ *
+ * @return  The address of the sampling stub for sampled trampolines or the callback address.
  */
-static ZyanStatus ZyrexTrampolineChunkInit(ZyrexTrampolineChunk* chunk, const void* address,
-    const void* callback, ZyanUSize min_bytes_to_reloc, ZyanUSize max_bytes_to_read)
+static ZyanUPointer ZyrexTrampolineGetCallbackDestination(const ZyrexTrampolineChunk* trampoline)
 {
-    ZYAN_ASSERT(chunk);
-    ZYAN_ASSERT(address);
-    ZYAN_ASSERT(callback);
-    ZYAN_ASSERT(min_bytes_to_reloc <= max_bytes_to_read);
+    ZYAN_ASSERT(trampoline);
 
-    chunk->is_used = ZYAN_TRUE;
-    chunk->callback_address = (ZyanUPointer)callback;
+    return trampoline->sampling_interval 
+        ? (ZyanUPointer)&trampoline->code->sampling_stub 
+        : trampoline->callback_address;
+}
 
-#if defined(ZYAN_X64)
-    
-    ZyrexWriteAbsoluteJump(&chunk->callback_jump, (ZyanUPointer)&chunk->callback_address);
-    ZYAN_CHECK(ZyanProcessFlushInstructionCache(&chunk->callback_jump, 
-        ZYREX_SIZEOF_ABSOLUTE_JUMP));
+ZyanUPointer ZyrexTrampolineGetCallbackJumpDestination(const void* callback_jump)
+{
+    ZYAN_ASSERT(callback_jump);
 
-#endif
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)callback_jump, g_trampoline_data.region_size);
 
-    ZyanUSize bytes_read;
-    ZyanUSize bytes_written;
+    return *ZyrexTrampolineRegionGetCallbackEntry(region, callback_jump);
+}
 
-    // Relocate instructions
-    ZYAN_CHECK(ZyrexRelocateCode(address, max_bytes_to_read, chunk, min_bytes_to_reloc, 
-        &bytes_read, &bytes_written));
+ZyanStatus ZyrexTrampolineSetCallback(ZyrexTrampolineChunk* trampoline, const void* callback)
+{
+    if (!trampoline || !callback)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-    // Write backjump
-    ZyrexWriteAbsoluteJump(&chunk->code_buffer[bytes_written],
-        (ZyanUPointer)&chunk->backjump_address);
-    chunk->backjump_address = (ZyanUPointer)address + bytes_read;
+    volatile ZyanUPointer* const entry = ZyrexTrampolineGetPrivateCallbackEntry(trampoline);
+    if (!entry)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-    // Fill remaining space with `INT 3` instructions
-    const ZyanUSize bytes_remaining = sizeof(chunk->code_buffer) - bytes_written;
-    if (bytes_remaining > 0)
+    // The sampling stub jumps through the `callback_address` field itself
+    ZyrexTrampolineStoreCallbackEntry((volatile ZyanUPointer*)&trampoline->callback_address,
+        (ZyanUPointer)callback);
+    if (!trampoline->is_bypassed && !trampoline->sampling_interval)
     {
-        ZYAN_MEMSET(&chunk->code_buffer[bytes_written + ZYREX_SIZEOF_ABSOLUTE_JUMP], 0xCC,
-            bytes_remaining - ZYREX_SIZEOF_ABSOLUTE_JUMP);
+        ZyrexTrampolineStoreCallbackEntry(entry, (ZyanUPointer)callback);
     }
 
-    ZYAN_CHECK(ZyanProcessFlushInstructionCache(&chunk->code_buffer, 
-        ZYREX_TRAMPOLINE_MAX_CODE_SIZE_WITH_BACKJUMP + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS));
+    return ZYAN_STATUS_SUCCESS;
+}
 
-    // Backup original instructions
-    ZYAN_ASSERT(bytes_read <= ZYAN_ARRAY_LENGTH(chunk->original_code));
-    chunk->original_code_size = (ZyanU8)bytes_read;
-    ZYAN_MEMCPY(chunk->original_code, address, bytes_read);
+ZyanStatus ZyrexTrampolineSetBypass(ZyrexTrampolineChunk* trampoline, ZyanBool bypass)
+{
+    if (!trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    volatile ZyanUPointer* const entry = ZyrexTrampolineGetPrivateCallbackEntry(trampoline);
+    if (!entry)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    trampoline->is_bypassed = bypass ? ZYAN_TRUE : ZYAN_FALSE;
+    ZyrexTrampolineStoreCallbackEntry(entry, bypass ? 
+        (ZyanUPointer)&trampoline->code->code_buffer : 
+        ZyrexTrampolineGetCallbackDestination(trampoline));
 
     return ZYAN_STATUS_SUCCESS;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
+ZyanStatus ZyrexTrampolineSetSamplingInterval(ZyrexTrampolineChunk* trampoline, 
+    ZyanU32 interval)
+{
+    if (!trampoline || (interval == 0))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (!trampoline->is_used || !trampoline->sampling_interval)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-/* ============================================================================================== */
-/* Public functions                                                                               */
-/* ============================================================================================== */
+    // Both fields are pointer-sized and aligned, so the stores are atomic. A thread that resets 
+    // the counter concurrently might still use the previous interval once
+    trampoline->sampling_interval = (ZyanIPointer)interval;
+    trampoline->sampling_counter = (ZyanIPointer)interval;
+
+    return ZYAN_STATUS_SUCCESS;
+}
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Creation and destruction                                                                       */
+/* Listeners                                                                                      */
 /* ---------------------------------------------------------------------------------------------- */
 
-ZyanStatus ZyrexTrampolineCreate(const void* address, const void* callback,
-    ZyanUSize min_bytes_to_reloc, ZyrexTrampolineChunk** trampoline)
+ZyanStatus ZyrexTrampolineFindChain(const void* address, ZyrexTrampolineChunk** trampoline)
 {
-    if (!address || !callback || (min_bytes_to_reloc < 1) || !trampoline)
+    if (!address || !trampoline)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-
-    // Check if the memory region of the target function has enough space for the hook code
-    ZyanUSize source_size = ZYREX_TRAMPOLINE_MAX_CODE_SIZE;
-#ifdef ZYAN_WINDOWS
-    ZYAN_CHECK(ZyrexGetSizeOfReadableMemoryRegion(address, &source_size));
-    if (source_size < min_bytes_to_reloc)
+    if (!g_trampoline_data.is_initialized)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_FALSE;
     }
-#endif
 
-    if (!g_trampoline_data.is_initialized)
+    // Only trampolines with a private callback stub are part of the chain index
+    for (ZyanUSize i = ZyrexTrampolineChainLowerBound((ZyanUPointer)address); 
+        i < g_trampoline_data.chains.size; ++i)
     {
-        ZYAN_CHECK(ZyanVectorInit(&g_trampoline_data.regions, sizeof(ZyrexTrampolineRegion*), 8, 
-            ZYAN_NULL));
-
-        g_trampoline_data.region_size = ZyanMemoryGetSystemAllocationGranularity();
-        g_trampoline_data.chunks_per_region =
-            g_trampoline_data.region_size / sizeof(ZyrexTrampolineChunk);
+        ZyrexTrampolineChunk* const* element = ZyanVectorGet(&g_trampoline_data.chains, i);
+        ZYAN_ASSERT(element && *element);
 
-        g_trampoline_data.is_initialized = ZYAN_TRUE;
+        ZyrexTrampolineChunk* const chunk = *element;
+        if (ZyrexTrampolineChainGetAddress(chunk) != (ZyanUPointer)address)
+        {
+            break;
+        }
+        if (ZyrexTrampolineGetPrivateCallbackEntry(chunk))
+        {
+            *trampoline = chunk;
+            return ZYAN_STATUS_TRUE;
+        }
     }
 
-#ifdef ZYAN_X64
-
-    // Gather memory address lower and upper bounds in order to find a suitable memory region for
-    // the trampoline
-    ZyanUPointer lo = (ZyanUPointer)(-1);
-    ZyanUPointer hi = 0;
-    ZYAN_CHECK(ZyrexGetAddressRangeOfRelativeInstructions(address, source_size,
-        ZYREX_SIZEOF_RELATIVE_JUMP, &lo, &hi));
+    return ZYAN_STATUS_FALSE;
+}
 
-    const ZyanUPointer address_value = (ZyanUPointer)address;
-    if (address_value < lo)
+ZyanStatus ZyrexTrampolineListenerFind(const void* listener, ZyrexTrampolineChunk** trampoline)
+{
+    if (!listener || !trampoline)
     {
-        lo = address_value;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    if (address_value > hi)
+    if (!g_trampoline_data.is_initialized)
     {
-        hi = address_value;
+        return ZYAN_STATUS_FALSE;
     }
 
-    if ((hi - lo) > ZYREX_RANGEOF_RELATIVE_JUMP)
+    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)listener, 
+        g_trampoline_data.region_size);
+
+    ZyanUSize found_index;
+    const ZyanStatus status = 
+        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
+            (ZyanComparison)&ZyanComparePointer);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_FALSE)
     {
-        return ZYAN_STATUS_OUT_OF_RANGE;
+        return ZYAN_STATUS_FALSE;
     }
 
-#else
+    // Listener addresses always point to a private callback stub
+    const ZyanUPointer stub_base = region_address + g_trampoline_data.code_offset;
+    if (((ZyanUPointer)listener < stub_base) || 
+        ((ZyanUPointer)listener >= stub_base + ZYREX_TRAMPOLINE_CALLBACK_AREA_SIZE) ||
+        (((ZyanUPointer)listener - stub_base) % ZYREX_TRAMPOLINE_CALLBACK_STUB_SIZE))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
 
-    const ZyanUPointer lo = (ZyanUPointer)address;
-    const ZyanUPointer hi = (ZyanUPointer)address;
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)region_address;
+    const ZyanUSize index = ZyrexTrampolineRegionGetCallbackIndex(region, listener);
+    if (!region->header.callback_references[index] || 
+        !(region->header.private_callbacks & (1ULL << index)))
+    {
+        return ZYAN_STATUS_FALSE;
+    }
 
-#endif
+    for (ZyanUSize i = 0; i < g_trampoline_data.chunks_per_region; ++i)
+    {
+        ZyanUSize listener_index;
+        if (ZyrexTrampolineRegionIsChunkUsed(region, i) && 
+            ZyrexTrampolineListenerGetIndex(&region->chunks[i], listener, &listener_index))
+        {
+            *trampoline = &region->chunks[i];
+            return ZYAN_STATUS_TRUE;
+        }
+    }
 
-    ZyanBool is_new_region = ZYAN_FALSE;
-    ZyrexTrampolineRegion* region;
-    ZyrexTrampolineChunk* chunk;
-    ZyanStatus status = ZyrexTrampolineRegionFindChunk(lo, hi, &region, &chunk);
-    ZYAN_CHECK(status);
+    return ZYAN_STATUS_FALSE;
+}
 
-    switch (status)
-    {
-    case ZYAN_STATUS_TRUE:
+ZyanStatus ZyrexTrampolineListenerCreate(ZyrexTrampolineChunk* trampoline, const void* callback,
+    const void** listener)
+{
+    if (!trampoline || !callback || !listener)
     {
-        ZYAN_ASSERT(region);
-        ZYAN_ASSERT(chunk);
-        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
-        break;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    case ZYAN_STATUS_FALSE:
+    if (!ZyrexTrampolineGetPrivateCallbackEntry(trampoline))
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionAllocate(lo, hi, &region));
-        is_new_region = ZyrexTrampolineRegionFindChunkInRegion(region, lo, hi, &chunk);
-        ZYAN_ASSERT(is_new_region);
-        ZYAN_ASSERT(region);
-        ZYAN_ASSERT(chunk);
-        break;
-    }
-    default:
-        ZYAN_UNREACHABLE;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZYAN_ASSERT(region->header.number_of_unused_chunks > 0);
+    // Listeners have to share the trampoline-region, as the callback table entries are addressed
+    // relative to the callback stubs
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+    if (!ZyrexTrampolineRegionHasCallback(region, (ZyanUPointer)callback, ZYAN_TRUE))
+    {
+        return ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
 
-    status = ZyrexTrampolineChunkInit(chunk, address, callback, min_bytes_to_reloc, source_size);
-    if (!ZYAN_SUCCESS(status))
+    if (!trampoline->listeners)
     {
-        if (is_new_region)
+        // TODO: Replace with ZyanMemoryAlloc in the future
+        ZyanVector* const listeners = ZYAN_MALLOC(sizeof(ZyanVector));
+        if (!listeners)
         {
-            ZYAN_UNUSED(ZyrexTrampolineRegionFree(region));
-        } else
+            return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+        }
+        const ZyanStatus status = 
+            ZyanVectorInit(listeners, sizeof(ZyrexTrampolineListener), 1, ZYAN_NULL);
+        if (!ZYAN_SUCCESS(status))
         {
-            ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region));
+            ZYAN_FREE(listeners);
+            return status;
         }
-        return status;
+        trampoline->listeners = listeners;
     }
 
-    --region->header.number_of_unused_chunks;
-    ZYAN_UNUSED(ZyrexTrampolineRegionProtect(region));
-
-    if (is_new_region)
+    // Reserving the memory in advance guarantees that the insertion below does not fail
+    ZYAN_CHECK(ZyanVectorReserve(trampoline->listeners, trampoline->listeners->size + 1));
+
+    // The stub is not reachable before the listener is linked, so it initially continues with 
+    // the original function
+    ZyrexTrampolineListener item;
+    item.callback_address = (ZyanUPointer)callback;
+    item.callback_jump = ZYAN_NULL;
+    item.is_linked = ZYAN_FALSE;
+    const ZyanStatus status = ZyrexTrampolineRegionAcquireCallback(region, 
+        (ZyanUPointer)&trampoline->code->code_buffer, ZYAN_TRUE, &item.callback_jump);
+    if (!ZYAN_SUCCESS(status))
     {
-        ZYAN_UNUSED(ZyrexTrampolineRegionInsert(region));
+        if (item.callback_jump)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineRegionReleaseCallback(region, item.callback_jump));
+        }
+        return status;
     }
 
-    *trampoline = chunk;
+    ZYAN_UNUSED(ZyanVectorInsert(trampoline->listeners, 0, &item));
+    *listener = item.callback_jump;
+
     return ZYAN_STATUS_SUCCESS;
 }
 
-ZyanStatus ZyrexTrampolineFree(ZyrexTrampolineChunk* trampoline)
+ZyanStatus ZyrexTrampolineListenerLink(ZyrexTrampolineChunk* trampoline, const void* listener)
 {
-    if (!trampoline)
+    if (!trampoline || !listener)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    if (!g_trampoline_data.is_initialized)
+
+    ZyanUSize index;
+    if (!ZyrexTrampolineListenerGetIndex(trampoline, listener, &index))
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_NOT_FOUND;
     }
 
-    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)trampoline, 
-        g_trampoline_data.region_size);
-    ZyanUSize found_index;
-    const ZyanStatus status =
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
-
-    if (status == ZYAN_STATUS_FALSE)
+    ZyrexTrampolineListener* const items = ZyanVectorGetMutable(trampoline->listeners, 0);
+    ZYAN_ASSERT(items);
+    if (items[index].is_linked)
     {
-        return ZYAN_STATUS_NOT_FOUND;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)region_address;
-    if (region->header.number_of_unused_chunks == g_trampoline_data.chunks_per_region - 1 - 1)
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+    volatile ZyanUPointer* const head = 
+        ZyrexTrampolineRegionGetCallbackEntry(region, trampoline->callback_jump);
+
+    // The stub of the listener is not reachable yet and can be redirected non-atomically
+    ZyrexTrampolineListener item = items[index];
+    item.is_linked = ZYAN_TRUE;
+    *ZyrexTrampolineRegionGetCallbackEntry(region, item.callback_jump) = *head;
+
+    // The order of the linked listeners has to match the order of the callback chain
+    ZYAN_MEMMOVE(&items[1], &items[0], index * sizeof(ZyrexTrampolineListener));
+    items[0] = item;
+
+    ZyrexTrampolineStoreCallbackEntry(head, item.callback_address);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTrampolineListenerUnlink(ZyrexTrampolineChunk* trampoline, const void* listener)
+{
+    if (!trampoline || !listener)
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionRemove(region));
-        ZYAN_CHECK(ZyrexTrampolineRegionFree(region));
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    else
+
+    ZyanUSize index;
+    if (!ZyrexTrampolineListenerGetIndex(trampoline, listener, &index))
     {
-        ZYAN_CHECK(ZyrexTrampolineRegionUnprotect(region));
-        ++region->header.number_of_unused_chunks;
-        trampoline->is_used = ZYAN_FALSE;
-        ZYAN_CHECK(ZyrexTrampolineRegionProtect(region));
+        return ZYAN_STATUS_NOT_FOUND;
     }
 
-    ZyanUSize size;
-    ZYAN_CHECK(ZyanVectorGetSize(&g_trampoline_data.regions, &size));
-    if (size == 0)
+    ZyrexTrampolineListener* const item = ZyanVectorGetMutable(trampoline->listeners, index);
+    ZYAN_ASSERT(item);
+    if (!item->is_linked)
     {
-        ZYAN_CHECK(ZyanVectorDestroy(&g_trampoline_data.regions));
-        g_trampoline_data.is_initialized = ZYAN_FALSE;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+
+    // The stub of the listener keeps its destination, so threads that already entered the 
+    // listener still continue with the rest of the chain
+    ZyrexTrampolineStoreCallbackEntry(ZyrexTrampolineGetChainEntry(trampoline, index),
+        *ZyrexTrampolineRegionGetCallbackEntry(region, item->callback_jump));
+    item->is_linked = ZYAN_FALSE;
+
     return ZYAN_STATUS_SUCCESS;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Searching                                                                                      */
-/* ---------------------------------------------------------------------------------------------- */
-
-ZyanStatus ZyrexTrampolineFind(const void* original, ZyrexTrampolineChunk** trampoline)
+ZyanStatus ZyrexTrampolineListenerFree(ZyrexTrampolineChunk* trampoline, const void* listener)
 {
-    if (!original || !trampoline)
+    if (!trampoline || !listener)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    if (!g_trampoline_data.is_initialized)
+
+    ZyanUSize index;
+    if (!ZyrexTrampolineListenerGetIndex(trampoline, listener, &index))
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_NOT_FOUND;
     }
 
-    const ZyanUPointer region_address = ZYAN_ALIGN_DOWN((ZyanUPointer)original, 
-        g_trampoline_data.region_size);
-
-    ZyanUSize found_index;
-    const ZyanStatus status = 
-        ZyanVectorBinarySearch(&g_trampoline_data.regions, &region_address, &found_index, 
-            (ZyanComparison)&ZyanComparePointer);
-    ZYAN_CHECK(status);
-    
-    if (status == ZYAN_STATUS_FALSE)
+    const ZyrexTrampolineListener* const item = ZyanVectorGet(trampoline->listeners, index);
+    ZYAN_ASSERT(item);
+    if (item->is_linked)
     {
-        return ZYAN_STATUS_FALSE;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZyrexTrampolineRegion** const element = 
-        ZyanVectorGetMutable(&g_trampoline_data.regions, found_index);
-    ZYAN_ASSERT(element && *element);
+    ZyrexTrampolineRegion* const region = (ZyrexTrampolineRegion*)ZYAN_ALIGN_DOWN(
+        (ZyanUPointer)trampoline, g_trampoline_data.region_size);
+    const ZyanU8* const callback_jump = item->callback_jump;
 
-    ZyrexTrampolineRegion* const region = *element;
-    ZYAN_ASSERT(region->header.signature == ZYREX_TRAMPOLINE_REGION_SIGNATURE);
+    ZYAN_CHECK(ZyanVectorDelete(trampoline->listeners, index));
 
-    for (ZyanUSize i = 1; i < g_trampoline_data.chunks_per_region; ++i)
-    {
-        ZyrexTrampolineChunk* const chunk = &region->chunks[i];
-        ZYAN_ASSERT(chunk);
+    return ZyrexTrampolineRegionReleaseCallback(region, callback_jump);
+}
 
-        if (!chunk->is_used)
-        {
-            continue;
-        }
+ZyanUSize ZyrexTrampolineGetListenerCount(const ZyrexTrampolineChunk* trampoline)
+{
+    ZYAN_ASSERT(trampoline);
 
-        if ((ZyanUPointer)&chunk->code_buffer == (ZyanUPointer)original)
+    ZyanUSize count = 0;
+    if (trampoline->listeners)
+    {
+        ZYAN_VECTOR_FOREACH(ZyrexTrampolineListener, trampoline->listeners, item,
         {
-            *trampoline = chunk;
-            return ZYAN_STATUS_TRUE;
-        }
+            count += item.is_linked;
+        });
     }
 
-    return ZYAN_STATUS_FALSE;
+    return count;
+}
+
+ZyanStatus ZyrexTrampolineDetach(ZyrexTrampolineChunk* trampoline)
+{
+    if (!trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_CHECK(ZyrexTrampolineSetBypass(trampoline, ZYAN_TRUE));
+    trampoline->is_detached = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
@@ -24,18 +24,111 @@
 
 ***************************************************************************************************/
 
+#ifndef _GNU_SOURCE
+    // Required for the `REG_RIP`/`REG_EIP` register indices of the `ucontext_t` struct
+#   define _GNU_SOURCE
+#endif
+
 #include <stdlib.h>
 #include <stdint.h>
-#include <Windows.h>
-#include <TlHelp32.h>
+#include <Zycore/API/Memory.h>
+#include <Zycore/API/Process.h>
+#include <Zycore/API/Synchronization.h>
+#include <Zycore/Comparison.h>
 #include <Zycore/LibC.h>
 #include <Zycore/Vector.h>
 #include <Zycore/Zycore.h>
 #include <Zydis/Zydis.h>
 #include <Zyrex/Transaction.h>
+#include <Zyrex/Internal/Barrier.h>
+#include <Zyrex/Internal/ExceptionHook.h>
+#include <Zyrex/Internal/ImportTable.h>
 #include <Zyrex/Internal/InlineHook.h>
+#include <Zyrex/Internal/MemoryMap.h>
+#include <Zyrex/Internal/Relocation.h>
+#include <Zyrex/Internal/RelocationCache.h>
+#include <Zyrex/Internal/Thunk.h>
 #include <Zyrex/Internal/Trampoline.h>
 
+#if   defined(ZYAN_WINDOWS)
+#   include <Windows.h>
+#   include <TlHelp32.h>
+#elif defined(ZYAN_POSIX)
+#   include <dirent.h>
+#   include <errno.h>
+#   include <semaphore.h>
+#   include <sched.h>
+#   include <signal.h>
+#   include <time.h>
+#   include <ucontext.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#else
+#   error "Unsupported platform detected"
+#endif
+
+/* ============================================================================================== */
+/* Constants                                                                                      */
+/* ============================================================================================== */
+
+#ifdef ZYAN_POSIX
+
+/**
+ * @brief   Defines the signal that is used to suspend threads.
+ */
+#define ZYREX_SIGNAL_SUSPEND            (SIGRTMIN + 4)
+
+/**
+ * @brief   Defines the signal that is used to resume suspended threads.
+ */
+#define ZYREX_SIGNAL_RESUME             (SIGRTMIN + 5)
+
+/**
+ * @brief   Defines the time (in milliseconds) to wait for a thread to acknowledge the suspend
+ *          signal.
+ *
+ * Threads that block the suspend signal or are stuck in an uninterruptible system call are 
+ * skipped after this time.
+ */
+#define ZYREX_SIGNAL_SUSPEND_TIMEOUT    1000
+
+#endif
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the offset of the callback jump inside of a remote trampoline slot.
+ */
+#define ZYREX_REMOTE_SLOT_CALLBACK_JUMP         40
+
+/**
+ * @brief   Defines the offset of the backjump address inside of a remote trampoline slot.
+ */
+#define ZYREX_REMOTE_SLOT_BACKJUMP_ADDRESS      48
+
+/**
+ * @brief   Defines the offset of the callback address inside of a remote trampoline slot.
+ */
+#define ZYREX_REMOTE_SLOT_CALLBACK_ADDRESS      56
+
+/**
+ * @brief   Defines the maximum number of attempts to reserve a remote trampoline-region.
+ *
+ * The target process keeps running while the regions are allocated, so a free memory block might 
+ * get occupied before it is reserved.
+ */
+#define ZYREX_REMOTE_REGION_ALLOCATION_ATTEMPTS 4
+
+ZYAN_STATIC_ASSERT(ZYREX_TRAMPOLINE_MAX_CODE_SIZE + ZYREX_TRAMPOLINE_MAX_CODE_SIZE_BONUS + 
+    ZYREX_SIZEOF_ABSOLUTE_JUMP <= ZYREX_REMOTE_SLOT_CALLBACK_JUMP);
+ZYAN_STATIC_ASSERT(ZYREX_REMOTE_SLOT_CALLBACK_JUMP + ZYREX_SIZEOF_ABSOLUTE_JUMP <= 
+    ZYREX_REMOTE_SLOT_BACKJUMP_ADDRESS);
+ZYAN_STATIC_ASSERT(ZYREX_REMOTE_SLOT_CALLBACK_ADDRESS + sizeof(ZyanUPointer) <= 
+    ZYREX_TRAMPOLINE_CODE_SLOT_SIZE);
+
+#endif
+
 /* ============================================================================================== */
 /* Enums and types                                                                                */
 /* ============================================================================================== */
@@ -52,7 +145,16 @@ typedef enum ZyrexOperationAction_
     /**
      * @brief   Removal action.
      */
-     ZYREX_OPERATION_ACTION_REMOVE
+     ZYREX_OPERATION_ACTION_REMOVE,
+    /**
+     * @brief   Links a listener into the callback chain of an installed inline hook.
+     */
+    ZYREX_OPERATION_ACTION_ATTACH_LISTENER,
+    /**
+     * @brief   Unlinks a listener from the callback chain of an installed inline hook or 
+     *          detaches the callback of the hook itself, if the `value` is `ZYAN_NULL`.
+     */
+    ZYREX_OPERATION_ACTION_REMOVE_LISTENER
 } ZyrexOperationAction;
 
 /**
@@ -73,9 +175,18 @@ typedef struct ZyrexOperation_
      */
     void* address;
     /**
-     * @brief   The trampoline chunk.
+     * @brief   The trampoline chunk or `ZYAN_NULL`, if this is a pointer hook.
      */
     ZyrexTrampolineChunk* trampoline;
+    /**
+     * @brief   The pointer value the slot of a pointer hook is replaced with or the listener 
+     *          address of a listener operation.
+     */
+    const void* value;
+    /**
+     * @brief   The original pointer value of the slot of a pointer hook.
+     */
+    const void* original;
     /**
      * @brief   This value points to the memory that is passed by the user to store the trampoline
      *          pointer.
@@ -83,19 +194,297 @@ typedef struct ZyrexOperation_
     //ZyanConstVoidPointer* trampoline_accessor;
 } ZyrexOperation;
 
-/* ============================================================================================== */
-/* Globals                                                                                        */
-/* ============================================================================================== */
+#ifdef ZYAN_POSIX
 
 /**
- * @brief   Contains global transaction data.
+ * @brief   Defines the `ZyrexSuspendedThread` struct.
+ *
+ * This struct is shared between the transaction thread and the signal handler of the suspended
+ * thread. It is allocated on the heap, so that its address stays stable while the thread-update
+ * list grows.
  */
-static struct
+typedef struct ZyrexSuspendedThread_
+{
+    /**
+     * @brief   The signal context of the suspended thread.
+     *
+     * The context is written back by the kernel, when the signal handler returns.
+     */
+    ucontext_t* context;
+    /**
+     * @brief   Signals the suspended thread to leave the signal handler.
+     */
+    volatile sig_atomic_t is_resumed;
+} ZyrexSuspendedThread;
+
+#endif
+
+/**
+ * @brief   Defines the `ZyrexThreadEntry` struct.
+ */
+typedef struct ZyrexThreadEntry_
+{
+    /**
+     * @brief   The thread id.
+     */
+    ZyanThreadId id;
+#if   defined(ZYAN_WINDOWS)
+    /**
+     * @brief   The handle of the suspended thread.
+     */
+    HANDLE handle;
+#elif defined(ZYAN_POSIX)
+    /**
+     * @brief   The suspension state of the thread.
+     */
+    ZyrexSuspendedThread* state;
+#endif
+} ZyrexThreadEntry;
+
+/**
+ * @brief   Defines the `ZyrexMigrationRangeType` enum.
+ */
+typedef enum ZyrexMigrationRangeType_
+{
+    /**
+     * @brief   The range covers the patched instructions of an attached hook.
+     */
+    ZYREX_MIGRATION_RANGE_TYPE_ORIGINAL_CODE,
+    /**
+     * @brief   The range covers the trampoline code (including the backjump) of a removed hook.
+     */
+    ZYREX_MIGRATION_RANGE_TYPE_TRAMPOLINE_CODE,
+    /**
+     * @brief   The range covers the callback jump of a removed hook or listener.
+     */
+    ZYREX_MIGRATION_RANGE_TYPE_CALLBACK_JUMP,
+    /**
+     * @brief   The range covers the sampling stub of a removed hook.
+     */
+    ZYREX_MIGRATION_RANGE_TYPE_SAMPLING_STUB
+} ZyrexMigrationRangeType;
+
+/**
+ * @brief   Defines the `ZyrexMigrationRange` struct.
+ */
+typedef struct ZyrexMigrationRange_
+{
+    /**
+     * @brief   The start address of the range.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The size of the range.
+     */
+    ZyanUSize size;
+    /**
+     * @brief   The range type.
+     */
+    ZyrexMigrationRangeType type;
+    /**
+     * @brief   The operation that affects the range.
+     */
+    const ZyrexOperation* operation;
+} ZyrexMigrationRange;
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the `ZyrexNtGetNextThread` function prototype.
+ */
+typedef NTSTATUS (NTAPI* ZyrexNtGetNextThread)(HANDLE ProcessHandle, HANDLE ThreadHandle,
+    ACCESS_MASK DesiredAccess, ULONG HandleAttributes, ULONG Flags, PHANDLE NewThreadHandle);
+
+#endif
+
+/**
+ * @brief   Defines the `ZyrexCodePatch` struct.
+ */
+typedef struct ZyrexCodePatch_
+{
+    /**
+     * @brief   The target address of the patch.
+     */
+    ZyanU8* address;
+    /**
+     * @brief   The number of valid bytes in the `data` buffer.
+     */
+    ZyanU8 size;
+    /**
+     * @brief   The offset of the hooked address relative to the target address of the patch.
+     *
+     * This value is non-zero for hot-patch hooks, whose patch starts in the padding in front of
+     * the hooked function.
+     */
+    ZyanU8 offset;
+    /**
+     * @brief   Signals, if the patch restores the original code.
+     */
+    ZyanBool is_removal;
+    /**
+     * @brief   Signals, if the patch replaces a pointer-sized slot.
+     */
+    ZyanBool is_pointer;
+    /**
+     * @brief   The patch bytes.
+     */
+    ZyanU8 data[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
+    /**
+     * @brief   The undo log entry of the patch.
+     *
+     * Contains the original bytes at the target address, which are recorded right before the 
+     * patch is written.
+     */
+    ZyanU8 original[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
+} ZyrexCodePatch;
+
+/**
+ * @brief   Defines the `ZyrexCodePage` struct.
+ */
+typedef struct ZyrexCodePage_
+{
+    /**
+     * @brief   The base address of the page.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The original page protection.
+     */
+#if   defined(ZYAN_WINDOWS)
+    DWORD old_protection;
+#elif defined(ZYAN_POSIX)
+    int old_protection;
+#endif
+} ZyrexCodePage;
+
+/**
+ * @brief   Defines the `ZyrexPointerHook` struct.
+ */
+typedef struct ZyrexPointerHook_
+{
+    /**
+     * @brief   The hook type (`ZYREX_HOOK_TYPE_IAT` or `ZYREX_HOOK_TYPE_VTABLE`).
+     */
+    ZyrexHookType type;
+    /**
+     * @brief   The address of the hooked pointer slot.
+     */
+    void** slot;
+    /**
+     * @brief   The original pointer value of the slot.
+     */
+    const void* original;
+} ZyrexPointerHook;
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the `ZyrexRemoteRegion` struct.
+ *
+ * A remote trampoline-region is a reserved memory block in the address space of the target 
+ * process. Each remote trampoline occupies a single `ZYREX_TRAMPOLINE_CODE_SLOT_SIZE` slot, that 
+ * contains the relocated code, the backjump and the jump to the callback function.
+ */
+typedef struct ZyrexRemoteRegion_
+{
+    /**
+     * @brief   The address of the region in the target process.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   The number of assigned slots.
+     */
+    ZyanUSize slot_count;
+    /**
+     * @brief   Signals, if the region contains the trampoline of at least one installed hook.
+     */
+    ZyanBool is_used;
+} ZyrexRemoteRegion;
+
+/**
+ * @brief   Defines the `ZyrexRemoteHook` struct.
+ *
+ * The hook is considered alive as long as the `status` of its entry signals success.
+ */
+typedef struct ZyrexRemoteHook_
+{
+    /**
+     * @brief   The address to hook in the target process.
+     */
+    ZyanUPointer address;
+    /**
+     * @brief   A pointer to the corresponding `ZyrexRemoteInlineHookEntry` struct.
+     */
+    ZyrexRemoteInlineHookEntry* entry;
+    /**
+     * @brief   A local copy of the original code.
+     */
+    ZyanU8 source[ZYREX_TRAMPOLINE_MAX_CODE_SIZE];
+    /**
+     * @brief   The local trampoline chunk, that receives the relocation results.
+     *
+     * The `code` field points to the `code` field of this struct.
+     */
+    ZyrexTrampolineChunk chunk;
+    /**
+     * @brief   The local copy of the relocated code.
+     */
+    ZyrexTrampolineCode code;
+    /**
+     * @brief   The fixups of the relocated code.
+     */
+    ZyrexRelocationFixups fixups;
+    /**
+     * @brief   The lowest address the trampoline has to reach using relative offsets.
+     */
+    ZyanUPointer address_lo;
+    /**
+     * @brief   The highest address the trampoline has to reach using relative offsets.
+     */
+    ZyanUPointer address_hi;
+    /**
+     * @brief   The index of the remote trampoline-region that contains the trampoline.
+     */
+    ZyanUSize region;
+    /**
+     * @brief   The address of the trampoline slot in the target process.
+     */
+    ZyanUPointer slot;
+} ZyrexRemoteHook;
+
+#endif
+
+/**
+ * @brief   Defines the `ZyrexTransaction` struct.
+ */
+struct ZyrexTransaction_
 {
     /**
-     * @brief   The id of the thread that started the current transaction.
+     * @brief   The id of the thread that started the global transaction or `0`, if the global
+     *          transaction is not active.
+     *
+     * This field is unused for transaction objects created by `ZyrexTransactionBeginEx`.
      */
     volatile ZyanThreadId transaction_thread_id;
+    /**
+     * @brief   Signals, if the suspension of threads is deferred to the commit phase.
+     */
+    ZyanBool is_deferred;
+    /**
+     * @brief   Signals, if all threads of the process should be updated during the commit phase.
+     */
+    ZyanBool update_all_threads;
+    /**
+     * @brief   Signals, if the transaction currently holds the transaction locks.
+     */
+    ZyanBool is_locked;
+    /**
+     * @brief   Signals, if a failed commit left the target code partially patched.
+     *
+     * The trampolines of pending hook installations are never released in this case, as they
+     * might already be reachable from the patched code.
+     */
+    ZyanBool is_inconsistent;
     /**
      * @brief   A list with all pending operations.
      */
@@ -103,404 +492,5450 @@ static struct
     /**
      * @brief   A list with all threads to update.
      */
-    ZyanVector/*<HANDLE>*/ threads_to_update;
-} g_transaction_data =
+    ZyanVector/*<ZyrexThreadEntry>*/ threads_to_update;
+    /**
+     * @brief   A list with the ids of all threads to update during the commit phase.
+     */
+    ZyanVector/*<ZyanThreadId>*/ deferred_threads;
+};
+
+/* ============================================================================================== */
+/* Globals                                                                                        */
+/* ============================================================================================== */
+
+/**
+ * @brief   Contains the global transaction that is used by the thread-bound transaction API.
+ */
+static ZyrexTransaction g_transaction_data =
+{
+    0, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE, ZYAN_FALSE, ZYAN_VECTOR_INITIALIZER, 
+    ZYAN_VECTOR_INITIALIZER, ZYAN_VECTOR_INITIALIZER
+};
+
+/**
+ * @brief   Contains the locks that synchronize concurrent transactions.
+ *
+ * The `region_lock` protects the trampoline-regions, the cached memory map and the barrier slots.
+ * It is held for the duration of every single hook preparation. The `commit_lock` serializes the
+ * thread suspension, code patching and thread migration. If both locks are required, the 
+ * `commit_lock` is always acquired first.
+ *
+ * The locks are lazily initialized by the first transaction.
+ */
+static struct
+{
+    /**
+     * @brief   The initialization state of the locks (`0` = uninitialized, `1` = initializing,
+     *          `2` = initialized).
+     */
+    volatile ZyanU32 state;
+    /**
+     * @brief   The lock that serializes the commit phase of all transactions.
+     */
+    ZyanCriticalSection commit_lock;
+    /**
+     * @brief   The lock that protects the shared trampoline bookkeeping.
+     */
+    ZyanCriticalSection region_lock;
+} g_transaction_locks;
+
+/**
+ * @brief   Contains all installed exception and context hooks sorted by address.
+ *
+ * The list is only modified during the commit phase and is protected by the region lock. The
+ * exception dispatcher does not access this list, but uses a hash table that is built from it.
+ */
+static ZyanVector/*<ZyrexExceptionHook>*/ g_exception_hooks = ZYAN_VECTOR_INITIALIZER;
+
+/**
+ * @brief   Contains all installed pointer hooks sorted by slot address.
+ *
+ * The list is only modified during the commit phase and is protected by the region lock.
+ */
+static ZyanVector/*<ZyrexPointerHook>*/ g_pointer_hooks = ZYAN_VECTOR_INITIALIZER;
+
+#if   defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   Contains the lazily resolved `ntdll` functions.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the functions have been resolved.
+     */
+    ZyanBool is_resolved;
+    /**
+     * @brief   The `NtGetNextThread` function or `ZYAN_NULL`, if not available.
+     */
+    ZyrexNtGetNextThread nt_get_next_thread;
+} g_ntdll_functions =
 {
-    0, ZYAN_VECTOR_INITIALIZER, ZYAN_VECTOR_INITIALIZER
+    ZYAN_FALSE, ZYAN_NULL
 };
 
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   Contains the data required for the signal based thread suspension.
+ *
+ * Threads are suspended one at a time. The transaction thread publishes the target thread and its
+ * state, sends the suspend signal and waits for the signal handler to acknowledge it.
+ */
+static struct
+{
+    /**
+     * @brief   Signals, if the signal handlers have been installed.
+     */
+    ZyanBool is_installed;
+    /**
+     * @brief   The id of the thread that is currently being suspended.
+     */
+    volatile pid_t target_thread;
+    /**
+     * @brief   The state of the thread that is currently being suspended or `ZYAN_NULL`, if the
+     *          state has already been claimed by the signal handler.
+     */
+    ZyrexSuspendedThread* volatile target_state;
+    /**
+     * @brief   The semaphore that is posted by the signal handler after entering and before 
+     *          leaving the suspended state.
+     */
+    sem_t acknowledge;
+} g_signal_data;
+
+#endif
+
 /* ============================================================================================== */
 /* Internal functions                                                                             */
 /* ============================================================================================== */
 
 /* ---------------------------------------------------------------------------------------------- */
-/* ZyanVector<HANDLE>                                                                             */
+/* Threads                                                                                        */
 /* ---------------------------------------------------------------------------------------------- */
 
 /**
- * @brief   Finalizes the given `HANDLE` item.
+ * @brief   Returns the id of the calling thread.
+ *
+ * @return  The id of the calling thread.
  *
- * @param   item    A pointer to the `HANDLE` item.
+ * On Linux, the kernel thread id is returned, as it is required to send signals to individual 
+ * threads and is also used by `/proc/self/task`.
  */
-static void ZyrexWindowsHandleDestroy(HANDLE* item)
+static ZyanThreadId ZyrexGetCurrentThreadId(void)
 {
-    ZYAN_ASSERT(item);
-
-    CloseHandle(*item);
+#if   defined(ZYAN_WINDOWS)
+    return GetCurrentThreadId();
+#elif defined(ZYAN_POSIX)
+    return (ZyanThreadId)syscall(SYS_gettid);
+#endif
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Code Patching                                                                                  */
-/* ---------------------------------------------------------------------------------------------- */
+#ifdef ZYAN_POSIX
 
 /**
- * @brief   Writes the hook jump which redirects the code-flow from the given `address` to the 
- *          `trampoline`.
+ * @brief   The signal handler that suspends the current thread.
  *
- * @param   address     The target address.
- * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
- *
- * @return  A zyan status code.
+ * @param   signal  The signal number.
+ * @param   info    A pointer to the `siginfo_t` struct.
+ * @param   context A pointer to the `ucontext_t` struct of the interrupted thread.
  */
-static ZyanStatus ZyrexWriteHookJump(void* address, const ZyrexTrampolineChunk* trampoline)
+static void ZyrexSignalHandlerSuspend(int signal, siginfo_t* info, void* context)
+{
+    ZYAN_UNUSED(signal);
+    ZYAN_UNUSED(info);
+
+    const int saved_errno = errno;
+
+    // Ignore late signals for threads that timed out before and foreign signals
+    if ((pid_t)syscall(SYS_gettid) != g_signal_data.target_thread)
+    {
+        errno = saved_errno;
+        return;
+    }
+    ZyrexSuspendedThread* const state = 
+        __sync_lock_test_and_set(&g_signal_data.target_state, ZYAN_NULL);
+    if (!state)
+    {
+        errno = saved_errno;
+        return;
+    }
+
+    state->context = (ucontext_t*)context;
+    sem_post(&g_signal_data.acknowledge);
+
+    // The resume signal is blocked while the handler executes and only gets delivered while 
+    // waiting in `sigsuspend`, so no wakeup can be lost
+    sigset_t mask;
+    sigfillset(&mask);
+    sigdelset(&mask, ZYREX_SIGNAL_RESUME);
+    while (!state->is_resumed)
+    {
+        sigsuspend(&mask);
+    }
+
+    // The state must not be accessed after this point
+    sem_post(&g_signal_data.acknowledge);
+
+    errno = saved_errno;
+}
+
+/**
+ * @brief   The signal handler that resumes a suspended thread.
+ *
+ * @param   signal  The signal number.
+ *
+ * This handler only exists to interrupt the `sigsuspend` call of the suspend handler.
+ */
+static void ZyrexSignalHandlerResume(int signal)
+{
+    ZYAN_UNUSED(signal);
+}
+
+/**
+ * @brief   Installs the signal handlers used to suspend and resume threads, if not already done.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexSignalHandlersInstall(void)
+{
+    // Only the transaction thread is able to reach this code, so there is no need for
+    // synchronization
+    if (g_signal_data.is_installed)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    if (sem_init(&g_signal_data.acknowledge, 0, 0) != 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    struct sigaction action;
+    ZYAN_MEMSET(&action, 0, sizeof(action));
+    action.sa_sigaction = &ZyrexSignalHandlerSuspend;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigfillset(&action.sa_mask);
+    if (sigaction(ZYREX_SIGNAL_SUSPEND, &action, ZYAN_NULL) != 0)
+    {
+        sem_destroy(&g_signal_data.acknowledge);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    ZYAN_MEMSET(&action, 0, sizeof(action));
+    action.sa_handler = &ZyrexSignalHandlerResume;
+    action.sa_flags = SA_RESTART;
+    sigfillset(&action.sa_mask);
+    if (sigaction(ZYREX_SIGNAL_RESUME, &action, ZYAN_NULL) != 0)
+    {
+        signal(ZYREX_SIGNAL_SUSPEND, SIG_DFL);
+        sem_destroy(&g_signal_data.acknowledge);
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    g_signal_data.is_installed = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the signal handler of the target thread to acknowledge a state transition.
+ *
+ * @param   timeout Pass `ZYAN_TRUE` to give up after `ZYREX_SIGNAL_SUSPEND_TIMEOUT` milliseconds.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the transition was acknowledged, `ZYAN_STATUS_FALSE`, if the
+ *          timeout elapsed or an other zyan status code, if an error occured.
+ */
+static ZyanStatus ZyrexSignalWaitForAcknowledge(ZyanBool timeout)
+{
+    struct timespec deadline;
+    if (timeout)
+    {
+        if (clock_gettime(CLOCK_REALTIME, &deadline) != 0)
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        deadline.tv_sec  += ZYREX_SIGNAL_SUSPEND_TIMEOUT / 1000;
+        deadline.tv_nsec += (ZYREX_SIGNAL_SUSPEND_TIMEOUT % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec  += 1;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    while ((timeout ? sem_timedwait(&g_signal_data.acknowledge, &deadline) 
+                    : sem_wait(&g_signal_data.acknowledge)) != 0)
+    {
+        if (errno == ETIMEDOUT)
+        {
+            return ZYAN_STATUS_FALSE;
+        }
+        if (errno != EINTR)
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/**
+ * @brief   Sends the given `signal` to the thread with the given `id`.
+ *
+ * @param   id      The thread id.
+ * @param   signal  The signal number or `0` to check for the existence of the thread.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexSignalSend(ZyanThreadId id, int signal)
+{
+    return (syscall(SYS_tgkill, getpid(), (pid_t)id, signal) == 0)
+        ? ZYAN_STATUS_SUCCESS
+        : ZYAN_STATUS_BAD_SYSTEMCALL;
+}
+
+#endif
+
+/**
+ * @brief   Suspends the thread represented by the given `entry`.
+ *
+ * @param   entry   A pointer to the `ZyrexThreadEntry` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * On POSIX systems, this function initializes the suspension state of the `entry`. The thread
+ * executes the suspend signal handler until it gets resumed by `ZyrexThreadResume`.
+ */
+static ZyanStatus ZyrexThreadSuspend(ZyrexThreadEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+
+#if   defined(ZYAN_WINDOWS)
+
+    return (SuspendThread(entry->handle) == (DWORD)(-1))
+        ? ZYAN_STATUS_BAD_SYSTEMCALL
+        : ZYAN_STATUS_SUCCESS;
+
+#elif defined(ZYAN_POSIX)
+
+    ZYAN_ASSERT(!entry->state);
+    ZYAN_CHECK(ZyrexSignalHandlersInstall());
+
+    ZyrexSuspendedThread* const state = ZYAN_MALLOC(sizeof(ZyrexSuspendedThread));
+    if (!state)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    state->context = ZYAN_NULL;
+    state->is_resumed = 0;
+
+    g_signal_data.target_thread = (pid_t)entry->id;
+    __sync_synchronize();
+    g_signal_data.target_state = state;
+    __sync_synchronize();
+
+    ZyanStatus status = ZyrexSignalSend(entry->id, ZYREX_SIGNAL_SUSPEND);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexSignalWaitForAcknowledge(ZYAN_TRUE);
+        if (status == ZYAN_STATUS_FALSE)
+        {
+            // Revoke the request. If the handler claimed the state in the meantime, the thread is
+            // about to acknowledge the suspension
+            if (__sync_lock_test_and_set(&g_signal_data.target_state, ZYAN_NULL))
+            {
+                status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            } else
+            {
+                status = ZyrexSignalWaitForAcknowledge(ZYAN_FALSE);
+            }
+        }
+    }
+    g_signal_data.target_thread = 0;
+    g_signal_data.target_state = ZYAN_NULL;
+
+    if (status != ZYAN_STATUS_TRUE)
+    {
+        ZYAN_FREE(state);
+        return ZYAN_SUCCESS(status) ? ZYAN_STATUS_BAD_SYSTEMCALL : status;
+    }
+
+    entry->state = state;
+
+    return ZYAN_STATUS_SUCCESS;
+
+#endif
+}
+
+/**
+ * @brief   Resumes the thread represented by the given `entry`.
+ *
+ * @param   entry   A pointer to the `ZyrexThreadEntry` struct.
+ *
+ * On POSIX systems, this function releases the suspension state of the `entry`.
+ */
+static void ZyrexThreadResume(ZyrexThreadEntry* entry)
+{
+    ZYAN_ASSERT(entry);
+
+#if   defined(ZYAN_WINDOWS)
+
+    ResumeThread(entry->handle);
+
+#elif defined(ZYAN_POSIX)
+
+    if (!entry->state)
+    {
+        return;
+    }
+
+    entry->state->is_resumed = 1;
+    __sync_synchronize();
+
+    // Wait until the signal handler does no longer access the state
+    if (ZYAN_SUCCESS(ZyrexSignalSend(entry->id, ZYREX_SIGNAL_RESUME)))
+    {
+        ZYAN_UNUSED(ZyrexSignalWaitForAcknowledge(ZYAN_FALSE));
+    }
+
+    ZYAN_FREE(entry->state);
+    entry->state = ZYAN_NULL;
+
+#endif
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* ZyanVector<ZyrexThreadEntry>                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines the access rights required for threads in the thread-update list.
+ */
+#define ZYREX_THREAD_ACCESS \
+    (THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT | \
+     THREAD_QUERY_LIMITED_INFORMATION)
+
+#endif
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexThreadEntry` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareThreadEntry, ZyrexThreadEntry, id);
+
+/**
+ * @brief   Finalizes the given `ZyrexThreadEntry` item.
+ *
+ * @param   item    A pointer to the `ZyrexThreadEntry` item.
+ */
+static void ZyrexThreadEntryDestroy(ZyrexThreadEntry* item)
+{
+    ZYAN_ASSERT(item);
+
+#if   defined(ZYAN_WINDOWS)
+    CloseHandle(item->handle);
+#elif defined(ZYAN_POSIX)
+    // The suspension state is released when the thread gets resumed
+    ZYAN_ASSERT(!item->state);
+#endif
+}
+
+/**
+ * @brief   Suspends the given thread and inserts it into the sorted `threads` list.
+ *
+ * @param   threads     A pointer to the `ZyanVector` that contains the `ZyrexThreadEntry` items.
+ * @param   entry       A pointer to the `ZyrexThreadEntry` of the thread.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the thread was suspended and added to the list,
+ *          `ZYAN_STATUS_FALSE`, if the list already contains a thread with the given `id` or an
+ *          other zyan status code, if an error occured.
+ *
+ * The list takes ownership of the thread handle only, if this function returns 
+ * `ZYAN_STATUS_TRUE`.
+ */
+static ZyanStatus ZyrexThreadListSuspend(ZyanVector* threads, ZyrexThreadEntry* entry)
+{
+    ZYAN_ASSERT(threads);
+    ZYAN_ASSERT(entry);
+
+    ZyanUSize found_index;
+    ZyanStatus status = ZyanVectorBinarySearch(threads, entry, &found_index,
+        (ZyanComparison)&ZyrexCompareThreadEntry);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+    
+    ZYAN_CHECK(ZyrexThreadSuspend(entry));
+
+    status = ZyanVectorInsert(threads, found_index, entry);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexThreadResume(entry);
+        return status;
+    }
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/**
+ * @brief   Resumes all threads in the given `threads` list.
+ *
+ * @param   threads A pointer to the `ZyanVector` that contains the `ZyrexThreadEntry` items.
+ */
+static void ZyrexThreadListResume(ZyanVector* threads)
+{
+    ZYAN_ASSERT(threads);
+
+    ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexThreadEntry, threads, entry, 
+    {
+        ZyrexThreadResume(entry);
+    });
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread enumeration                                                                             */
+/* ---------------------------------------------------------------------------------------------- */
+
+#if   defined(ZYAN_WINDOWS)
+
+/**
+ * @brief   Returns the `NtGetNextThread` function.
+ *
+ * @return  A pointer to the `NtGetNextThread` function or `ZYAN_NULL`, if not available.
+ */
+static ZyrexNtGetNextThread ZyrexGetNtGetNextThread(void)
+{
+    // Only the transaction thread is able to reach this code, so there is no need for
+    // synchronization
+    if (!g_ntdll_functions.is_resolved)
+    {
+        const HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+        if (ntdll)
+        {
+            g_ntdll_functions.nt_get_next_thread =
+                (ZyrexNtGetNextThread)GetProcAddress(ntdll, "NtGetNextThread");
+        }
+        g_ntdll_functions.is_resolved = ZYAN_TRUE;
+    }
+
+    return g_ntdll_functions.nt_get_next_thread;
+}
+
+/**
+ * @brief   Suspends all threads of the given `process` by walking its thread list using
+ *          `NtGetNextThread`.
+ *
+ * @param   nt_get_next_thread  A pointer to the `NtGetNextThread` function.
+ * @param   process             The process handle.
+ * @param   exclude_thread_id   The id of a thread to skip or `0`.
+ * @param   threads             A pointer to the `ZyanVector` that receives the `ZyrexThreadEntry`
+ *                              items.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexSuspendProcessThreadsNt(ZyrexNtGetNextThread nt_get_next_thread, 
+    HANDLE process, DWORD exclude_thread_id, ZyanVector* threads)
+{
+    ZYAN_ASSERT(nt_get_next_thread);
+    ZYAN_ASSERT(threads);
+
+    // Threads that are still running during the first pass might create new threads, so we keep
+    // walking the list until a full pass does not discover any new thread
+    ZyanBool found_new_thread;
+    do
+    {
+        found_new_thread = ZYAN_FALSE;
+
+        HANDLE current = ZYAN_NULL;
+        ZyanBool is_owned = ZYAN_FALSE;
+        HANDLE next;
+        while (nt_get_next_thread(process, current, ZYREX_THREAD_ACCESS, 0, 0, &next) >= 0)
+        {
+            if (is_owned)
+            {
+                CloseHandle(current);
+            }
+            current  = next;
+            is_owned = ZYAN_TRUE;
+
+            const DWORD id = GetThreadId(next);
+            if ((id == 0) || (id == exclude_thread_id))
+            {
+                continue;
+            }
+
+            ZyrexThreadEntry entry = { id, next };
+            const ZyanStatus status = ZyrexThreadListSuspend(threads, &entry);
+            if (status == ZYAN_STATUS_TRUE)
+            {
+                // The handle is owned by the list now, but it is still valid to continue the
+                // enumeration from it
+                is_owned = ZYAN_FALSE;
+                found_new_thread = ZYAN_TRUE;
+                continue;
+            }
+
+            // Skip threads that terminated or could not be suspended for other reasons
+            if (!ZYAN_SUCCESS(status) && (status != ZYAN_STATUS_BAD_SYSTEMCALL))
+            {
+                CloseHandle(current);
+                return status;
+            }
+        }
+
+        if (is_owned)
+        {
+            CloseHandle(current);
+        }
+    } while (found_new_thread);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Suspends all threads of the given `process` using a Toolhelp snapshot.
+ *
+ * @param   process             The process handle.
+ * @param   exclude_thread_id   The id of a thread to skip or `0`.
+ * @param   threads             A pointer to the `ZyanVector` that receives the `ZyrexThreadEntry`
+ *                              items.
+ *
+ * @return  A zyan status code.
+ *
+ * This function is used as a fallback, if `NtGetNextThread` is not available.
+ */
+static ZyanStatus ZyrexSuspendProcessThreadsToolhelp(HANDLE process, DWORD exclude_thread_id, 
+    ZyanVector* threads)
+{
+    ZYAN_ASSERT(threads);
+
+    const DWORD process_id = GetProcessId(process);
+
+    ZyanBool found_new_thread;
+    do
+    {
+        found_new_thread = ZYAN_FALSE;
+
+        const HANDLE h_snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+        if (h_snapshot == INVALID_HANDLE_VALUE)
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+
+        THREADENTRY32 thread;
+        ZYAN_MEMSET(&thread, 0, sizeof(thread));
+        thread.dwSize = sizeof(thread);
+
+        ZyanStatus status = ZYAN_STATUS_SUCCESS;
+        for (BOOL has_next = Thread32First(h_snapshot, &thread); has_next; 
+            has_next = Thread32Next(h_snapshot, &thread))
+        {
+            if ((thread.th32OwnerProcessID != process_id) || 
+                (thread.th32ThreadID == exclude_thread_id))
+            {
+                continue;
+            }
+
+            const HANDLE h_thread = OpenThread(ZYREX_THREAD_ACCESS, ZYAN_FALSE, 
+                thread.th32ThreadID);
+            if (h_thread == ZYAN_NULL)
+            {
+                continue;
+            }
+
+            ZyrexThreadEntry entry = { thread.th32ThreadID, h_thread };
+            status = ZyrexThreadListSuspend(threads, &entry);
+            if (status == ZYAN_STATUS_TRUE)
+            {
+                found_new_thread = ZYAN_TRUE;
+                continue;
+            }
+
+            CloseHandle(h_thread);
+            if (!ZYAN_SUCCESS(status) && (status != ZYAN_STATUS_BAD_SYSTEMCALL))
+            {
+                break;
+            }
+            status = ZYAN_STATUS_SUCCESS;
+        }
+
+        if (!CloseHandle(h_snapshot) && ZYAN_SUCCESS(status))
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        ZYAN_CHECK(status);
+
+    } while (found_new_thread);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Suspends all threads of the given `process` and adds them to the `threads` list.
+ *
+ * @param   process             The process handle.
+ * @param   exclude_thread_id   The id of a thread to skip or `0`.
+ * @param   threads             A pointer to the `ZyanVector` that receives the `ZyrexThreadEntry`
+ *                              items.
+ *
+ * @return  A zyan status code.
+ *
+ * Threads are suspended as soon as they are discovered. Threads that are already contained in the
+ * `threads` list are skipped.
+ */
+static ZyanStatus ZyrexSuspendProcessThreads(HANDLE process, DWORD exclude_thread_id,
+    ZyanVector* threads)
+{
+    const ZyrexNtGetNextThread nt_get_next_thread = ZyrexGetNtGetNextThread();
+    if (nt_get_next_thread)
+    {
+        return ZyrexSuspendProcessThreadsNt(nt_get_next_thread, process, exclude_thread_id, 
+            threads);
+    }
+
+    return ZyrexSuspendProcessThreadsToolhelp(process, exclude_thread_id, threads);
+}
+
+#elif defined(ZYAN_POSIX)
+
+/**
+ * @brief   Suspends all threads of the current process and adds them to the `threads` list.
+ *
+ * @param   exclude_thread_id   The id of a thread to skip or `0`.
+ * @param   threads             A pointer to the `ZyanVector` that receives the `ZyrexThreadEntry`
+ *                              items.
+ *
+ * @return  A zyan status code.
+ *
+ * The threads are enumerated using `/proc/self/task`. Threads are suspended as soon as they are 
+ * discovered. Threads that are already contained in the `threads` list are skipped.
+ */
+static ZyanStatus ZyrexSuspendProcessThreads(ZyanThreadId exclude_thread_id, ZyanVector* threads)
+{
+    ZYAN_ASSERT(threads);
+
+    // Threads that are still running during the first pass might create new threads, so we keep
+    // walking the list until a full pass does not discover any new thread
+    ZyanBool found_new_thread;
+    do
+    {
+        found_new_thread = ZYAN_FALSE;
+
+        DIR* const directory = opendir("/proc/self/task");
+        if (!directory)
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+
+        ZyanStatus status = ZYAN_STATUS_SUCCESS;
+        for (const struct dirent* item = readdir(directory); item; item = readdir(directory))
+        {
+            char* end;
+            const ZyanThreadId id = (ZyanThreadId)strtoull(item->d_name, &end, 10);
+            if ((end == item->d_name) || (*end != '\0') || (id == 0) || 
+                (id == exclude_thread_id))
+            {
+                continue;
+            }
+
+            ZyrexThreadEntry entry = { id, ZYAN_NULL };
+            status = ZyrexThreadListSuspend(threads, &entry);
+            if (status == ZYAN_STATUS_TRUE)
+            {
+                found_new_thread = ZYAN_TRUE;
+                continue;
+            }
+
+            // Skip threads that terminated or could not be suspended for other reasons
+            if (!ZYAN_SUCCESS(status) && (status != ZYAN_STATUS_BAD_SYSTEMCALL))
+            {
+                break;
+            }
+            status = ZYAN_STATUS_SUCCESS;
+        }
+
+        if ((closedir(directory) != 0) && ZYAN_SUCCESS(status))
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+        ZYAN_CHECK(status);
+
+    } while (found_new_thread);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Thread migration                                                                               */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexMigrationRange` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareMigrationRange, ZyrexMigrationRange, 
+    address);
+
+/**
+ * @brief   Inserts a new `ZyrexMigrationRange` item into the sorted `ranges` list.
+ *
+ * @param   ranges      A pointer to the `ZyanVector` that contains the `ZyrexMigrationRange`
+ *                      items.
+ * @param   address     The start address of the range.
+ * @param   size        The size of the range.
+ * @param   type        The range type.
+ * @param   operation   A pointer to the `ZyrexOperation` that affects the range.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexMigrationRangeInsert(ZyanVector* ranges, ZyanUPointer address, 
+    ZyanUSize size, ZyrexMigrationRangeType type, const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(ranges);
+    ZYAN_ASSERT(operation);
+
+    const ZyrexMigrationRange range = { address, size, type, operation };
+
+    ZyanUSize found_index;
+    ZYAN_CHECK(ZyanVectorBinarySearch(ranges, &range, &found_index, 
+        (ZyanComparison)&ZyrexCompareMigrationRange));
+
+    return ZyanVectorInsert(ranges, found_index, &range);
+}
+
+/**
+ * @brief   Collects the code ranges of all pending operations, which require threads to be
+ *          migrated, if their instruction pointer is located inside.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   ranges      A pointer to an initialized `ZyanVector` that receives the sorted
+ *                      `ZyrexMigrationRange` items.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexMigrationRangesCollect(const ZyrexTransaction* transaction, 
+    ZyanVector* ranges)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(ranges);
+
+    for (ZyanUSize i = 0; i < transaction->pending_operations.size; ++i)
+    {
+        const ZyrexOperation* item = ZyanVectorGet(&transaction->pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        // Pointer hooks do not execute any code that could be changed by the transaction
+        const ZyrexTrampolineChunk* const trampoline = item->trampoline;
+        if (!trampoline)
+        {
+            continue;
+        }
+
+        switch (item->action)
+        {
+        case ZYREX_OPERATION_ACTION_ATTACH:
+            // Exception hooks patch a single byte and context hooks do not patch any code at all
+            if (item->type != ZYREX_HOOK_TYPE_INLINE)
+            {
+                break;
+            }
+            ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, (ZyanUPointer)item->address, 
+                trampoline->original_code_size, ZYREX_MIGRATION_RANGE_TYPE_ORIGINAL_CODE, item));
+            break;
+        case ZYREX_OPERATION_ACTION_REMOVE:
+            ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, 
+                (ZyanUPointer)&trampoline->code->code_buffer,
+                trampoline->code_buffer_size + ZYREX_SIZEOF_ABSOLUTE_JUMP, 
+                ZYREX_MIGRATION_RANGE_TYPE_TRAMPOLINE_CODE, item));
+            // The exception dispatcher redirects directly to the callback function
+            if (trampoline->callback_jump && (item->type == ZYREX_HOOK_TYPE_INLINE))
+            {
+                ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, 
+                    (ZyanUPointer)trampoline->callback_jump, ZYREX_SIZEOF_ABSOLUTE_JUMP, 
+                    ZYREX_MIGRATION_RANGE_TYPE_CALLBACK_JUMP, item));
+            }
+            if (trampoline->sampling_interval)
+            {
+                ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, 
+                    (ZyanUPointer)&trampoline->code->sampling_stub, 
+                    ZYREX_TRAMPOLINE_SAMPLING_STUB_SIZE, ZYREX_MIGRATION_RANGE_TYPE_SAMPLING_STUB,
+                    item));
+            }
+            // The stubs of all remaining listeners are released together with the trampoline
+            if (trampoline->listeners)
+            {
+                ZYAN_VECTOR_FOREACH(ZyrexTrampolineListener, trampoline->listeners, listener,
+                {
+                    ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, 
+                        (ZyanUPointer)listener.callback_jump, ZYREX_SIZEOF_ABSOLUTE_JUMP, 
+                        ZYREX_MIGRATION_RANGE_TYPE_CALLBACK_JUMP, item));
+                });
+            }
+            break;
+        case ZYREX_OPERATION_ACTION_ATTACH_LISTENER:
+            // Linking a listener does not modify any code
+            break;
+        case ZYREX_OPERATION_ACTION_REMOVE_LISTENER:
+            if (item->value)
+            {
+                ZYAN_CHECK(ZyrexMigrationRangeInsert(ranges, (ZyanUPointer)item->value, 
+                    ZYREX_SIZEOF_ABSOLUTE_JUMP, ZYREX_MIGRATION_RANGE_TYPE_CALLBACK_JUMP, item));
+            }
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Searches the sorted `ranges` list for the range that contains the given `address`.
+ *
+ * @param   ranges  A pointer to the `ZyanVector` that contains the sorted `ZyrexMigrationRange`
+ *                  items.
+ * @param   address The address to search for.
+ *
+ * @return  A pointer to the `ZyrexMigrationRange` that contains the given `address` or 
+ *          `ZYAN_NULL`, if not found.
+ */
+static const ZyrexMigrationRange* ZyrexMigrationRangeFind(const ZyanVector* ranges, 
+    ZyanUPointer address)
+{
+    ZYAN_ASSERT(ranges);
+
+    // Find the last range that starts at or before the given address
+    ZyanUSize lo = 0;
+    ZyanUSize hi = ranges->size;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        const ZyrexMigrationRange* const range = ZyanVectorGet(ranges, mid);
+        ZYAN_ASSERT(range);
+
+        if (range->address <= address)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0)
+    {
+        return ZYAN_NULL;
+    }
+
+    const ZyrexMigrationRange* const range = ZyanVectorGet(ranges, lo - 1);
+    ZYAN_ASSERT(range);
+
+    return (address < range->address + range->size) ? range : ZYAN_NULL;
+}
+
+/**
+ * @brief   Translates the given `instruction_pointer`, if it is located inside one of the 
+ *          `ranges`.
+ *
+ * @param   instruction_pointer A pointer to the instruction pointer value of a suspended thread.
+ * @param   stack_pointer       A pointer to the stack pointer value of the suspended thread.
+ * @param   ranges              A pointer to the `ZyanVector` that contains the sorted 
+ *                              `ZyrexMigrationRange` items.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer was updated, `ZYAN_STATUS_FALSE`, if
+ *          not or an other zyan status code, if an error occured.
+ *
+ * The stack pointer is only updated for threads inside the sampling stub, which have to complete
+ * a pending `pop` instruction.
+ */
+static ZyanStatus ZyrexMigrateInstructionPointerInRanges(ZyanUPointer* instruction_pointer, 
+    ZyanUPointer* stack_pointer, const ZyanVector* ranges)
+{
+    ZYAN_ASSERT(instruction_pointer);
+    ZYAN_ASSERT(stack_pointer);
+    ZYAN_ASSERT(ranges);
+
+    const ZyanUPointer current_ip = *instruction_pointer;
+
+    const ZyrexMigrationRange* const range = ZyrexMigrationRangeFind(ranges, current_ip);
+    if (!range)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyrexOperation* const operation = range->operation;
+    const ZyrexTrampolineChunk* const trampoline = operation->trampoline;
+
+    ZyanUPointer new_ip;
+    switch (range->type)
+    {
+    case ZYREX_MIGRATION_RANGE_TYPE_ORIGINAL_CODE:
+        return ZyrexMigrateInstructionPointer(instruction_pointer, operation->address, 
+            trampoline->original_code_size, &trampoline->code->code_buffer, 
+            trampoline->code_buffer_size, &trampoline->translation_map, ZYAN_FALSE);
+    case ZYREX_MIGRATION_RANGE_TYPE_TRAMPOLINE_CODE:
+        if (current_ip < 
+            (ZyanUPointer)&trampoline->code->code_buffer + trampoline->code_buffer_size)
+        {
+            return ZyrexMigrateInstructionPointer(instruction_pointer, 
+                &trampoline->code->code_buffer, trampoline->code_buffer_size, operation->address, 
+                trampoline->original_code_size, &trampoline->translation_map, ZYAN_TRUE);
+        }
+        // The thread is about to execute the backjump
+        new_ip = trampoline->backjump_address;
+        break;
+    case ZYREX_MIGRATION_RANGE_TYPE_CALLBACK_JUMP:
+        // The callback stub might be shared with other hooks and gets released by the 
+        // transaction, so the thread completes the jump. Destinations inside a released 
+        // trampoline are equivalent to the original function
+        new_ip = ZyrexTrampolineGetCallbackJumpDestination((const void*)range->address);
+        if ((operation->action == ZYREX_OPERATION_ACTION_REMOVE) &&
+            ((new_ip == (ZyanUPointer)&trampoline->code->code_buffer) ||
+             (new_ip == (ZyanUPointer)&trampoline->code->sampling_stub)))
+        {
+            new_ip = (ZyanUPointer)operation->address;
+        }
+        break;
+    case ZYREX_MIGRATION_RANGE_TYPE_SAMPLING_STUB:
+    {
+        // Up to the `push`, the sampling stub only modified the flags and the sampling counter, 
+        // so the thread can safely skip the current sample and continue with the original 
+        // function
+        const ZyanUPointer pop = (ZyanUPointer)&trampoline->code->sampling_stub + 
+            ZYREX_TRAMPOLINE_SAMPLING_STUB_POP_OFFSET;
+        if (current_ip < pop)
+        {
+            new_ip = (ZyanUPointer)operation->address;
+            break;
+        }
+        // Threads that already pushed the sampling interval have decided to take the sample. The 
+        // pending `pop` is completed in the saved context, before the thread continues with the 
+        // callback
+        if (current_ip == pop)
+        {
+            operation->trampoline->sampling_counter = *(const ZyanIPointer*)*stack_pointer;
+            *stack_pointer += sizeof(ZyanUPointer);
+        }
+        new_ip = trampoline->callback_address;
+        break;
+    }
+    default:
+        ZYAN_UNREACHABLE;
+    }
+
+    *instruction_pointer = new_ip;
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/**
+ * @brief   Translates the instruction pointer of the given suspended thread, if it is located 
+ *          inside one of the `ranges`.
+ *
+ * @param   entry           A pointer to the `ZyrexThreadEntry` of the suspended thread.
+ * @param   ranges          A pointer to the `ZyanVector` that contains the sorted 
+ *                          `ZyrexMigrationRange` items.
+ * @param   debug_registers The context hook addresses to write to the debug registers of the 
+ *                          thread or `ZYAN_NULL`, if the debug registers should not be changed.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer was updated, `ZYAN_STATUS_FALSE`, if
+ *          not or an other zyan status code, if an error occured.
+ *
+ * The thread context is read exactly once and only written back, if the instruction pointer was 
+ * updated or the debug registers have to be changed.
+ */
+static ZyanStatus ZyrexMigrateThreadInRanges(const ZyrexThreadEntry* entry, 
+    const ZyanVector* ranges, const ZyanUPointer* debug_registers)
+{
+    ZYAN_ASSERT(entry);
+    ZYAN_ASSERT(ranges);
+
+#if   defined(ZYAN_WINDOWS)
+
+    CONTEXT context;
+    ZYAN_MEMSET(&context, 0, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL;
+    if (debug_registers)
+    {
+        context.ContextFlags |= CONTEXT_DEBUG_REGISTERS;
+    }
+    if (!GetThreadContext(entry->handle, &context))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+#   if defined(ZYAN_X64)
+    ZyanUPointer instruction_pointer = context.Rip;
+    ZyanUPointer stack_pointer = context.Rsp;
+#   elif defined(ZYAN_X86)
+    ZyanUPointer instruction_pointer = context.Eip;
+    ZyanUPointer stack_pointer = context.Esp;
+#   else
+#       error "Unsupported architecture detected"
+#   endif
+
+    const ZyanStatus status = 
+        ZyrexMigrateInstructionPointerInRanges(&instruction_pointer, &stack_pointer, ranges);
+    if (!ZYAN_SUCCESS(status) || ((status != ZYAN_STATUS_TRUE) && !debug_registers))
+    {
+        return status;
+    }
+
+#   if defined(ZYAN_X64)
+    context.Rip = instruction_pointer;
+    context.Rsp = stack_pointer;
+#   elif defined(ZYAN_X86)
+    context.Eip = (DWORD)instruction_pointer;
+    context.Esp = (DWORD)stack_pointer;
+#   endif
+
+    if (debug_registers)
+    {
+        ZyrexDebugRegistersWrite(&context, debug_registers);
+    }
+
+    return SetThreadContext(entry->handle, &context) 
+        ? status 
+        : ZYAN_STATUS_BAD_SYSTEMCALL;
+
+#elif defined(ZYAN_POSIX)
+
+    ZYAN_ASSERT(entry->state && entry->state->context);
+
+    // Context hooks are not supported on this platform
+    ZYAN_ASSERT(!debug_registers);
+    ZYAN_UNUSED(debug_registers);
+
+    // The modified context is restored by the kernel, when the signal handler returns
+#   if defined(ZYAN_X64)
+    greg_t* const ip = &entry->state->context->uc_mcontext.gregs[REG_RIP];
+    greg_t* const sp = &entry->state->context->uc_mcontext.gregs[REG_RSP];
+#   elif defined(ZYAN_X86)
+    greg_t* const ip = &entry->state->context->uc_mcontext.gregs[REG_EIP];
+    greg_t* const sp = &entry->state->context->uc_mcontext.gregs[REG_ESP];
+#   else
+#       error "Unsupported architecture detected"
+#   endif
+
+    ZyanUPointer instruction_pointer = (ZyanUPointer)*ip;
+    ZyanUPointer stack_pointer = (ZyanUPointer)*sp;
+    const ZyanStatus status = 
+        ZyrexMigrateInstructionPointerInRanges(&instruction_pointer, &stack_pointer, ranges);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        *ip = (greg_t)instruction_pointer;
+        *sp = (greg_t)stack_pointer;
+    }
+
+    return status;
+
+#endif
+}
+
+/**
+ * @brief   Migrates and resumes all threads in the thread-update list of the given transaction.
+ *
+ * @param   transaction     A pointer to the `ZyrexTransaction` struct.
+ * @param   ranges          A pointer to the `ZyanVector` that contains the sorted 
+ *                          `ZyrexMigrationRange` items.
+ * @param   debug_registers The context hook addresses to write to the debug registers of all 
+ *                          threads or `ZYAN_NULL`, if the debug registers should not be changed.
+ *
+ * The context of every thread is read exactly once. Only threads with an instruction pointer
+ * inside one of the `ranges` have their context written back, unless the debug registers have to
+ * be changed. Every thread is resumed right after it was processed.
+ */
+static void ZyrexMigrateAndResumeThreads(ZyrexTransaction* transaction, const ZyanVector* ranges,
+    const ZyanUPointer* debug_registers)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(ranges);
+
+    ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexThreadEntry, &transaction->threads_to_update, entry, 
+    {
+        if ((ranges->size > 0) || debug_registers)
+        {
+            ZYAN_UNUSED(ZyrexMigrateThreadInRanges(entry, ranges, debug_registers));
+        }
+        ZyrexThreadResume(entry);
+    });
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Code Patching                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexCodePatch` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareCodePatch, ZyrexCodePatch, address);
+
+/**
+ * @brief   Initializes the given `ZyrexCodePatch` struct for the given `operation`.
+ *
+ * @param   patch       A pointer to the `ZyrexCodePatch` struct.
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * The patch bytes are generated in a local buffer but are calculated relative to the runtime
+ * address of the `operation`.
+ *
+ * Exception hooks replace the first byte of the hooked function with an `INT 3` instruction.
+ * Pointer hooks replace the value of the hooked pointer slot.
+ */
+static void ZyrexCodePatchInit(ZyrexCodePatch* patch, const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(patch);
+    ZYAN_ASSERT(operation);
+    ZYAN_ASSERT(operation->type != ZYREX_HOOK_TYPE_CONTEXT);
+
+    patch->is_pointer = !operation->trampoline;
+    if (patch->is_pointer)
+    {
+        patch->address = (ZyanU8*)operation->address;
+        patch->size = sizeof(void*);
+        patch->offset = 0;
+        patch->is_removal = (operation->action == ZYREX_OPERATION_ACTION_REMOVE);
+        ZYAN_MEMCPY(patch->data, &operation->value, sizeof(void*));
+        return;
+    }
+
+    const ZyrexTrampolineChunk* const trampoline = operation->trampoline;
+    const ZyanU8 offset = trampoline->hot_patch_size;
+
+    patch->address = (ZyanU8*)operation->address - offset;
+    patch->offset = offset;
+    patch->is_removal = (operation->action == ZYREX_OPERATION_ACTION_REMOVE);
+
+    if (operation->type == ZYREX_HOOK_TYPE_EXCEPTION)
+    {
+        ZYAN_ASSERT(!offset);
+        patch->size = 1;
+        patch->data[0] = patch->is_removal ? 
+            trampoline->original_code[0] : ZYREX_EXCEPTION_HOOK_OPCODE;
+        return;
+    }
+
+    switch (operation->action)
+    {
+    case ZYREX_OPERATION_ACTION_ATTACH:
+    {
+        // On x86, trampolines without a private callback stub jump directly to the callback
+        const ZyanUPointer destination = trampoline->callback_jump ? 
+            (ZyanUPointer)trampoline->callback_jump : trampoline->callback_address;
+
+        patch->size = ZYREX_SIZEOF_RELATIVE_JUMP;
+        patch->data[0] = 0xE9;
+        *(ZyanI32*)&patch->data[1] = ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_RELATIVE_JUMP,
+            (ZyanUPointer)patch->address, destination);
+
+        // Hot-patch hooks redirect the function entry to the relative jump in the padding
+        if (offset)
+        {
+            ZYAN_ASSERT(offset == ZYREX_SIZEOF_RELATIVE_JUMP);
+            patch->size += ZYREX_SIZEOF_SHORT_JUMP;
+            patch->data[offset + 0] = 0xEB;
+            patch->data[offset + 1] = (ZyanU8)(ZyanI8)ZyrexCalculateRelativeOffset(
+                ZYREX_SIZEOF_SHORT_JUMP, (ZyanUPointer)operation->address, 
+                (ZyanUPointer)patch->address);
+        }
+        break;
+    }
+    case ZYREX_OPERATION_ACTION_REMOVE:
+        if (offset)
+        {
+            // Only the short jump at the function entry has to be restored
+            patch->size = offset + ZYREX_SIZEOF_SHORT_JUMP;
+            ZYAN_MEMCPY(patch->data, trampoline->hot_patch_code, offset);
+            ZYAN_MEMCPY(&patch->data[offset], trampoline->original_code, 
+                ZYREX_SIZEOF_SHORT_JUMP);
+            break;
+        }
+        patch->size = trampoline->original_code_size;
+        ZYAN_MEMCPY(patch->data, trampoline->original_code, trampoline->original_code_size);
+        break;
+    default:
+        ZYAN_UNREACHABLE;
+    }
+}
+
+/**
+ * @brief   Checks, if the target of the given `operation` is still unchanged.
+ *
+ * @param   operation   A pointer to the `ZyrexOperation` struct.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if the target is unchanged or `ZYREX_STATUS_TARGET_MODIFIED`, 
+ *          if not.
+ *
+ * The target code of inline and exception hooks has to match the original code saved in the 
+ * trampoline and the slot of pointer hooks has to contain the original pointer value. Only
+ * attach operations are checked, as all other targets contain code that was written by Zyrex 
+ * itself.
+ *
+ * The caller has to hold the commit lock.
+ */
+static ZyanStatus ZyrexCodePatchVerify(const ZyrexOperation* operation)
+{
+    ZYAN_ASSERT(operation);
+
+    if (operation->action != ZYREX_OPERATION_ACTION_ATTACH)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    if (!operation->trampoline)
+    {
+        return (*(void* volatile*)operation->address == operation->original) ? 
+            ZYAN_STATUS_SUCCESS : ZYREX_STATUS_TARGET_MODIFIED;
+    }
+
+    const ZyrexTrampolineChunk* const trampoline = operation->trampoline;
+    const ZyanU8* const address = (const ZyanU8*)operation->address;
+    if (ZYAN_MEMCMP(address, trampoline->original_code, trampoline->original_code_size) ||
+        (trampoline->hot_patch_size && ZYAN_MEMCMP(address - trampoline->hot_patch_size, 
+            trampoline->hot_patch_code, trampoline->hot_patch_size)))
+    {
+        return ZYREX_STATUS_TARGET_MODIFIED;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Writes the given `patch` to its target address.
+ *
+ * @param   patch   A pointer to the `ZyrexCodePatch` struct.
+ *
+ * The caller has to make sure the target memory is writable.
+ *
+ * Hot-patch jumps are written in two steps, to keep the function entry consistent for threads 
+ * that are not suspended by the transaction. When attaching, the relative jump is written to the 
+ * padding before the short jump gets published using a single store. When removing, the short 
+ * jump is reverted first.
+ *
+ * Pointer slots are always replaced using a single aligned store.
+ */
+static void ZyrexCodePatchWrite(const ZyrexCodePatch* patch)
+{
+    ZYAN_ASSERT(patch);
+
+    if (patch->is_pointer)
+    {
+        void* value;
+        ZYAN_MEMCPY(&value, patch->data, sizeof(value));
+        *(void* volatile*)patch->address = value;
+        return;
+    }
+
+    if (!patch->offset)
+    {
+        ZYAN_MEMCPY(patch->address, patch->data, patch->size);
+        return;
+    }
+
+    ZYAN_ASSERT(patch->size == patch->offset + ZYREX_SIZEOF_SHORT_JUMP);
+
+    ZyanU16 entry;
+    ZYAN_MEMCPY(&entry, &patch->data[patch->offset], sizeof(entry));
+
+    if (!patch->is_removal)
+    {
+        ZYAN_MEMCPY(patch->address, patch->data, patch->offset);
+    }
+    *(volatile ZyanU16*)(patch->address + patch->offset) = entry;
+    if (patch->is_removal)
+    {
+        ZYAN_MEMCPY(patch->address, patch->data, patch->offset);
+    }
+}
+
+/**
+ * @brief   Inserts the given `patch` into the sorted `patches` list.
+ *
+ * @param   patches A pointer to the `ZyanVector` that contains the `ZyrexCodePatch` items.
+ * @param   patch   A pointer to the `ZyrexCodePatch` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexCodePatchInsert(ZyanVector* patches, const ZyrexCodePatch* patch)
+{
+    ZYAN_ASSERT(patches);
+    ZYAN_ASSERT(patch);
+
+    ZyanUSize found_index;
+    const ZyanStatus status = ZyanVectorBinarySearch(patches, patch, &found_index,
+        (ZyanComparison)&ZyrexCompareCodePatch);
+    ZYAN_CHECK(status);
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        // Two operations targeting the same address in a single transaction
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // Hot-patch jumps extend in front of the hooked address and might overlap the patch of a
+    // neighboring function
+    if (found_index > 0)
+    {
+        const ZyrexCodePatch* const previous = ZyanVectorGet(patches, found_index - 1);
+        ZYAN_ASSERT(previous);
+        if (previous->address + previous->size > patch->address)
+        {
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
+    }
+    if (found_index < patches->size)
+    {
+        const ZyrexCodePatch* const next = ZyanVectorGet(patches, found_index);
+        ZYAN_ASSERT(next);
+        if (patch->address + patch->size > next->address)
+        {
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
+    }
+
+    return ZyanVectorInsert(patches, found_index, patch);
+}
+
+/**
+ * @brief   Makes the given code `page` writable.
+ *
+ * @param   page            A pointer to the `ZyrexCodePage` struct.
+ * @param   page_size       The system page size.
+ * @param   save_protection Set `ZYAN_TRUE` to save the current page protection to the 
+ *                          `old_protection` field of the `page`.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexCodePageUnprotect(ZyrexCodePage* page, ZyanUPointer page_size, 
+    ZyanBool save_protection)
+{
+    ZYAN_ASSERT(page);
+
+#if   defined(ZYAN_WINDOWS)
+    DWORD old_protection;
+    if (!VirtualProtect((LPVOID)page->address, page_size, PAGE_EXECUTE_READWRITE,
+        &old_protection))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    // `mprotect` does not return the previous protection, so we have to look it up in the cached
+    // memory map
+    int old_protection = 0;
+    if (save_protection)
+    {
+        const ZyrexMemoryRange* range;
+        const ZyanStatus status = ZyrexMemoryMapFind(page->address, &range);
+        if (status != ZYAN_STATUS_TRUE)
+        {
+            return ZYAN_SUCCESS(status) ? ZYAN_STATUS_BAD_SYSTEMCALL : status;
+        }
+        old_protection = (int)range->protection;
+    }
+    if (mprotect((void*)page->address, page_size, PROT_READ | PROT_WRITE | PROT_EXEC) != 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    if (save_protection)
+    {
+        page->old_protection = old_protection;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Restores the original protection of the given code `page`.
+ *
+ * @param   page        A pointer to the `ZyrexCodePage` struct.
+ * @param   page_size   The system page size.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexCodePageRestore(const ZyrexCodePage* page, ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(page);
+
+#if   defined(ZYAN_WINDOWS)
+    DWORD old_protection;
+    if (!VirtualProtect((LPVOID)page->address, page_size, page->old_protection, 
+        &old_protection))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#elif defined(ZYAN_POSIX)
+    if (mprotect((void*)page->address, page_size, page->old_protection) != 0)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Reports the first patch that touches the given `page` as the failed operation.
+ *
+ * @param   patches             A pointer to the `ZyanVector` that contains the sorted
+ *                              `ZyrexCodePatch` items.
+ * @param   page                A pointer to the `ZyrexCodePage` struct. 
+ * @param   failed_operation    Receives the hooked address of the patch. This argument is 
+ *                              optional and might be `ZYAN_NULL`.
+ */
+static void ZyrexCodePatchReportFailure(const ZyanVector* patches, const ZyrexCodePage* page,
+    const void** failed_operation)
+{
+    ZYAN_ASSERT(patches);
+    ZYAN_ASSERT(page);
+
+    if (!failed_operation)
+    {
+        return;
+    }
+
+    for (ZyanUSize i = 0; i < patches->size; ++i)
+    {
+        const ZyrexCodePatch* const patch = ZyanVectorGet(patches, i);
+        ZYAN_ASSERT(patch);
+
+        if ((ZyanUPointer)patch->address + patch->size > page->address)
+        {
+            *failed_operation = patch->address + patch->offset;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief   Flushes the instruction cache for all pages in the given list.
+ *
+ * @param   pages       A pointer to the `ZyanVector` that contains the sorted `ZyrexCodePage`
+ *                      items.
+ * @param   page_size   The system page size.
+ *
+ * @return  A zyan status code.
+ *
+ * The instruction cache is flushed once for every run of contiguous pages.
+ */
+static ZyanStatus ZyrexCodePagesFlush(const ZyanVector* pages, ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(pages);
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < pages->size; )
+    {
+        const ZyrexCodePage* const first = ZyanVectorGet(pages, i);
+        ZYAN_ASSERT(first);
+
+        ZyanUSize count = 1;
+        while (i + count < pages->size)
+        {
+            const ZyrexCodePage* const next = ZyanVectorGet(pages, i + count);
+            ZYAN_ASSERT(next);
+            if (next->address != first->address + count * page_size)
+            {
+                break;
+            }
+            ++count;
+        }
+
+        const ZyanStatus status_flush = 
+            ZyanProcessFlushInstructionCache((void*)first->address, count * page_size);
+        if (!ZYAN_SUCCESS(status_flush))
+        {
+            status = status_flush;
+        }
+
+        i += count;
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Replays the undo log of all patches in the given list.
+ *
+ * @param   patches     A pointer to the `ZyanVector` that contains the sorted `ZyrexCodePatch` 
+ *                      items.
+ * @param   pages       A pointer to the `ZyanVector` that contains the sorted `ZyrexCodePage`
+ *                      items of all patches.
+ * @param   page_size   The system page size.
+ *
+ * @return  A zyan status code.
+ *
+ * The pages are unprotected and restored using the same batched page operations as in 
+ * `ZyrexCodePatchApplyAll`. The original protection of every page was saved before and is not
+ * touched by this function.
+ *
+ * Failing to unprotect one of the pages leaves all target code unchanged.
+ */
+static ZyanStatus ZyrexCodePatchRevertAll(const ZyanVector* patches, ZyanVector* pages, 
+    ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(patches);
+    ZYAN_ASSERT(pages);
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    ZyanUSize unprotected_count = 0;
+    for (; unprotected_count < pages->size; ++unprotected_count)
+    {
+        ZyrexCodePage* const page = ZyanVectorGetMutable(pages, unprotected_count);
+        ZYAN_ASSERT(page);
+
+        status = ZyrexCodePageUnprotect(page, page_size, ZYAN_FALSE);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+    }
+
+    if (ZYAN_SUCCESS(status))
+    {
+        // Reverting an attach patch follows the write order of a removal and vice versa
+        for (ZyanUSize i = patches->size; i > 0; --i)
+        {
+            const ZyrexCodePatch* const patch = ZyanVectorGet(patches, i - 1);
+            ZYAN_ASSERT(patch);
+
+            ZyrexCodePatch undo = *patch;
+            undo.is_removal = !patch->is_removal;
+            ZYAN_MEMCPY(undo.data, patch->original, patch->size);
+            ZyrexCodePatchWrite(&undo);
+        }
+    }
+
+    for (ZyanUSize i = 0; i < unprotected_count; ++i)
+    {
+        const ZyrexCodePage* const page = ZyanVectorGet(pages, i);
+        ZYAN_ASSERT(page);
+
+        // A page that stays writable does not affect the consistency of the code
+        ZYAN_UNUSED(ZyrexCodePageRestore(page, page_size));
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Writes all code patches in the given list to their target addresses.
+ *
+ * @param   patches             A pointer to the `ZyanVector` that contains the sorted
+ *                              `ZyrexCodePatch` items.
+ * @param   failed_operation    Receives the address of the patch that could not be applied, if
+ *                              the function fails.
+ *
+ * @return  A zyan status code.
+ *
+ * Every affected page is unprotected exactly once, before any patch is written, and its original
+ * protection is restored after all patches are applied. The instruction cache is flushed once for
+ * every run of contiguous pages.
+ *
+ * Failing to unprotect one of the pages leaves all target code unchanged. If restoring the page
+ * protection or flushing the instruction cache fails after the patches have been written, the 
+ * original code is restored from the undo log that is recorded right before the first patch is 
+ * written. `ZYREX_STATUS_PARTIALLY_APPLIED` is returned, if the original code could not be 
+ * restored.
+ *
+ * All memory is allocated before the first page is touched.
+ */
+static ZyanStatus ZyrexCodePatchApplyAll(ZyanVector* patches, const void** failed_operation)
+{
+    ZYAN_ASSERT(patches);
+
+    if (patches->size == 0)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    const ZyanUPointer page_size = ZyanMemoryGetSystemPageSize();
+
+    ZyanVector pages;
+    ZYAN_CHECK(ZyanVectorInit(&pages, sizeof(ZyrexCodePage), patches->size, ZYAN_NULL));
+
+    // Collect all distinct pages. As the patches are sorted by address, the resulting page list is
+    // sorted as well
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; (i < patches->size) && ZYAN_SUCCESS(status); ++i)
+    {
+        const ZyrexCodePatch* const patch = ZyanVectorGet(patches, i);
+        ZYAN_ASSERT(patch);
+
+        const ZyanUPointer first = ZYAN_ALIGN_DOWN((ZyanUPointer)patch->address, page_size);
+        const ZyanUPointer last  = 
+            ZYAN_ALIGN_DOWN((ZyanUPointer)patch->address + patch->size - 1, page_size);
+
+        for (ZyanUPointer address = first; address <= last; address += page_size)
+        {
+            if (pages.size > 0)
+            {
+                const ZyrexCodePage* const previous = ZyanVectorGet(&pages, pages.size - 1);
+                ZYAN_ASSERT(previous);
+                if (previous->address >= address)
+                {
+                    continue;
+                }
+            }
+
+            const ZyrexCodePage page = { address, 0 };
+            status = ZyanVectorPushBack(&pages, &page);
+            if (!ZYAN_SUCCESS(status))
+            {
+                break;
+            }
+        }
+    }
+
+    ZyanUSize unprotected_count = 0;
+    if (ZYAN_SUCCESS(status))
+    {
+        for (; unprotected_count < pages.size; ++unprotected_count)
+        {
+            ZyrexCodePage* const page = ZyanVectorGetMutable(&pages, unprotected_count);
+            ZYAN_ASSERT(page);
+
+            status = ZyrexCodePageUnprotect(page, page_size, ZYAN_TRUE);
+            if (!ZYAN_SUCCESS(status))
+            {
+                ZyrexCodePatchReportFailure(patches, page, failed_operation);
+                break;
+            }
+        }
+    }
+
+    const ZyanBool patched = ZYAN_SUCCESS(status);
+    if (patched)
+    {
+        for (ZyanUSize i = 0; i < patches->size; ++i)
+        {
+            ZyrexCodePatch* const patch = ZyanVectorGetMutable(patches, i);
+            ZYAN_ASSERT(patch);
+
+            // Record the undo log entry right before the patch is written
+            ZYAN_MEMCPY(patch->original, patch->address, patch->size);
+            ZyrexCodePatchWrite(patch);
+        }
+    }
+
+    for (ZyanUSize i = 0; i < unprotected_count; ++i)
+    {
+        const ZyrexCodePage* const page = ZyanVectorGet(&pages, i);
+        ZYAN_ASSERT(page);
+
+        if (!ZYAN_SUCCESS(ZyrexCodePageRestore(page, page_size)) && ZYAN_SUCCESS(status))
+        {
+            status = ZYAN_STATUS_BAD_SYSTEMCALL;
+            ZyrexCodePatchReportFailure(patches, page, failed_operation);
+        }
+    }
+
+    if (patched)
+    {
+        if (ZYAN_SUCCESS(status))
+        {
+            status = ZyrexCodePagesFlush(&pages, page_size);
+            if (!ZYAN_SUCCESS(status) && failed_operation)
+            {
+                const ZyrexCodePatch* const patch = ZyanVectorGet(patches, 0);
+                ZYAN_ASSERT(patch);
+                *failed_operation = patch->address + patch->offset;
+            }
+        }
+        if (!ZYAN_SUCCESS(status))
+        {
+            if (!ZYAN_SUCCESS(ZyrexCodePatchRevertAll(patches, &pages, page_size)))
+            {
+                status = ZYREX_STATUS_PARTIALLY_APPLIED;
+            }
+            ZYAN_UNUSED(ZyrexCodePagesFlush(&pages, page_size));
+        }
+    }
+
+    ZyanVectorDestroy(&pages);
+
+    return status;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Exception hooks                                                                                */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexExceptionHook` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareExceptionHook, ZyrexExceptionHook, address);
+
+/**
+ * @brief   Searches the list of installed exception and context hooks for the given `address`.
+ *
+ * @param   address The address of the hooked function.
+ *
+ * @return  A pointer to the `ZyrexExceptionHook` of the given `address` or `ZYAN_NULL`, if not 
+ *          found.
+ *
+ * The caller has to hold the region lock.
+ */
+static const ZyrexExceptionHook* ZyrexExceptionHookFind(ZyanUPointer address)
+{
+    if (!g_exception_hooks.data)
+    {
+        return ZYAN_NULL;
+    }
+
+    const ZyrexExceptionHook hook = { ZYREX_HOOK_TYPE_EXCEPTION, address, 0 };
+
+    ZyanUSize found_index;
+    if (ZyanVectorBinarySearch(&g_exception_hooks, &hook, &found_index, 
+        (ZyanComparison)&ZyrexCompareExceptionHook) != ZYAN_STATUS_TRUE)
+    {
+        return ZYAN_NULL;
+    }
+
+    return ZyanVectorGet(&g_exception_hooks, found_index);
+}
+
+/**
+ * @brief   Returns the number of context hooks that are installed after committing the given 
+ *          transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * @return  The number of context hooks.
+ *
+ * The caller has to hold the region lock.
+ */
+static ZyanUSize ZyrexContextHookCount(const ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZyanUSize count = 0;
+    if (g_exception_hooks.data)
+    {
+        ZYAN_VECTOR_FOREACH(ZyrexExceptionHook, &g_exception_hooks, hook,
+        {
+            count += (hook.type == ZYREX_HOOK_TYPE_CONTEXT);
+        });
+    }
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        if (operation.type != ZYREX_HOOK_TYPE_CONTEXT)
+        {
+            continue;
+        }
+        if (operation.action == ZYREX_OPERATION_ACTION_ATTACH)
+        {
+            ++count;
+        } else
+        {
+            --count;
+        }
+    });
+
+    return count;
+}
+
+/**
+ * @brief   Collects the exception and context hooks that are active while or after committing
+ *          the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   is_final    Pass `ZYAN_FALSE` to collect the hooks that are active while the code is
+ *                      patched (all installed hooks and pending installations) or `ZYAN_TRUE` to
+ *                      collect the hooks that are active after the commit.
+ * @param   hooks       A pointer to an initialized `ZyanVector` that receives the sorted
+ *                      `ZyrexExceptionHook` items.
+ *
+ * @return  A zyan status code.
+ *
+ * Context hooks removed by the transaction are kept in the final list with a `callback` of `0`. 
+ * This allows the exception dispatcher to resume threads that still have the breakpoint set in
+ * one of their debug registers.
+ *
+ * The caller has to hold the region lock.
+ */
+static ZyanStatus ZyrexExceptionHooksCollect(const ZyrexTransaction* transaction, 
+    ZyanBool is_final, ZyanVector* hooks)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(hooks);
+
+    if (g_exception_hooks.data)
+    {
+        for (ZyanUSize i = 0; i < g_exception_hooks.size; ++i)
+        {
+            ZYAN_CHECK(ZyanVectorPushBack(hooks, ZyanVectorGet(&g_exception_hooks, i)));
+        }
+    }
+
+    for (ZyanUSize i = 0; i < transaction->pending_operations.size; ++i)
+    {
+        const ZyrexOperation* item = ZyanVectorGet(&transaction->pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        if ((item->type != ZYREX_HOOK_TYPE_EXCEPTION) && (item->type != ZYREX_HOOK_TYPE_CONTEXT))
+        {
+            continue;
+        }
+
+        const ZyrexExceptionHook hook = 
+        { 
+            item->type, (ZyanUPointer)item->address, item->trampoline->callback_address
+        };
+
+        ZyanUSize found_index;
+        const ZyanStatus status = ZyanVectorBinarySearch(hooks, &hook, &found_index, 
+            (ZyanComparison)&ZyrexCompareExceptionHook);
+        ZYAN_CHECK(status);
+
+        ZyrexExceptionHook* const existing = 
+            (status == ZYAN_STATUS_TRUE) ? ZyanVectorGetMutable(hooks, found_index) : ZYAN_NULL;
+
+        switch (item->action)
+        {
+        case ZYREX_OPERATION_ACTION_ATTACH:
+            if (!existing)
+            {
+                ZYAN_CHECK(ZyanVectorInsert(hooks, found_index, &hook));
+                break;
+            }
+            if (existing->callback)
+            {
+                return ZYAN_STATUS_INVALID_OPERATION;
+            }
+            *existing = hook;
+            break;
+        case ZYREX_OPERATION_ACTION_REMOVE:
+            if (!is_final || !existing)
+            {
+                break;
+            }
+            if (existing->type == ZYREX_HOOK_TYPE_CONTEXT)
+            {
+                existing->callback = 0;
+                break;
+            }
+            ZYAN_CHECK(ZyanVectorDelete(hooks, found_index));
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Prepares the exception dispatcher for the commit phase of the given transaction.
+ *
+ * @param   transaction     A pointer to the `ZyrexTransaction` struct.
+ * @param   hooks           Receives the `ZyrexExceptionHook` items that are active after the
+ *                          commit. The vector is initialized by this function.
+ * @param   table           Receives the hash table of the final `hooks`.
+ * @param   debug_registers Receives the context hook addresses to assign to the debug registers.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the transaction contains exception or context hooks, 
+ *          `ZYAN_STATUS_FALSE`, if not, or another zyan status code, if an error occured.
+ *
+ * All memory required by the exception dispatcher is allocated up-front, so that no failure is
+ * possible after the code has been patched. On success, a hash table containing the hooks that 
+ * are active while the code is patched is published immediately.
+ *
+ * The caller has to hold the transaction locks.
+ */
+static ZyanStatus ZyrexExceptionHooksPrepare(const ZyrexTransaction* transaction, 
+    ZyanVector* hooks, ZyrexExceptionHookTable** table, 
+    ZyanUPointer debug_registers[ZYREX_CONTEXT_HOOK_MAX_COUNT])
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(hooks);
+    ZYAN_ASSERT(table);
+    ZYAN_ASSERT(debug_registers);
+
+    ZyanBool has_hooks = ZYAN_FALSE;
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        has_hooks |= (operation.type == ZYREX_HOOK_TYPE_EXCEPTION) || 
+            (operation.type == ZYREX_HOOK_TYPE_CONTEXT);
+    });
+    if (!has_hooks)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyanUSize capacity = (g_exception_hooks.data ? g_exception_hooks.size : 0) + 
+        transaction->pending_operations.size;
+
+    ZyanVector active;
+    ZYAN_CHECK(ZyanVectorInit(&active, sizeof(ZyrexExceptionHook), capacity, ZYAN_NULL));
+    ZyanStatus status = ZyanVectorInit(hooks, sizeof(ZyrexExceptionHook), capacity, ZYAN_NULL);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&active);
+        return status;
+    }
+
+    status = ZyrexExceptionHooksCollect(transaction, ZYAN_FALSE, &active);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexExceptionHooksCollect(transaction, ZYAN_TRUE, hooks);
+    }
+
+    // Assign the debug registers in address order
+    ZYAN_MEMSET(debug_registers, 0, ZYREX_CONTEXT_HOOK_MAX_COUNT * sizeof(ZyanUPointer));
+    ZyanUSize context_hooks = 0;
+    for (ZyanUSize i = 0; ZYAN_SUCCESS(status) && (i < hooks->size); ++i)
+    {
+        const ZyrexExceptionHook* const hook = ZyanVectorGet(hooks, i);
+        ZYAN_ASSERT(hook);
+
+        if ((hook->type != ZYREX_HOOK_TYPE_CONTEXT) || !hook->callback)
+        {
+            continue;
+        }
+        if (context_hooks == ZYREX_CONTEXT_HOOK_MAX_COUNT)
+        {
+            status = ZYAN_STATUS_OUT_OF_RESOURCES;
+            break;
+        }
+        debug_registers[context_hooks++] = hook->address;
+    }
+
+    ZyrexExceptionHookTable* active_table = ZYAN_NULL;
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexExceptionHookTableCreate(active.data, active.size, &active_table);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexExceptionHookTableCreate(hooks->data, hooks->size, table);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexExceptionHookTableDestroy(active_table);
+        }
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexExceptionDispatcherInstall();
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexExceptionHookTableDestroy(*table);
+            ZyrexExceptionHookTableDestroy(active_table);
+        }
+    }
+    ZyanVectorDestroy(&active);
+
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(hooks);
+        return status;
+    }
+
+    ZyrexExceptionDispatcherPublish(active_table);
+
+    return ZYAN_STATUS_TRUE;
+}
+
+/**
+ * @brief   Publishes the final exception and context hooks prepared by 
+ *          `ZyrexExceptionHooksPrepare` and updates the list of installed hooks.
+ *
+ * @param   hooks   A pointer to the `ZyanVector` that contains the final `ZyrexExceptionHook`
+ *                  items. The vector is moved into the list of installed hooks.
+ * @param   table   The hash table of the final `hooks`.
+ *
+ * The caller has to hold the transaction locks.
+ */
+static void ZyrexExceptionHooksPublish(ZyanVector* hooks, ZyrexExceptionHookTable* table)
+{
+    ZYAN_ASSERT(hooks);
+    ZYAN_ASSERT(table);
+
+    ZyrexExceptionDispatcherPublish(table);
+
+    // The removed context hooks are only required by the dispatcher
+    for (ZyanUSize i = hooks->size; i > 0; --i)
+    {
+        const ZyrexExceptionHook* const hook = ZyanVectorGet(hooks, i - 1);
+        ZYAN_ASSERT(hook);
+
+        if (!hook->callback)
+        {
+            ZYAN_UNUSED(ZyanVectorDelete(hooks, i - 1));
+        }
+    }
+
+    if (g_exception_hooks.data)
+    {
+        ZyanVectorDestroy(&g_exception_hooks);
+    }
+    g_exception_hooks = *hooks;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Pointer hooks                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexPointerHook` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexComparePointerHook, ZyrexPointerHook, slot);
+
+/**
+ * @brief   Searches the list of installed pointer hooks for the given `slot`.
+ *
+ * @param   slot    The address of the pointer slot.
+ * @param   index   Receives the index of the matching hook or the index at which a hook for the
+ *                  given `slot` would be inserted.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if a hook was found, `ZYAN_STATUS_FALSE`, if not, or another zyan
+ *          status code, if an error occured.
+ *
+ * The caller has to hold the region lock.
+ */
+static ZyanStatus ZyrexPointerHookFind(void** slot, ZyanUSize* index)
+{
+    ZYAN_ASSERT(index);
+
+    if (!g_pointer_hooks.data)
+    {
+        *index = 0;
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyrexPointerHook hook = { ZYREX_HOOK_TYPE_VTABLE, slot, ZYAN_NULL };
+
+    return ZyanVectorBinarySearch(&g_pointer_hooks, &hook, index, 
+        (ZyanComparison)&ZyrexComparePointerHook);
+}
+
+/**
+ * @brief   Reserves memory for all pointer hooks installed by the given transaction.
+ *
+ * @param   transaction         A pointer to the `ZyrexTransaction` struct.
+ * @param   failed_operation    Receives the slot address of a pointer hook that is already 
+ *                              installed, if the function fails.
+ *
+ * @return  A zyan status code.
+ *
+ * Hooking a slot that is already hooked fails with `ZYAN_STATUS_INVALID_OPERATION`. This 
+ * guarantees that `ZyrexPointerHooksUpdate` does not fail after the slots have been replaced. The
+ * caller has to hold the transaction locks.
+ */
+static ZyanStatus ZyrexPointerHooksReserve(const ZyrexTransaction* transaction, 
+    const void** failed_operation)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZyanUSize count = 0;
+    for (ZyanUSize i = 0; i < transaction->pending_operations.size; ++i)
+    {
+        const ZyrexOperation* const operation = 
+            ZyanVectorGet(&transaction->pending_operations, i);
+        ZYAN_ASSERT(operation);
+
+        if (operation->trampoline || (operation->action != ZYREX_OPERATION_ACTION_ATTACH))
+        {
+            continue;
+        }
+
+        // Another transaction might have hooked the same slot since the operation was added
+        ZyanUSize index;
+        const ZyanStatus status = ZyrexPointerHookFind((void**)operation->address, &index);
+        ZYAN_CHECK(status);
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            if (failed_operation)
+            {
+                *failed_operation = operation->address;
+            }
+            return ZYAN_STATUS_INVALID_OPERATION;
+        }
+
+        ++count;
+    }
+    if (!count)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    if (!g_pointer_hooks.data)
+    {
+        ZYAN_CHECK(ZyanVectorInit(&g_pointer_hooks, sizeof(ZyrexPointerHook), count, ZYAN_NULL));
+    }
+
+    return ZyanVectorReserve(&g_pointer_hooks, g_pointer_hooks.size + count);
+}
+
+/**
+ * @brief   Updates the list of installed pointer hooks after the given transaction was applied.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * The caller has to hold the transaction locks.
+ */
+static void ZyrexPointerHooksUpdate(const ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        if (operation.trampoline)
+        {
+            continue;
+        }
+
+        ZyanUSize index;
+        const ZyanStatus status = ZyrexPointerHookFind((void**)operation.address, &index);
+        switch (operation.action)
+        {
+        case ZYREX_OPERATION_ACTION_ATTACH:
+        {
+            // Duplicate hooks are rejected by `ZyrexPointerHooksReserve`
+            if (status != ZYAN_STATUS_FALSE)
+            {
+                break;
+            }
+            ZyrexPointerHook hook;
+            hook.type = operation.type;
+            hook.slot = (void**)operation.address;
+            hook.original = operation.original;
+            ZYAN_UNUSED(ZyanVectorInsert(&g_pointer_hooks, index, &hook));
+            break;
+        }
+        case ZYREX_OPERATION_ACTION_REMOVE:
+            if (status == ZYAN_STATUS_TRUE)
+            {
+                ZYAN_UNUSED(ZyanVectorDelete(&g_pointer_hooks, index));
+            }
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+    });
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook installation                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines a comparison function for pointers to `ZyrexInlineHookEntry` items that
+ *          compares the target addresses.
+ *
+ * @param   left    A pointer to the first entry pointer.
+ * @param   right   A pointer to the second entry pointer.
+ *
+ * @return  Returns `0` if the target addresses are equal, a negative value if the address of the
+ *          `left` entry is less than the address of the `right` entry, or a positive value if it is
+ *          greater.
+ */
+static ZyanI32 ZyrexCompareInlineHookEntry(const ZyrexInlineHookEntry* const* left, 
+    const ZyrexInlineHookEntry* const* right)
+{
+    ZYAN_ASSERT(left && *left);
+    ZYAN_ASSERT(right && *right);
+
+    if ((ZyanUPointer)(*left)->address < (ZyanUPointer)(*right)->address)
+    {
+        return -1;
+    }
+    if ((ZyanUPointer)(*left)->address > (ZyanUPointer)(*right)->address)
+    {
+        return 1;
+    }
+    return 0;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Remote hooks                                                                                   */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Marks all given remote inline hook entries as failed.
+ *
+ * @param   entries The remote inline hook entries.
+ * @param   count   The number of entries.
+ * @param   status  The status code to store in every entry.
+ *
+ * @return  The given `status` code.
+ */
+static ZyanStatus ZyrexRemoteHookEntriesFail(ZyrexRemoteInlineHookEntry* entries, ZyanUSize count,
+    ZyanStatus status)
+{
+    ZYAN_ASSERT(entries);
+    ZYAN_ASSERT(!ZYAN_SUCCESS(status));
+
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        entries[i].trampoline = 0;
+        entries[i].status = status;
+    }
+
+    return status;
+}
+
+#ifdef ZYAN_WINDOWS
+
+/**
+ * @brief   Defines a comparison function for the `ZyrexRemoteHook` struct.
+ */
+static ZYAN_DECLARE_COMPARISON_FOR_FIELD(ZyrexCompareRemoteHook, ZyrexRemoteHook, address);
+
+/**
+ * @brief   Writes an absolute indirect jump instruction to the given `buffer`.
+ *
+ * @param   buffer      A pointer to the buffer that receives the instruction.
+ * @param   address     The runtime address of the jump.
+ * @param   destination The runtime address of the memory that contains the absolute destination
+ *                      for the jump.
+ *
+ * In contrast to `ZyrexWriteAbsoluteJump`, the `buffer` does not have to be located at the 
+ * runtime address of the jump.
+ */
+static void ZyrexRemoteWriteAbsoluteJump(ZyanU8* buffer, ZyanUPointer address, 
+    ZyanUPointer destination)
+{
+    ZYAN_ASSERT(buffer);
+
+    buffer[0] = 0xFF;
+    buffer[1] = 0x25;
+#if defined(ZYAN_X64)
+    const ZyanI32 value = 
+        ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_ABSOLUTE_JUMP, address, destination);
+#else
+    ZYAN_UNUSED(address);
+    const ZyanU32 value = (ZyanU32)destination;
+#endif
+    ZYAN_MEMCPY(&buffer[2], &value, sizeof(value));
+}
+
+/**
+ * @brief   Reads and relocates the original code of the given remote `hook`.
+ *
+ * @param   process     The handle of the target process.
+ * @param   hook        A pointer to the `ZyrexRemoteHook` struct.
+ * @param   page_size   The system page size.
+ *
+ * @return  A zyan status code.
+ *
+ * The code is relocated to the local `code` buffer of the `hook`. All relative offsets that refer
+ * to addresses outside of the relocated code are recorded as fixups and get resolved, as soon as 
+ * the remote address of the trampoline is known.
+ */
+static ZyanStatus ZyrexRemoteHookPrepare(HANDLE process, ZyrexRemoteHook* hook, 
+    ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(hook);
+    ZYAN_ASSERT(hook->entry);
+
+    // The hooked code might be located at the end of a readable memory region
+    SIZE_T size = sizeof(hook->source);
+    if (!ReadProcessMemory(process, (LPCVOID)hook->address, hook->source, size, ZYAN_NULL))
+    {
+        size = ZYAN_ALIGN_UP(hook->address + 1, page_size) - hook->address;
+        if ((size >= sizeof(hook->source)) || 
+            !ReadProcessMemory(process, (LPCVOID)hook->address, hook->source, size, ZYAN_NULL))
+        {
+            return ZYAN_STATUS_BAD_SYSTEMCALL;
+        }
+    }
+
+    ZYAN_MEMSET(&hook->chunk, 0, sizeof(hook->chunk));
+    ZYAN_MEMSET(&hook->code, 0xCC, sizeof(hook->code));
+    hook->chunk.code = &hook->code;
+
+    ZyanUSize bytes_read;
+    ZyanUSize bytes_written;
+    ZYAN_CHECK(ZyrexRelocateCode(hook->source, size, &hook->chunk, ZYREX_SIZEOF_RELATIVE_JUMP, 
+        &bytes_read, &bytes_written, &hook->fixups));
+    hook->chunk.original_code_size = (ZyanU8)bytes_read;
+    hook->chunk.code_buffer_size = (ZyanU8)bytes_written;
+    hook->chunk.backjump_address = hook->address + bytes_read;
+    hook->chunk.callback_address = hook->entry->callback;
+
+    hook->address_lo = hook->address;
+    hook->address_hi = hook->address;
+
+#ifdef ZYAN_X64
+
+    // Gather the range of all addresses the trampoline has to reach using relative offsets
+    for (ZyanU8 i = 0; i < hook->fixups.count; ++i)
+    {
+        const ZyanUPointer target = 
+            (ZyanUPointer)((ZyanI64)hook->address + hook->fixups.items[i].target);
+        hook->address_lo = ZYAN_MIN(hook->address_lo, target);
+        hook->address_hi = ZYAN_MAX(hook->address_hi, target);
+    }
+
+    if ((hook->address_hi - hook->address_lo) > ZYREX_RANGEOF_RELATIVE_JUMP)
+    {
+        return ZYAN_STATUS_OUT_OF_RANGE;
+    }
+
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Writes the trampoline of the given remote `hook` to the given `buffer`.
+ *
+ * @param   hook    A pointer to the `ZyrexRemoteHook` struct.
+ * @param   buffer  A pointer to the local copy of the trampoline slot.
+ *
+ * @return  A zyan status code.
+ *
+ * The `buffer` is left untouched, if any of the relative values of the relocated code does not
+ * reach its target from the remote address of the slot.
+ */
+static ZyanStatus ZyrexRemoteHookWriteSlot(const ZyrexRemoteHook* hook, ZyanU8* buffer)
+{
+    ZYAN_ASSERT(hook);
+    ZYAN_ASSERT(buffer);
+
+    const ZyanU8 size = hook->chunk.code_buffer_size;
+
+    ZyanU8 code[sizeof(hook->code.code_buffer)];
+    ZYAN_MEMCPY(code, hook->code.code_buffer, size);
+    ZYAN_CHECK(ZyrexRelocationApplyFixupsEx(hook->address, hook->slot, code, &hook->fixups));
+    ZYAN_MEMCPY(buffer, code, size);
+
+    ZyrexRemoteWriteAbsoluteJump(&buffer[size], hook->slot + size, 
+        hook->slot + ZYREX_REMOTE_SLOT_BACKJUMP_ADDRESS);
+    ZyrexRemoteWriteAbsoluteJump(&buffer[ZYREX_REMOTE_SLOT_CALLBACK_JUMP], 
+        hook->slot + ZYREX_REMOTE_SLOT_CALLBACK_JUMP, 
+        hook->slot + ZYREX_REMOTE_SLOT_CALLBACK_ADDRESS);
+
+    ZYAN_MEMCPY(&buffer[ZYREX_REMOTE_SLOT_BACKJUMP_ADDRESS], &hook->chunk.backjump_address, 
+        sizeof(ZyanUPointer));
+    ZYAN_MEMCPY(&buffer[ZYREX_REMOTE_SLOT_CALLBACK_ADDRESS], &hook->chunk.callback_address, 
+        sizeof(ZyanUPointer));
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Searches the address space of the given `process` for a free memory block close to 
+ *          the given `address`.
+ *
+ * @param   process     The handle of the target process.
+ * @param   address     The preferred address.
+ * @param   min_address The lowest acceptable start address.
+ * @param   max_address The highest acceptable start address.
+ * @param   size        The size of the memory block.
+ * @param   alignment   The alignment of the memory block.
+ * @param   result      Receives the start address of the free memory block.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if a free memory block was found or `ZYAN_STATUS_FALSE`, if not.
+ *
+ * The address space is walked in both directions, starting at the preferred `address`. The free
+ * block closest to the preferred `address` is returned.
+ */
+static ZyanStatus ZyrexRemoteRegionFindFree(HANDLE process, ZyanUPointer address, 
+    ZyanUPointer min_address, ZyanUPointer max_address, ZyanUSize size, ZyanUPointer alignment,
+    ZyanUPointer* result)
+{
+    ZYAN_ASSERT(result);
+
+    MEMORY_BASIC_INFORMATION info;
+
+    // Walk downwards
+    ZyanBool found_below = ZYAN_FALSE;
+    ZyanUPointer below = ZYAN_ALIGN_DOWN(address, alignment);
+    while ((below >= min_address) && 
+        VirtualQueryEx(process, (LPCVOID)below, &info, sizeof(info)))
+    {
+        const ZyanUPointer base = (ZyanUPointer)info.BaseAddress;
+        const ZyanUPointer end = base + info.RegionSize;
+        if ((info.State == MEM_FREE) && (end - base >= size))
+        {
+            const ZyanUPointer candidate = ZYAN_ALIGN_DOWN(ZYAN_MIN(below, end - size), alignment);
+            if ((candidate >= base) && (candidate >= min_address))
+            {
+                below = candidate;
+                found_below = ZYAN_TRUE;
+                break;
+            }
+        }
+        if (base < alignment)
+        {
+            break;
+        }
+        below = ZYAN_ALIGN_DOWN(base - 1, alignment);
+    }
+
+    // Walk upwards
+    ZyanBool found_above = ZYAN_FALSE;
+    ZyanUPointer above = ZYAN_ALIGN_UP(address, alignment);
+    while ((above <= max_address) && 
+        VirtualQueryEx(process, (LPCVOID)above, &info, sizeof(info)))
+    {
+        const ZyanUPointer end = (ZyanUPointer)info.BaseAddress + info.RegionSize;
+        if ((info.State == MEM_FREE) && (end - above >= size))
+        {
+            found_above = ZYAN_TRUE;
+            break;
+        }
+        const ZyanUPointer next = ZYAN_ALIGN_UP(end, alignment);
+        if (next <= above)
+        {
+            break;
+        }
+        above = next;
+    }
+
+    found_below = found_below && (below <= max_address);
+    found_above = found_above && (above >= min_address);
+    if (found_below && (!found_above || (address - below <= above - address)))
+    {
+        *result = below;
+        return ZYAN_STATUS_TRUE;
+    }
+    if (found_above)
+    {
+        *result = above;
+        return ZYAN_STATUS_TRUE;
+    }
+
+    return ZYAN_STATUS_FALSE;
+}
+
+/**
+ * @brief   Reserves a new remote trampoline-region in range of the given `hook`.
+ *
+ * @param   process     The handle of the target process.
+ * @param   hook        A pointer to the `ZyrexRemoteHook` struct.
+ * @param   region_size The size of the region.
+ * @param   region      Receives the new region.
+ *
+ * @return  A zyan status code.
+ *
+ * The region memory is only reserved. The used pages are committed, when the region is written.
+ */
+static ZyanStatus ZyrexRemoteRegionAllocate(HANDLE process, const ZyrexRemoteHook* hook, 
+    ZyanUSize region_size, ZyrexRemoteRegion* region)
+{
+    ZYAN_ASSERT(hook);
+    ZYAN_ASSERT(region);
+
+    void* address = ZYAN_NULL;
+
+#if defined(ZYAN_X64)
+
+    // The whole region has to be in range of all addresses the trampoline refers to
+    const ZyanUPointer min_address = (hook->address_hi > ZYREX_RANGEOF_RELATIVE_JUMP) 
+        ? hook->address_hi - ZYREX_RANGEOF_RELATIVE_JUMP 
+        : 0;
+    const ZyanUPointer max_address = 
+        hook->address_lo + ZYREX_RANGEOF_RELATIVE_JUMP - region_size;
+
+    for (ZyanU8 i = 0; !address && (i < ZYREX_REMOTE_REGION_ALLOCATION_ATTEMPTS); ++i)
+    {
+        ZyanUPointer candidate;
+        const ZyanStatus status = ZyrexRemoteRegionFindFree(process, 
+            hook->address_lo + (hook->address_hi - hook->address_lo) / 2, min_address, 
+            max_address, region_size, region_size, &candidate);
+        ZYAN_CHECK(status);
+        if (status != ZYAN_STATUS_TRUE)
+        {
+            return ZYAN_STATUS_OUT_OF_RANGE;
+        }
+        address = VirtualAllocEx(process, (LPVOID)candidate, region_size, MEM_RESERVE, 
+            PAGE_NOACCESS);
+    }
+
+#else
+
+    address = VirtualAllocEx(process, ZYAN_NULL, region_size, MEM_RESERVE, PAGE_NOACCESS);
+
+#endif
+
+    if (!address)
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+    region->address = (ZyanUPointer)address;
+    region->slot_count = 0;
+    region->is_used = ZYAN_FALSE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Checks, if the given remote trampoline-region is able to hold the trampoline of the
+ *          given `hook`.
+ *
+ * @param   region      A pointer to the `ZyrexRemoteRegion` struct.
+ * @param   hook        A pointer to the `ZyrexRemoteHook` struct.
+ * @param   region_size The size of the region.
+ *
+ * @return  `ZYAN_TRUE`, if the region has an unused slot in range of the `hook` or `ZYAN_FALSE`,
+ *          if not.
+ */
+static ZyanBool ZyrexRemoteRegionIsSuitable(const ZyrexRemoteRegion* region, 
+    const ZyrexRemoteHook* hook, ZyanUSize region_size)
+{
+    ZYAN_ASSERT(region);
+    ZYAN_ASSERT(hook);
+
+    if (region->slot_count >= region_size / ZYREX_TRAMPOLINE_CODE_SLOT_SIZE)
+    {
+        return ZYAN_FALSE;
+    }
+
+#if defined(ZYAN_X64)
+    return (region->address + ZYREX_RANGEOF_RELATIVE_JUMP >= hook->address_hi) &&
+        (region->address + region_size <= hook->address_lo + ZYREX_RANGEOF_RELATIVE_JUMP);
+#else
+    ZYAN_UNUSED(hook);
+    return ZYAN_TRUE;
+#endif
+}
+
+/**
+ * @brief   Assigns a remote trampoline slot to the given `hook`.
+ *
+ * @param   process     The handle of the target process.
+ * @param   hook        A pointer to the `ZyrexRemoteHook` struct.
+ * @param   regions     A pointer to the `ZyanVector` that contains the `ZyrexRemoteRegion` items.
+ * @param   region_size The size of a region.
+ *
+ * @return  A zyan status code.
+ *
+ * The hooks are processed in the order of their addresses, so the most recently reserved regions
+ * are checked first. A new region is only reserved, if none of the existing ones is suitable.
+ */
+static ZyanStatus ZyrexRemoteHookAssignSlot(HANDLE process, ZyrexRemoteHook* hook, 
+    ZyanVector* regions, ZyanUSize region_size)
+{
+    ZYAN_ASSERT(hook);
+    ZYAN_ASSERT(regions);
+
+    ZyrexRemoteRegion* region = ZYAN_NULL;
+    for (ZyanUSize i = regions->size; i > 0; --i)
+    {
+        ZyrexRemoteRegion* const candidate = ZyanVectorGetMutable(regions, i - 1);
+        ZYAN_ASSERT(candidate);
+
+        if (ZyrexRemoteRegionIsSuitable(candidate, hook, region_size))
+        {
+            region = candidate;
+            hook->region = i - 1;
+            break;
+        }
+    }
+
+    if (!region)
+    {
+        ZyrexRemoteRegion new_region;
+        ZYAN_CHECK(ZyrexRemoteRegionAllocate(process, hook, region_size, &new_region));
+
+        const ZyanStatus status = ZyanVectorPushBack(regions, &new_region);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(VirtualFreeEx(process, (LPVOID)new_region.address, 0, MEM_RELEASE));
+            return status;
+        }
+
+        hook->region = regions->size - 1;
+        region = ZyanVectorGetMutable(regions, hook->region);
+        ZYAN_ASSERT(region);
+    }
+
+    hook->slot = region->address + region->slot_count * ZYREX_TRAMPOLINE_CODE_SLOT_SIZE;
+    ++region->slot_count;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Commits and writes the remote trampoline-region with the given `index`.
+ *
+ * @param   process     The handle of the target process.
+ * @param   hooks       A pointer to the `ZyanVector` that contains the `ZyrexRemoteHook` items.
+ * @param   region      A pointer to the `ZyrexRemoteRegion` struct.
+ * @param   index       The index of the region.
+ * @param   page_size   The system page size.
+ *
+ * @return  A zyan status code.
+ *
+ * The trampolines of all hooks of the region are generated in a local image, which is written to
+ * the target process using a single `WriteProcessMemory` call. If the region could not be 
+ * written, the `status` of all affected entries is updated.
+ */
+static ZyanStatus ZyrexRemoteRegionWrite(HANDLE process, const ZyanVector* hooks, 
+    const ZyrexRemoteRegion* region, ZyanUSize index, ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(hooks);
+    ZYAN_ASSERT(region);
+
+    const ZyanUSize size = 
+        ZYAN_ALIGN_UP(region->slot_count * ZYREX_TRAMPOLINE_CODE_SLOT_SIZE, page_size);
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyanU8* const image = ZYAN_MALLOC(size);
+    ZyanStatus status = image ? ZYAN_STATUS_BAD_SYSTEMCALL : ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    if (image)
+    {
+        // Fill the unused slots with `INT 3` instructions
+        ZYAN_MEMSET(image, 0xCC, size);
+        for (ZyanUSize i = 0; i < hooks->size; ++i)
+        {
+            const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, i);
+            ZYAN_ASSERT(hook);
+
+            if ((hook->region == index) && ZYAN_SUCCESS(hook->entry->status))
+            {
+                hook->entry->status = 
+                    ZyrexRemoteHookWriteSlot(hook, &image[hook->slot - region->address]);
+            }
+        }
+
+        LPVOID const address = (LPVOID)region->address;
+        DWORD old_protection;
+        if (VirtualAllocEx(process, address, size, MEM_COMMIT, PAGE_READWRITE) &&
+            WriteProcessMemory(process, address, image, size, ZYAN_NULL) &&
+            VirtualProtectEx(process, address, size, PAGE_EXECUTE_READ, &old_protection) &&
+            FlushInstructionCache(process, address, size))
+        {
+            status = ZYAN_STATUS_SUCCESS;
+        }
+
+        // TODO: Replace with ZyanMemoryFree in the future
+        ZYAN_FREE(image);
+    }
+
+    if (!ZYAN_SUCCESS(status))
+    {
+        for (ZyanUSize i = 0; i < hooks->size; ++i)
+        {
+            const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, i);
+            ZYAN_ASSERT(hook);
+
+            if ((hook->region == index) && ZYAN_SUCCESS(hook->entry->status))
+            {
+                hook->entry->status = status;
+            }
+        }
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Writes the hook jumps of the remote hooks in the range from `first` to `last`.
+ *
+ * @param   process The handle of the target process.
+ * @param   hooks   A pointer to the `ZyanVector` that contains the `ZyrexRemoteHook` items.
+ * @param   first   The index of the first hook of the span. The hook has to be alive.
+ * @param   last    The index of the last hook of the span. The hook has to be alive.
+ *
+ * @return  A zyan status code.
+ *
+ * The whole span is read, made writable, written and restored using a single system call each.
+ * Hooks whose original code changed after it was relocated are rejected with 
+ * `ZYAN_STATUS_INVALID_OPERATION`. All threads of the target process have to be suspended.
+ */
+static ZyanStatus ZyrexRemoteHooksPatchSpan(HANDLE process, const ZyanVector* hooks, 
+    ZyanUSize first, ZyanUSize last)
+{
+    ZYAN_ASSERT(hooks);
+    ZYAN_ASSERT(first <= last);
+
+    const ZyrexRemoteHook* const head = ZyanVectorGet(hooks, first);
+    const ZyrexRemoteHook* const tail = ZyanVectorGet(hooks, last);
+    ZYAN_ASSERT(head && tail);
+
+    LPVOID const address = (LPVOID)head->address;
+    const ZyanUSize size = tail->address + tail->chunk.original_code_size - head->address;
+
+    // TODO: Replace with ZyanMemoryAlloc in the future
+    ZyanU8* const buffer = ZYAN_MALLOC(size);
+    if (!buffer)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+
+    ZyanStatus status = ZYAN_STATUS_BAD_SYSTEMCALL;
+    DWORD old_protection;
+    if (ReadProcessMemory(process, address, buffer, size, ZYAN_NULL) &&
+        VirtualProtectEx(process, address, size, PAGE_EXECUTE_READWRITE, &old_protection))
+    {
+        for (ZyanUSize i = first; i <= last; ++i)
+        {
+            const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, i);
+            ZYAN_ASSERT(hook);
+
+            if (!ZYAN_SUCCESS(hook->entry->status))
+            {
+                continue;
+            }
+
+            ZyanU8* const code = &buffer[hook->address - head->address];
+            if (ZYAN_MEMCMP(code, hook->source, hook->chunk.original_code_size))
+            {
+                // The original code was modified by the target process in the meantime
+                hook->entry->status = ZYAN_STATUS_INVALID_OPERATION;
+                continue;
+            }
+
+            const ZyanI32 value = ZyrexCalculateRelativeOffset(ZYREX_SIZEOF_RELATIVE_JUMP, 
+                hook->address, hook->slot + ZYREX_REMOTE_SLOT_CALLBACK_JUMP);
+            code[0] = 0xE9;
+            ZYAN_MEMCPY(&code[1], &value, sizeof(value));
+        }
+
+        if (WriteProcessMemory(process, address, buffer, size, ZYAN_NULL))
+        {
+            status = ZYAN_STATUS_SUCCESS;
+        }
+
+        ZYAN_UNUSED(VirtualProtectEx(process, address, size, old_protection, &old_protection));
+        ZYAN_UNUSED(FlushInstructionCache(process, address, size));
+    }
+
+    // TODO: Replace with ZyanMemoryFree in the future
+    ZYAN_FREE(buffer);
+
+    return status;
+}
+
+/**
+ * @brief   Writes the hook jumps of all alive remote hooks.
+ *
+ * @param   process     The handle of the target process.
+ * @param   hooks       A pointer to the `ZyanVector` that contains the sorted `ZyrexRemoteHook`
+ *                      items.
+ * @param   page_size   The system page size.
+ *
+ * Hooks located on the same or neighbouring pages of a memory region with uniform protection are
+ * combined into a single span. The `status` of every entry receives the result of the individual
+ * operation. All threads of the target process have to be suspended.
+ */
+static void ZyrexRemoteHooksPatch(HANDLE process, const ZyanVector* hooks, 
+    ZyanUPointer page_size)
+{
+    ZYAN_ASSERT(hooks);
+
+    ZyanUSize first = 0;
+    while (first < hooks->size)
+    {
+        const ZyrexRemoteHook* const head = ZyanVectorGet(hooks, first);
+        ZYAN_ASSERT(head);
+
+        if (!ZYAN_SUCCESS(head->entry->status))
+        {
+            ++first;
+            continue;
+        }
+
+        ZyanUPointer span_end = head->address + head->chunk.original_code_size;
+        ZyanUPointer region_end = span_end;
+
+        MEMORY_BASIC_INFORMATION info;
+        if (VirtualQueryEx(process, (LPCVOID)head->address, &info, sizeof(info)))
+        {
+            region_end = (ZyanUPointer)info.BaseAddress + info.RegionSize;
+        }
+
+        ZyanUSize last = first;
+        for (ZyanUSize i = first + 1; i < hooks->size; ++i)
+        {
+            const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, i);
+            ZYAN_ASSERT(hook);
+
+            if (!ZYAN_SUCCESS(hook->entry->status))
+            {
+                continue;
+            }
+
+            const ZyanUPointer end = hook->address + hook->chunk.original_code_size;
+            if ((ZYAN_ALIGN_DOWN(hook->address, page_size) > ZYAN_ALIGN_UP(span_end, page_size)) ||
+                (end > region_end))
+            {
+                break;
+            }
+            span_end = end;
+            last = i;
+        }
+
+        const ZyanStatus status = ZyrexRemoteHooksPatchSpan(process, hooks, first, last);
+        if (!ZYAN_SUCCESS(status))
+        {
+            for (ZyanUSize i = first; i <= last; ++i)
+            {
+                const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, i);
+                ZYAN_ASSERT(hook);
+
+                if (ZYAN_SUCCESS(hook->entry->status))
+                {
+                    hook->entry->status = status;
+                }
+            }
+        }
+
+        first = last + 1;
+    }
+}
+
+/**
+ * @brief   Returns the alive remote hook, whose overwritten instructions contain the given 
+ *          `address`.
+ *
+ * @param   hooks   A pointer to the `ZyanVector` that contains the sorted `ZyrexRemoteHook` items.
+ * @param   address The address to search for.
+ *
+ * @return  A pointer to the `ZyrexRemoteHook` or `ZYAN_NULL`, if not found.
+ */
+static const ZyrexRemoteHook* ZyrexRemoteHookFind(const ZyanVector* hooks, ZyanUPointer address)
+{
+    ZYAN_ASSERT(hooks);
+
+    // Find the last hook that starts at or before the given address
+    ZyanUSize lo = 0;
+    ZyanUSize hi = hooks->size;
+    while (lo < hi)
+    {
+        const ZyanUSize mid = lo + ((hi - lo) >> 1);
+        const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, mid);
+        ZYAN_ASSERT(hook);
+
+        if (hook->address <= address)
+        {
+            lo = mid + 1;
+        } else
+        {
+            hi = mid;
+        }
+    }
+
+    if (lo == 0)
+    {
+        return ZYAN_NULL;
+    }
+
+    const ZyrexRemoteHook* const hook = ZyanVectorGet(hooks, lo - 1);
+    ZYAN_ASSERT(hook);
+
+    return (ZYAN_SUCCESS(hook->entry->status) &&
+        (address < hook->address + hook->chunk.original_code_size)) ? hook : ZYAN_NULL;
+}
+
+/**
+ * @brief   Translates the instruction pointer of the given suspended remote thread, if it is 
+ *          located inside of the overwritten instructions of an installed hook.
+ *
+ * @param   entry   A pointer to the `ZyrexThreadEntry` of the suspended thread.
+ * @param   hooks   A pointer to the `ZyanVector` that contains the sorted `ZyrexRemoteHook` items.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the instruction pointer was updated, `ZYAN_STATUS_FALSE`, if
+ *          not or an other zyan status code, if an error occured.
+ *
+ * The thread context is read exactly once and only written back, if the instruction pointer was 
+ * updated.
+ */
+static ZyanStatus ZyrexRemoteMigrateThread(const ZyrexThreadEntry* entry, 
+    const ZyanVector* hooks)
+{
+    ZYAN_ASSERT(entry);
+    ZYAN_ASSERT(hooks);
+
+    CONTEXT context;
+    ZYAN_MEMSET(&context, 0, sizeof(context));
+    context.ContextFlags = CONTEXT_CONTROL;
+    if (!GetThreadContext(entry->handle, &context))
+    {
+        return ZYAN_STATUS_BAD_SYSTEMCALL;
+    }
+
+#if   defined(ZYAN_X64)
+    const ZyanUPointer instruction_pointer = context.Rip;
+#elif defined(ZYAN_X86)
+    const ZyanUPointer instruction_pointer = context.Eip;
+#else
+#   error "Unsupported architecture detected"
+#endif
+
+    const ZyrexRemoteHook* const hook = ZyrexRemoteHookFind(hooks, instruction_pointer);
+    if (!hook)
+    {
+        return ZYAN_STATUS_FALSE;
+    }
+
+    const ZyanStatus status = ZyrexMigrateThreadContext(&context, (const void*)hook->address, 
+        hook->chunk.original_code_size, (const void*)hook->slot, hook->chunk.code_buffer_size, 
+        &hook->chunk.translation_map, ZYAN_FALSE);
+    if (status != ZYAN_STATUS_TRUE)
+    {
+        return status;
+    }
+
+    return SetThreadContext(entry->handle, &context) 
+        ? status 
+        : ZYAN_STATUS_BAD_SYSTEMCALL;
+}
+
+/**
+ * @brief   Installs the given remote inline hooks.
+ *
+ * @param   process The handle of the target process.
+ * @param   entries The remote inline hook entries.
+ * @param   count   The number of entries.
+ *
+ * @return  `ZYAN_STATUS_SUCCESS`, if all hooks were installed, the status code of the first
+ *          failed entry (in array order), or a generic zyan status code if the batch could not be
+ *          started.
+ *
+ * All regions that do not contain the trampoline of at least one installed hook are released 
+ * before this function returns.
+ */
+static ZyanStatus ZyrexRemoteHooksInstall(HANDLE process, ZyrexRemoteInlineHookEntry* entries,
+    ZyanUSize count)
+{
+    ZYAN_ASSERT(entries);
+    ZYAN_ASSERT(count);
+
+    // Suspending all threads of the current process would include the calling thread
+    if (GetProcessId(process) == GetCurrentProcessId())
+    {
+        return ZyrexRemoteHookEntriesFail(entries, count, ZYAN_STATUS_INVALID_OPERATION);
+    }
+
+    // The relocated code and the trampoline layout depend on the architecture of the current 
+    // process
+    BOOL is_wow64_local;
+    BOOL is_wow64_remote;
+    if (!IsWow64Process(GetCurrentProcess(), &is_wow64_local) || 
+        !IsWow64Process(process, &is_wow64_remote))
+    {
+        return ZyrexRemoteHookEntriesFail(entries, count, ZYAN_STATUS_BAD_SYSTEMCALL);
+    }
+    if (is_wow64_local != is_wow64_remote)
+    {
+        return ZyrexRemoteHookEntriesFail(entries, count, ZYAN_STATUS_INVALID_OPERATION);
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    const ZyanUPointer page_size = system_info.dwPageSize;
+    const ZyanUSize region_size = system_info.dwAllocationGranularity;
+
+    ZyanVector hooks;
+    ZyanStatus status = ZyanVectorInit(&hooks, sizeof(ZyrexRemoteHook), count, ZYAN_NULL);
+    if (!ZYAN_SUCCESS(status))
+    {
+        return ZyrexRemoteHookEntriesFail(entries, count, status);
+    }
+    ZyanVector regions;
+    status = ZyanVectorInit(&regions, sizeof(ZyrexRemoteRegion), 4, ZYAN_NULL);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&hooks);
+        return ZyrexRemoteHookEntriesFail(entries, count, status);
+    }
+
+    // Sort the hooks by address, so that neighbouring hooks share the same trampoline-region and
+    // their hook jumps can be written together
+    ZyrexRemoteHook key;
+    ZYAN_MEMSET(&key, 0, sizeof(key));
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        ZyrexRemoteInlineHookEntry* const entry = &entries[i];
+
+        entry->trampoline = 0;
+        if (!entry->address || !entry->callback)
+        {
+            entry->status = ZYAN_STATUS_INVALID_ARGUMENT;
+            continue;
+        }
+        entry->status = ZYAN_STATUS_SUCCESS;
+
+        key.address = entry->address;
+        key.entry = entry;
+
+        ZyanUSize found_index;
+        status = ZyanVectorBinarySearch(&hooks, &key, &found_index, 
+            (ZyanComparison)&ZyrexCompareRemoteHook);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            entry->status = ZYAN_STATUS_INVALID_OPERATION;
+            continue;
+        }
+
+        status = ZyanVectorInsert(&hooks, found_index, &key);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        // Entries after the failed one have not been visited yet
+        ZYAN_UNUSED(ZyrexRemoteHookEntriesFail(entries, count, status));
+    }
+
+    // Relocate all hooks and assign the trampoline slots
+    ZyanUPointer previous_end = 0;
+    for (ZyanUSize i = 0; ZYAN_SUCCESS(status) && (i < hooks.size); ++i)
+    {
+        ZyrexRemoteHook* const hook = ZyanVectorGetMutable(&hooks, i);
+        ZYAN_ASSERT(hook);
+
+        ZyanStatus hook_status = ZyrexRemoteHookPrepare(process, hook, page_size);
+        if (ZYAN_SUCCESS(hook_status) && (hook->address < previous_end))
+        {
+            // The hook jump would overwrite the relocated code of the previous hook
+            hook_status = ZYAN_STATUS_INVALID_OPERATION;
+        }
+        if (ZYAN_SUCCESS(hook_status))
+        {
+            hook_status = ZyrexRemoteHookAssignSlot(process, hook, &regions, region_size);
+        }
+        if (ZYAN_SUCCESS(hook_status))
+        {
+            previous_end = hook->address + hook->chunk.original_code_size;
+        }
+        hook->entry->status = hook_status;
+    }
+
+    // Write all trampoline-regions, before any of the hooks gets activated
+    for (ZyanUSize i = 0; ZYAN_SUCCESS(status) && (i < regions.size); ++i)
+    {
+        const ZyrexRemoteRegion* const region = ZyanVectorGet(&regions, i);
+        ZYAN_ASSERT(region);
+
+        ZYAN_UNUSED(ZyrexRemoteRegionWrite(process, &hooks, region, i, page_size));
+    }
+
+    // Suspend all threads of the target process once for the whole batch
+    if (ZYAN_SUCCESS(status) && (regions.size > 0))
+    {
+        ZyanVector threads;
+        status = ZyanVectorInit(&threads, sizeof(ZyrexThreadEntry), 16, 
+            (ZyanMemberProcedure)&ZyrexThreadEntryDestroy);
+        if (ZYAN_SUCCESS(status))
+        {
+            status = ZyrexSuspendProcessThreads(process, 0, &threads);
+            if (ZYAN_SUCCESS(status))
+            {
+                // The trampoline addresses have to be published, before the callbacks get reachable
+                for (ZyanUSize i = 0; i < hooks.size; ++i)
+                {
+                    const ZyrexRemoteHook* const hook = ZyanVectorGet(&hooks, i);
+                    ZYAN_ASSERT(hook);
+
+                    if (ZYAN_SUCCESS(hook->entry->status) && hook->entry->trampoline_slot &&
+                        !WriteProcessMemory(process, (LPVOID)hook->entry->trampoline_slot, 
+                            &hook->slot, sizeof(hook->slot), ZYAN_NULL))
+                    {
+                        hook->entry->status = ZYAN_STATUS_BAD_SYSTEMCALL;
+                    }
+                }
+
+                ZyrexRemoteHooksPatch(process, &hooks, page_size);
+
+                ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexThreadEntry, &threads, entry, 
+                {
+                    ZYAN_UNUSED(ZyrexRemoteMigrateThread(entry, &hooks));
+                    ZyrexThreadResume(entry);
+                });
+            } else
+            {
+                // Threads that got suspended before the enumeration failed are still listed
+                ZyrexThreadListResume(&threads);
+            }
+            ZyanVectorDestroy(&threads);
+        }
+    }
+
+    // Publish the results and release all unused trampoline-regions
+    for (ZyanUSize i = 0; i < hooks.size; ++i)
+    {
+        const ZyrexRemoteHook* const hook = ZyanVectorGet(&hooks, i);
+        ZYAN_ASSERT(hook);
+
+        if (!ZYAN_SUCCESS(status) && ZYAN_SUCCESS(hook->entry->status))
+        {
+            hook->entry->status = status;
+        }
+        if (ZYAN_SUCCESS(hook->entry->status))
+        {
+            ZyrexRemoteRegion* const region = ZyanVectorGetMutable(&regions, hook->region);
+            ZYAN_ASSERT(region);
+
+            region->is_used = ZYAN_TRUE;
+            hook->entry->trampoline = hook->slot;
+        }
+    }
+    ZYAN_VECTOR_FOREACH(ZyrexRemoteRegion, &regions, region, 
+    {
+        if (!region.is_used)
+        {
+            ZYAN_UNUSED(VirtualFreeEx(process, (LPVOID)region.address, 0, MEM_RELEASE));
+        }
+    });
+
+    ZyanVectorDestroy(&regions);
+    ZyanVectorDestroy(&hooks);
+    ZYAN_CHECK(status);
+
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        if (!ZYAN_SUCCESS(entries[i].status))
+        {
+            return entries[i].status;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+#endif
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Initializes the transaction locks, if not already done.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionLocksInitialize(void)
+{
+    if (g_transaction_locks.state == 2)
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+#if   defined(ZYAN_WINDOWS)
+    const ZyanBool is_owner = 
+        (InterlockedCompareExchange((volatile LONG*)&g_transaction_locks.state, 1, 0) == 0);
+#elif defined(ZYAN_POSIX)
+    const ZyanBool is_owner = __sync_bool_compare_and_swap(&g_transaction_locks.state, 0, 1);
+#endif
+
+    if (!is_owner)
+    {
+        // Another thread is currently initializing the locks
+        while (g_transaction_locks.state != 2)
+        {
+            if (g_transaction_locks.state == 0)
+            {
+                return ZyrexTransactionLocksInitialize();
+            }
+#if   defined(ZYAN_WINDOWS)
+            SwitchToThread();
+#elif defined(ZYAN_POSIX)
+            sched_yield();
+#endif
+        }
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+    ZyanStatus status = ZyanCriticalSectionInitialize(&g_transaction_locks.commit_lock);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanCriticalSectionInitialize(&g_transaction_locks.region_lock);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyanCriticalSectionDelete(&g_transaction_locks.commit_lock));
+        }
+    }
+
+    // Publish the initialized locks to all other threads
+#if   defined(ZYAN_WINDOWS)
+    InterlockedExchange((volatile LONG*)&g_transaction_locks.state, ZYAN_SUCCESS(status) ? 2 : 0);
+#elif defined(ZYAN_POSIX)
+    __sync_synchronize();
+    g_transaction_locks.state = ZYAN_SUCCESS(status) ? 2 : 0;
+#endif
+
+    return status;
+}
+
+/**
+ * @brief   Acquires the commit lock and the region lock for the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ */
+static void ZyrexTransactionLock(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(!transaction->is_locked);
+    ZYAN_ASSERT(g_transaction_locks.state == 2);
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.commit_lock));
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    transaction->is_locked = ZYAN_TRUE;
+}
+
+/**
+ * @brief   Releases the commit lock and the region lock of the given transaction, if held.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ */
+static void ZyrexTransactionUnlock(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    if (!transaction->is_locked)
+    {
+        return;
+    }
+
+    transaction->is_locked = ZYAN_FALSE;
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.commit_lock));
+}
+
+/**
+ * @brief   Initializes the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   is_deferred Signals, if the suspension of threads should be deferred to the commit
+ *                      phase.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionInit(ZyrexTransaction* transaction, ZyanBool is_deferred)
+{
+    ZYAN_ASSERT(transaction);
+
+    transaction->is_deferred = is_deferred;
+    transaction->update_all_threads = ZYAN_FALSE;
+    transaction->is_locked = ZYAN_FALSE;
+    transaction->is_inconsistent = ZYAN_FALSE;
+
+    ZYAN_CHECK(ZyanVectorInit(&transaction->pending_operations, sizeof(ZyrexOperation), 16, 
+        ZYAN_NULL));
+
+    ZyanStatus status = ZyanVectorInit(&transaction->threads_to_update, 
+        sizeof(ZyrexThreadEntry), 16, (ZyanMemberProcedure)&ZyrexThreadEntryDestroy);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&transaction->pending_operations);
+        return status;
+    }
+
+    status = ZyanVectorInit(&transaction->deferred_threads, sizeof(ZyanThreadId), 
+        is_deferred ? 16 : 1, ZYAN_NULL);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&transaction->threads_to_update);
+        ZyanVectorDestroy(&transaction->pending_operations);
+        return status;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Destroys the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * All threads in the thread-update list have to be resumed before calling this function.
+ */
+static void ZyrexTransactionDestroy(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZyanVectorDestroy(&transaction->pending_operations);
+    ZyanVectorDestroy(&transaction->threads_to_update);
+    ZyanVectorDestroy(&transaction->deferred_threads);
+}
+
+/**
+ * @brief   Checks, if the given transaction object was created by `ZyrexTransactionBeginEx` and
+ *          is still active.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * @return  `ZYAN_TRUE`, if the transaction object is valid, `ZYAN_FALSE` if not.
+ */
+static ZyanBool ZyrexTransactionIsValid(const ZyrexTransaction* transaction)
+{
+    return transaction && (transaction != &g_transaction_data) && transaction->is_deferred &&
+        transaction->pending_operations.data;
+}
+
+/**
+ * @brief   Immediately suspends the given thread and adds it to the thread-update list of the 
+ *          given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   thread_id   The id of the thread.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionSuspendThread(ZyrexTransaction* transaction, 
+    ZyanThreadId thread_id)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->is_locked);
+
+    if (thread_id == ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_SUCCESS;
+    }
+
+#if   defined(ZYAN_WINDOWS)
+    const HANDLE handle = OpenThread(ZYREX_THREAD_ACCESS, ZYAN_FALSE, thread_id);
+    if (handle == ZYAN_NULL)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;    
+    }
+
+    ZyrexThreadEntry entry = { thread_id, handle };
+    const ZyanStatus status = ZyrexThreadListSuspend(&transaction->threads_to_update, &entry);
+    if (status != ZYAN_STATUS_TRUE)
+    {
+        CloseHandle(handle);
+        return ZYAN_SUCCESS(status) ? ZYAN_STATUS_SUCCESS : status;
+    }
+#elif defined(ZYAN_POSIX)
+    if (!ZYAN_SUCCESS(ZyrexSignalSend(thread_id, 0)))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexThreadEntry entry = { thread_id, ZYAN_NULL };
+    const ZyanStatus status = ZyrexThreadListSuspend(&transaction->threads_to_update, &entry);
+    if (status != ZYAN_STATUS_TRUE)
+    {
+        return ZYAN_SUCCESS(status) ? ZYAN_STATUS_SUCCESS : status;
+    }
+#endif
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Immediately suspends all threads of the process (except the calling one) and adds 
+ *          them to the thread-update list of the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionSuspendAllThreads(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->is_locked);
+
+#if   defined(ZYAN_WINDOWS)
+    return ZyrexSuspendProcessThreads(GetCurrentProcess(), ZyrexGetCurrentThreadId(), 
+        &transaction->threads_to_update);
+#elif defined(ZYAN_POSIX)
+    return ZyrexSuspendProcessThreads(ZyrexGetCurrentThreadId(), 
+        &transaction->threads_to_update);
+#endif
+}
+
+/**
+ * @brief   Suspends all threads that were added to the given deferred transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * @return  A zyan status code.
+ *
+ * Threads that exited in the meantime are silently skipped.
+ */
+static ZyanStatus ZyrexTransactionSuspendDeferredThreads(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->is_deferred);
+
+    if (transaction->update_all_threads)
+    {
+        return ZyrexTransactionSuspendAllThreads(transaction);
+    }
+
+    for (ZyanUSize i = 0; i < transaction->deferred_threads.size; ++i)
+    {
+        const ZyanThreadId* thread_id = ZyanVectorGet(&transaction->deferred_threads, i);
+        ZYAN_ASSERT(thread_id);
+
+        const ZyanStatus status = ZyrexTransactionSuspendThread(transaction, *thread_id);
+        if (!ZYAN_SUCCESS(status) && (status != ZYAN_STATUS_INVALID_ARGUMENT))
+        {
+            return status;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Links and unlinks the listeners of the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ *
+ * Every listener is published or removed using a single atomic pointer store. The callback of a
+ * hook that is removed while listeners are still linked gets detached instead.
+ *
+ * The caller has to hold the transaction locks.
+ */
+static void ZyrexTransactionUpdateListeners(const ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        switch (operation.action)
+        {
+        case ZYREX_OPERATION_ACTION_ATTACH_LISTENER:
+            ZYAN_UNUSED(ZyrexTrampolineListenerLink(operation.trampoline, operation.value));
+            break;
+        case ZYREX_OPERATION_ACTION_REMOVE_LISTENER:
+            if (operation.value)
+            {
+                ZYAN_UNUSED(ZyrexTrampolineListenerUnlink(operation.trampoline, operation.value));
+                break;
+            }
+            ZYAN_UNUSED(ZyrexTrampolineDetach(operation.trampoline));
+            break;
+        default:
+            break;
+        }
+    });
+}
+
+/**
+ * @brief   Releases the given trampoline, its barrier slot and its thunk.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   is_attached `ZYAN_TRUE`, if the hook was attached before.
+ *
+ * The caller has to hold the region lock.
+ */
+static void ZyrexTransactionReleaseTrampoline(ZyrexTrampolineChunk* trampoline, 
+    ZyanBool is_attached)
+{
+    ZYAN_ASSERT(trampoline);
+
+    if (trampoline->barrier_slot != ZYREX_BARRIER_SLOT_INVALID)
+    {
+        ZYAN_UNUSED(ZyrexBarrierSlotSetCounters(trampoline->barrier_slot, ZYAN_NULL));
+        ZYAN_UNUSED(ZyrexBarrierSlotRelease(trampoline->barrier_slot));
+    }
+    // Fails with `ZYAN_STATUS_NOT_FOUND` for all hooks that are not thunk hooks
+    ZYAN_UNUSED(ZyrexThunkFree((const void*)trampoline->callback_address, is_attached));
+    ZYAN_UNUSED(ZyrexTrampolineFree(trampoline));
+}
+
+/**
+ * @brief   Applies all pending operations of the given transaction and releases all resources
+ *          of removed hooks.
+ *
+ * @param   transaction         A pointer to the `ZyrexTransaction` struct.
+ * @param   failed_operation    Receives the target address of the operation that failed the
+ *                              transaction.
+ *
+ * @return  A zyan status code.
+ *
+ * The caller has to hold the transaction locks. If the function fails, the transaction stays 
+ * active.
+ */
+static ZyanStatus ZyrexTransactionApply(ZyrexTransaction* transaction, 
+    const void** failed_operation)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->is_locked);
+
+    // A transaction that left the code partially patched can only be cancelled
+    if (transaction->is_inconsistent)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    // Collect the code patches of all pending operations sorted by address, so that every page
+    // has to be unprotected and flushed only once
+    ZyanVector patches;
+    ZYAN_CHECK(ZyanVectorInit(&patches, sizeof(ZyrexCodePatch), 
+        ZYAN_MAX(transaction->pending_operations.size, 1), ZYAN_NULL));
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < transaction->pending_operations.size; ++i)
+    {
+        const ZyrexOperation* item = ZyanVectorGet(&transaction->pending_operations, i);
+        ZYAN_ASSERT(item);
+
+        // Listeners only redirect callback stubs of hooks that are already installed
+        if ((item->action == ZYREX_OPERATION_ACTION_ATTACH_LISTENER) ||
+            (item->action == ZYREX_OPERATION_ACTION_REMOVE_LISTENER))
+        {
+            continue;
+        }
+
+        switch (item->type)
+        {
+        case ZYREX_HOOK_TYPE_INLINE:
+        case ZYREX_HOOK_TYPE_EXCEPTION:
+        case ZYREX_HOOK_TYPE_IAT:
+        case ZYREX_HOOK_TYPE_VTABLE:
+        {
+            // The target might have been modified by someone else since the operation was added
+            status = ZyrexCodePatchVerify(item);
+            if (!ZYAN_SUCCESS(status))
+            {
+                break;
+            }
+            ZyrexCodePatch patch;
+            ZyrexCodePatchInit(&patch, item);
+            status = ZyrexCodePatchInsert(&patches, &patch);
+            break;
+        }
+        case ZYREX_HOOK_TYPE_CONTEXT:
+            // Context hooks are applied by writing the debug registers during thread migration
+            break;
+        default:
+            ZYAN_UNREACHABLE;
+        }
+
+        if (!ZYAN_SUCCESS(status))
+        {
+            if (failed_operation)
+            {
+                *failed_operation = item->address;
+            }
+            break;
+        }
+    }
+
+    // The exception dispatcher has to know about new hooks, before the first breakpoint can be hit
+    ZyanVector exception_hooks;
+    ZyrexExceptionHookTable* exception_table = ZYAN_NULL;
+    ZyanUPointer debug_registers[ZYREX_CONTEXT_HOOK_MAX_COUNT];
+    ZyanBool has_exception_hooks = ZYAN_FALSE;
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexPointerHooksReserve(transaction, failed_operation);
+    }
+
+    // The ranges of all code that is changed or released by the transaction are collected before 
+    // the first patch is written, as threads inside these ranges can not be left behind once the 
+    // code was modified
+    ZyanVector ranges;
+    ZyanBool has_ranges = ZYAN_FALSE;
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorInit(&ranges, sizeof(ZyrexMigrationRange), 
+            ZYAN_MAX(transaction->pending_operations.size, 1), ZYAN_NULL);
+        has_ranges = ZYAN_SUCCESS(status);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexMigrationRangesCollect(transaction, &ranges);
+    }
+
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexExceptionHooksPrepare(transaction, &exception_hooks, &exception_table, 
+            debug_registers);
+        has_exception_hooks = (status == ZYAN_STATUS_TRUE);
+    }
+
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexCodePatchApplyAll(&patches, failed_operation);
+    }
+    ZyanVectorDestroy(&patches);
+
+    if (!ZYAN_SUCCESS(status))
+    {
+        if (has_ranges)
+        {
+            ZyanVectorDestroy(&ranges);
+        }
+
+        // The published table still contains all installed hooks. Entries of pending hooks are 
+        // never hit, as neither their code nor any debug register was changed
+        if (has_exception_hooks)
+        {
+            ZyrexExceptionHookTableDestroy(exception_table);
+            ZyanVectorDestroy(&exception_hooks);
+        }
+
+        // The original code has been restored from the undo log, unless the status says otherwise
+        transaction->is_inconsistent = (status == ZYREX_STATUS_PARTIALLY_APPLIED);
+        return status;
+    }
+
+    ZyrexTransactionUpdateListeners(transaction);
+
+    // Debug registers are only written, if the set of context hooks changed
+    ZyanBool update_debug_registers = ZYAN_FALSE;
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        update_debug_registers |= (operation.type == ZYREX_HOOK_TYPE_CONTEXT);
+    });
+
+    // Translate the instruction pointers of threads inside patched code, before any trampoline gets
+    // released
+    ZyrexMigrateAndResumeThreads(transaction, &ranges, 
+        update_debug_registers ? debug_registers : ZYAN_NULL);
+    ZyanVectorDestroy(&ranges);
+
+#ifdef ZYAN_WINDOWS
+    // The committing thread is never suspended, so its debug registers are written separately
+    if (update_debug_registers)
+    {
+        ZYAN_UNUSED(ZyrexDebugRegistersWriteCurrentThread(debug_registers));
+    }
+#endif
+
+    if (has_exception_hooks)
+    {
+        ZyrexExceptionHooksPublish(&exception_hooks, exception_table);
+    }
+    ZyrexPointerHooksUpdate(transaction);
+
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        if ((operation.action == ZYREX_OPERATION_ACTION_REMOVE_LISTENER) && operation.value)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineListenerFree(operation.trampoline, operation.value));
+            continue;
+        }
+        if ((operation.action != ZYREX_OPERATION_ACTION_REMOVE) || !operation.trampoline)
+        {
+            continue;
+        }
+        ZyrexTransactionReleaseTrampoline(operation.trampoline, ZYAN_TRUE);
+    });
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Releases all resources of pending hook installations and resumes all suspended 
+ *          threads of the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ */
+static void ZyrexTransactionCancel(ZyrexTransaction* transaction)
+{
+    ZYAN_ASSERT(transaction);
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexOperation, &transaction->pending_operations, operation, 
+    {
+        if (operation->action == ZYREX_OPERATION_ACTION_ATTACH_LISTENER)
+        {
+            ZYAN_UNUSED(ZyrexTrampolineListenerFree(operation->trampoline, operation->value));
+            continue;
+        }
+        if ((operation->action != ZYREX_OPERATION_ACTION_ATTACH) || !operation->trampoline ||
+            transaction->is_inconsistent)
+        {
+            continue;
+        }
+        ZyrexTransactionReleaseTrampoline(operation->trampoline, ZYAN_FALSE);
+    });
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    ZyrexThreadListResume(&transaction->threads_to_update);
+}
+
+/**
+ * @brief   Adds a listener to the callback chain of an existing inline hook at the given 
+ *          `address`.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   address     The hooked address.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address the callback has to call to continue with the 
+ *                      original function, if the operation succeeded.
+ *
+ * @return  `ZYAN_STATUS_TRUE`, if the listener was added, `ZYAN_STATUS_FALSE`, if no hook with a
+ *          callback chain exists at the given `address` or its trampoline-region is exhausted,
+ *          or another zyan status code, if an error occured.
+ */
+static ZyanStatus ZyrexTransactionAddListener(ZyrexTransaction* transaction, void* address, 
+    const void* callback, ZyanConstVoidPointer* trampoline)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(address);
+    ZYAN_ASSERT(callback);
+    ZYAN_ASSERT(trampoline);
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_INLINE,
+        /* action              */ ZYREX_OPERATION_ACTION_ATTACH_LISTENER,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.address = address;
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    ZyanStatus status = ZyrexTrampolineFindChain(address, &operation.trampoline);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        status = ZyrexTrampolineListenerCreate(operation.trampoline, callback, &operation.value);
+        if (status == ZYAN_STATUS_OUT_OF_RESOURCES)
+        {
+            // The caller falls back to a stacked trampoline in another region
+            status = ZYAN_STATUS_FALSE;
+        } else
+        if (ZYAN_SUCCESS(status))
+        {
+            status = ZyanVectorPushBack(&transaction->pending_operations, &operation);
+            if (ZYAN_SUCCESS(status))
+            {
+                status = ZYAN_STATUS_TRUE;
+            } else
+            {
+                ZYAN_UNUSED(ZyrexTrampolineListenerFree(operation.trampoline, operation.value));
+            }
+        }
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        *trampoline = operation.value;
+    }
+
+    return status;
+}
+
+/**
+ * @brief   Adds an inline hook installation to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   flags       A combination of `ZYREX_INLINE_HOOK_FLAG_*` values.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddInlineHook(ZyrexTransaction* transaction, void* address, 
+    const void* callback, ZyrexInlineHookFlags flags, ZyanConstVoidPointer* trampoline)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->pending_operations.data);
+    ZYAN_ASSERT(transaction->threads_to_update.data);
+
+    if (!address || !callback || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Listeners share the trampoline of the existing hook and thus can not have any other flags
+    if ((flags & ZYREX_INLINE_HOOK_FLAG_CHAIN) && 
+        !(flags & ~(ZYREX_INLINE_HOOK_FLAG_CHAIN | ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK)))
+    {
+        const ZyanStatus status = 
+            ZyrexTransactionAddListener(transaction, address, callback, trampoline);
+        ZYAN_CHECK(status);
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_INLINE,
+        /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.address = address;
+
+    if (flags & ZYREX_INLINE_HOOK_FLAG_CHAIN)
+    {
+        flags |= ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_MEASURE_CYCLES)
+    {
+        flags |= ZYREX_INLINE_HOOK_FLAG_COUNTERS;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_SAMPLING)
+    {
+        flags |= ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_COUNTERS)
+    {
+        flags |= ZYREX_INLINE_HOOK_FLAG_RESERVE_BARRIER_SLOT;
+    }
+
+    ZyrexTrampolineFlags trampoline_flags = ZYREX_TRAMPOLINE_FLAG_NONE;
+    if (flags & ZYREX_INLINE_HOOK_FLAG_DYNAMIC_CALLBACK)
+    {
+        trampoline_flags |= ZYREX_TRAMPOLINE_FLAG_PRIVATE_CALLBACK;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_COUNTERS)
+    {
+        trampoline_flags |= ZYREX_TRAMPOLINE_FLAG_COUNTERS;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_MEASURE_CYCLES)
+    {
+        trampoline_flags |= ZYREX_TRAMPOLINE_FLAG_MEASURE_CYCLES;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_SAMPLING)
+    {
+        trampoline_flags |= ZYREX_TRAMPOLINE_FLAG_SAMPLING;
+    }
+    if (flags & ZYREX_INLINE_HOOK_FLAG_HOT_PATCH)
+    {
+        trampoline_flags |= ZYREX_TRAMPOLINE_FLAG_HOT_PATCH;
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    ZyanU32 barrier_slot = ZYREX_BARRIER_SLOT_INVALID;
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    if (ZyrexExceptionHookFind((ZyanUPointer)address))
+    {
+        // The trampoline would relocate the breakpoint of the exception hook
+        status = ZYAN_STATUS_INVALID_OPERATION;
+    } else
+    if (flags & ZYREX_INLINE_HOOK_FLAG_RESERVE_BARRIER_SLOT)
+    {
+        status = ZyrexBarrierSlotReserve(&barrier_slot);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTrampolineCreate(address, callback, ZYREX_SIZEOF_RELATIVE_JUMP, 
+            barrier_slot, trampoline_flags, &operation.trampoline);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorPushBack(&transaction->pending_operations, &operation);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexTrampolineFree(operation.trampoline));
+        }
+    }
+    if (ZYAN_SUCCESS(status) && operation.trampoline->counters)
+    {
+        ZYAN_UNUSED(ZyrexBarrierSlotSetCounters(barrier_slot, operation.trampoline->counters));
+    }
+    if (!ZYAN_SUCCESS(status) && (barrier_slot != ZYREX_BARRIER_SLOT_INVALID))
+    {
+        ZYAN_UNUSED(ZyrexBarrierSlotRelease(barrier_slot));
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_CHECK(status);
+
+    *trampoline = &operation.trampoline->code->code_buffer;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Adds multiple inline hook installations to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   entries     The inline hook entries.
+ * @param   count       The number of entries.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddInlineHooks(ZyrexTransaction* transaction,
+    ZyrexInlineHookEntry* entries, ZyanUSize count)
+{
+    ZYAN_ASSERT(transaction);
+
+    if (!entries || (count == 0))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // Sort the entries by address, so that consecutive hooks are likely to share the same
+    // trampoline-region and readable memory range
+    ZyanVector sorted;
+    ZYAN_CHECK(ZyanVectorInit(&sorted, sizeof(ZyrexInlineHookEntry*), count, ZYAN_NULL));
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        ZyrexInlineHookEntry* const entry = &entries[i];
+
+        ZyanUSize found_index;
+        status = ZyanVectorBinarySearch(&sorted, &entry, &found_index, 
+            (ZyanComparison)&ZyrexCompareInlineHookEntry);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+        if (status == ZYAN_STATUS_TRUE)
+        {
+            entry->status = ZYAN_STATUS_INVALID_OPERATION;
+            continue;
+        }
+
+        status = ZyanVectorInsert(&sorted, found_index, &entry);
+        if (!ZYAN_SUCCESS(status))
+        {
+            break;
+        }
+    }
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyanVectorDestroy(&sorted);
+        return status;
+    }
+
+    // The trampoline batch state is shared, so the region lock is held for the whole batch
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    status = ZyrexTrampolineBatchBegin();
+    if (ZYAN_SUCCESS(status))
+    {
+        for (ZyanUSize i = 0; i < sorted.size; ++i)
+        {
+            ZyrexInlineHookEntry* const* entry = ZyanVectorGet(&sorted, i);
+            ZYAN_ASSERT(entry && *entry);
+
+            (*entry)->status = ZyrexTransactionAddInlineHook(transaction, (*entry)->address, 
+                (*entry)->callback, (*entry)->flags, (*entry)->trampoline);
+        }
+
+        status = ZyrexTrampolineBatchEnd();
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZyanVectorDestroy(&sorted);
+    ZYAN_CHECK(status);
+
+    for (ZyanUSize i = 0; i < count; ++i)
+    {
+        if (!ZYAN_SUCCESS(entries[i].status))
+        {
+            return entries[i].status;
+        }
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Adds a thunk hook installation to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   address     The address to hook.
+ * @param   signature   A pointer to the `ZyrexThunkSignature` struct.
+ * @param   handler     The handler function.
+ * @param   user_data   The user data passed to the handler.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddThunkHook(ZyrexTransaction* transaction, void* address, 
+    const ZyrexThunkSignature* signature, ZyrexThunkHandler handler, void* user_data,
+    ZyanConstVoidPointer* trampoline)
+{
+    ZYAN_ASSERT(transaction);
+
+    if (!address || !signature || !handler || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // The thunk has to exist before the trampoline, which receives it as callback, but it can only
+    // be completed after the trampoline was created
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    const void* thunk;
+    ZyanStatus status = ZyrexThunkCreate(address, signature, handler, user_data, &thunk);
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexTransactionAddInlineHook(transaction, address, thunk, 
+            ZYREX_INLINE_HOOK_FLAG_NONE, trampoline);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexThunkFree(thunk, ZYAN_FALSE));
+        }
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyrexThunkSetOriginal(thunk, *trampoline);
+        if (!ZYAN_SUCCESS(status))
+        {
+            const ZyanUSize index = transaction->pending_operations.size - 1;
+            const ZyrexOperation* const operation = 
+                ZyanVectorGet(&transaction->pending_operations, index);
+            ZYAN_ASSERT(operation && operation->trampoline);
+            ZYAN_ASSERT(operation->trampoline->callback_address == (ZyanUPointer)thunk);
+
+            ZyrexTransactionReleaseTrampoline(operation->trampoline, ZYAN_FALSE);
+            ZYAN_UNUSED(ZyanVectorDelete(&transaction->pending_operations, index));
+        }
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    return status;
+}
+
+/**
+ * @brief   Adds an exception or context hook installation to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   type        The hook type (`ZYREX_HOOK_TYPE_EXCEPTION` or `ZYREX_HOOK_TYPE_CONTEXT`).
+ * @param   address     The address to hook.
+ * @param   callback    The callback address.
+ * @param   trampoline  Receives the address of the trampoline to the original function, if the
+ *                      operation succeeded.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddExceptionHook(ZyrexTransaction* transaction, 
+    ZyrexHookType type, void* address, const void* callback, ZyanConstVoidPointer* trampoline)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->pending_operations.data);
+    ZYAN_ASSERT(transaction->threads_to_update.data);
+    ZYAN_ASSERT((type == ZYREX_HOOK_TYPE_EXCEPTION) || (type == ZYREX_HOOK_TYPE_CONTEXT));
+
+    if (!address || !callback || !trampoline)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+#ifndef ZYAN_WINDOWS
+    // The debug registers of other threads can not be written on this platform
+    if (type == ZYREX_HOOK_TYPE_CONTEXT)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+#endif
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_EXCEPTION,
+        /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.type = type;
+    operation.address = address;
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    ZyanStatus status = ZYAN_STATUS_SUCCESS;
+    if (ZyrexExceptionHookFind((ZyanUPointer)address))
+    {
+        status = ZYAN_STATUS_INVALID_OPERATION;
+    } else
+    if ((type == ZYREX_HOOK_TYPE_CONTEXT) && 
+        (ZyrexContextHookCount(transaction) >= ZYREX_CONTEXT_HOOK_MAX_COUNT))
+    {
+        // Concurrent transactions are checked again during the commit phase
+        status = ZYAN_STATUS_OUT_OF_RESOURCES;
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        // Only the first instruction has to be relocated, as the callback is entered by the 
+        // exception dispatcher
+        status = ZyrexTrampolineCreate(address, callback, 1, ZYREX_BARRIER_SLOT_INVALID, 
+            ZYREX_TRAMPOLINE_FLAG_NONE, &operation.trampoline);
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        status = ZyanVectorPushBack(&transaction->pending_operations, &operation);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZYAN_UNUSED(ZyrexTrampolineFree(operation.trampoline));
+        }
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_CHECK(status);
+
+    *trampoline = &operation.trampoline->code->code_buffer;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Checks, if the given `listener` is linked into the callback chain of the given
+ *          trampoline.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   listener    The listener address.
+ *
+ * @return  `ZYAN_TRUE`, if the listener is linked or `ZYAN_FALSE`, if not.
+ */
+static ZyanBool ZyrexTransactionIsListenerLinked(const ZyrexTrampolineChunk* trampoline, 
+    const void* listener)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(trampoline->listeners);
+
+    ZYAN_VECTOR_FOREACH(ZyrexTrampolineListener, trampoline->listeners, item,
+    {
+        if (item.callback_jump == listener)
+        {
+            return item.is_linked;
+        }
+    });
+
+    return ZYAN_FALSE;
+}
+
+/**
+ * @brief   Returns the number of listeners of the given trampoline, that remain linked after
+ *          committing the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   trampoline  The trampoline chunk.
+ * @param   is_detached Receives `ZYAN_TRUE`, if the callback of the trampoline is detached after
+ *                      committing the transaction.
+ *
+ * @return  The number of remaining listeners.
+ *
+ * The caller has to hold the region lock.
+ */
+static ZyanUSize ZyrexTransactionGetListenerCount(const ZyrexTransaction* transaction,
+    const ZyrexTrampolineChunk* trampoline, ZyanBool* is_detached)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(is_detached);
+
+    ZyanUSize count = ZyrexTrampolineGetListenerCount(trampoline);
+    *is_detached = trampoline->is_detached;
+
+    ZYAN_VECTOR_FOREACH(ZyrexOperation, &transaction->pending_operations, operation,
+    {
+        if ((operation.trampoline != trampoline) || 
+            (operation.action != ZYREX_OPERATION_ACTION_REMOVE_LISTENER))
+        {
+            continue;
+        }
+        if (!operation.value)
+        {
+            *is_detached = ZYAN_TRUE;
+            continue;
+        }
+        if (count)
+        {
+            --count;
+        }
+    });
+
+    return count;
+}
+
+/**
+ * @brief   Adds a hook removal to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   type        The type of the hook.
+ * @param   original    A pointer to the trampoline address received during the hook attaching.
+ *                      Receives the address of the original function after removing the hook.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddHookRemoval(ZyrexTransaction* transaction, 
+    ZyrexHookType type, ZyanConstVoidPointer* original)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->pending_operations.data);
+    ZYAN_ASSERT(transaction->threads_to_update.data);
+
+    if (!original)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexTrampolineChunk* trampoline;
+    const void* listener = ZYAN_NULL;
+    ZyrexOperationAction action = ZYREX_OPERATION_ACTION_REMOVE;
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    ZyanStatus status = ZyrexTrampolineFind(*original, &trampoline);
+    if ((status == ZYAN_STATUS_FALSE) && (type == ZYREX_HOOK_TYPE_INLINE))
+    {
+        status = ZyrexTrampolineListenerFind(*original, &trampoline);
+        listener = *original;
+    }
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        // The backjump targets the first instruction following the relocated code
+        const ZyrexExceptionHook* const hook = ZyrexExceptionHookFind(
+            trampoline->backjump_address - trampoline->original_code_size);
+        if ((hook ? hook->type : ZYREX_HOOK_TYPE_INLINE) != type)
+        {
+            status = ZYAN_STATUS_INVALID_OPERATION;
+        }
+    }
+    if ((status == ZYAN_STATUS_TRUE) && (type == ZYREX_HOOK_TYPE_INLINE))
+    {
+        // The trampoline is only released, if neither its own callback nor any listener 
+        // remains in the callback chain
+        ZyanBool is_detached;
+        const ZyanUSize count = 
+            ZyrexTransactionGetListenerCount(transaction, trampoline, &is_detached);
+        if (listener)
+        {
+            if (!ZyrexTransactionIsListenerLinked(trampoline, listener))
+            {
+                status = ZYAN_STATUS_FALSE;
+            } else
+            if (!is_detached || (count > 1))
+            {
+                action = ZYREX_OPERATION_ACTION_REMOVE_LISTENER;
+            }
+        } else
+        if (is_detached)
+        {
+            status = ZYAN_STATUS_FALSE;
+        } else
+        if (count)
+        {
+            action = ZYREX_OPERATION_ACTION_REMOVE_LISTENER;
+        }
+    }
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_CHECK(status);
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        return ZYAN_STATUS_NOT_FOUND;
+    }
+
+    void* const address = 
+        (void*)(trampoline->backjump_address - trampoline->original_code_size);
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_INLINE,
+        /* action              */ ZYREX_OPERATION_ACTION_REMOVE,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.type = type;
+    operation.action = action;
+    operation.address = address;
+    operation.trampoline = trampoline;
+    if (action == ZYREX_OPERATION_ACTION_REMOVE_LISTENER)
+    {
+        operation.value = listener;
+    }
+
+    ZYAN_CHECK(ZyanVectorPushBack(&transaction->pending_operations, &operation));
+    *original = address;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Adds a pointer hook installation to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   type        The hook type (`ZYREX_HOOK_TYPE_IAT` or `ZYREX_HOOK_TYPE_VTABLE`).
+ * @param   slot        The address of the pointer slot to hook.
+ * @param   callback    The callback address.
+ * @param   original    Receives the original pointer value of the slot, if the operation 
+ *                      succeeded.
+ *
+ * @return  A zyan status code.
+ *
+ * Pointer hooks do not require a trampoline, as the original function stays intact.
+ */
+static ZyanStatus ZyrexTransactionAddPointerHook(ZyrexTransaction* transaction, 
+    ZyrexHookType type, void** slot, const void* callback, ZyanConstVoidPointer* original)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->pending_operations.data);
+    ZYAN_ASSERT(transaction->threads_to_update.data);
+    ZYAN_ASSERT((type == ZYREX_HOOK_TYPE_IAT) || (type == ZYREX_HOOK_TYPE_VTABLE));
+
+    // Only aligned slots can be replaced using a single atomic store
+    if (!slot || !callback || !original || ((ZyanUPointer)slot & (sizeof(void*) - 1)))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_VTABLE,
+        /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.type = type;
+    operation.address = slot;
+    operation.value = callback;
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    ZyanUSize index;
+    ZyanStatus status = ZyrexPointerHookFind(slot, &index);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        status = ZYAN_STATUS_INVALID_OPERATION;
+    }
+    if (ZYAN_SUCCESS(status))
+    {
+        operation.original = *(void* volatile*)slot;
+        status = ZyanVectorPushBack(&transaction->pending_operations, &operation);
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_CHECK(status);
+
+    *original = operation.original;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/**
+ * @brief   Adds a pointer hook removal to the given transaction.
+ *
+ * @param   transaction A pointer to the `ZyrexTransaction` struct.
+ * @param   type        The hook type (`ZYREX_HOOK_TYPE_IAT` or `ZYREX_HOOK_TYPE_VTABLE`).
+ * @param   slot        The address of the hooked pointer slot.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddPointerHookRemoval(ZyrexTransaction* transaction, 
+    ZyrexHookType type, void** slot)
+{
+    ZYAN_ASSERT(transaction);
+    ZYAN_ASSERT(transaction->pending_operations.data);
+    ZYAN_ASSERT(transaction->threads_to_update.data);
+
+    if (!slot)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexOperation operation = 
+    {
+        /* type                */ ZYREX_HOOK_TYPE_VTABLE,
+        /* action              */ ZYREX_OPERATION_ACTION_REMOVE,
+        /* address             */ ZYAN_NULL,
+        /* trampoline          */ ZYAN_NULL,
+        /* value               */ ZYAN_NULL,
+        /* original            */ ZYAN_NULL
+    };
+    operation.type = type;
+    operation.address = slot;
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+
+    ZyanUSize index;
+    ZyanStatus status = ZyrexPointerHookFind(slot, &index);
+    if (status == ZYAN_STATUS_TRUE)
+    {
+        const ZyrexPointerHook* const hook = ZyanVectorGet(&g_pointer_hooks, index);
+        ZYAN_ASSERT(hook);
+
+        if (hook->type == type)
+        {
+            operation.value = hook->original;
+            operation.original = hook->original;
+            status = ZyanVectorPushBack(&transaction->pending_operations, &operation);
+        } else
+        {
+            status = ZYAN_STATUS_NOT_FOUND;
+        }
+    } else
+    if (status == ZYAN_STATUS_FALSE)
+    {
+        status = ZYAN_STATUS_NOT_FOUND;
+    }
+
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    return status;
+}
+
+/**
+ * @brief   Resolves the import address table slot of the given import.
+ *
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL`.
+ * @param   import_name     The name or ordinal of the imported function.
+ * @param   slot            Receives the address of the import address table slot.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionResolveImportSlot(const void* module, 
+    const char* import_module, const char* import_name, void*** slot)
+{
+#if   defined(ZYAN_WINDOWS)
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    const ZyanStatus status = 
+        ZyrexImportTableFindSlot(module, import_module, import_name, slot);
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    return status;
+#elif defined(ZYAN_POSIX)
+    // Import address tables are specific to the PE format
+    ZYAN_UNUSED(module);
+    ZYAN_UNUSED(import_module);
+    ZYAN_UNUSED(import_name);
+    ZYAN_UNUSED(slot);
+
+    return ZYAN_STATUS_INVALID_OPERATION;
+#endif
+}
+
+/**
+ * @brief   Adds an import address table hook installation to the given transaction.
+ *
+ * @param   transaction     A pointer to the `ZyrexTransaction` struct.
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL`.
+ * @param   import_name     The name or ordinal of the imported function.
+ * @param   callback        The callback address.
+ * @param   original        Receives the original address of the imported function, if the
+ *                          operation succeeded.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddIatHook(ZyrexTransaction* transaction, const void* module,
+    const char* import_module, const char* import_name, const void* callback,
+    ZyanConstVoidPointer* original)
+{
+    ZYAN_ASSERT(transaction);
+
+    if (!module || !import_name)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    void** slot;
+    ZYAN_CHECK(ZyrexTransactionResolveImportSlot(module, import_module, import_name, &slot));
+
+    return ZyrexTransactionAddPointerHook(transaction, ZYREX_HOOK_TYPE_IAT, slot, callback, 
+        original);
+}
+
+/**
+ * @brief   Adds an import address table hook removal to the given transaction.
+ *
+ * @param   transaction     A pointer to the `ZyrexTransaction` struct.
+ * @param   module          The base address of the importing module.
+ * @param   import_module   The name of the exporting module or `ZYAN_NULL`.
+ * @param   import_name     The name or ordinal of the imported function.
+ *
+ * @return  A zyan status code.
+ */
+static ZyanStatus ZyrexTransactionAddIatHookRemoval(ZyrexTransaction* transaction, 
+    const void* module, const char* import_module, const char* import_name)
+{
+    ZYAN_ASSERT(transaction);
+
+    if (!module || !import_name)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    void** slot;
+    ZYAN_CHECK(ZyrexTransactionResolveImportSlot(module, import_module, import_name, &slot));
+
+    return ZyrexTransactionAddPointerHookRemoval(transaction, ZYREX_HOOK_TYPE_IAT, slot);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+
+/* ============================================================================================== */
+/* Exported functions                                                                             */
+/* ============================================================================================== */
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction                                                                                    */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTransactionBegin()
+{
+    if (g_transaction_data.transaction_thread_id != 0)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
+
+#if   defined(ZYAN_WINDOWS)
+    if (InterlockedCompareExchange((volatile LONG*)&g_transaction_data.transaction_thread_id,
+        (LONG)ZyrexGetCurrentThreadId(), 0) != 0)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+#elif defined(ZYAN_POSIX)
+    if (!__sync_bool_compare_and_swap(&g_transaction_data.transaction_thread_id, 0,
+        ZyrexGetCurrentThreadId()))
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+#endif
+
+    // Threads are suspended immediately by the global transaction. Holding both locks for the 
+    // whole transaction guarantees that no suspended thread owns the region lock
+    ZyrexTransactionLock(&g_transaction_data);
+
+    // Every transaction starts with a fresh snapshot of the address space, which is then shared 
+    // by all trampoline allocations of the transaction
+    ZyrexMemoryMapInvalidate();
+
+    const ZyanStatus status = ZyrexTransactionInit(&g_transaction_data, ZYAN_FALSE);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZyrexTransactionUnlock(&g_transaction_data);
+        g_transaction_data.transaction_thread_id = 0;
+        return status;
+    }
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexUpdateThread(ZyanThreadId thread_id)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+    
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    return ZyrexTransactionSuspendThread(&g_transaction_data, thread_id);
+}
+
+ZyanStatus ZyrexUpdateAllThreads()
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+    
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    return ZyrexTransactionSuspendAllThreads(&g_transaction_data);
+}
+
+ZyanStatus ZyrexTransactionCommit()
+{
+    return ZyrexTransactionCommitEx(NULL);
+}
+
+ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+    
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    // The transaction stays active on failure, so the caller is able to call 
+    // `ZyrexTransactionAbort`
+    ZYAN_CHECK(ZyrexTransactionApply(&g_transaction_data, failed_operation));
+
+    ZyrexTransactionDestroy(&g_transaction_data);
+    ZyrexTransactionUnlock(&g_transaction_data);
+    g_transaction_data.transaction_thread_id = 0;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTransactionAbort()
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+    
+    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
+    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+
+    ZyrexTransactionCancel(&g_transaction_data);
+
+    ZyrexTransactionDestroy(&g_transaction_data);
+    ZyrexTransactionUnlock(&g_transaction_data);
+    g_transaction_data.transaction_thread_id = 0;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Transaction objects                                                                            */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexTransactionBeginEx(ZyrexTransaction** transaction)
+{
+    if (!transaction)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
+
+    ZyrexTransaction* const value = ZYAN_MALLOC(sizeof(ZyrexTransaction));
+    if (!value)
+    {
+        return ZYAN_STATUS_NOT_ENOUGH_MEMORY;
+    }
+    value->transaction_thread_id = 0;
+
+    const ZyanStatus status = ZyrexTransactionInit(value, ZYAN_TRUE);
+    if (!ZYAN_SUCCESS(status))
+    {
+        ZYAN_FREE(value);
+        return status;
+    }
+
+    // Refresh the shared snapshot of the address space for the trampoline allocations
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    ZyrexMemoryMapInvalidate();
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+
+    *transaction = value;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTransactionUpdateThread(ZyrexTransaction* transaction, ZyanThreadId thread_id)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    for (ZyanUSize i = 0; i < transaction->deferred_threads.size; ++i)
+    {
+        const ZyanThreadId* item = ZyanVectorGet(&transaction->deferred_threads, i);
+        ZYAN_ASSERT(item);
+
+        if (*item == thread_id)
+        {
+            return ZYAN_STATUS_SUCCESS;
+        }
+    }
+
+    return ZyanVectorPushBack(&transaction->deferred_threads, &thread_id);
+}
+
+ZyanStatus ZyrexTransactionUpdateAllThreads(ZyrexTransaction* transaction)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    transaction->update_all_threads = ZYAN_TRUE;
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTransactionInstallInlineHook(ZyrexTransaction* transaction, void* address, 
+    const void* callback, ZyrexInlineHookFlags flags, ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddInlineHook(transaction, address, callback, flags, trampoline);
+}
+
+ZyanStatus ZyrexTransactionInstallInlineHooks(ZyrexTransaction* transaction,
+    ZyrexInlineHookEntry* entries, ZyanUSize count)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddInlineHooks(transaction, entries, count);
+}
+
+ZyanStatus ZyrexTransactionInstallThunkHook(ZyrexTransaction* transaction, void* address, 
+    const ZyrexThunkSignature* signature, ZyrexThunkHandler handler, void* user_data,
+    ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddThunkHook(transaction, address, signature, handler, user_data, 
+        trampoline);
+}
+
+ZyanStatus ZyrexTransactionRemoveInlineHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddHookRemoval(transaction, ZYREX_HOOK_TYPE_INLINE, trampoline);
+}
+
+ZyanStatus ZyrexTransactionInstallExceptionHook(ZyrexTransaction* transaction, void* address,
+    const void* callback, ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddExceptionHook(transaction, ZYREX_HOOK_TYPE_EXCEPTION, address, 
+        callback, trampoline);
+}
+
+ZyanStatus ZyrexTransactionInstallContextHook(ZyrexTransaction* transaction, void* address,
+    const void* callback, ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddExceptionHook(transaction, ZYREX_HOOK_TYPE_CONTEXT, address, 
+        callback, trampoline);
+}
+
+ZyanStatus ZyrexTransactionRemoveExceptionHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddHookRemoval(transaction, ZYREX_HOOK_TYPE_EXCEPTION, trampoline);
+}
+
+ZyanStatus ZyrexTransactionRemoveContextHook(ZyrexTransaction* transaction, 
+    ZyanConstVoidPointer* trampoline)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddHookRemoval(transaction, ZYREX_HOOK_TYPE_CONTEXT, trampoline);
+}
+
+ZyanStatus ZyrexTransactionInstallIatHook(ZyrexTransaction* transaction, const void* module,
+    const char* import_module, const char* import_name, const void* callback,
+    ZyanConstVoidPointer* original)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddIatHook(transaction, module, import_module, import_name, callback,
+        original);
+}
+
+ZyanStatus ZyrexTransactionInstallVTableHook(ZyrexTransaction* transaction, void* vtable,
+    ZyanUSize index, const void* callback, ZyanConstVoidPointer* original)
+{
+    if (!ZyrexTransactionIsValid(transaction) || !vtable)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddPointerHook(transaction, ZYREX_HOOK_TYPE_VTABLE, 
+        (void**)vtable + index, callback, original);
+}
+
+ZyanStatus ZyrexTransactionRemoveIatHook(ZyrexTransaction* transaction, const void* module,
+    const char* import_module, const char* import_name)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddIatHookRemoval(transaction, module, import_module, import_name);
+}
+
+ZyanStatus ZyrexTransactionRemoveVTableHook(ZyrexTransaction* transaction, void* vtable,
+    ZyanUSize index)
+{
+    if (!ZyrexTransactionIsValid(transaction) || !vtable)
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+    if (transaction->is_locked)
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
+
+    return ZyrexTransactionAddPointerHookRemoval(transaction, ZYREX_HOOK_TYPE_VTABLE, 
+        (void**)vtable + index);
+}
+
+ZyanStatus ZyrexTransactionSubmit(ZyrexTransaction* transaction, const void** failed_operation)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    // A previous attempt might have failed after the threads were suspended
+    if (!transaction->is_locked)
+    {
+        ZyrexTransactionLock(transaction);
+
+        const ZyanStatus status = ZyrexTransactionSuspendDeferredThreads(transaction);
+        if (!ZYAN_SUCCESS(status))
+        {
+            ZyrexThreadListResume(&transaction->threads_to_update);
+            ZyanVectorClear(&transaction->threads_to_update);
+            ZyrexTransactionUnlock(transaction);
+            return status;
+        }
+    }
+
+    // The transaction stays active on failure, so the caller is able to call 
+    // `ZyrexTransactionDiscard`
+    ZYAN_CHECK(ZyrexTransactionApply(transaction, failed_operation));
+
+    ZyrexTransactionUnlock(transaction);
+    ZyrexTransactionDestroy(transaction);
+    ZYAN_FREE(transaction);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexTransactionDiscard(ZyrexTransaction* transaction)
+{
+    if (!ZyrexTransactionIsValid(transaction))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
+
+    ZyrexTransactionCancel(transaction);
+
+    ZyrexTransactionUnlock(transaction);
+    ZyrexTransactionDestroy(transaction);
+    ZYAN_FREE(transaction);
+
+    return ZYAN_STATUS_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook installation                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline)
 {
-    // TODO: Use platform independent APIs
+    return ZyrexInstallInlineHookEx(address, callback, ZYREX_INLINE_HOOK_FLAG_NONE, trampoline);
+}
 
-    DWORD old_protect;
-    if (!VirtualProtect((LPVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP, PAGE_EXECUTE_READWRITE, 
-        &old_protect))
+ZyanStatus ZyrexInstallInlineHookEx(void* address, const void* callback,
+    ZyrexInlineHookFlags flags, ZyanConstVoidPointer* trampoline)
+{
+    if (!address || !callback || !trampoline)
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-#if defined(ZYAN_X64)
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-    ZyrexWriteRelativeJump(address, (ZyanUPointer)&trampoline->callback_jump);
+    return ZyrexTransactionAddInlineHook(&g_transaction_data, address, callback, flags, 
+        trampoline);
+}
 
-#elif defined(ZYAN_X86)
+ZyanStatus ZyrexInstallInlineHooks(ZyrexInlineHookEntry* entries, ZyanUSize count)
+{
+    if (!entries || (count == 0))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-    ZyrexWriteRelativeJump(address, (ZyanUPointer)trampoline->callback_address);
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-#else
-#   error "Unsupported platform"
-#endif
+    return ZyrexTransactionAddInlineHooks(&g_transaction_data, entries, count);
+}
 
-    if (!VirtualProtect((LPVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP, old_protect, &old_protect))
+ZyanStatus ZyrexInstallThunkHook(void* address, const ZyrexThunkSignature* signature,
+    ZyrexThunkHandler handler, void* user_data, ZyanConstVoidPointer* trampoline)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    if (!FlushInstructionCache(GetCurrentProcess(), (LPCVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP))
+    return ZyrexTransactionAddThunkHook(&g_transaction_data, address, signature, handler, 
+        user_data, trampoline);
+}
+
+ZyanStatus ZyrexInstallExceptionHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    return ZYAN_STATUS_SUCCESS;
+    return ZyrexTransactionAddExceptionHook(&g_transaction_data, ZYREX_HOOK_TYPE_EXCEPTION, 
+        address, callback, trampoline);
 }
 
-/**
- * @brief   Reads the original code instructions from the `trampoline` and restores them to the
- *          given `address`.
- *
- * @param   address     The target address.
- * @param   trampoline  A pointer to the `ZyrexTrampolineChunk` struct.
- *
- * @return  A zyan status code.
- */
-static ZyanStatus ZyrexRestoreInstructions(void* address, const ZyrexTrampolineChunk* trampoline)
+ZyanStatus ZyrexInstallContextHook(void* address, const void* callback, 
+    ZyanConstVoidPointer* trampoline)
 {
-    // TODO: Use platform independent APIs
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
+    {
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-    DWORD old_protect;
-    if (!VirtualProtect((LPVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP, PAGE_EXECUTE_READWRITE, 
-        &old_protect))
+    return ZyrexTransactionAddExceptionHook(&g_transaction_data, ZYREX_HOOK_TYPE_CONTEXT, 
+        address, callback, trampoline);
+}
+
+ZyanStatus ZyrexInstallIatHook(const void* module, const char* import_module, 
+    const char* import_name, const void* callback, ZyanConstVoidPointer* original)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZYAN_MEMCPY(address, &trampoline->original_code, trampoline->original_code_size);
+    return ZyrexTransactionAddIatHook(&g_transaction_data, module, import_module, import_name, 
+        callback, original);
+}
 
-    if (!VirtualProtect((LPVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP, old_protect, &old_protect))
+ZyanStatus ZyrexInstallVTableHook(void* vtable, ZyanUSize index, const void* callback, 
+    ZyanConstVoidPointer* original)
+{
+    if (!vtable)
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    if (!FlushInstructionCache(GetCurrentProcess(), (LPCVOID)address, ZYREX_SIZEOF_RELATIVE_JUMP))
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    return ZYAN_STATUS_SUCCESS;    
+    return ZyrexTransactionAddPointerHook(&g_transaction_data, ZYREX_HOOK_TYPE_VTABLE, 
+        (void**)vtable + index, callback, original);
 }
 
-/* ---------------------------------------------------------------------------------------------- */
+ZyanStatus ZyrexInstallRemoteInlineHooks(void* process, ZyrexRemoteInlineHookEntry* entries, 
+    ZyanUSize count)
+{
+    if (!process || !entries || (count == 0))
+    {
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-/* ============================================================================================== */
-/* Exported functions                                                                             */
-/* ============================================================================================== */
+#if   defined(ZYAN_WINDOWS)
+    return ZyrexRemoteHooksInstall((HANDLE)process, entries, count);
+#else
+    return ZyrexRemoteHookEntriesFail(entries, count, ZYAN_STATUS_INVALID_OPERATION);
+#endif
+}
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Transaction                                                                                    */
+/* Hook removal                                                                                   */
 /* ---------------------------------------------------------------------------------------------- */
 
-ZyanStatus ZyrexTransactionBegin()
+ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* original)
 {
-    if (g_transaction_data.transaction_thread_id != 0)
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    if (InterlockedCompareExchange((volatile LONG*)&g_transaction_data.transaction_thread_id,
-        (LONG)GetCurrentThreadId(), 0) != 0)
+    return ZyrexTransactionAddHookRemoval(&g_transaction_data, ZYREX_HOOK_TYPE_INLINE, original);
+}
+
+ZyanStatus ZyrexRemoveExceptionHook(ZyanConstVoidPointer* original)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    ZYAN_CHECK(ZyanVectorInit(&g_transaction_data.pending_operations, sizeof(ZyrexOperation),
-        16, ZYAN_NULL));
+    return ZyrexTransactionAddHookRemoval(&g_transaction_data, ZYREX_HOOK_TYPE_EXCEPTION, 
+        original);
+}
 
-    const ZyanStatus status = ZyanVectorInit(&g_transaction_data.threads_to_update, 
-        sizeof(HANDLE), 16, (ZyanMemberProcedure)&ZyrexWindowsHandleDestroy);
-    if (!ZYAN_SUCCESS(status))
+ZyanStatus ZyrexRemoveContextHook(ZyanConstVoidPointer* original)
+{
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        ZyanVectorDestroy(&g_transaction_data.pending_operations);
-        return status;
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
 
-    return ZYAN_STATUS_SUCCESS;
+    return ZyrexTransactionAddHookRemoval(&g_transaction_data, ZYREX_HOOK_TYPE_CONTEXT, original);
 }
 
-ZyanStatus ZyrexUpdateThread(DWORD thread_id)
+ZyanStatus ZyrexRemoveIatHook(const void* module, const char* import_module, 
+    const char* import_name)
 {
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
         return ZYAN_STATUS_INVALID_OPERATION;
     }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
 
-    if (thread_id == GetCurrentThreadId())
+    return ZyrexTransactionAddIatHookRemoval(&g_transaction_data, module, import_module, 
+        import_name);
+}
+
+ZyanStatus ZyrexRemoveVTableHook(void* vtable, ZyanUSize index)
+{
+    if (!vtable)
     {
-        return ZYAN_STATUS_SUCCESS;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    const DWORD desired_access = THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT;
-    const HANDLE handle = OpenThread(desired_access, ZYAN_FALSE, thread_id);
-    if (handle == ZYAN_NULL)
+    if (g_transaction_data.transaction_thread_id != ZyrexGetCurrentThreadId())
     {
-        return ZYAN_STATUS_INVALID_ARGUMENT;    
+        return ZYAN_STATUS_INVALID_OPERATION;
     }
-    if (SuspendThread(handle) == (DWORD)(-1))
+
+    return ZyrexTransactionAddPointerHookRemoval(&g_transaction_data, ZYREX_HOOK_TYPE_VTABLE, 
+        (void**)vtable + index);
+}
+
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook modification                                                                              */
+/* ---------------------------------------------------------------------------------------------- */
+
+ZyanStatus ZyrexSetInlineHookCallback(ZyanConstVoidPointer trampoline, const void* callback)
+{
+    if (!trampoline || !callback)
     {
-        CloseHandle(handle);
-        return ZYAN_STATUS_BAD_SYSTEMCALL;        
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    return ZyanVectorPushBack(&g_transaction_data.threads_to_update, &handle);
+    // Intentionally not synchronized with the transaction API to keep this function lock-free
+    return ZyrexTrampolineSetCallback(ZyrexTrampolineGetChunk(trampoline), callback);
 }
 
-ZyanStatus ZyrexUpdateAllThreads()
+ZyanStatus ZyrexSetInlineHookEnabled(ZyanConstVoidPointer trampoline, ZyanBool enabled)
 {
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
+    if (!trampoline)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
 
-    const HANDLE h_snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
-    if (h_snapshot == INVALID_HANDLE_VALUE)
+    return ZyrexTrampolineSetBypass(ZyrexTrampolineGetChunk(trampoline), !enabled);
+}
+
+ZyanStatus ZyrexSetInlineHooksEnabled(const ZyanConstVoidPointer* trampolines, ZyanUSize count,
+    ZyanBool enabled)
+{
+    if (!trampolines || (count == 0))
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    THREADENTRY32 thread;
-    ZYAN_MEMSET(&thread, 0, sizeof(thread));
-    thread.dwSize = sizeof(thread);
-
-    if (Thread32First(h_snapshot, &thread))
+    ZyanStatus result = ZYAN_STATUS_SUCCESS;
+    for (ZyanUSize i = 0; i < count; ++i)
     {
-        do
+        const ZyanStatus status = ZyrexSetInlineHookEnabled(trampolines[i], enabled);
+        if (!ZYAN_SUCCESS(status) && ZYAN_SUCCESS(result))
         {
-            const HANDLE h_thread = 
-                OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT | THREAD_SET_CONTEXT, 
-                    ZYAN_FALSE, thread.th32ThreadID);
-            if (h_thread != ZYAN_NULL)
-            {
-                if (SuspendThread(h_thread) == (DWORD)(-1))
-                {
-                    CloseHandle(h_thread);
-                }
-                else
-                {
-                    ZyanVectorPushBack(&g_transaction_data.threads_to_update, &h_thread);     
-                } 
-            }                     
-        } while (!Thread32Next(h_snapshot, &thread));
+            result = status;
+        }
     }
 
-    if (!CloseHandle(h_snapshot))
+    return result;
+}
+
+ZyanStatus ZyrexSetInlineHookSamplingInterval(ZyanConstVoidPointer trampoline, 
+    ZyanU32 interval)
+{
+    if (!trampoline || (interval == 0))
     {
-        return ZYAN_STATUS_BAD_SYSTEMCALL;
-    };
+        return ZYAN_STATUS_INVALID_ARGUMENT;
+    }
 
-    return ZYAN_STATUS_SUCCESS;
+    return ZyrexTrampolineSetSamplingInterval(ZyrexTrampolineGetChunk(trampoline), interval);
 }
 
-ZyanStatus ZyrexTransactionCommit()
+/* ---------------------------------------------------------------------------------------------- */
+/* Hook counters                                                                                  */
+/* ---------------------------------------------------------------------------------------------- */
+
+/**
+ * @brief   Defines the `ZyrexCountersEnumContext` struct.
+ */
+typedef struct ZyrexCountersEnumContext_
 {
-    return ZyrexTransactionCommitEx(NULL);
+    /**
+     * @brief   The buffer that receives the counter values.
+     */
+    ZyrexInlineHookCounters* buffer;
+    /**
+     * @brief   The number of elements the `buffer` can hold.
+     */
+    ZyanUSize capacity;
+    /**
+     * @brief   The number of trampolines with counters found so far.
+     */
+    ZyanUSize count;
+} ZyrexCountersEnumContext;
+
+/**
+ * @brief   Atomically reads the given `counter`.
+ *
+ * @param   counter A pointer to the counter.
+ *
+ * @return  The value of the counter.
+ */
+ZYAN_INLINE ZyanU64 ZyrexCounterLoad(volatile ZyanU64* counter)
+{
+#if defined(ZYAN_X64)
+    return *counter;
+#elif defined(ZYAN_WINDOWS)
+    return (ZyanU64)InterlockedCompareExchange64((volatile LONGLONG*)counter, 0, 0);
+#elif defined(ZYAN_POSIX)
+    return __sync_fetch_and_add(counter, 0);
+#else
+#   error "Unsupported platform detected"
+#endif
 }
 
-ZyanStatus ZyrexTransactionCommitEx(const void** failed_operation)
+/**
+ * @brief   Sums up the counter shards of the given trampoline.
+ *
+ * @param   trampoline  The trampoline chunk. Must have counters enabled.
+ * @param   counters    Receives the counter values.
+ */
+static void ZyrexInlineHookCountersRead(const ZyrexTrampolineChunk* trampoline, 
+    ZyrexInlineHookCounters* counters)
 {
-    ZYAN_UNUSED(failed_operation);
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(trampoline->counters);
+    ZYAN_ASSERT(counters);
 
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
-    {
-        return ZYAN_STATUS_INVALID_OPERATION;
-    }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
+    counters->address = 
+        (const void*)(trampoline->backjump_address - trampoline->original_code_size);
+    counters->trampoline = &trampoline->code->code_buffer;
+    counters->calls = 0;
+    counters->rejections = 0;
+    counters->cycles = 0;
 
-    ZyanISize revert_index = (ZyanISize)(-1);
-    ZyanStatus status = ZYAN_STATUS_SUCCESS;
-    for (ZyanISize i = 0; i < (ZyanISize)g_transaction_data.pending_operations.size; ++i)
+    for (ZyanUSize i = 0; i < ZYREX_TRAMPOLINE_COUNTER_SHARDS; ++i)
     {
-        const ZyrexOperation* item = ZyanVectorGet(&g_transaction_data.pending_operations, i);
-        ZYAN_ASSERT(item);
+        ZyrexTrampolineCounterShard* const shard = &trampoline->counters->shards[i];
+        counters->calls      += ZyrexCounterLoad(&shard->calls);
+        counters->rejections += ZyrexCounterLoad(&shard->rejections);
+        counters->cycles     += ZyrexCounterLoad(&shard->cycles);
+    }
+}
 
-        switch (item->type)
-        {
-        case ZYREX_HOOK_TYPE_INLINE:
-            switch (item->action)
-            {
-            case ZYREX_OPERATION_ACTION_ATTACH:
-            {
-                // TODO: Check if code has changed between this call and the Attach*
-                status = ZyrexWriteHookJump(item->address, item->trampoline);
-                break;
-            }
-            case ZYREX_OPERATION_ACTION_REMOVE:
-                status = ZyrexRestoreInstructions(item->address, item->trampoline);
-                if (ZYAN_SUCCESS(status))
-                {
-                    status = ZyrexTrampolineFree(item->trampoline);
-                    if (status == ZYAN_STATUS_FALSE)
-                    {
-                        status = ZYAN_STATUS_NOT_FOUND;
-                    }
-                }
-                break;
-            default:
-                ZYAN_UNREACHABLE;
-            }
-            break;
-        case ZYREX_HOOK_TYPE_EXCEPTION:
-            break;
-        case ZYREX_HOOK_TYPE_CONTEXT:
-            break;
-        default:
-            ZYAN_UNREACHABLE;
-        }
+/**
+ * @brief   Collects the counters of the given trampoline, if enabled.
+ *
+ * @param   trampoline  The trampoline chunk.
+ * @param   context     A pointer to the `ZyrexCountersEnumContext` struct.
+ *
+ * @return  `ZYAN_TRUE` to continue the enumeration.
+ */
+static ZyanBool ZyrexCountersEnumCallback(const ZyrexTrampolineChunk* trampoline, void* context)
+{
+    ZYAN_ASSERT(trampoline);
+    ZYAN_ASSERT(context);
 
-        if (!ZYAN_SUCCESS(status))
-        {
-            revert_index = i - 1;
-            break;
-        }
+    if (!trampoline->counters)
+    {
+        return ZYAN_TRUE;
     }
 
-    if (revert_index >= 0)
+    ZyrexCountersEnumContext* const data = (ZyrexCountersEnumContext*)context;
+    if (data->count < data->capacity)
     {
-        // TODO: Revert changes
+        ZyrexInlineHookCountersRead(trampoline, &data->buffer[data->count]);
     }
+    ++data->count;
 
-    // TODO: Update threads
-
-    ZyanVectorDestroy(&g_transaction_data.pending_operations);
-    ZyanVectorDestroy(&g_transaction_data.threads_to_update);
-    g_transaction_data.transaction_thread_id = 0;
-
-    return ZYAN_STATUS_SUCCESS;
+    return ZYAN_TRUE;
 }
 
-ZyanStatus ZyrexTransactionAbort()
+ZyanStatus ZyrexGetInlineHookCounters(ZyanConstVoidPointer trampoline, 
+    ZyrexInlineHookCounters* counters)
 {
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
+    if (!trampoline || !counters)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
-
-    ZYAN_VECTOR_FOREACH_MUTABLE(ZyrexOperation, &g_transaction_data.pending_operations, operation, 
-    {
-        ZyrexTrampolineFree(operation->trampoline);
-    });
 
-    ZYAN_VECTOR_FOREACH(HANDLE, &g_transaction_data.threads_to_update, handle, 
+    const ZyrexTrampolineChunk* const chunk = ZyrexTrampolineGetChunk(trampoline);
+    if (!chunk->counters)
     {
-        ResumeThread(handle);
-    });
+        return ZYAN_STATUS_INVALID_OPERATION;
+    }
 
-    ZyanVectorDestroy(&g_transaction_data.pending_operations);
-    ZyanVectorDestroy(&g_transaction_data.threads_to_update);
-    g_transaction_data.transaction_thread_id = 0;
+    // Intentionally not synchronized with the transaction API to keep this function lock-free
+    ZyrexInlineHookCountersRead(chunk, counters);
 
     return ZYAN_STATUS_SUCCESS;
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/* Hook installation                                                                              */
-/* ---------------------------------------------------------------------------------------------- */
-
-ZyanStatus ZyrexInstallInlineHook(void* address, const void* callback, 
-    ZyanConstVoidPointer* trampoline)
+ZyanStatus ZyrexGetAllInlineHookCounters(ZyrexInlineHookCounters* buffer, ZyanUSize capacity,
+    ZyanUSize* count)
 {
-    if (!address || !callback || !trampoline)
+    if ((!buffer && (capacity > 0)) || !count)
     {
         return ZYAN_STATUS_INVALID_ARGUMENT;
     }
 
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
+
+    ZyrexCountersEnumContext context;
+    context.buffer = buffer;
+    context.capacity = capacity;
+    context.count = 0;
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    const ZyanStatus status = 
+        ZyrexTrampolineEnumerate(&ZyrexCountersEnumCallback, &context);
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
+    ZYAN_CHECK(status);
+
+    *count = context.count;
+
+    return (context.count > capacity) ? ZYAN_STATUS_INSUFFICIENT_BUFFER_SIZE : 
+        ZYAN_STATUS_SUCCESS;
+}
+
+ZyanStatus ZyrexGetTrampolineStatistics(ZyrexTrampolineStatistics* statistics)
+{
+    if (!statistics)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
 
-    ZyrexOperation operation = 
-    {
-        /* type                */ ZYREX_HOOK_TYPE_INLINE,
-        /* action              */ ZYREX_OPERATION_ACTION_ATTACH,
-        /* address             */ ZYAN_NULL,
-        /* trampoline          */ ZYAN_NULL
-    };
-    operation.address = address;
-    ZYAN_CHECK(ZyrexTrampolineCreate(address, callback, ZYREX_SIZEOF_RELATIVE_JUMP, 
-        &operation.trampoline));
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
 
-    *trampoline = &operation.trampoline->code_buffer;
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    const ZyanStatus status = ZyrexTrampolineGetStatistics(statistics);
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
 
-    return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);
+    return status;
 }
 
 /* ---------------------------------------------------------------------------------------------- */
-/* Hook installation                                                                              */
+/* Relocation cache                                                                               */
 /* ---------------------------------------------------------------------------------------------- */
 
-ZyanStatus ZyrexRemoveInlineHook(ZyanConstVoidPointer* original)
+ZyanStatus ZyrexOpenRelocationCache(const char* path)
 {
-    if (g_transaction_data.transaction_thread_id != GetCurrentThreadId())
+    if (!path)
     {
-        return ZYAN_STATUS_INVALID_OPERATION;
+        return ZYAN_STATUS_INVALID_ARGUMENT;
     }
-    
-    ZYAN_ASSERT(g_transaction_data.pending_operations.data);
-    ZYAN_ASSERT(g_transaction_data.threads_to_update.data);
 
-    ZyrexTrampolineChunk* trampoline;
-    ZYAN_CHECK(ZyrexTrampolineFind(*original, &trampoline));
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
 
-    ZyrexOperation operation = 
-    {
-        /* type                */ ZYREX_HOOK_TYPE_INLINE,
-        /* action              */ ZYREX_OPERATION_ACTION_REMOVE,
-        /* address             */ ZYAN_NULL,
-        /* trampoline          */ ZYAN_NULL
-    };
-    operation.address = address;
-    operation.trampoline = trampoline;
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    const ZyanStatus status = ZyrexRelocationCacheOpen(path);
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
 
-    *original = address;
+    return status;
+}
+
+ZyanStatus ZyrexCloseRelocationCache(ZyanBool save)
+{
+    ZYAN_CHECK(ZyrexTransactionLocksInitialize());
+
+    ZYAN_UNUSED(ZyanCriticalSectionEnter(&g_transaction_locks.region_lock));
+    const ZyanStatus status = ZyrexRelocationCacheClose(save);
+    ZYAN_UNUSED(ZyanCriticalSectionLeave(&g_transaction_locks.region_lock));
 
-    return ZyanVectorPushBack(&g_transaction_data.pending_operations, &operation);        
+    return status;
 }
 
 /* ---------------------------------------------------------------------------------------------- */